@@ -1,6 +1,10 @@
 # runtime helper for godot peek mcp
 # handles game screenshots, autoload variable overrides, expression evaluation, input injection
 #
+# when the godot peek extension is loaded this only adds its native
+# GodotPeekRuntime node, which does all of the above in C++ (and also serves
+# the framed game socket). everything below is the fallback for when it isn't
+#
 # setup:
 #   - automatically added when plugin is enabled
 #   - for best results, ensure this is FIRST in Project Settings > Autoload
@@ -19,6 +23,10 @@ func _ready() -> void:
 	# skip in export builds — no mcp server to talk to
 	if not OS.has_feature("editor"):
 		return
+	if ClassDB.class_exists("GodotPeekRuntime"):
+		add_child(ClassDB.instantiate("GodotPeekRuntime"))
+		set_process(false)
+		return
 	_apply_overrides()
 	_start_screenshot_server()
 
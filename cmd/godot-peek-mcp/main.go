@@ -53,11 +53,18 @@ func main() {
 func run(ctx context.Context) error {
 	// socket path resolution:
 	// 1. GODOT_PEEK_SOCKET env var (explicit full path override)
-	// 2. derive from cwd directory name (matches C++ plugin logic)
+	// 2. the registered editor whose project contains cwd
+	// 3. derive from cwd directory name (matches C++ plugin logic)
 	socketPath := os.Getenv("GODOT_PEEK_SOCKET")
 	if socketPath == "" {
 		dir, err := os.Getwd()
 		if err == nil {
+			instances, _ := godot.ListInstances(godot.RegistryDir())
+			if inst, ok := godot.FindInstance(instances, dir); ok {
+				socketPath = inst.SocketPath
+			}
+		}
+		if err == nil && socketPath == "" {
 			sanitized := sanitizeProjectName(filepath.Base(dir))
 			if sanitized != "" {
 				socketPath = "/tmp/godot-peek-" + sanitized + ".sock"
@@ -0,0 +1,91 @@
+#include "compression.h"
+#include "server_stats.h"
+#include "trace.h"
+
+#include <zlib.h>
+
+bool deflate_compress(const std::string& in, std::string& out, int level) {
+    uLongf bound = compressBound(static_cast<uLong>(in.size()));
+    out.resize(bound);
+    int rc = compress2(reinterpret_cast<Bytef*>(&out[0]), &bound,
+                       reinterpret_cast<const Bytef*>(in.data()), static_cast<uLong>(in.size()), level);
+    if (rc != Z_OK) {
+        out.clear();
+        return false;
+    }
+    out.resize(bound);
+    return true;
+}
+
+bool deflate_decompress(const std::string& in, std::string& out, size_t max_out) {
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) {
+        return false;
+    }
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+
+    out.clear();
+    char chunk[16384];
+    int rc = Z_OK;
+    while (rc != Z_STREAM_END) {
+        zs.next_out = reinterpret_cast<Bytef*>(chunk);
+        zs.avail_out = sizeof(chunk);
+        rc = inflate(&zs, Z_NO_FLUSH);
+        if (rc != Z_OK && rc != Z_STREAM_END) {
+            break;
+        }
+        out.append(chunk, sizeof(chunk) - zs.avail_out);
+        if (out.size() > max_out || (rc == Z_OK && zs.avail_in == 0 && zs.avail_out != 0)) {
+            break;  // too big, or truncated input
+        }
+    }
+    inflateEnd(&zs);
+    return rc == Z_STREAM_END && out.size() <= max_out;
+}
+
+// --- CompressionWorker ---
+
+CompressionWorker::CompressionWorker(int level) : level(level) {
+    thread = std::thread([this] { run(); });
+}
+
+CompressionWorker::~CompressionWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void CompressionWorker::submit(std::shared_ptr<CompressionJob> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void CompressionWorker::run() {
+    while (true) {
+        std::shared_ptr<CompressionJob> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) {
+                // pending jobs are abandoned; their connections are closing
+                return;
+            }
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        PEEK_TRACE_SCOPE("deflate");
+        uint64_t start = stats_now_ns();
+        job->ok = deflate_compress(job->payload, job->compressed, level) &&
+                  job->compressed.size() < job->payload.size();
+        job->compress_ns = stats_now_ns() - start;
+        job->done.store(true, std::memory_order_release);
+    }
+}
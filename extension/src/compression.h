@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// response compression (no godot dependency). deflate in the zlib format:
+// zlib ships with every platform we build for and Go's standard library can
+// read it, so neither side needs a new dependency.
+
+// compress in into out (replacing it). false on zlib failure
+bool deflate_compress(const std::string& in, std::string& out, int level = 1);
+
+// inflate in into out, refusing output larger than max_out. false if the
+// data is corrupt or too large
+bool deflate_decompress(const std::string& in, std::string& out, size_t max_out);
+
+// one payload handed to the worker. the main thread owns it until done is
+// set, the worker from submit() until then
+struct CompressionJob {
+    std::string payload;       // in: bytes to compress
+    std::string compressed;    // out: deflated bytes (valid if ok)
+    bool ok = false;           // out: compressed and actually smaller
+    uint64_t compress_ns = 0;  // out: time spent in deflate
+    std::atomic<bool> done{false};
+};
+
+// a single background thread that compresses large responses so the editor
+// main thread never blocks on deflate. results are picked up by polling
+// CompressionJob::done, which keeps per-client response order in the caller
+class CompressionWorker {
+public:
+    explicit CompressionWorker(int level = 1);
+    ~CompressionWorker();
+
+    CompressionWorker(const CompressionWorker&) = delete;
+    CompressionWorker& operator=(const CompressionWorker&) = delete;
+
+    void submit(std::shared_ptr<CompressionJob> job);
+
+private:
+    void run();
+
+    int level;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<CompressionJob>> queue;
+    bool stopping = false;
+    std::thread thread;
+};
@@ -0,0 +1,178 @@
+#include "count_snapshots.h"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+void CountSnapshotStore::begin() {
+    for (uint32_t id : touched) {
+        pass_counts[id] = 0;
+    }
+    touched.clear();
+    pass_nodes = 0;
+}
+
+void CountSnapshotStore::add(std::string_view class_name, std::string_view script) {
+    // the scratch key keeps its capacity, so a lookup of a known key
+    // doesn't allocate
+    scratch.assign(class_name);
+    scratch += '\0';
+    scratch.append(script);
+    auto it = key_ids.find(scratch);
+    uint32_t id;
+    if (it != key_ids.end()) {
+        id = it->second;
+    } else {
+        id = static_cast<uint32_t>(keys.size());
+        keys.push_back(CountKey{std::string(class_name), std::string(script)});
+        key_ids.emplace(scratch, id);
+        pass_counts.push_back(0);
+    }
+    if (pass_counts[id]++ == 0) {
+        touched.push_back(id);
+    }
+    pass_nodes++;
+}
+
+const CountSnapshot& CountSnapshotStore::commit(int64_t time_ms, uint64_t frame, const CountTotals& totals) {
+    CountSnapshot snap;
+    snap.id = next_id++;
+    snap.time_ms = time_ms;
+    snap.frame = frame;
+    snap.nodes = pass_nodes;
+    snap.totals = totals;
+    std::sort(touched.begin(), touched.end());
+    snap.counts.reserve(touched.size());
+    for (uint32_t id : touched) {
+        snap.counts.emplace_back(id, pass_counts[id]);
+    }
+    begin();
+
+    if (snapshots.size() >= max_snapshots) {
+        snapshots.pop_front();
+    }
+    snapshots.push_back(std::move(snap));
+    return snapshots.back();
+}
+
+const CountSnapshot* CountSnapshotStore::find(int64_t ref) const {
+    if (snapshots.empty()) {
+        return nullptr;
+    }
+    if (ref <= 0) {
+        if (static_cast<uint64_t>(-ref) >= snapshots.size()) {
+            return nullptr;
+        }
+        return &snapshots[snapshots.size() - 1 - static_cast<size_t>(-ref)];
+    }
+    // ids are consecutive, so the position follows from the first one
+    int64_t first = snapshots.front().id;
+    if (ref < first || ref - first >= static_cast<int64_t>(snapshots.size())) {
+        return nullptr;
+    }
+    return &snapshots[static_cast<size_t>(ref - first)];
+}
+
+std::vector<CountDelta> CountSnapshotStore::diff(const CountSnapshot& from, const CountSnapshot& to) const {
+    std::vector<CountDelta> out;
+    // both sides are sorted by key id: one merge
+    auto a = from.counts.begin();
+    auto b = to.counts.begin();
+    while (a != from.counts.end() || b != to.counts.end()) {
+        CountDelta d;
+        if (b == to.counts.end() || (a != from.counts.end() && a->first < b->first)) {
+            d = CountDelta{a->first, a->second, 0};
+            ++a;
+        } else if (a == from.counts.end() || b->first < a->first) {
+            d = CountDelta{b->first, 0, b->second};
+            ++b;
+        } else {
+            d = CountDelta{a->first, a->second, b->second};
+            ++a;
+            ++b;
+        }
+        if (d.delta() != 0) {
+            out.push_back(d);
+        }
+    }
+    std::stable_sort(out.begin(), out.end(),
+                     [](const CountDelta& x, const CountDelta& y) { return x.delta() > y.delta(); });
+    return out;
+}
+
+// helper: a key as {"class", "script"?}
+static json key_json(const CountKey& key) {
+    json entry = {{"class", key.class_name}};
+    if (!key.script.empty()) {
+        entry["script"] = key.script;
+    }
+    return entry;
+}
+
+json count_snapshot_json(const CountSnapshotStore& store, const CountSnapshot& snapshot, size_t top) {
+    std::vector<std::pair<uint32_t, uint32_t>> largest = snapshot.counts;
+    size_t n = std::min(top, largest.size());
+    std::partial_sort(largest.begin(), largest.begin() + static_cast<std::ptrdiff_t>(n), largest.end(),
+                      [](const auto& x, const auto& y) { return x.second > y.second; });
+
+    json counts = json::array();
+    for (size_t i = 0; i < n; i++) {
+        json entry = key_json(store.key(largest[i].first));
+        entry["count"] = largest[i].second;
+        counts.push_back(std::move(entry));
+    }
+    return {
+        {"id", snapshot.id},
+        {"time_ms", snapshot.time_ms},
+        {"frame", snapshot.frame},
+        {"nodes", snapshot.nodes},
+        {"keys", snapshot.counts.size()},
+        {"objects", snapshot.totals.objects},
+        {"resources", snapshot.totals.resources},
+        {"orphan_nodes", snapshot.totals.orphan_nodes},
+        {"top", std::move(counts)}
+    };
+}
+
+json count_diff_json(const CountSnapshotStore& store, const CountSnapshot& from, const CountSnapshot& to,
+                     size_t limit) {
+    std::vector<CountDelta> deltas = store.diff(from, to);
+    json grown = json::array();
+    json shrunk = json::array();
+    auto entry = [&](const CountDelta& d) {
+        json e = key_json(store.key(d.key));
+        e["before"] = d.before;
+        e["after"] = d.after;
+        e["delta"] = d.delta();
+        return e;
+    };
+    for (size_t i = 0; i < deltas.size() && deltas[i].delta() > 0 && grown.size() < limit; i++) {
+        grown.push_back(entry(deltas[i]));
+    }
+    for (size_t i = deltas.size(); i > 0 && deltas[i - 1].delta() < 0 && shrunk.size() < limit; i--) {
+        shrunk.push_back(entry(deltas[i - 1]));
+    }
+
+    auto total = [](int64_t before, int64_t after) {
+        json t = {{"before", before}, {"after", after}};
+        if (before >= 0 && after >= 0) {
+            t["delta"] = after - before;
+        }
+        return t;
+    };
+    auto side = [](const CountSnapshot& s) {
+        return json{{"id", s.id}, {"time_ms", s.time_ms}, {"frame", s.frame}};
+    };
+    return {
+        {"from", side(from)},
+        {"to", side(to)},
+        {"seconds", static_cast<double>(to.time_ms - from.time_ms) / 1000.0},
+        {"changed", deltas.size()},
+        {"grown", std::move(grown)},
+        {"shrunk", std::move(shrunk)},
+        {"nodes", total(static_cast<int64_t>(from.nodes), static_cast<int64_t>(to.nodes))},
+        {"objects", total(from.totals.objects, to.totals.objects)},
+        {"resources", total(from.totals.resources, to.totals.resources)},
+        {"orphan_nodes", total(from.totals.orphan_nodes, to.totals.orphan_nodes)}
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// live node counts per class and script, snapshotted and diffed (no godot
+// dependency).
+//
+// the game runtime walks the scene tree once per snapshot and feeds every
+// node's class and script path to a CountSnapshotStore. a snapshot keeps
+// only the (key id, count) pairs that are non-zero, sorted by key, so a
+// thousand classes cost 8 KB and two snapshots diff in one merge. keys are
+// interned once for the life of the store. the engine's aggregate object,
+// resource and orphan counts ride along, since godot doesn't expose the live
+// resources themselves.
+
+struct CountKey {
+    std::string class_name;
+    std::string script;     // resource path, "" for none or a built-in script
+};
+
+// engine-wide counts from the Performance monitors, -1 when unknown
+struct CountTotals {
+    int64_t objects = -1;
+    int64_t resources = -1;
+    int64_t orphan_nodes = -1;
+};
+
+struct CountSnapshot {
+    int64_t id = 0;             // 1-based, per store
+    int64_t time_ms = 0;        // unix ms
+    uint64_t frame = 0;         // process frame it was taken in
+    uint64_t nodes = 0;         // nodes counted
+    CountTotals totals;
+    std::vector<std::pair<uint32_t, uint32_t>> counts;  // (key id, count), by key id
+};
+
+struct CountDelta {
+    uint32_t key = 0;
+    int64_t before = 0;
+    int64_t after = 0;
+    int64_t delta() const { return after - before; }
+};
+
+// snapshots kept before the oldest goes: ten minutes at one per second
+constexpr size_t COUNT_SNAPSHOTS_MAX = 600;
+
+class CountSnapshotStore {
+public:
+    explicit CountSnapshotStore(size_t max_snapshots = COUNT_SNAPSHOTS_MAX) : max_snapshots(max_snapshots) {}
+
+    // one pass: begin(), add() per node, commit()
+    void begin();
+    void add(std::string_view class_name, std::string_view script);
+    const CountSnapshot& commit(int64_t time_ms, uint64_t frame, const CountTotals& totals);
+
+    const CountKey& key(uint32_t id) const { return keys[id]; }
+    size_t key_count() const { return keys.size(); }
+
+    // 0: the newest, negative: that many before it, else a snapshot id.
+    // nullptr when there is no such snapshot (or it was dropped)
+    const CountSnapshot* find(int64_t ref) const;
+    const std::deque<CountSnapshot>& all() const { return snapshots; }
+
+    // every key whose count changed between from and to, biggest growth
+    // first and biggest shrink last
+    std::vector<CountDelta> diff(const CountSnapshot& from, const CountSnapshot& to) const;
+
+private:
+    size_t max_snapshots;
+    int64_t next_id = 1;
+    std::deque<CountSnapshot> snapshots;
+
+    std::vector<CountKey> keys;
+    std::unordered_map<std::string, uint32_t> key_ids;   // class '\0' script
+    std::string scratch;
+
+    // the pass in progress: counts by key id and the ids touched
+    std::vector<uint32_t> pass_counts;
+    std::vector<uint32_t> touched;
+    uint64_t pass_nodes = 0;
+};
+
+// the JSON the runtime's count commands reply with. top: the largest
+// counts in a snapshot summary; limit: entries per grown / shrunk list
+nlohmann::json count_snapshot_json(const CountSnapshotStore& store, const CountSnapshot& snapshot, size_t top);
+nlohmann::json count_diff_json(const CountSnapshotStore& store, const CountSnapshot& from, const CountSnapshot& to,
+                               size_t limit);
@@ -3,6 +3,7 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
 #include <godot_cpp/classes/editor_interface.hpp>
 #include <godot_cpp/classes/script_editor.hpp>
 #include <godot_cpp/classes/script_editor_base.hpp>
@@ -30,9 +31,32 @@ void GodotPeekDebuggerPlugin::_setup_session(int32_t session_id) {
     Ref<EditorDebuggerSession> session = get_session(session_id);
     if (session.is_valid()) {
         apply_cached_breakpoints(session);
+
+        // lets multi-frame handlers (debug_step) wait for the game to stop
+        Callable on_breaked = callable_mp(this, &GodotPeekDebuggerPlugin::_on_session_breaked);
+        if (!session->is_connected("breaked", on_breaked)) {
+            session->connect("breaked", on_breaked);
+        }
+
+        // lets the plugin drop cached debugger reads when the state changes
+        Callable on_state = callable_mp(this, &GodotPeekDebuggerPlugin::_on_session_state);
+        for (const char* signal : {"started", "stopped", "continued"}) {
+            if (!session->is_connected(signal, on_state)) {
+                session->connect(signal, on_state);
+            }
+        }
     }
 }
 
+void GodotPeekDebuggerPlugin::_on_session_breaked(bool) {
+    breaked.fire();
+    state_changed.fire();
+}
+
+void GodotPeekDebuggerPlugin::_on_session_state() {
+    state_changed.fire();
+}
+
 bool GodotPeekDebuggerPlugin::_has_capture(const String& capture) const {
     // we don't capture any custom messages from the game side
     return capture == "godot_peek";
@@ -145,6 +169,10 @@ bool GodotPeekDebuggerPlugin::is_session_active() {
     return false;
 }
 
+int32_t GodotPeekDebuggerPlugin::active_session_id() {
+    return is_session_active() ? current_session_id : -1;
+}
+
 bool GodotPeekDebuggerPlugin::is_debuggable() {
     Ref<EditorDebuggerSession> session = get_current_session();
     if (session.is_valid()) {
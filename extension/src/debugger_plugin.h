@@ -4,6 +4,8 @@
 #include <godot_cpp/classes/editor_debugger_session.hpp>
 #include <godot_cpp/classes/ref.hpp>
 #include <vector>
+
+#include "frame_task.h"
 #include <string>
 
 namespace godot {
@@ -39,6 +41,8 @@ public:
     // debugger state queries (not const because get_session isn't const in base class)
     bool is_paused();
     bool is_session_active();
+    // id of the session the game runs in, -1 when there is none
+    int32_t active_session_id();
     bool is_debuggable();
 
     // execution control
@@ -48,6 +52,11 @@ public:
     void continue_execution();
     void request_break();
 
+    // fired whenever the game stops in the debugger (breakpoint, step, break)
+    const FrameSignal& break_signal() const { return breaked; }
+    // fired on every session start, stop, break and continue
+    const FrameSignal& state_signal() const { return state_changed; }
+
 private:
     // track the current active session
     int32_t current_session_id = 0;
@@ -62,6 +71,14 @@ private:
 
     // apply cached breakpoints to a session
     void apply_cached_breakpoints(Ref<EditorDebuggerSession> session);
+
+    // EditorDebuggerSession "breaked" handler
+    void _on_session_breaked(bool can_debug);
+    FrameSignal breaked;
+
+    // EditorDebuggerSession "started", "stopped" and "continued" handler
+    void _on_session_state();
+    FrameSignal state_changed;
 };
 
 }
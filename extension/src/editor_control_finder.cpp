@@ -1,10 +1,13 @@
 #include "editor_control_finder.h"
+#include "trace.h"
 
 #include <godot_cpp/classes/editor_interface.hpp>
 #include <godot_cpp/classes/control.hpp>
 #include <godot_cpp/classes/label.hpp>
 #include <godot_cpp/classes/button.hpp>
 #include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
+#include <godot_cpp/classes/theme.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 using namespace godot;
@@ -45,6 +48,46 @@ RichTextLabel* EditorControlFinder::get_output_panel() {
     return output_panel.get();
 }
 
+Button* EditorControlFinder::get_output_clear_button() {
+    Button* cached = output_clear_button.get();
+    if (cached) {
+        return cached;
+    }
+
+    EditorInterface* editor = EditorInterface::get_singleton();
+    if (!editor) {
+        return nullptr;
+    }
+
+    Control* base = editor->get_base_control();
+    if (!base) {
+        return nullptr;
+    }
+
+    // EditorLog gives its Clear button the editor's "Clear" icon; the
+    // tooltip is translated, so it's only the fallback for english editors
+    Ref<Theme> theme = editor->get_editor_theme();
+    Ref<Texture2D> clear_icon = theme.is_valid() ? theme->get_icon("Clear", "EditorIcons") : Ref<Texture2D>();
+
+    // same path patterns as the Output panel itself
+    auto buttons = find_all_by_class(base, "Button");
+    for (Node* node : buttons) {
+        String path = node->get_path();
+        if (!path.contains("EditorLog") && !(path.contains("EditorBottomPanel") && path.contains("/Output/"))) {
+            continue;
+        }
+        Button* btn = Object::cast_to<Button>(node);
+        if (btn && ((clear_icon.is_valid() && btn->get_button_icon() == clear_icon) ||
+                    btn->get_tooltip_text() == "Clear Output")) {
+            output_clear_button.set(btn);
+            UtilityFunctions::print("EditorControlFinder: found output clear button at ", path);
+            break;
+        }
+    }
+
+    return output_clear_button.get();
+}
+
 Tree* EditorControlFinder::get_errors_tree() {
     Tree* cached = errors_tree.get();
     if (cached) {
@@ -319,6 +362,7 @@ Tree* EditorControlFinder::get_remote_scene_tree(bool click_remote_button) {
 
 void EditorControlFinder::invalidate_cache() {
     output_panel.clear();
+    output_clear_button.clear();
     errors_tree.clear();
     monitors_tree.clear();
     stack_trace_label.clear();
@@ -330,20 +374,23 @@ void EditorControlFinder::invalidate_cache() {
 }
 
 std::vector<Node*> EditorControlFinder::find_all_by_class(Node* root, const char* class_name) {
+    // full walk of the editor UI - the expensive part of control discovery
+    PEEK_TRACE_SCOPE("EditorControlFinder::find_all_by_class");
+
     std::vector<Node*> results;
+    collect_by_class(root, class_name, results);
+    return results;
+}
 
+void EditorControlFinder::collect_by_class(Node* node, const char* class_name, std::vector<Node*>& results) {
     // is_class() checks if node is exactly that class or inherits from it
-    if (root->is_class(class_name)) {
-        results.push_back(root);
+    if (node->is_class(class_name)) {
+        results.push_back(node);
     }
 
     // recurse into children
-    int child_count = root->get_child_count();
+    int child_count = node->get_child_count();
     for (int i = 0; i < child_count; i++) {
-        Node* child = root->get_child(i);
-        auto child_results = find_all_by_class(child, class_name);
-        results.insert(results.end(), child_results.begin(), child_results.end());
+        collect_by_class(node->get_child(i), class_name, results);
     }
-
-    return results;
 }
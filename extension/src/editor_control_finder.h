@@ -4,6 +4,7 @@
 #include <godot_cpp/classes/control.hpp>
 #include <godot_cpp/classes/rich_text_label.hpp>
 #include <godot_cpp/classes/label.hpp>
+#include <godot_cpp/classes/button.hpp>
 #include <godot_cpp/classes/tree.hpp>
 #include <godot_cpp/core/object.hpp>  // ObjectDB
 #include <vector>
@@ -51,6 +52,10 @@ public:
     // find the Output panel RichTextLabel (lazy cached)
     godot::RichTextLabel* get_output_panel();
 
+    // find the Output dock's Clear button (lazy cached). pressing it empties
+    // EditorLog's message list along with the panel
+    godot::Button* get_output_clear_button();
+
     // find the Debugger Errors tree (lazy cached)
     godot::Tree* get_errors_tree();
 
@@ -87,8 +92,16 @@ private:
         const char* class_name
     );
 
+    // recursive worker for find_all_by_class, appends into one result vector
+    void collect_by_class(
+        godot::Node* node,
+        const char* class_name,
+        std::vector<godot::Node*>& results
+    );
+
     // cached references with lifetime validation via ObjectDB
     CachedRef<godot::RichTextLabel> output_panel;
+    CachedRef<godot::Button> output_clear_button;
     CachedRef<godot::Tree> errors_tree;
     CachedRef<godot::Tree> monitors_tree;
     CachedRef<godot::RichTextLabel> stack_trace_label;
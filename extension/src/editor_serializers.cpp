@@ -0,0 +1,290 @@
+#include "editor_serializers.h"
+#include "trace.h"
+
+using json = nlohmann::json;
+
+// --- trees ---
+
+std::string tree_text(const TreeView& tree) {
+    PEEK_TRACE_SCOPE("tree_text");
+    std::string result;
+    ItemHandle root = tree.root();
+    if (root) {
+        append_tree_item_text(tree, root, 0, result);
+    }
+    return result;
+}
+
+void append_tree_item_text(const TreeView& tree, ItemHandle item, int depth, std::string& out) {
+    // get text from all columns, join with " | "
+    int col_count = tree.column_count();
+    size_t line_start = out.size();
+    out.append(depth * 2, ' ');  // 2 spaces per depth level
+    size_t text_start = out.size();
+
+    for (int col = 0; col < col_count; col++) {
+        std::string text = tree.text(item, col);
+        if (!text.empty()) {
+            if (out.size() > text_start) {
+                out += " | ";
+            }
+            out += text;
+        }
+    }
+
+    if (out.size() > text_start) {
+        out += '\n';
+    } else {
+        out.resize(line_start);  // nothing in any column, drop the indent
+    }
+
+    // recurse into children
+    for (ItemHandle child = tree.first_child(item); child; child = tree.next_sibling(child)) {
+        append_tree_item_text(tree, child, depth + 1, out);
+    }
+}
+
+// helper: recursive worker for scene_tree_text
+static void append_scene_tree_item_text(const TreeView& tree, ItemHandle item, int depth, std::string& out) {
+    // get node name from column 0
+    std::string name_str = tree.text(item, 0);
+    if (!name_str.empty()) {
+        // try to get node type from tooltip
+        // tooltip often contains "NodeName (Type)" or type info
+        std::string tt = tree.tooltip(item, 0);
+        std::string type_str;
+        size_t paren_pos = tt.find('(');
+        if (paren_pos != std::string::npos) {
+            size_t end_paren = tt.find(')', paren_pos);
+            if (end_paren != std::string::npos) {
+                type_str = tt.substr(paren_pos + 1, end_paren - paren_pos - 1);
+            }
+        }
+
+        // build output line: "  NodeName (Type)" or just "  NodeName"
+        out.append(depth * 2, ' ');
+        out += name_str;
+        if (!type_str.empty()) {
+            out += " (";
+            out += type_str;
+            out += ')';
+        }
+        out += '\n';
+    }
+
+    // recurse into children
+    for (ItemHandle child = tree.first_child(item); child; child = tree.next_sibling(child)) {
+        append_scene_tree_item_text(tree, child, depth + 1, out);
+    }
+}
+
+std::string scene_tree_text(const TreeView& tree) {
+    PEEK_TRACE_SCOPE("scene_tree_text");
+    std::string result;
+    ItemHandle root = tree.root();
+    if (root) {
+        append_scene_tree_item_text(tree, root, 0, result);
+    }
+    return result;
+}
+
+json monitors_json(const TreeView& tree) {
+    PEEK_TRACE_SCOPE("monitors_json");
+    json monitors = json::array();
+    ItemHandle root = tree.root();
+    if (!root) {
+        return monitors;
+    }
+
+    // monitors tree structure: root -> groups (Time, Memory, etc) -> metrics
+    // each metric has name in col 0, value in col 1
+    for (ItemHandle group = tree.first_child(root); group; group = tree.next_sibling(group)) {
+        json metrics = json::array();
+        for (ItemHandle metric = tree.first_child(group); metric; metric = tree.next_sibling(metric)) {
+            metrics.push_back({
+                {"name", tree.text(metric, 0)},
+                {"value", tree.text(metric, 1)}
+            });
+        }
+
+        monitors.push_back({
+            {"group", tree.text(group, 0)},
+            {"metrics", metrics}
+        });
+    }
+    return monitors;
+}
+
+ItemHandle find_item_by_path(const TreeView& tree, ItemHandle root, const std::vector<std::string>& path_parts) {
+    if (path_parts.empty()) {
+        return root;
+    }
+
+    ItemHandle current = root;
+    size_t start_idx = 0;
+
+    // if first part matches root's text, skip it
+    if (path_parts[0] == tree.text(root, 0)) {
+        start_idx = 1;
+    }
+
+    // navigate through remaining parts
+    for (size_t i = start_idx; i < path_parts.size(); i++) {
+        ItemHandle found = nullptr;
+        for (ItemHandle child = tree.first_child(current); child; child = tree.next_sibling(child)) {
+            if (path_parts[i] == tree.text(child, 0)) {
+                found = child;
+                break;
+            }
+        }
+        if (!found) {
+            return nullptr;
+        }
+        current = found;
+    }
+
+    return current;
+}
+
+// --- inspector properties ---
+
+// helper: recursively collect all descendants matching a class name (preorder)
+static void find_children_by_class(const NodeView& view, NodeHandle root, const char* class_name,
+                                   std::vector<NodeHandle>& results) {
+    int child_count = view.child_count(root);
+    for (int i = 0; i < child_count; i++) {
+        NodeHandle child = view.child(root, i);
+        if (view.is_class(child, class_name)) {
+            results.push_back(child);
+        }
+        // recurse into children
+        find_children_by_class(view, child, class_name, results);
+    }
+}
+
+// helper: first descendant matching a class name in the same preorder as
+// find_children_by_class, without walking the rest of the subtree
+static NodeHandle find_first_by_class(const NodeView& view, NodeHandle root, const char* class_name) {
+    int child_count = view.child_count(root);
+    for (int i = 0; i < child_count; i++) {
+        NodeHandle child = view.child(root, i);
+        if (view.is_class(child, class_name)) {
+            return child;
+        }
+        NodeHandle nested = find_first_by_class(view, child, class_name);
+        if (nested) {
+            return nested;
+        }
+    }
+    return nullptr;
+}
+
+std::string extract_property_value(const NodeView& view, NodeHandle node, const std::string& cls) {
+    // EditorPropertyNil
+    if (cls == "EditorPropertyNil") {
+        return "null";
+    }
+
+    // EditorPropertyInteger, EditorPropertyFloat -> find EditorSpinSlider
+    if (cls == "EditorPropertyInteger" || cls == "EditorPropertyFloat") {
+        NodeHandle slider = find_first_by_class(view, node, "EditorSpinSlider");
+        std::string value;
+        if (slider && view.value_text(slider, value)) {
+            return value;
+        }
+    }
+
+    // EditorPropertyText -> find LineEdit
+    if (cls == "EditorPropertyText") {
+        NodeHandle edit = find_first_by_class(view, node, "LineEdit");
+        if (edit) {
+            return view.text(edit);
+        }
+    }
+
+    // EditorPropertyCheck -> find CheckBox
+    if (cls == "EditorPropertyCheck") {
+        NodeHandle box = find_first_by_class(view, node, "CheckBox");
+        if (box) {
+            return view.is_pressed(box) ? "true" : "false";
+        }
+    }
+
+    // EditorPropertyVector2/3/4 -> find multiple EditorSpinSliders
+    if (cls.find("EditorPropertyVector") == 0) {
+        std::vector<NodeHandle> sliders;
+        find_children_by_class(view, node, "EditorSpinSlider", sliders);
+        if (!sliders.empty()) {
+            std::string result = "(";
+            for (size_t i = 0; i < sliders.size(); i++) {
+                if (i > 0) result += ", ";
+                std::string value;
+                if (view.value_text(sliders[i], value)) {
+                    result += value;
+                }
+            }
+            result += ")";
+            return result;
+        }
+    }
+
+    // EditorPropertyObjectID, EditorPropertyArray -> find Button text
+    if (cls == "EditorPropertyObjectID" || cls == "EditorPropertyArray") {
+        NodeHandle button = find_first_by_class(view, node, "Button");
+        if (button) {
+            return view.text(button);
+        }
+    }
+
+    // fallback: try to find LineEdit, then Button
+    NodeHandle edit = find_first_by_class(view, node, "LineEdit");
+    if (edit) {
+        return view.text(edit);
+    }
+
+    NodeHandle button = find_first_by_class(view, node, "Button");
+    if (button) {
+        return view.text(button);
+    }
+
+    return "";
+}
+
+void collect_editor_properties(const NodeView& view, NodeHandle node, json& properties) {
+    std::string cls = view.class_name(node);
+
+    // check if this is an EditorProperty* subclass
+    if (cls.rfind("EditorProperty", 0) == 0) {
+        // try to get label via get_label() method (EditorProperty has this)
+        std::string prop_name = view.property_label(node);
+
+        // fallback: look for Label child with property name
+        if (prop_name.empty()) {
+            std::vector<NodeHandle> labels;
+            find_children_by_class(view, node, "Label", labels);
+            for (NodeHandle label : labels) {
+                prop_name = view.text(label);
+                if (!prop_name.empty()) {
+                    break;
+                }
+            }
+        }
+
+        // extract value based on type
+        std::string prop_value = extract_property_value(view, node, cls);
+
+        if (!prop_name.empty()) {
+            properties.push_back({
+                {"name", prop_name},
+                {"value", prop_value},
+                {"type", cls}
+            });
+        }
+    }
+
+    // recurse into children
+    int count = view.child_count(node);
+    for (int i = 0; i < count; i++) {
+        collect_editor_properties(view, view.child(node, i), properties);
+    }
+}
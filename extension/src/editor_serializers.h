@@ -0,0 +1,36 @@
+#pragma once
+
+#include "editor_views.h"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+#include <vector>
+
+// text/JSON extraction from editor widgets, written against the views in
+// editor_views.h so it runs (and is benchmarked) without the editor
+
+// indented multi-column text of a whole Tree (debugger errors, stack frames).
+// each item is "  col0 | col1 | ..." with empty columns skipped
+std::string tree_text(const TreeView& tree);
+
+// append one item and its descendants to out at the given depth
+void append_tree_item_text(const TreeView& tree, ItemHandle item, int depth, std::string& out);
+
+// remote scene tree as "  NodeName (Type)" lines, type parsed from the tooltip
+std::string scene_tree_text(const TreeView& tree);
+
+// monitors tree (root -> groups -> name/value metrics) as a JSON array of
+// {"group": ..., "metrics": [{"name": ..., "value": ...}]}
+nlohmann::json monitors_json(const TreeView& tree);
+
+// walk path_parts (from split_node_path) down from root by column-0 text.
+// a leading part matching the root's own text is skipped. nullptr if not found
+ItemHandle find_item_by_path(const TreeView& tree, ItemHandle root, const std::vector<std::string>& path_parts);
+
+// recursively collect EditorProperty* nodes under node as
+// {"name": ..., "value": ..., "type": ...} objects
+void collect_editor_properties(const NodeView& view, NodeHandle node, nlohmann::json& properties);
+
+// value shown by one EditorProperty* node, based on its class
+std::string extract_property_value(const NodeView& view, NodeHandle node, const std::string& cls);
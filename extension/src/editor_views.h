@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+// minimal read-only views over the editor widgets the handlers scrape
+// (no godot dependency). the editor implementations live in godot_views.h;
+// tests and benchmarks use the mock in tests/mock_editor.h.
+//
+// items and nodes are opaque handles (TreeItem* / Node* in the editor) so
+// walking a tree never allocates per-item wrapper objects.
+
+using ItemHandle = void*;
+using NodeHandle = void*;
+
+// a godot Tree: items with per-column text and tooltips
+class TreeView {
+public:
+    virtual ~TreeView() = default;
+
+    virtual ItemHandle root() const = 0;
+    virtual ItemHandle first_child(ItemHandle item) const = 0;
+    virtual ItemHandle next_sibling(ItemHandle item) const = 0;
+    virtual int column_count() const = 0;
+
+    // column text / tooltip as UTF-8 ("" if empty)
+    virtual std::string text(ItemHandle item, int column) const = 0;
+    virtual std::string tooltip(ItemHandle item, int column) const = 0;
+};
+
+// a subtree of editor controls (inspector, EditorProperty widgets)
+class NodeView {
+public:
+    virtual ~NodeView() = default;
+
+    virtual std::string class_name(NodeHandle node) const = 0;
+    // exact class or any base class, like Object::is_class()
+    virtual bool is_class(NodeHandle node, const char* class_name) const = 0;
+    virtual int child_count(NodeHandle node) const = 0;
+    virtual NodeHandle child(NodeHandle node, int index) const = 0;
+
+    // EditorProperty::get_label(), "" if the node has no label method
+    virtual std::string property_label(NodeHandle node) const = 0;
+
+    // display text of a LineEdit, Button or Label node ("" otherwise)
+    virtual std::string text(NodeHandle node) const = 0;
+
+    // get_value() of a range control (EditorSpinSlider) formatted like
+    // String(Variant). returns false if the node has no get_value
+    virtual bool value_text(NodeHandle node, std::string& out) const = 0;
+
+    // pressed state of a toggle button (CheckBox)
+    virtual bool is_pressed(NodeHandle node) const = 0;
+};
@@ -0,0 +1,169 @@
+#include "frame_codec.h"
+#include "json_rpc.h"
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+void append_frame(std::string& out, uint8_t content_type, uint8_t flags, const char* data, size_t len) {
+    char header[FRAME_HEADER_SIZE] = {
+        static_cast<char>((len >> 24) & 0xff),
+        static_cast<char>((len >> 16) & 0xff),
+        static_cast<char>((len >> 8) & 0xff),
+        static_cast<char>(len & 0xff),
+        static_cast<char>(content_type),
+        static_cast<char>(flags),
+        0, 0
+    };
+    out.reserve(out.size() + FRAME_HEADER_SIZE + len);
+    out.append(header, FRAME_HEADER_SIZE);
+    out.append(data, len);
+}
+
+void FrameDecoder::append(const char* data, size_t len) {
+    if (error || len == 0) {
+        return;
+    }
+    // same lazy compaction as LineFramer: only move bytes once the consumed
+    // prefix outweighs what is left
+    if (consumed > 0 && consumed >= buffer.size() - consumed) {
+        buffer.erase(0, consumed);
+        consumed = 0;
+    }
+    buffer.append(data, len);
+}
+
+bool FrameDecoder::next(Frame& frame) {
+    if (error || buffer.size() - consumed < FRAME_HEADER_SIZE) {
+        return false;
+    }
+
+    const unsigned char* h = reinterpret_cast<const unsigned char*>(buffer.data() + consumed);
+    size_t len = (static_cast<size_t>(h[0]) << 24) | (static_cast<size_t>(h[1]) << 16) |
+                 (static_cast<size_t>(h[2]) << 8) | static_cast<size_t>(h[3]);
+    if (len > max_frame || h[6] != 0 || h[7] != 0) {
+        error = true;
+        buffer.clear();
+        consumed = 0;
+        return false;
+    }
+    if (buffer.size() - consumed - FRAME_HEADER_SIZE < len) {
+        return false;  // payload still arriving
+    }
+
+    frame.content_type = h[4];
+    frame.flags = h[5];
+    frame.payload.assign(buffer, consumed + FRAME_HEADER_SIZE, len);
+    consumed += FRAME_HEADER_SIZE + len;
+
+    if (consumed == buffer.size()) {
+        buffer.clear();
+        consumed = 0;
+    }
+    return true;
+}
+
+bool parse_handshake(const std::string& line, Handshake& hs) {
+    // cheap reject before parsing: ordinary requests never mention negotiate
+    if (line.find("\"negotiate\"") == std::string::npos) {
+        return false;
+    }
+
+    json parsed = json::parse(line, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object() ||
+        !parsed.contains("method") || parsed["method"] != "negotiate") {
+        return false;
+    }
+
+    hs.id = 0;
+    if (parsed.contains("id") && parsed["id"].is_number_integer()) {
+        hs.id = parsed["id"].get<int64_t>();
+    }
+    hs.framing = "newline";
+    hs.encoding = "json";
+    hs.compression = "none";
+    hs.compress_threshold = DEFAULT_COMPRESS_THRESHOLD;
+    if (parsed.contains("params") && parsed["params"].is_object()) {
+        const json& params = parsed["params"];
+        if (params.contains("framing") && params["framing"].is_string()) {
+            hs.framing = params["framing"].get<std::string>();
+        }
+        if (params.contains("encoding") && params["encoding"].is_string()) {
+            hs.encoding = params["encoding"].get<std::string>();
+        }
+        if (params.contains("compression") && params["compression"].is_string()) {
+            hs.compression = params["compression"].get<std::string>();
+        }
+        if (params.contains("compress_threshold") && params["compress_threshold"].is_number_integer()) {
+            hs.compress_threshold = params["compress_threshold"].get<int64_t>();
+        }
+    }
+    return true;
+}
+
+bool encoding_from_name(const std::string& name, uint8_t& content_type) {
+    if (name == "json") {
+        content_type = CONTENT_JSON;
+    } else if (name == "msgpack") {
+        content_type = CONTENT_MSGPACK;
+    } else if (name == "cbor") {
+        content_type = CONTENT_CBOR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* encoding_name(uint8_t content_type) {
+    switch (content_type) {
+        case CONTENT_MSGPACK: return "msgpack";
+        case CONTENT_CBOR: return "cbor";
+        default: return "json";
+    }
+}
+
+std::string handshake_response(const Handshake& hs, Negotiated& negotiated) {
+    negotiated = Negotiated();
+    if (hs.framing != "newline" && hs.framing != "binary") {
+        return make_error(hs.id, -32602, "Unsupported framing: " + hs.framing + " (expected: newline, binary)");
+    }
+
+    uint8_t encoding = CONTENT_JSON;
+    if (!encoding_from_name(hs.encoding, encoding)) {
+        return make_error(hs.id, -32602, "Unsupported encoding: " + hs.encoding + " (expected: json, msgpack, cbor)");
+    }
+    if (encoding != CONTENT_JSON && hs.framing != "binary") {
+        // binary encodings can contain newlines, so they need frames
+        return make_error(hs.id, -32602, "Encoding " + hs.encoding + " requires binary framing");
+    }
+
+    if (hs.compression != "none" && hs.compression != "deflate") {
+        return make_error(hs.id, -32602, "Unsupported compression: " + hs.compression + " (expected: none, deflate)");
+    }
+    if (hs.compression != "none" && hs.framing != "binary") {
+        // the compressed flag lives in the frame header
+        return make_error(hs.id, -32602, "Compression " + hs.compression + " requires binary framing");
+    }
+    if (hs.compress_threshold < 0) {
+        return make_error(hs.id, -32602, "compress_threshold must be >= 0");
+    }
+
+    negotiated.binary = hs.framing == "binary";
+    negotiated.encoding = encoding;
+    negotiated.deflate = hs.compression == "deflate";
+    negotiated.compress_threshold = static_cast<size_t>(hs.compress_threshold);
+    json result = {
+        {"framing", hs.framing},
+        {"encoding", hs.encoding},
+        {"compression", hs.compression},
+        {"compress_threshold", hs.compress_threshold},
+        {"content_types", {
+            {"json", CONTENT_JSON},
+            {"binary", CONTENT_BINARY},
+            {"msgpack", CONTENT_MSGPACK},
+            {"cbor", CONTENT_CBOR}
+        }},
+        {"max_frame", FrameDecoder::DEFAULT_MAX_FRAME}
+    };
+    return make_result(hs.id, result.dump());
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// length-prefixed framing, the opt-in alternative to newline-delimited JSON
+// (no godot dependency).
+//
+// a client switches by sending a handshake as its first line:
+//   {"id":1,"method":"negotiate","params":{"framing":"binary","encoding":"msgpack"}}\n
+// the reply is still a newline-terminated JSON line; once it reports
+// "framing":"binary" every later byte in both directions is a frame:
+//   u32 payload length (big endian) | u8 content type | u8 flags | u16 reserved (0) | payload
+// newline framing stays the default for clients that never negotiate.
+// requests are always JSON; "encoding" (json, msgpack or cbor, binary
+// framing only) picks how responses are encoded, and "compression":"deflate"
+// (binary framing only) deflates response frames of at least
+// "compress_threshold" bytes, marking them with FRAME_FLAG_DEFLATE.
+
+constexpr size_t FRAME_HEADER_SIZE = 8;
+
+// content types
+constexpr uint8_t CONTENT_JSON = 1;     // a JSON-RPC request or response
+constexpr uint8_t CONTENT_BINARY = 2;   // raw bytes attached to the preceding response
+constexpr uint8_t CONTENT_MSGPACK = 3;  // a response encoded as MessagePack
+constexpr uint8_t CONTENT_CBOR = 4;     // a response encoded as CBOR
+
+// flags
+constexpr uint8_t FRAME_FLAG_MORE = 0x01;     // another frame of the same reply follows
+constexpr uint8_t FRAME_FLAG_DEFLATE = 0x02;  // payload is zlib-format deflate (compression.h)
+
+// response payloads below this many bytes are never compressed by default
+constexpr size_t DEFAULT_COMPRESS_THRESHOLD = 64 * 1024;
+
+struct Frame {
+    uint8_t content_type = CONTENT_JSON;
+    uint8_t flags = 0;
+    std::string payload;
+};
+
+// append one encoded frame to out
+void append_frame(std::string& out, uint8_t content_type, uint8_t flags, const char* data, size_t len);
+
+inline void append_frame(std::string& out, uint8_t content_type, uint8_t flags, const std::string& payload) {
+    append_frame(out, content_type, flags, payload.data(), payload.size());
+}
+
+// incremental frame decoder for one connection. bytes are appended as they
+// arrive and complete frames pulled out one at a time
+class FrameDecoder {
+public:
+    static constexpr size_t DEFAULT_MAX_FRAME = 64u << 20;
+
+    explicit FrameDecoder(size_t max_frame = DEFAULT_MAX_FRAME) : max_frame(max_frame) {}
+
+    void append(const char* data, size_t len);
+
+    // pop the next complete frame. returns false once none is buffered
+    bool next(Frame& frame);
+
+    // true once a header announced a frame over max_frame or used nonzero
+    // reserved bytes; the caller should drop the connection
+    bool failed() const { return error; }
+
+    size_t buffered() const { return buffer.size() - consumed; }
+
+private:
+    std::string buffer;
+    size_t consumed = 0;
+    size_t max_frame;
+    bool error = false;
+};
+
+// --- handshake ---
+
+struct Handshake {
+    int64_t id = 0;
+    std::string framing;   // requested framing ("newline" or "binary")
+    std::string encoding;  // requested response encoding ("json", "msgpack", "cbor")
+    std::string compression = "none";  // requested response compression ("none", "deflate")
+    int64_t compress_threshold = DEFAULT_COMPRESS_THRESHOLD;
+};
+
+// the outcome of a handshake, applied to the connection after the reply
+struct Negotiated {
+    bool binary = false;
+    uint8_t encoding = CONTENT_JSON;
+    bool deflate = false;
+    size_t compress_threshold = DEFAULT_COMPRESS_THRESHOLD;
+};
+
+// content type for an encoding name. false if unknown
+bool encoding_from_name(const std::string& name, uint8_t& content_type);
+
+// name of a response content type ("json", "msgpack", "cbor")
+const char* encoding_name(uint8_t content_type);
+
+// true if line is a negotiate request (the only message the transport
+// interprets itself). fills hs from it
+bool parse_handshake(const std::string& line, Handshake& hs);
+
+// the JSON-RPC reply to a handshake, plus the settings the connection
+// switches to after sending it (unchanged defaults on error)
+std::string handshake_response(const Handshake& hs, Negotiated& negotiated);
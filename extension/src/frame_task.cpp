@@ -0,0 +1,123 @@
+#include "frame_task.h"
+
+#include <chrono>
+#include <utility>
+
+// helper: monotonic milliseconds
+static uint64_t steady_ms() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+RpcTask& RpcTask::operator=(RpcTask&& other) noexcept {
+    if (this != &other) {
+        RpcTask dying(std::move(*this));
+        handle = other.handle;
+        other.handle = nullptr;
+    }
+    return *this;
+}
+
+RpcTask::~RpcTask() {
+    if (!handle) {
+        return;
+    }
+    if (FrameScheduler* scheduler = handle.promise().parked_in) {
+        scheduler->forget(handle);
+    }
+    handle.destroy();
+}
+
+FrameScheduler::FrameScheduler() : now(steady_ms()) {}
+
+FrameScheduler::~FrameScheduler() {
+    // the tasks own the frames; just stop them pointing back here
+    for (Parked& p : waiting) {
+        p.handle.promise().parked_in = nullptr;
+    }
+}
+
+void FrameScheduler::NextFrame::await_suspend(RpcTask::Handle h) {
+    Parked p;
+    p.handle = h;
+    scheduler.park(std::move(p));
+}
+
+void FrameScheduler::Sleep::await_suspend(RpcTask::Handle h) {
+    Parked p;
+    p.handle = h;
+    p.deadline = scheduler.now + ms;
+    scheduler.park(std::move(p));
+}
+
+void FrameScheduler::Until::await_suspend(RpcTask::Handle h) {
+    Parked p;
+    p.handle = h;
+    p.deadline = timeout_ms ? scheduler.now + timeout_ms : 0;
+    p.pred = pred;
+    p.result = &satisfied;
+    scheduler.park(std::move(p));
+}
+
+FrameScheduler::Until FrameScheduler::until(std::function<bool()> pred, uint32_t timeout_ms) {
+    return Until{*this, std::move(pred), timeout_ms};
+}
+
+FrameScheduler::Until FrameScheduler::signal(const FrameSignal& event, uint32_t timeout_ms) {
+    // only fires after the co_await count, not ones that happened earlier
+    uint64_t seen = event.count();
+    return Until{*this, [&event, seen] { return event.count() > seen; }, timeout_ms};
+}
+
+void FrameScheduler::park(Parked p) {
+    p.frame = frames;
+    p.handle.promise().parked_in = this;
+    waiting.push_back(std::move(p));
+}
+
+void FrameScheduler::forget(RpcTask::Handle h) {
+    for (size_t i = 0; i < waiting.size(); i++) {
+        if (waiting[i].handle == h) {
+            waiting.erase(waiting.begin() + static_cast<std::ptrdiff_t>(i));
+            return;
+        }
+    }
+}
+
+void FrameScheduler::tick() {
+    tick(steady_ms());
+}
+
+void FrameScheduler::tick(uint64_t now_ms) {
+    now = now_ms;
+    frames++;
+
+    // pick out everything that is due before resuming anything: resumed
+    // coroutines park again (or finish and get destroyed) as they run
+    std::vector<Parked> due;
+    for (size_t i = 0; i < waiting.size();) {
+        Parked& p = waiting[i];
+        bool timed_out = p.deadline && now >= p.deadline;
+        bool ready;
+        if (p.pred) {
+            ready = p.pred();
+            *p.result = ready;
+            ready = ready || timed_out;
+        } else if (p.deadline) {
+            ready = timed_out;
+        } else {
+            ready = p.frame < frames;
+        }
+        if (ready) {
+            due.push_back(std::move(p));
+            waiting.erase(waiting.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            i++;
+        }
+    }
+
+    for (Parked& p : due) {
+        p.handle.promise().parked_in = nullptr;
+        p.handle.resume();
+    }
+}
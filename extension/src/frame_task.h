@@ -0,0 +1,156 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+// handlers that span several editor frames (no godot dependency).
+//
+// a multi-frame handler is a c++20 coroutine returning RpcTask. it runs
+// synchronously until its first co_await, so a handler whose condition
+// already holds answers in the same frame. otherwise it is parked in a
+// FrameScheduler, which the plugin ticks from _process, and resumed once
+// what it waits for has happened, while the editor keeps running:
+//
+//     co_await frames.next_frame();                  // resume next frame
+//     co_await frames.timeout(300);                  // sleep 300ms
+//     bool ok = co_await frames.until(pred, 2000);   // poll pred each frame
+//     bool ok = co_await frames.signal(event, 2000); // wait for event.fire()
+//
+// coroutine frames outlive the call that started them: take parameters by
+// value, don't keep references into the request, and don't hold arena_json
+// (request_arena.h) across a co_await.
+
+// a one-shot notification godot-side code fires from a signal callback.
+// waiters resume on the next tick after a fire that happened while they
+// waited. must outlive its waiters
+class FrameSignal {
+public:
+    void fire() { fired++; }
+    uint64_t count() const { return fired; }
+
+private:
+    uint64_t fired = 0;
+};
+
+class FrameScheduler;
+
+// the coroutine type of a multi-frame handler. co_return the full response
+// (as a regular handler would return it). the task owns the coroutine frame;
+// destroying an unfinished task abandons the handler
+class RpcTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        std::string response;
+        FrameScheduler* parked_in = nullptr;  // while waiting in a scheduler
+
+        RpcTask get_return_object() {
+            return RpcTask(Handle::from_promise(*this));
+        }
+        // run eagerly up to the first co_await
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        // keep the frame so the response can be read out
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(std::string r) { response = std::move(r); }
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    RpcTask() = default;
+    RpcTask(RpcTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    RpcTask& operator=(RpcTask&& other) noexcept;
+    RpcTask(const RpcTask&) = delete;
+    RpcTask& operator=(const RpcTask&) = delete;
+    ~RpcTask();
+
+    bool valid() const { return static_cast<bool>(handle); }
+    bool done() const { return !handle || handle.done(); }
+
+    // the co_returned response, once done
+    std::string take_response() { return handle ? std::move(handle.promise().response) : std::string(); }
+
+private:
+    explicit RpcTask(Handle h) : handle(h) {}
+
+    Handle handle;
+};
+
+class FrameScheduler {
+public:
+    FrameScheduler();
+    ~FrameScheduler();
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    // awaitables. timeouts are in milliseconds, measured from the last tick;
+    // 0 means wait forever
+    struct NextFrame {
+        FrameScheduler& scheduler;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(RpcTask::Handle h);
+        void await_resume() const noexcept {}
+    };
+
+    struct Sleep {
+        FrameScheduler& scheduler;
+        uint32_t ms;
+        bool await_ready() const noexcept { return ms == 0; }
+        void await_suspend(RpcTask::Handle h);
+        void await_resume() const noexcept {}
+    };
+
+    // resumes with true once pred holds, false on timeout
+    struct Until {
+        FrameScheduler& scheduler;
+        std::function<bool()> pred;
+        uint32_t timeout_ms;
+        bool satisfied = false;
+        bool await_ready() { return satisfied = pred(); }
+        void await_suspend(RpcTask::Handle h);
+        bool await_resume() const noexcept { return satisfied; }
+    };
+
+    NextFrame next_frame() { return NextFrame{*this}; }
+    Sleep timeout(uint32_t ms) { return Sleep{*this, ms}; }
+    Until until(std::function<bool()> pred, uint32_t timeout_ms = 0);
+    Until signal(const FrameSignal& event, uint32_t timeout_ms = 0);
+
+    // resume every parked coroutine whose wait is over. call once per frame
+    void tick();
+    void tick(uint64_t now_ms);  // explicit clock, for tests
+
+    // clock reading of the last tick (or construction)
+    uint64_t now_ms() const { return now; }
+
+    // ticks so far
+    uint64_t frame() const { return frames; }
+
+    // coroutines currently waiting
+    size_t parked() const { return waiting.size(); }
+
+private:
+    struct Parked {
+        RpcTask::Handle handle;
+        uint64_t frame = 0;             // tick count when parked
+        uint64_t deadline = 0;          // clock ms, 0 = none
+        std::function<bool()> pred;     // empty for next_frame / sleep
+        bool* result = nullptr;         // Until::satisfied
+    };
+
+    friend class RpcTask;
+
+    void park(Parked p);
+
+    // an unfinished task is being destroyed: never resume it
+    void forget(RpcTask::Handle h);
+
+    std::vector<Parked> waiting;
+    uint64_t now = 0;
+    uint64_t frames = 0;
+};
@@ -3,16 +3,39 @@
 #include "message_handler.h"
 #include "editor_control_finder.h"
 #include "debugger_plugin.h"
+#include "server_stats.h"
+#include "instance_registry.h"
+#include "runtime_commands.h"
+#include "output_archive.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/editor_interface.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/tree.hpp>
+#include <godot_cpp/classes/tree_item.hpp>
 
 #include <string>
+#include <cstdlib>
+#include <ctime>
 
 using namespace godot;
 
+// absolute project directory without the trailing slash ("" outside a project)
+static std::string get_project_path() {
+    ProjectSettings* ps = ProjectSettings::get_singleton();
+    if (!ps) {
+        return std::string();
+    }
+    std::string path = ps->globalize_path("res://").utf8().get_data();
+    while (path.size() > 1 && path.back() == '/') {
+        path.pop_back();
+    }
+    return path;
+}
+
 // derive a project-specific socket path from the godot project directory name.
 // eg project at /home/user/Code/my-game -> /tmp/godot-peek-my-game.sock
 // sanitizes to lowercase alphanumeric + dash to avoid path issues.
@@ -60,15 +83,52 @@ static std::string get_project_socket_path() {
     return "/tmp/godot-peek-" + sanitized + ".sock";
 }
 
+// GODOT_PEEK_IO_URING=1 opts into the io_uring socket backend (linux only;
+// SocketServer falls back to poll if the kernel can't do it)
+static IoBackend requested_io_backend() {
+    const char* env = std::getenv("GODOT_PEEK_IO_URING");
+    return env && std::string(env) == "1" ? IoBackend::io_uring : IoBackend::poll;
+}
+
+// GODOT_PEEK_WAKE=1 opts into the short idle sleep while clients are
+// connected (see settle_sleep)
+static bool wake_enabled() {
+    const char* env = std::getenv("GODOT_PEEK_WAKE");
+    return env && std::string(env) == "1";
+}
+
+// the output archive (output_archive.h) keeps this many MiB by default.
+// GODOT_PEEK_ARCHIVE_MB=<n> changes the cap, and 0 turns the archive off.
+// each capture reads the whole panel back (RichTextLabel has no way to read
+// only the newest paragraphs); the output governor keeps that bounded
+static constexpr uint64_t ARCHIVE_DEFAULT_MB = 64;
+
+static uint64_t archive_max_bytes() {
+    const char* env = std::getenv("GODOT_PEEK_ARCHIVE_MB");
+    if (!env || !*env) {
+        return ARCHIVE_DEFAULT_MB << 20;
+    }
+    return std::strtoull(env, nullptr, 10) << 20;
+}
+
+// with GODOT_PEEK_WAKE=1, the editor's low-processor sleep while a client
+// is connected
+static constexpr int64_t WAKE_SLEEP_USEC = 2000;
+
+// how often a running session's error count is compared (debugger_changed)
+static constexpr uint64_t ERRORS_POLL_MS = 100;
+
 void GodotPeekPlugin::_bind_methods() {
     // bind methods/signals here later
 }
 
 GodotPeekPlugin::GodotPeekPlugin() {
     // create instances - they're not started yet
-    socket_server = std::make_unique<SocketServer>();
+    socket_server = std::make_unique<SocketServer>(requested_io_backend());
     message_handler = std::make_unique<MessageHandler>();
     control_finder = std::make_unique<EditorControlFinder>();
+    server_stats = std::make_unique<ServerStats>();
+    instance_registry = std::make_unique<InstanceRegistry>();
 
     // create debugger plugin (Ref<> handles reference counting)
     debugger_plugin.instantiate();
@@ -79,6 +139,19 @@ GodotPeekPlugin::GodotPeekPlugin() {
     // wire up the debugger plugin so message handler can control debugging
     message_handler->set_debugger_plugin(debugger_plugin.ptr());
 
+    // both layers record into the same stats (read back via get_server_stats)
+    socket_server->set_stats(server_stats.get());
+    message_handler->set_server_stats(server_stats.get());
+
+    // requests run by priority lane each frame (request_lanes.h)
+    socket_server->set_lane_classifier([this](const std::string& message) {
+        return message_handler->lane_of(message);
+    });
+
+    // an unfocused editor sleeps ~100ms between frames, which requests wait
+    // out. shortening that sleep costs idle CPU, so it's opt-in
+    boost_sleep = wake_enabled();
+
     // set up callback for auto-stop scheduling
     message_handler->set_scene_launch_callback([this](double timeout) {
         if (timeout > 0.0) {
@@ -99,7 +172,10 @@ GodotPeekPlugin::~GodotPeekPlugin() {
 }
 
 void GodotPeekPlugin::_enter_tree() {
-    socket_path = get_project_socket_path();
+    // the dirname-derived path, unless a live editor for another project
+    // with the same directory name already holds it
+    std::string project_path = get_project_path();
+    socket_path = choose_socket_path(instance_registry->list(), project_path, get_project_socket_path());
 
     UtilityFunctions::print("GodotPeekPlugin: starting socket server...");
 
@@ -107,11 +183,45 @@ void GodotPeekPlugin::_enter_tree() {
     // editor process when we're a game child process) is already listening,
     // it returns false without touching the socket file.
     if (socket_server->start(socket_path)) {
-        UtilityFunctions::print("GodotPeekPlugin: listening on ", socket_path.c_str());
+        UtilityFunctions::print("GodotPeekPlugin: listening on ", socket_path.c_str(),
+                                socket_server->backend() == IoBackend::io_uring ? " (io_uring)" : "");
+
+        // advertise ourselves so clients can find and pick between editors
+        InstanceInfo info;
+        info.pid = OS::get_singleton()->get_process_id();
+        info.project_path = project_path;
+        info.project_hash = project_path_hash(project_path);
+        info.socket_path = socket_path;
+        String version = Engine::get_singleton()->get_version_info()["string"];
+        info.godot_version = version.utf8().get_data();
+        info.started_at = static_cast<int64_t>(std::time(nullptr));
+        registered = instance_registry->add(info);
+
+        // games launched from here inherit the environment: tell their
+        // GodotPeekRuntime where to serve the framed transport
+        OS::get_singleton()->set_environment(GAME_SOCKET_ENV, String::utf8(game_socket_path(socket_path).c_str()));
+        if (!registered) {
+            UtilityFunctions::print("GodotPeekPlugin: could not write registry entry in ", instance_registry->directory().c_str());
+        }
     } else {
         UtilityFunctions::print("GodotPeekPlugin: socket server not started (another instance owns ", socket_path.c_str(), ")");
     }
 
+    // output is archived per session: this one covers the editor until the
+    // first game launch, and every launch starts another
+    uint64_t archive_bytes = archive_max_bytes();
+    if (archive_bytes > 0) {
+        output_archive = std::make_unique<OutputArchive>(default_archive_dir(project_path_hash(project_path)),
+                                                         archive_bytes);
+        message_handler->set_output_archive(output_archive.get());
+        if (!message_handler->begin_output_session()) {
+            UtilityFunctions::print("GodotPeekPlugin: could not write output archive in ",
+                                    output_archive->directory().c_str());
+            message_handler->set_output_archive(nullptr);
+            output_archive.reset();
+        }
+    }
+
     // register debugger plugin so we can control breakpoints and stepping
     if (debugger_plugin.is_valid()) {
         add_debugger_plugin(debugger_plugin);
@@ -129,6 +239,18 @@ void GodotPeekPlugin::_exit_tree() {
 
     // stop() only unlinks the socket file if we own it (owns_socket flag)
     socket_server->stop();
+    restore_sleep();
+
+    if (registered) {
+        instance_registry->remove(OS::get_singleton()->get_process_id());
+        registered = false;
+    }
+
+    if (output_archive) {
+        message_handler->archive_output(true);
+        message_handler->set_output_archive(nullptr);
+        output_archive.reset();
+    }
 }
 
 void GodotPeekPlugin::_process(double delta) {
@@ -145,13 +267,102 @@ void GodotPeekPlugin::_process(double delta) {
         }
     }
 
+    // cached read results (response_cache.h) only hold while the debugger
+    // state is still: bump the revision on every transition, debugger
+    // session event and new error. what the running game changes otherwise
+    // (the remote tree) is covered by the cache's max age
+    EditorInterface* editor = EditorInterface::get_singleton();
+    bool playing = editor && editor->is_playing_scene();
+    bool paused = debugger_plugin.is_valid() && debugger_plugin->is_paused();
+    bool session = debugger_plugin.is_valid() && debugger_plugin->is_session_active();
+    if (playing != was_playing || paused != was_paused || session != was_session_active || debugger_changed()) {
+        message_handler->invalidate_cache();
+    }
+    if (output_archive && playing && !was_playing) {
+        message_handler->begin_output_session();
+    }
+    message_handler->archive_output();
+    was_playing = playing;
+    was_paused = paused;
+    was_session_active = session;
+
+    // resume handlers waiting on earlier frames first, so their responses
+    // go out in this poll
+    message_handler->process_frame();
+
     // poll the socket for incoming messages each frame
     // the callback routes messages through our handler
     if (socket_server && socket_server->is_running()) {
-        socket_server->poll([this](const std::string& message) -> std::string {
-            return message_handler->handle(message);
+        socket_server->poll([this](const std::string& message, RpcContext& ctx) -> std::string {
+            return message_handler->handle(message, &ctx);
         });
     }
+
+    // after the poll, so a client accepted in it gets a short sleep already
+    settle_sleep();
+}
+
+bool GodotPeekPlugin::debugger_changed() {
+    bool changed = false;
+    if (debugger_plugin.is_valid()) {
+        uint64_t events = debugger_plugin->state_signal().count();
+        changed = events != seen_debugger_events;
+        seen_debugger_events = events;
+    }
+
+    // errors arrive without a session event: watch the Errors tab's item
+    // count, every ERRORS_POLL_MS while a session is up (the lookup walks
+    // the editor UI until the tree is found)
+    if (!debugger_plugin.is_valid() || !debugger_plugin->is_session_active()) {
+        return changed;
+    }
+    uint64_t now_ms = stats_now_ns() / 1000000;
+    if (now_ms - last_errors_poll_ms < ERRORS_POLL_MS) {
+        return changed;
+    }
+    last_errors_poll_ms = now_ms;
+    Tree* errors = control_finder->get_errors_tree();
+    TreeItem* root = errors ? errors->get_root() : nullptr;
+    int64_t count = root ? root->get_child_count() : 0;
+    if (count != seen_error_count) {
+        seen_error_count = count;
+        changed = true;
+    }
+    return changed;
+}
+
+// an unfocused editor sleeps between frames, and godot can't be woken from
+// a sleep early: OS::delay_usec restarts on EINTR, and a deferred call only
+// runs once the sleep is over. so with GODOT_PEEK_WAKE=1 the sleep is cut
+// to WAKE_SLEEP_USEC for as long as any client is connected, and the
+// editor's own value comes back when the last one disconnects. clients
+// such as the MCP server stay connected for the whole session, so the
+// editor runs ~500 frames a second while idle for as long as they do
+void GodotPeekPlugin::settle_sleep() {
+    if (!boost_sleep) {
+        return;
+    }
+    if (!socket_server->is_running() || socket_server->client_count() == 0) {
+        restore_sleep();
+        return;
+    }
+    OS* os = OS::get_singleton();
+    int64_t current = os->get_low_processor_usage_mode_sleep_usec();
+    if (current == WAKE_SLEEP_USEC || (!sleep_boosted && current < WAKE_SLEEP_USEC)) {
+        return;  // already boosted, or the user runs with a shorter sleep
+    }
+    // the first client, or the editor set its own value meanwhile (it does
+    // on focus changes): that's the one to restore
+    saved_sleep_usec = current;
+    sleep_boosted = true;
+    os->set_low_processor_usage_mode_sleep_usec(WAKE_SLEEP_USEC);
+}
+
+void GodotPeekPlugin::restore_sleep() {
+    if (sleep_boosted) {
+        OS::get_singleton()->set_low_processor_usage_mode_sleep_usec(saved_sleep_usec);
+        sleep_boosted = false;
+    }
 }
 
 GodotPeekDebuggerPlugin* GodotPeekPlugin::get_debugger_plugin() const {
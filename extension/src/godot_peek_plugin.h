@@ -3,12 +3,16 @@
 #include <godot_cpp/classes/editor_plugin.hpp>
 #include <godot_cpp/classes/ref.hpp>
 #include <memory>  // for std::unique_ptr
+#include <cstdint>
 #include <string>
 
 // forward declarations to avoid including full headers
 class SocketServer;
 class MessageHandler;
 class EditorControlFinder;
+class ServerStats;
+class InstanceRegistry;
+class OutputArchive;
 
 namespace godot {
 class GodotPeekDebuggerPlugin;
@@ -36,9 +40,13 @@ public:
 private:
     // unique_ptr handles cleanup automatically
     // we use pointers + forward declarations to keep the header lightweight
+    // server_stats is declared first so it outlives the server that records into it
+    std::unique_ptr<ServerStats> server_stats;
     std::unique_ptr<SocketServer> socket_server;
     std::unique_ptr<MessageHandler> message_handler;
     std::unique_ptr<EditorControlFinder> control_finder;
+    std::unique_ptr<InstanceRegistry> instance_registry;
+    std::unique_ptr<OutputArchive> output_archive;   // null when disabled
 
     // debugger plugin is a Ref<> because EditorDebuggerPlugin inherits RefCounted
     Ref<GodotPeekDebuggerPlugin> debugger_plugin;
@@ -47,8 +55,30 @@ private:
     double auto_stop_timeout = 0.0;   // seconds remaining, 0 = disabled
     bool auto_stop_active = false;
 
+    // debugger state seen last frame (response cache invalidation)
+    bool was_playing = false;
+    bool was_paused = false;
+    bool was_session_active = false;
+    uint64_t seen_debugger_events = 0;   // debugger plugin state_signal count
+    int64_t seen_error_count = -1;       // items in the Errors tab
+    uint64_t last_errors_poll_ms = 0;
+    // a session event fired or the error count moved since the last call
+    bool debugger_changed();
+
     // project-specific socket path (computed at enter_tree)
     std::string socket_path;
+
+    // true while our entry is in the discovery registry
+    bool registered = false;
+
+    // opt-in short idle sleep: _process cuts the editor's low-processor
+    // sleep while any client is connected and puts the editor's own value
+    // back after the last one leaves. main thread only
+    void settle_sleep();     // each frame, after the socket poll
+    void restore_sleep();
+    bool boost_sleep = false;        // GODOT_PEEK_WAKE=1
+    bool sleep_boosted = false;
+    int64_t saved_sleep_usec = 0;    // the editor's value while boosted
 };
 
 }
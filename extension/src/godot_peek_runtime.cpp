@@ -0,0 +1,918 @@
+#include "godot_peek_runtime.h"
+#include "runtime_commands.h"
+#include "json_rpc.h"
+#include "godot_views.h"
+#include "text_transcode.h"
+#include "profiling_loader.h"
+
+#include <nlohmann/json.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/gd_script.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/input.hpp>
+#include <godot_cpp/classes/input_event_action.hpp>
+#include <godot_cpp/classes/input_event_key.hpp>
+#include <godot_cpp/classes/input_event_mouse_button.hpp>
+#include <godot_cpp/classes/input_event_mouse_motion.hpp>
+#include <godot_cpp/classes/script.hpp>
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/world2d.hpp>
+#include <godot_cpp/classes/world3d.hpp>
+#include <godot_cpp/classes/collision_object2d.hpp>
+#include <godot_cpp/classes/collision_object3d.hpp>
+#include <godot_cpp/classes/rigid_body2d.hpp>
+#include <godot_cpp/classes/rigid_body3d.hpp>
+#include <godot_cpp/classes/character_body2d.hpp>
+#include <godot_cpp/classes/character_body3d.hpp>
+#include <godot_cpp/classes/static_body2d.hpp>
+#include <godot_cpp/classes/static_body3d.hpp>
+#include <godot_cpp/classes/area2d.hpp>
+#include <godot_cpp/classes/area3d.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+using namespace godot;
+using json = nlohmann::json;
+
+// helper: godot String from a std::string
+static String to_godot(const std::string& s) {
+    return String::utf8(s.c_str());
+}
+
+// helper: std::string from a godot String
+static std::string from_godot(const String& s) {
+    return utf32_to_utf8(utf32_view(s));
+}
+
+// helper: params as an object ({} when missing or malformed)
+static json parse_params(const std::string& params_str) {
+    json params = json::parse(params_str, nullptr, false);
+    return params.is_object() ? params : json::object();
+}
+
+// helper: an integer param, sent as a number or (over udp) a numeric string
+static int64_t int_param(const json& params, const char* key, int64_t fallback) {
+    if (!params.contains(key)) {
+        return fallback;
+    }
+    const json& value = params[key];
+    if (value.is_number()) {
+        return value.get<int64_t>();
+    }
+    if (value.is_string()) {
+        const std::string& s = value.get_ref<const std::string&>();
+        char* end = nullptr;
+        long long n = std::strtoll(s.c_str(), &end, 10);
+        if (!s.empty() && *end == '\0') {
+            return n;
+        }
+    }
+    return fallback;
+}
+
+// what evaluate reports as "value": like str(), but with null/bool spelled
+// out and nodes shown as "Name (Class)"
+static std::string variant_to_string(const Variant& value) {
+    switch (value.get_type()) {
+        case Variant::NIL:
+            return "null";
+        case Variant::BOOL:
+            return static_cast<bool>(value) ? "true" : "false";
+        case Variant::OBJECT: {
+            Object* obj = value;
+            if (!obj) {
+                return "null";
+            }
+            if (Node* node = Object::cast_to<Node>(obj)) {
+                return from_godot(String(node->get_name())) + " (" + from_godot(node->get_class()) + ")";
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return from_godot(UtilityFunctions::str(value));
+}
+
+// helper: the gdscript `name in obj` test
+static bool has_property(Object* obj, const String& name) {
+    TypedArray<Dictionary> props = obj->get_property_list();
+    for (int64_t i = 0; i < props.size(); i++) {
+        Dictionary prop = props[i];
+        if (String(prop["name"]) == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// helper: the live node behind an ObjectID, nullptr once it's freed
+static Node* node_from_id(uint64_t id) {
+    return id ? Object::cast_to<Node>(UtilityFunctions::instance_from_id(static_cast<int64_t>(id))) : nullptr;
+}
+
+void GodotPeekRuntime::_bind_methods() {
+}
+
+GodotPeekRuntime::GodotPeekRuntime() {
+    register_commands();
+}
+
+GodotPeekRuntime::~GodotPeekRuntime() {
+    stop_udp();
+}
+
+void GodotPeekRuntime::register_commands() {
+    dispatcher.add_task("screenshot", [this](int64_t id, std::string params_str, RpcContext& ctx) {
+        return screenshot(id, std::move(params_str), ctx);
+    });
+    dispatcher.add("evaluate", [this](int64_t id, const std::string& params_str) {
+        return evaluate(id, params_str);
+    });
+    dispatcher.add("input", [this](int64_t id, const std::string& params_str) {
+        return input(id, params_str);
+    });
+    dispatcher.add("query_nodes", [this](int64_t id, const std::string& params_str) {
+        return query_nodes(id, params_str);
+    });
+    dispatcher.add("snapshot_counts", [this](int64_t id, const std::string& params_str) {
+        return snapshot_counts(id, params_str);
+    });
+    dispatcher.add("diff_counts", [this](int64_t id, const std::string& params_str) {
+        return diff_counts(id, params_str);
+    });
+    dispatcher.add("find_orphans", [this](int64_t id, const std::string& params_str) {
+        return find_orphans(id, params_str);
+    });
+    dispatcher.add("load_profile", [this](int64_t id, const std::string& params_str) {
+        return load_profile(id, params_str);
+    });
+    dispatcher.add("sample_physics", [this](int64_t id, const std::string& params_str) {
+        return sample_physics(id, params_str);
+    });
+    dispatcher.add("physics_series", [this](int64_t id, const std::string& params_str) {
+        return physics_series(id, params_str);
+    });
+}
+
+void GodotPeekRuntime::_ready() {
+    // physics processing is the probe's, off until it's started
+    set_physics_process(false);
+
+    // export builds have no mcp server to talk to
+    if (!OS::get_singleton()->has_feature("editor")) {
+        set_process(false);
+        return;
+    }
+
+    apply_overrides();
+
+    if (start_udp()) {
+        UtilityFunctions::print("[GodotPeek] Runtime listening on UDP port ", RUNTIME_UDP_PORT);
+    } else {
+        UtilityFunctions::push_error("[GodotPeek] Runtime could not listen on UDP port ", RUNTIME_UDP_PORT);
+    }
+
+    // the editor exports this for the games it launches
+    const char* path = std::getenv(GAME_SOCKET_ENV);
+    if (path && *path && socket_server.start(path)) {
+        UtilityFunctions::print("[GodotPeek] Runtime listening on ", path);
+    }
+
+    const char* track = std::getenv(TRACK_ORPHANS_ENV);
+    if (track && *track && std::strcmp(track, "0") != 0) {
+        start_orphan_tracking();
+    }
+}
+
+void GodotPeekRuntime::_exit_tree() {
+    stop_udp();
+    socket_server.stop();
+    stop_class_index();
+    stop_orphan_tracking();
+    stop_physics_timing();
+}
+
+void GodotPeekRuntime::_process(double delta) {
+    // screenshots waiting on a drawn frame resume first, so both transports
+    // can answer them in this frame
+    frames.tick();
+    dispatcher.finish_tasks();
+
+    if (count_interval_ms > 0 && Time::get_singleton()->get_ticks_msec() >= next_count_ms) {
+        take_count_snapshot();
+    }
+    if (orphans_live && Time::get_singleton()->get_ticks_msec() >= next_sweep_ms) {
+        sweep_orphans();
+    }
+    if (physics_interval_ms > 0 && Time::get_singleton()->get_ticks_msec() >= next_physics_ms) {
+        take_physics_sample();
+    }
+
+    poll_udp();
+    if (socket_server.is_running()) {
+        socket_server.poll([this](const std::string& message, RpcContext& ctx) -> std::string {
+            return dispatcher.handle(message, &ctx);
+        });
+    }
+}
+
+void GodotPeekRuntime::_physics_process(double delta) {
+    // last in the tree's physics pass (see start_physics_timing)
+    physics_ticks.stop(static_cast<int64_t>(Time::get_singleton()->get_ticks_usec()));
+}
+
+void GodotPeekRuntime::apply_overrides() {
+    String path = RUNTIME_OVERRIDES_PATH;
+    if (!FileAccess::file_exists(path)) {
+        return;
+    }
+    String content = FileAccess::get_file_as_string(path);
+    // one-shot: the next run starts clean
+    DirAccess::remove_absolute(path);
+
+    Variant parsed = JSON::parse_string(content);
+    if (parsed.get_type() != Variant::DICTIONARY) {
+        UtilityFunctions::push_warning("[GodotPeek] Failed to parse overrides JSON");
+        return;
+    }
+    Dictionary overrides = parsed;
+    if (overrides.is_empty()) {
+        return;
+    }
+    UtilityFunctions::print("[GodotPeek] Applying ", overrides.size(), " autoload override(s)...");
+
+    Array names = overrides.keys();
+    for (int64_t i = 0; i < names.size(); i++) {
+        String autoload_name = names[i];
+        Node* autoload = get_node_or_null(NodePath("/root/" + autoload_name));
+        if (!autoload) {
+            UtilityFunctions::push_warning("[GodotPeek] Autoload '", autoload_name, "' not found, skipping overrides");
+            continue;
+        }
+        Variant props_value = overrides[autoload_name];
+        if (props_value.get_type() != Variant::DICTIONARY) {
+            continue;
+        }
+        Dictionary props = props_value;
+        Array keys = props.keys();
+        for (int64_t j = 0; j < keys.size(); j++) {
+            String prop_name = keys[j];
+            if (has_property(autoload, prop_name)) {
+                autoload->set(prop_name, props[prop_name]);
+                UtilityFunctions::print("[GodotPeek] Set ", autoload_name, ".", prop_name, " = ", props[prop_name]);
+            } else {
+                UtilityFunctions::push_warning("[GodotPeek] Property '", prop_name, "' not found on autoload '", autoload_name, "'");
+            }
+        }
+    }
+}
+
+bool GodotPeekRuntime::start_udp() {
+    udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd < 0) {
+        return false;
+    }
+    fcntl(udp_fd, F_SETFL, fcntl(udp_fd, F_GETFL, 0) | O_NONBLOCK);
+    fcntl(udp_fd, F_SETFD, fcntl(udp_fd, F_GETFD, 0) | FD_CLOEXEC);
+
+    // clients only ever send from this machine
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(RUNTIME_UDP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(udp_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        stop_udp();
+        return false;
+    }
+    return true;
+}
+
+void GodotPeekRuntime::stop_udp() {
+    if (udp_fd >= 0) {
+        close(udp_fd);
+        udp_fd = -1;
+    }
+    pending.clear();
+}
+
+void GodotPeekRuntime::send_datagram(const sockaddr_in& to, const std::string& payload) {
+    sendto(udp_fd, payload.data(), payload.size(), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+}
+
+void GodotPeekRuntime::poll_udp() {
+    if (udp_fd < 0) {
+        return;
+    }
+
+    // every datagram is one command; run it as a JSON-RPC request and send
+    // the result back the way the gdscript helper did
+    char buf[65536];
+    while (true) {
+        sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        ssize_t n = recvfrom(udp_fd, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&from), &from_len);
+        if (n < 0) {
+            break;  // EAGAIN: nothing more this frame
+        }
+        std::string cmd;
+        std::string request;
+        std::string error;
+        if (!datagram_to_request(std::string(buf, static_cast<size_t>(n)), next_udp_id++, cmd, request, error)) {
+            send_datagram(from, json{{"error", error}}.dump());
+            continue;
+        }
+        RpcContext ctx;
+        std::string response = dispatcher.handle(request, &ctx);
+        if (ctx.deferred) {
+            pending.push_back(PendingDatagram{from, std::move(cmd), ctx.deferred});
+            continue;
+        }
+        send_datagram(from, response_to_datagram(response, cmd));
+    }
+
+    for (size_t i = 0; i < pending.size(); ) {
+        if (pending[i].deferred->done) {
+            send_datagram(pending[i].from, response_to_datagram(pending[i].deferred->response, pending[i].cmd));
+            pending.erase(pending.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void GodotPeekRuntime::_on_frame_post_draw() {
+    waiting_for_draw = false;
+    post_draw.fire();
+}
+
+RpcTask GodotPeekRuntime::screenshot(int64_t id, std::string params_str, RpcContext& ctx) {
+    json params = parse_params(params_str);
+    bool inline_data = params.contains("inline") && params["inline"].is_boolean() && params["inline"].get<bool>();
+
+    // grab the viewport once the frame being drawn has finished. the
+    // connection only exists while someone is waiting
+    if (!waiting_for_draw) {
+        waiting_for_draw = true;
+        RenderingServer::get_singleton()->connect("frame_post_draw",
+                                                  callable_mp(this, &GodotPeekRuntime::_on_frame_post_draw),
+                                                  Object::CONNECT_ONE_SHOT);
+    }
+    bool drawn = co_await frames.signal(post_draw, SCREENSHOT_WAIT_MS);
+    if (!drawn) {
+        co_return make_error(id, -32000, "timed out waiting for a frame");
+    }
+
+    Viewport* viewport = get_viewport();
+    if (!viewport) {
+        co_return make_error(id, -32000, "no viewport");
+    }
+    Ref<Image> img = viewport->get_texture()->get_image();
+    if (img.is_null()) {
+        co_return make_error(id, -32000, "failed to get viewport image");
+    }
+
+    json result = {{"width", img->get_width()}, {"height", img->get_height()}};
+    if (inline_data && ctx.binary_frames) {
+        // straight into a binary frame, no file round trip
+        PackedByteArray png = img->save_png_to_buffer();
+        result["format"] = "png";
+        result["size"] = png.size();
+        result["attachment"] = ctx.attachments.size();
+        ctx.attachments.emplace_back(reinterpret_cast<const char*>(png.ptr()), png.size());
+    } else {
+        Error err = img->save_png(RUNTIME_SCREENSHOT_PATH);
+        if (err != OK) {
+            co_return make_error(id, -32000, "failed to save png: " + from_godot(UtilityFunctions::error_string(err)));
+        }
+        result["path"] = RUNTIME_SCREENSHOT_PATH;
+    }
+    co_return make_result(id, result.dump());
+}
+
+std::string GodotPeekRuntime::evaluate(int64_t id, const std::string& params_str) {
+    json params = parse_params(params_str);
+    std::string expression = params.contains("expression") && params["expression"].is_string()
+                                 ? params["expression"].get<std::string>()
+                                 : std::string();
+    if (expression.empty()) {
+        return make_error(id, -32602, "empty expression");
+    }
+
+    // compiled as a throwaway GDScript rather than an Expression, which has
+    // no var, return or multi-line support
+    Ref<GDScript> script;
+    script.instantiate();
+    script->set_source_code(to_godot(evaluate_source(expression)));
+    if (script->reload() != OK) {
+        return make_error(id, -32000, "compile error: check expression syntax");
+    }
+
+    // in the tree so get_node / get_tree work from the expression
+    Node* host = memnew(Node);
+    host->set_script(script);
+    get_tree()->get_root()->add_child(host);
+    Variant value = host->call("_eval");
+    host->queue_free();
+
+    json result = {
+        {"value", variant_to_string(value)},
+        {"type", from_godot(UtilityFunctions::type_string(value.get_type()))}
+    };
+    return make_result(id, result.dump());
+}
+
+std::string GodotPeekRuntime::input(int64_t id, const std::string& params_str) {
+    InputCommand cmd;
+    std::string error;
+    if (!parse_input_command(parse_params(params_str), cmd, error)) {
+        return make_error(id, -32602, error);
+    }
+
+    Ref<InputEvent> event;
+    switch (cmd.kind) {
+        case InputKind::action: {
+            Ref<InputEventAction> e;
+            e.instantiate();
+            e->set_action(StringName(to_godot(cmd.action)));
+            e->set_pressed(cmd.pressed);
+            e->set_strength(cmd.strength);
+            event = e;
+            break;
+        }
+        case InputKind::key: {
+            // names may carry modifiers ("Ctrl+S"); they come back as mask bits
+            int64_t code = cmd.key.empty() ? cmd.keycode
+                                           : static_cast<int64_t>(OS::get_singleton()->find_keycode_from_string(to_godot(cmd.key)));
+            Ref<InputEventKey> e;
+            e.instantiate();
+            e->set_keycode(static_cast<Key>(code & KEY_CODE_MASK));
+            e->set_shift_pressed(code & KEY_MASK_SHIFT);
+            e->set_ctrl_pressed(code & KEY_MASK_CTRL);
+            e->set_alt_pressed(code & KEY_MASK_ALT);
+            e->set_meta_pressed(code & KEY_MASK_META);
+            e->set_pressed(cmd.pressed);
+            event = e;
+            break;
+        }
+        case InputKind::mouse_button: {
+            Ref<InputEventMouseButton> e;
+            e.instantiate();
+            e->set_button_index(static_cast<MouseButton>(cmd.button));
+            e->set_pressed(cmd.pressed);
+            e->set_position(Vector2(cmd.x, cmd.y));
+            event = e;
+            break;
+        }
+        case InputKind::mouse_motion: {
+            Ref<InputEventMouseMotion> e;
+            e.instantiate();
+            e->set_relative(Vector2(cmd.rel_x, cmd.rel_y));
+            e->set_position(Vector2(cmd.x, cmd.y));
+            event = e;
+            break;
+        }
+    }
+
+    Input::get_singleton()->parse_input_event(event);
+    return make_result(id, json{{"success", true}, {"type", cmd.type}}.dump());
+}
+
+std::string GodotPeekRuntime::query_nodes(int64_t id, const std::string& params_str) {
+    start_class_index();
+    json result;
+    std::string error;
+    if (!::query_nodes(GodotSceneView(this), parse_params(params_str), &class_index, result, error)) {
+        return make_error(id, -32602, error);
+    }
+    return make_result(id, result.dump());
+}
+
+void GodotPeekRuntime::start_class_index() {
+    SceneTree* tree = get_tree();
+    if (class_index_live || !tree) {
+        return;
+    }
+    // one walk now, then the tree's signals keep it current
+    std::vector<Node*> stack = {tree->get_root()};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        class_index.add(node, from_godot(node->get_class()));
+        for (int32_t i = 0; i < node->get_child_count(); i++) {
+            stack.push_back(node->get_child(i));
+        }
+    }
+    class_index_live = true;
+    watch_tree();
+}
+
+void GodotPeekRuntime::stop_class_index() {
+    if (!class_index_live) {
+        return;
+    }
+    class_index.clear();
+    class_index_live = false;
+    watch_tree();
+}
+
+void GodotPeekRuntime::start_orphan_tracking() {
+    if (orphans_live || !get_tree()) {
+        return;
+    }
+    orphans_since_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+    next_sweep_ms = Time::get_singleton()->get_ticks_msec() + ORPHAN_SWEEP_MS;
+    orphans_live = true;
+    watch_tree();
+}
+
+void GodotPeekRuntime::stop_orphan_tracking() {
+    if (!orphans_live) {
+        return;
+    }
+    orphans.clear();
+    orphan_script_paths.clear();
+    orphans_live = false;
+    watch_tree();
+}
+
+void GodotPeekRuntime::watch_tree() {
+    bool want = class_index_live || orphans_live;
+    if (want == tree_watched) {
+        return;
+    }
+    SceneTree* tree = get_tree();
+    if (!tree) {
+        tree_watched = false;
+        return;
+    }
+    if (want) {
+        tree->connect("node_added", callable_mp(this, &GodotPeekRuntime::_on_node_added));
+        tree->connect("node_removed", callable_mp(this, &GodotPeekRuntime::_on_node_removed));
+    } else {
+        tree->disconnect("node_added", callable_mp(this, &GodotPeekRuntime::_on_node_added));
+        tree->disconnect("node_removed", callable_mp(this, &GodotPeekRuntime::_on_node_removed));
+    }
+    tree_watched = want;
+}
+
+void GodotPeekRuntime::_on_node_added(Node* node) {
+    if (class_index_live) {
+        class_index.add(node, from_godot(node->get_class()));
+    }
+    if (orphans_live) {
+        orphans.attached(node->get_instance_id());
+    }
+}
+
+void GodotPeekRuntime::_on_node_removed(Node* node) {
+    if (class_index_live) {
+        class_index.remove(node);
+    }
+    if (orphans_live) {
+        record_detached(node);
+    }
+}
+
+void GodotPeekRuntime::record_detached(Node* node) {
+    DetachedNode entry;
+    entry.id = node->get_instance_id();
+    if (Node* parent = node->get_parent()) {
+        entry.parent_id = parent->get_instance_id();
+    }
+
+    // most removals are of a handful of scripted scenes: resolve each
+    // script's path once
+    std::string_view script_path;
+    if (Object* script = node->get_script()) {
+        uint64_t script_id = script->get_instance_id();
+        auto it = orphan_script_paths.find(script_id);
+        if (it == orphan_script_paths.end()) {
+            Script* s = Object::cast_to<Script>(script);
+            it = orphan_script_paths.emplace(script_id, s ? from_godot(s->get_path()) : std::string()).first;
+        }
+        script_path = it->second;
+    }
+    String scene_file = node->get_scene_file_path();
+    entry.key = orphans.intern(from_godot(node->get_class()), script_path,
+                               scene_file.is_empty() ? std::string() : from_godot(scene_file));
+    entry.time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+    entry.frame = Engine::get_singleton()->get_process_frames();
+    orphans.detached(entry);
+}
+
+void GodotPeekRuntime::sweep_orphans() {
+    // freed nodes leave no signal behind: drop them here so the tracker only
+    // grows with real orphans
+    orphans.sweep([](uint64_t id) {
+        Node* node = node_from_id(id);
+        if (!node) {
+            return DetachedState::freed;
+        }
+        if (node->is_inside_tree()) {
+            return DetachedState::in_tree;
+        }
+        return node->get_parent() ? DetachedState::orphan_child : DetachedState::orphan_root;
+    });
+    next_sweep_ms = Time::get_singleton()->get_ticks_msec() + ORPHAN_SWEEP_MS;
+}
+
+std::string GodotPeekRuntime::find_orphans(int64_t id, const std::string& params_str) {
+    json params = parse_params(params_str);
+    if (int_param(params, "stop", 0) != 0) {
+        stop_orphan_tracking();
+        return make_result(id, json{{"tracking", false}}.dump());
+    }
+    int64_t limit = std::clamp<int64_t>(int_param(params, "limit", 20), 1, 1000);
+    int64_t samples = std::clamp<int64_t>(int_param(params, "samples", 3), 0, 100);
+
+    bool started = !orphans_live;
+    start_orphan_tracking();
+    sweep_orphans();
+
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    json result = orphan_groups_json(orphans, static_cast<size_t>(limit), static_cast<size_t>(samples), now_ms,
+                                     [](const DetachedNode& entry) {
+        json sample = {{"id", entry.id}, {"frame", entry.frame}};
+        if (Node* node = node_from_id(entry.id)) {
+            sample["name"] = from_godot(String(node->get_name()));
+            sample["children"] = node->get_child_count();
+        }
+        // where it was detached from, while that parent is still around
+        Node* parent = node_from_id(entry.parent_id);
+        if (parent && parent->is_inside_tree()) {
+            sample["detached_from"] = from_godot(String(parent->get_path()));
+        } else if (parent) {
+            sample["detached_from"] = from_godot(String(parent->get_name())) + " (orphaned)";
+        } else if (entry.parent_id != 0) {
+            sample["detached_from"] = "(freed)";
+        }
+        return sample;
+    });
+
+    int64_t engine_orphans = static_cast<int64_t>(
+        Performance::get_singleton()->get_monitor(Performance::OBJECT_ORPHAN_NODE_COUNT));
+    result["tracking"] = true;
+    result["started"] = started;
+    result["since_ms"] = orphans_since_ms;
+    result["engine_orphans"] = engine_orphans;
+    // never added to the tree, or detached before tracking started
+    result["untracked"] = std::max<int64_t>(engine_orphans - static_cast<int64_t>(orphans.size()), 0);
+    return make_result(id, result.dump());
+}
+
+const CountSnapshot& GodotPeekRuntime::take_count_snapshot() {
+    // scripts are shared between many nodes: look each path up once a pass
+    std::unordered_map<Object*, std::string> script_paths;
+    count_snapshots.begin();
+    std::vector<Node*> stack = {get_tree()->get_root()};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        Object* script = node->get_script();
+        const std::string* path = nullptr;
+        if (script) {
+            auto it = script_paths.find(script);
+            if (it == script_paths.end()) {
+                Script* s = Object::cast_to<Script>(script);
+                it = script_paths.emplace(script, s ? from_godot(s->get_path()) : std::string()).first;
+            }
+            path = &it->second;
+        }
+        count_snapshots.add(from_godot(node->get_class()), path ? *path : std::string_view());
+        for (int32_t i = node->get_child_count() - 1; i >= 0; i--) {
+            stack.push_back(node->get_child(i));
+        }
+    }
+
+    Performance* perf = Performance::get_singleton();
+    CountTotals totals;
+    totals.objects = static_cast<int64_t>(perf->get_monitor(Performance::OBJECT_COUNT));
+    totals.resources = static_cast<int64_t>(perf->get_monitor(Performance::OBJECT_RESOURCE_COUNT));
+    totals.orphan_nodes = static_cast<int64_t>(perf->get_monitor(Performance::OBJECT_ORPHAN_NODE_COUNT));
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    if (count_interval_ms > 0) {
+        next_count_ms = Time::get_singleton()->get_ticks_msec() + count_interval_ms;
+    }
+    return count_snapshots.commit(now_ms, Engine::get_singleton()->get_process_frames(), totals);
+}
+
+std::string GodotPeekRuntime::snapshot_counts(int64_t id, const std::string& params_str) {
+    json params = parse_params(params_str);
+    // interval_ms: keep taking them (0 stops); no faster than 4 a second
+    int64_t interval = int_param(params, "interval_ms", -1);
+    if (interval >= 0) {
+        count_interval_ms = interval == 0 ? 0 : static_cast<uint64_t>(std::max<int64_t>(interval, 250));
+    }
+    int64_t top = std::clamp<int64_t>(int_param(params, "top", 20), 0, 1000);
+
+    json result = count_snapshot_json(count_snapshots, take_count_snapshot(), static_cast<size_t>(top));
+    result["interval_ms"] = count_interval_ms;
+    result["stored"] = count_snapshots.all().size();
+    return make_result(id, result.dump());
+}
+
+std::string GodotPeekRuntime::diff_counts(int64_t id, const std::string& params_str) {
+    json params = parse_params(params_str);
+    int64_t from_ref = int_param(params, "from", -1);
+    int64_t to_ref = int_param(params, "to", 0);
+    int64_t limit = std::clamp<int64_t>(int_param(params, "limit", 20), 1, 1000);
+
+    const CountSnapshot* from = count_snapshots.find(from_ref);
+    const CountSnapshot* to = count_snapshots.find(to_ref);
+    if (!from || !to) {
+        return make_error(id, -32602, "no snapshot " + std::to_string(!from ? from_ref : to_ref) +
+                                          " (take two with snapshot_counts first)");
+    }
+    return make_result(id, count_diff_json(count_snapshots, *from, *to, static_cast<size_t>(limit)).dump());
+}
+
+std::string GodotPeekRuntime::load_profile(int64_t id, const std::string& params_str) {
+    LoadProfile* profile = ProfilingLoader::profile();
+    if (!profile) {
+        return make_error(id, -32000, "load profiling is off: start the game with run_scene profile_loads=true");
+    }
+    json params = parse_params(params_str);
+    int64_t limit = std::clamp<int64_t>(int_param(params, "limit", 20), 1, 1000);
+    bool by_total = params.contains("sort") && params["sort"] == "total";
+    return make_result(id, load_profile_json(profile->records(), profile->dropped(), static_cast<size_t>(limit),
+                                             by_total).dump());
+}
+
+// helper: a 2d or 3d collision object's kind; false for the ones not counted
+// (physical bones and other custom bodies)
+template <typename Rigid, typename Character, typename Static, typename Area>
+static bool body_kind(Object* body, BodyKind& kind, bool& active, bool& frozen) {
+    if (Rigid* rigid = Object::cast_to<Rigid>(body)) {
+        kind = BodyKind::rigid;
+        frozen = rigid->is_freeze_enabled();
+        active = !frozen && !rigid->is_sleeping();
+        return true;
+    }
+    if (Object::cast_to<Character>(body)) {
+        kind = BodyKind::character;
+    } else if (Object::cast_to<Static>(body)) {
+        kind = BodyKind::static_body;
+    } else if (Object::cast_to<Area>(body)) {
+        kind = BodyKind::area;
+    } else {
+        return false;
+    }
+    active = false;
+    frozen = false;
+    return true;
+}
+
+const PhysicsSample& GodotPeekRuntime::take_physics_sample() {
+    std::unordered_map<Object*, std::string> script_paths;
+    physics_samples.begin();
+    std::vector<Node*> stack = {get_tree()->get_root()};
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+
+        BodyKind kind;
+        bool active = false;
+        bool frozen = false;
+        if (CollisionObject3D* body = Object::cast_to<CollisionObject3D>(node)) {
+            Ref<World3D> world = body->get_world_3d();
+            if (world.is_valid() &&
+                body_kind<RigidBody3D, CharacterBody3D, StaticBody3D, Area3D>(body, kind, active, frozen)) {
+                physics_samples.add_body(world->get_space().get_id(), 3, kind, active, frozen);
+            }
+        } else if (CollisionObject2D* body = Object::cast_to<CollisionObject2D>(node)) {
+            Ref<World2D> world = body->get_world_2d();
+            if (world.is_valid() &&
+                body_kind<RigidBody2D, CharacterBody2D, StaticBody2D, Area2D>(body, kind, active, frozen)) {
+                physics_samples.add_body(world->get_space().get_id(), 2, kind, active, frozen);
+            }
+        }
+
+        // physics processing is only on for nodes that implement
+        // _physics_process (the built-in bodies use the internal kind)
+        if (node != this && node->is_physics_processing()) {
+            Object* script = node->get_script();
+            const std::string* path = nullptr;
+            if (script) {
+                auto it = script_paths.find(script);
+                if (it == script_paths.end()) {
+                    Script* s = Object::cast_to<Script>(script);
+                    it = script_paths.emplace(script, s ? from_godot(s->get_path()) : std::string()).first;
+                }
+                path = &it->second;
+            }
+            physics_samples.add_processor(from_godot(node->get_class()), path ? *path : std::string_view());
+        }
+
+        for (int32_t i = node->get_child_count() - 1; i >= 0; i--) {
+            stack.push_back(node->get_child(i));
+        }
+    }
+
+    Performance* perf = Performance::get_singleton();
+    auto monitor = [perf](Performance::Monitor m) { return static_cast<int64_t>(perf->get_monitor(m)); };
+    PhysicsServerCounts server_2d{monitor(Performance::PHYSICS_2D_ACTIVE_OBJECTS),
+                                  monitor(Performance::PHYSICS_2D_COLLISION_PAIRS),
+                                  monitor(Performance::PHYSICS_2D_ISLAND_COUNT)};
+    PhysicsServerCounts server_3d{monitor(Performance::PHYSICS_3D_ACTIVE_OBJECTS),
+                                  monitor(Performance::PHYSICS_3D_COLLISION_PAIRS),
+                                  monitor(Performance::PHYSICS_3D_ISLAND_COUNT)};
+    // seconds, the slowest tick in the last second
+    double physics_ms = perf->get_monitor(Performance::TIME_PHYSICS_PROCESS) * 1000.0;
+
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    if (physics_interval_ms > 0) {
+        next_physics_ms = Time::get_singleton()->get_ticks_msec() + physics_interval_ms;
+    }
+    return physics_samples.commit(now_ms, Engine::get_singleton()->get_physics_frames(), physics_ticks.take(),
+                                  physics_ms, server_2d, server_3d);
+}
+
+void GodotPeekRuntime::start_physics_timing() {
+    SceneTree* tree = get_tree();
+    if (physics_timing || !tree) {
+        return;
+    }
+    // physics_frame fires before the tree's physics pass; this node's
+    // _physics_process, at the highest priority, runs at the end of it
+    tree->connect("physics_frame", callable_mp(this, &GodotPeekRuntime::_on_physics_frame));
+    set_physics_process_priority(std::numeric_limits<int32_t>::max());
+    set_physics_process(true);
+    physics_ticks.take();
+    physics_timing = true;
+}
+
+void GodotPeekRuntime::stop_physics_timing() {
+    physics_interval_ms = 0;
+    if (!physics_timing) {
+        return;
+    }
+    if (SceneTree* tree = get_tree()) {
+        tree->disconnect("physics_frame", callable_mp(this, &GodotPeekRuntime::_on_physics_frame));
+    }
+    set_physics_process(false);
+    physics_timing = false;
+}
+
+void GodotPeekRuntime::_on_physics_frame() {
+    physics_ticks.start(static_cast<int64_t>(Time::get_singleton()->get_ticks_usec()));
+}
+
+std::string GodotPeekRuntime::sample_physics(int64_t id, const std::string& params_str) {
+    json params = parse_params(params_str);
+    if (int_param(params, "stop", 0) != 0) {
+        stop_physics_timing();
+        return make_result(id, json{{"interval_ms", 0}, {"stored", physics_samples.all().size()}}.dump());
+    }
+    // interval_ms: keep sampling (0 stops); no faster than 10 a second
+    int64_t interval = int_param(params, "interval_ms", -1);
+    if (interval >= 0) {
+        physics_interval_ms = interval == 0 ? 0 : static_cast<uint64_t>(std::max<int64_t>(interval, 100));
+    }
+    int64_t top = std::clamp<int64_t>(int_param(params, "top", 20), 0, 1000);
+
+    // the tree pass is timed from the first request on, so the first
+    // sample has no ticks yet
+    start_physics_timing();
+    json result = physics_sample_json(physics_samples, take_physics_sample(), static_cast<size_t>(top));
+    result["interval_ms"] = physics_interval_ms;
+    result["stored"] = physics_samples.all().size();
+    return make_result(id, result.dump());
+}
+
+std::string GodotPeekRuntime::physics_series(int64_t id, const std::string& params_str) {
+    if (physics_samples.all().empty()) {
+        return make_error(id, -32602, "no physics samples (start them with sample_physics interval_ms)");
+    }
+    json params = parse_params(params_str);
+    int64_t since = int_param(params, "since", 0);
+    int64_t limit = std::clamp<int64_t>(int_param(params, "limit", 120), 1, static_cast<int64_t>(PHYSICS_SAMPLES_MAX));
+    return make_result(id, physics_series_json(physics_samples, since, static_cast<size_t>(limit)).dump());
+}
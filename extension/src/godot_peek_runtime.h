@@ -0,0 +1,141 @@
+#pragma once
+
+#include <godot_cpp/classes/node.hpp>
+
+#include "count_snapshots.h"
+#include "frame_task.h"
+#include "node_query.h"
+#include "orphan_tracker.h"
+#include "physics_probe.h"
+#include "rpc_context.h"
+#include "rpc_dispatcher.h"
+#include "socket_server.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <netinet/in.h>
+
+namespace godot {
+
+// the game-side half of godot peek, in native code. peek_runtime_helper.gd
+// adds it as a child when the extension is loaded and only does the work
+// itself when it isn't. answers screenshot / evaluate / input / query_nodes /
+// snapshot_counts / diff_counts / find_orphans / load_profile /
+// sample_physics / physics_series over the legacy udp port and over a framed
+// socket (runtime_commands.h), and applies the one-shot autoload overrides at
+// startup.
+//
+// each frame costs one recvfrom on the udp socket and one accept on the
+// framed socket; nothing is parsed unless a command came in. the class index
+// behind query_nodes is only built, and kept current from the tree's
+// node_added / node_removed signals, once the first query arrives; the
+// orphan tracker rides the same signals from the first find_orphans (or from
+// startup with TRACK_ORPHANS_ENV set). the physics probe only physics-
+// processes (last, to time the tree's pass) once sample_physics asks.
+class GodotPeekRuntime : public Node {
+    GDCLASS(GodotPeekRuntime, Node)
+
+protected:
+    static void _bind_methods();
+
+public:
+    GodotPeekRuntime();
+    ~GodotPeekRuntime();
+
+    void _ready() override;
+    void _process(double delta) override;
+    void _physics_process(double delta) override;
+    void _exit_tree() override;
+
+private:
+    static constexpr uint32_t SCREENSHOT_WAIT_MS = 1000;
+
+    // a udp command whose reply is still being produced
+    struct PendingDatagram {
+        sockaddr_in from{};
+        std::string cmd;
+        std::shared_ptr<DeferredResponse> deferred;
+    };
+
+    void apply_overrides();
+    void register_commands();
+
+    bool start_udp();
+    void stop_udp();
+    void poll_udp();
+    void send_datagram(const sockaddr_in& to, const std::string& payload);
+
+    // command handlers (JSON-RPC: params in, full response out)
+    RpcTask screenshot(int64_t id, std::string params_str, RpcContext& ctx);
+    std::string evaluate(int64_t id, const std::string& params_str);
+    std::string input(int64_t id, const std::string& params_str);
+    std::string query_nodes(int64_t id, const std::string& params_str);
+    std::string snapshot_counts(int64_t id, const std::string& params_str);
+    std::string diff_counts(int64_t id, const std::string& params_str);
+    std::string find_orphans(int64_t id, const std::string& params_str);
+    std::string load_profile(int64_t id, const std::string& params_str);
+    std::string sample_physics(int64_t id, const std::string& params_str);
+    std::string physics_series(int64_t id, const std::string& params_str);
+
+    // one pass over the tree into count_snapshots
+    const CountSnapshot& take_count_snapshot();
+
+    void start_class_index();
+    void stop_class_index();
+    // one pass over the tree into physics_samples
+    const PhysicsSample& take_physics_sample();
+    void start_physics_timing();
+    void stop_physics_timing();
+    void _on_physics_frame();
+
+    void start_orphan_tracking();
+    void stop_orphan_tracking();
+    void record_detached(Node* node);
+    void sweep_orphans();
+
+    // node_added / node_removed stay connected while either the class index
+    // or the orphan tracker needs them
+    void watch_tree();
+    void _on_node_added(Node* node);
+    void _on_node_removed(Node* node);
+
+    // RenderingServer.frame_post_draw, connected one-shot per screenshot
+    void _on_frame_post_draw();
+
+    RpcDispatcher dispatcher;
+    FrameScheduler frames;
+    FrameSignal post_draw;
+    bool waiting_for_draw = false;
+
+    NodeClassIndex class_index;
+    bool class_index_live = false;
+    bool tree_watched = false;
+
+    static constexpr uint64_t ORPHAN_SWEEP_MS = 1000;
+    OrphanTracker orphans;
+    bool orphans_live = false;
+    uint64_t next_sweep_ms = 0;             // Time::get_ticks_msec()
+    int64_t orphans_since_ms = 0;           // unix ms tracking started
+    std::unordered_map<uint64_t, std::string> orphan_script_paths;  // by script ObjectID
+
+    CountSnapshotStore count_snapshots;
+    uint64_t count_interval_ms = 0;     // 0: only on request
+    uint64_t next_count_ms = 0;         // Time::get_ticks_msec() of the next one
+
+    PhysicsSampleStore physics_samples;
+    PhysicsTickTimer physics_ticks;
+    bool physics_timing = false;
+    uint64_t physics_interval_ms = 0;   // 0: only on request
+    uint64_t next_physics_ms = 0;       // Time::get_ticks_msec() of the next one
+
+    SocketServer socket_server;
+    int udp_fd = -1;
+    int64_t next_udp_id = 1;
+    std::vector<PendingDatagram> pending;
+};
+
+}
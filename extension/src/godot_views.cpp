@@ -0,0 +1,200 @@
+#include "godot_views.h"
+#include "text_transcode.h"
+
+#include <godot_cpp/classes/tree.hpp>
+#include <godot_cpp/classes/tree_item.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/label.hpp>
+#include <godot_cpp/classes/line_edit.hpp>
+#include <godot_cpp/classes/button.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/class_db_singleton.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+std::u32string_view utf32_view(const String& s) {
+    return std::u32string_view(s.ptr(), static_cast<size_t>(s.length()));
+}
+
+// helper: godot String to UTF-8 std::string, without a CharString in between
+static std::string to_utf8(const String& s) {
+    if (s.is_empty()) {
+        return std::string();
+    }
+    return utf32_to_utf8(utf32_view(s));
+}
+
+// --- GodotTreeView ---
+
+ItemHandle GodotTreeView::root() const {
+    return tree ? tree->get_root() : nullptr;
+}
+
+ItemHandle GodotTreeView::first_child(ItemHandle handle) const {
+    return item(handle)->get_first_child();
+}
+
+ItemHandle GodotTreeView::next_sibling(ItemHandle handle) const {
+    return item(handle)->get_next();
+}
+
+int GodotTreeView::column_count() const {
+    return tree ? tree->get_columns() : 0;
+}
+
+std::string GodotTreeView::text(ItemHandle handle, int column) const {
+    return to_utf8(item(handle)->get_text(column));
+}
+
+std::string GodotTreeView::tooltip(ItemHandle handle, int column) const {
+    return to_utf8(item(handle)->get_tooltip_text(column));
+}
+
+// --- GodotNodeView ---
+
+std::string GodotNodeView::class_name(NodeHandle handle) const {
+    return to_utf8(node(handle)->get_class());
+}
+
+bool GodotNodeView::is_class(NodeHandle handle, const char* class_name) const {
+    return node(handle)->is_class(class_name);
+}
+
+int GodotNodeView::child_count(NodeHandle handle) const {
+    return node(handle)->get_child_count();
+}
+
+NodeHandle GodotNodeView::child(NodeHandle handle, int index) const {
+    return node(handle)->get_child(index);
+}
+
+std::string GodotNodeView::property_label(NodeHandle handle) const {
+    Node* n = node(handle);
+    if (!n->has_method("get_label")) {
+        return std::string();
+    }
+    String label = n->call("get_label");
+    return to_utf8(label);
+}
+
+std::string GodotNodeView::text(NodeHandle handle) const {
+    Node* n = node(handle);
+    if (LineEdit* le = Object::cast_to<LineEdit>(n)) {
+        return to_utf8(le->get_text());
+    }
+    if (Button* btn = Object::cast_to<Button>(n)) {
+        return to_utf8(btn->get_text());
+    }
+    if (Label* lbl = Object::cast_to<Label>(n)) {
+        return to_utf8(lbl->get_text());
+    }
+    return std::string();
+}
+
+bool GodotNodeView::value_text(NodeHandle handle, std::string& out) const {
+    Node* n = node(handle);
+    if (!n->has_method("get_value")) {
+        return false;
+    }
+    Variant val = n->call("get_value");
+    out = to_utf8(String(val));
+    return true;
+}
+
+bool GodotNodeView::is_pressed(NodeHandle handle) const {
+    Button* btn = Object::cast_to<Button>(node(handle));
+    return btn && btn->is_pressed();
+}
+
+// --- GodotSceneView ---
+
+NodeHandle GodotSceneView::find(const std::string& path) const {
+    return anchor->get_node_or_null(NodePath(String::utf8(path.c_str())));
+}
+
+NodeHandle GodotSceneView::parent(NodeHandle handle) const {
+    return node(handle)->get_parent();
+}
+
+int GodotSceneView::child_count(NodeHandle handle) const {
+    return node(handle)->get_child_count();
+}
+
+NodeHandle GodotSceneView::child(NodeHandle handle, int index) const {
+    return node(handle)->get_child(index);
+}
+
+std::string GodotSceneView::name(NodeHandle handle) const {
+    return to_utf8(String(node(handle)->get_name()));
+}
+
+std::string GodotSceneView::path(NodeHandle handle) const {
+    return to_utf8(String(node(handle)->get_path()));
+}
+
+std::string GodotSceneView::class_name(NodeHandle handle) const {
+    return to_utf8(node(handle)->get_class());
+}
+
+bool GodotSceneView::is_class(NodeHandle handle, const std::string& class_name) const {
+    if (class_name != class_key) {
+        class_key = class_name;
+        class_string = String::utf8(class_name.c_str());
+    }
+    return node(handle)->is_class(class_string);
+}
+
+bool GodotSceneView::inherits(const std::string& cls, const std::string& base) const {
+    return ClassDBSingleton::get_singleton()->is_parent_class(StringName(String::utf8(cls.c_str())),
+                                                              StringName(String::utf8(base.c_str())));
+}
+
+bool GodotSceneView::in_group(NodeHandle handle, const std::string& group) const {
+    if (group != group_key) {
+        group_key = group;
+        group_name = StringName(String::utf8(group.c_str()));
+    }
+    return node(handle)->is_in_group(group_name);
+}
+
+void GodotSceneView::group_members(const std::string& group, std::vector<NodeHandle>& out) const {
+    SceneTree* tree = anchor->get_tree();
+    if (!tree) {
+        return;
+    }
+    TypedArray<Node> members = tree->get_nodes_in_group(StringName(String::utf8(group.c_str())));
+    out.reserve(out.size() + members.size());
+    for (int64_t i = 0; i < members.size(); i++) {
+        if (Node* n = Object::cast_to<Node>(members[i])) {
+            out.push_back(n);
+        }
+    }
+}
+
+bool GodotSceneView::property(NodeHandle handle, const std::string& name, nlohmann::json& out) const {
+    Variant value = node(handle)->get_indexed(NodePath(String::utf8(name.c_str())));
+    switch (value.get_type()) {
+        case Variant::NIL:
+            return false;
+        case Variant::BOOL:
+            out = static_cast<bool>(value);
+            return true;
+        case Variant::INT:
+            out = static_cast<int64_t>(value);
+            return true;
+        case Variant::FLOAT:
+            out = static_cast<double>(value);
+            return true;
+        case Variant::OBJECT: {
+            // nodes by path, other objects by class
+            Object* obj = value;
+            Node* n = Object::cast_to<Node>(obj);
+            out = !obj ? std::string() : to_utf8(n ? String(n->get_path()) : obj->get_class());
+            return true;
+        }
+        default:
+            out = to_utf8(UtilityFunctions::str(value));
+            return true;
+    }
+}
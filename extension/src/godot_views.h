@@ -0,0 +1,84 @@
+#pragma once
+
+#include "editor_views.h"
+#include "node_query.h"
+
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+
+#include <string_view>
+
+namespace godot {
+    class Tree;
+    class TreeItem;
+    class Node;
+}
+
+// editor implementations of the views in editor_views.h, and the game's
+// SceneView (node_query.h). handles are the raw TreeItem* / Node* pointers.
+
+// the UTF-32 buffer of a godot String, for text_transcode.h. valid while s is
+std::u32string_view utf32_view(const godot::String& s);
+
+class GodotTreeView : public TreeView {
+public:
+    explicit GodotTreeView(godot::Tree* tree) : tree(tree) {}
+
+    ItemHandle root() const override;
+    ItemHandle first_child(ItemHandle item) const override;
+    ItemHandle next_sibling(ItemHandle item) const override;
+    int column_count() const override;
+    std::string text(ItemHandle item, int column) const override;
+    std::string tooltip(ItemHandle item, int column) const override;
+
+    static godot::TreeItem* item(ItemHandle handle) { return static_cast<godot::TreeItem*>(handle); }
+
+private:
+    godot::Tree* tree;
+};
+
+class GodotNodeView : public NodeView {
+public:
+    std::string class_name(NodeHandle node) const override;
+    bool is_class(NodeHandle node, const char* class_name) const override;
+    int child_count(NodeHandle node) const override;
+    NodeHandle child(NodeHandle node, int index) const override;
+    std::string property_label(NodeHandle node) const override;
+    std::string text(NodeHandle node) const override;
+    bool value_text(NodeHandle node, std::string& out) const override;
+    bool is_pressed(NodeHandle node) const override;
+
+    static godot::Node* node(NodeHandle handle) { return static_cast<godot::Node*>(handle); }
+};
+
+class GodotSceneView : public SceneView {
+public:
+    // anchor: any node in the tree; absolute paths resolve from it
+    explicit GodotSceneView(godot::Node* anchor) : anchor(anchor) {}
+
+    NodeHandle find(const std::string& path) const override;
+    NodeHandle parent(NodeHandle node) const override;
+    int child_count(NodeHandle node) const override;
+    NodeHandle child(NodeHandle node, int index) const override;
+    std::string name(NodeHandle node) const override;
+    std::string path(NodeHandle node) const override;
+    std::string class_name(NodeHandle node) const override;
+    bool is_class(NodeHandle node, const std::string& class_name) const override;
+    bool inherits(const std::string& cls, const std::string& base) const override;
+    bool in_group(NodeHandle node, const std::string& group) const override;
+    void group_members(const std::string& group, std::vector<NodeHandle>& out) const override;
+    // get_indexed(), so "position:y" works too. null reads as missing
+    bool property(NodeHandle node, const std::string& name, nlohmann::json& out) const override;
+
+    static godot::Node* node(NodeHandle handle) { return static_cast<godot::Node*>(handle); }
+
+private:
+    godot::Node* anchor;
+
+    // a query asks about the same class and group for every node: keep the
+    // godot strings from the last call instead of converting each time
+    mutable std::string class_key;
+    mutable godot::String class_string;
+    mutable std::string group_key;
+    mutable godot::StringName group_name;
+};
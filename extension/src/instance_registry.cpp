@@ -0,0 +1,199 @@
+#include "instance_registry.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <dirent.h>    // opendir(), readdir()
+#include <signal.h>    // kill()
+#include <sys/stat.h>  // mkdir(), lstat()
+#include <unistd.h>    // unlink(), getuid()
+
+using json = nlohmann::json;
+
+std::string default_registry_dir() {
+    const char* env = std::getenv("GODOT_PEEK_REGISTRY");
+    if (env && *env) {
+        return env;
+    }
+    const char* runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime && *runtime) {
+        return std::string(runtime) + "/godot-peek-registry";
+    }
+    return "/tmp/godot-peek-registry-" + std::to_string(getuid());
+}
+
+// helper: path exists, is not a symlink and belongs to the current user
+static bool owned_by_us(const std::string& path, bool want_dir) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0 || st.st_uid != getuid()) {
+        return false;
+    }
+    return want_dir ? S_ISDIR(st.st_mode) : S_ISREG(st.st_mode);
+}
+
+std::string project_path_hash(const std::string& project_path) {
+    size_t len = project_path.size();
+    while (len > 1 && project_path[len - 1] == '/') {
+        len--;
+    }
+
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(project_path[i]);
+        h *= 1099511628211ull;
+    }
+
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+    return buf;
+}
+
+bool pid_alive(int64_t pid) {
+    if (pid <= 0) {
+        return false;
+    }
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+std::string choose_socket_path(const std::vector<InstanceInfo>& live, const std::string& project_path,
+                               const std::string& preferred) {
+    std::string hash = project_path_hash(project_path);
+    for (const InstanceInfo& other : live) {
+        if (other.socket_path == preferred && other.project_hash != hash) {
+            // same directory name, different project
+            std::string base = preferred;
+            const std::string ext = ".sock";
+            if (base.size() > ext.size() && base.compare(base.size() - ext.size(), ext.size(), ext) == 0) {
+                base.resize(base.size() - ext.size());
+            }
+            return base + "-" + hash.substr(0, 8) + ext;
+        }
+    }
+    return preferred;
+}
+
+json instance_json(const InstanceInfo& info) {
+    return {
+        {"pid", info.pid},
+        {"project_path", info.project_path},
+        {"project_hash", info.project_hash},
+        {"socket_path", info.socket_path},
+        {"godot_version", info.godot_version},
+        {"started_at", info.started_at}
+    };
+}
+
+std::string instance_to_json(const InstanceInfo& info) {
+    return instance_json(info).dump();
+}
+
+bool instance_from_json(const std::string& text, InstanceInfo& info) {
+    json j = json::parse(text, nullptr, false);
+    if (j.is_discarded() || !j.is_object() ||
+        !j.contains("pid") || !j["pid"].is_number_integer() ||
+        !j.contains("socket_path") || !j["socket_path"].is_string()) {
+        return false;
+    }
+
+    info = InstanceInfo();
+    info.pid = j["pid"].get<int64_t>();
+    info.socket_path = j["socket_path"].get<std::string>();
+    if (j.contains("project_path") && j["project_path"].is_string()) {
+        info.project_path = j["project_path"].get<std::string>();
+    }
+    if (j.contains("project_hash") && j["project_hash"].is_string()) {
+        info.project_hash = j["project_hash"].get<std::string>();
+    }
+    if (j.contains("godot_version") && j["godot_version"].is_string()) {
+        info.godot_version = j["godot_version"].get<std::string>();
+    }
+    if (j.contains("started_at") && j["started_at"].is_number_integer()) {
+        info.started_at = j["started_at"].get<int64_t>();
+    }
+    return true;
+}
+
+// --- InstanceRegistry ---
+
+std::string InstanceRegistry::entry_path(int64_t pid) const {
+    return dir + "/" + std::to_string(pid) + ".json";
+}
+
+bool InstanceRegistry::add(const InstanceInfo& info) {
+    // private to this user: anyone who could write here could point
+    // clients at their own socket. a directory someone else created first
+    // is refused rather than used
+    if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+        return false;
+    }
+    if (!owned_by_us(dir, true)) {
+        return false;
+    }
+
+    // write to a temp name and rename so readers never see half an entry
+    std::string path = entry_path(info.pid);
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out << instance_to_json(info);
+        if (!out.flush()) {
+            unlink(tmp.c_str());
+            return false;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+void InstanceRegistry::remove(int64_t pid) {
+    unlink(entry_path(pid).c_str());
+}
+
+std::vector<InstanceInfo> InstanceRegistry::list() {
+    std::vector<InstanceInfo> live;
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return live;  // nobody has registered yet
+    }
+
+    while (dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        const std::string ext = ".json";
+        if (name.size() <= ext.size() || name.compare(name.size() - ext.size(), ext.size(), ext) != 0) {
+            continue;  // ".", "..", in-progress .tmp files
+        }
+
+        std::string path = dir + "/" + name;
+        if (!owned_by_us(path, false)) {
+            continue;  // not written by one of our editors
+        }
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+
+        InstanceInfo info;
+        if (!instance_from_json(text.str(), info) || !pid_alive(info.pid)) {
+            unlink(path.c_str());  // stale or corrupt: whoever lists first cleans up
+            continue;
+        }
+        live.push_back(std::move(info));
+    }
+    closedir(d);
+
+    std::sort(live.begin(), live.end(), [](const InstanceInfo& a, const InstanceInfo& b) {
+        return a.started_at != b.started_at ? a.started_at < b.started_at : a.pid < b.pid;
+    });
+    return live;
+}
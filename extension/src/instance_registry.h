@@ -0,0 +1,70 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// file-based discovery registry for running editors (no godot dependency).
+//
+// every editor that owns a socket drops <dir>/<pid>.json describing itself
+// and removes it on exit. clients list the directory to find editors; entries
+// whose pid is gone (crash, kill -9) are pruned by whoever lists next, which
+// costs one kill(pid, 0) per entry. the directory is per user (mode 0700)
+// and entries owned by anyone else are ignored.
+
+struct InstanceInfo {
+    int64_t pid = 0;
+    std::string project_path;   // absolute project directory
+    std::string project_hash;   // project_path_hash(project_path)
+    std::string socket_path;    // where this editor listens
+    std::string godot_version;
+    int64_t started_at = 0;     // unix seconds
+};
+
+// $GODOT_PEEK_REGISTRY, else $XDG_RUNTIME_DIR/godot-peek-registry, else
+// /tmp/godot-peek-registry-<uid>
+std::string default_registry_dir();
+
+// stable 16 hex digit FNV-1a hash of a project path (trailing slashes ignored)
+std::string project_path_hash(const std::string& project_path);
+
+// true if a process with this pid exists (EPERM counts: it's alive, just not ours)
+bool pid_alive(int64_t pid);
+
+// the socket path for a project: preferred, unless a live editor for a
+// different project already registered it, in which case the project hash is
+// appended to keep same-named projects apart
+std::string choose_socket_path(const std::vector<InstanceInfo>& live, const std::string& project_path,
+                               const std::string& preferred);
+
+// an entry as a JSON object (the registry file contents and list_instances items)
+nlohmann::json instance_json(const InstanceInfo& info);
+std::string instance_to_json(const InstanceInfo& info);
+
+// false if text isn't a valid entry
+bool instance_from_json(const std::string& text, InstanceInfo& info);
+
+class InstanceRegistry {
+public:
+    explicit InstanceRegistry(std::string dir = default_registry_dir()) : dir(std::move(dir)) {}
+
+    // write (or replace) this instance's entry. false if the directory or
+    // file can't be written, or the directory belongs to another user
+    bool add(const InstanceInfo& info);
+
+    // delete the entry for pid, if any
+    void remove(int64_t pid);
+
+    // every live entry of this user, sorted by start time. unreadable
+    // entries and entries for dead pids are deleted along the way
+    std::vector<InstanceInfo> list();
+
+    const std::string& directory() const { return dir; }
+
+private:
+    std::string entry_path(int64_t pid) const;
+
+    std::string dir;
+};
@@ -1,31 +1,47 @@
 #include "json_rpc.h"
-#include <nlohmann/json.hpp>
+#include "request_arena.h"
 
-using json = nlohmann::json;
+// the DOMs below only live for one call; inside a request they come from
+// the dispatcher's arena (request_arena.h) and the text is written straight
+// into the response string
 
 std::string make_error(int64_t id, int code, const std::string& message) {
-    json response = {
+    arena_json response = {
         {"id", id},
         {"error", {
             {"code", code},
             {"message", message}
         }}
     };
-    return response.dump();
+    std::string out;
+    out.reserve(message.size() + 64);
+    append_json(out, response);
+    return out;
 }
 
 std::string make_result(int64_t id, const std::string& result_json) {
     // parse the result JSON and wrap it in the response structure
-    json result = json::parse(result_json, nullptr, false);
+    arena_json result = arena_json::parse(result_json, nullptr, false);
     if (result.is_discarded()) {
-        result = json::object();
+        result = arena_json::object();
     }
 
-    json response = {
+    arena_json response = {
         {"id", id},
-        {"result", result}
+        {"result", std::move(result)}
     };
-    return response.dump();
+    std::string out;
+    out.reserve(result_json.size() + 32);
+    append_json(out, response);
+    return out;
+}
+
+bool is_error_response(const std::string& response) {
+    static const std::string error_prefix = R"({"error":)";
+    // the hand-written parse error literal puts id first
+    static const std::string parse_error_prefix = R"({"id":null,"error":)";
+    return response.compare(0, error_prefix.size(), error_prefix) == 0 ||
+           response.compare(0, parse_error_prefix.size(), parse_error_prefix) == 0;
 }
 
 std::vector<std::string> split_node_path(const std::string& path) {
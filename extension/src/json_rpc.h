@@ -13,5 +13,9 @@ std::string make_error(int64_t id, int code, const std::string& message);
 // build a JSON-RPC success response wrapping a result JSON string
 std::string make_result(int64_t id, const std::string& result_json);
 
+// true if a response built by make_error (or the parse error literal) is an error.
+// relies on nlohmann sorting keys, so error responses always start with {"error":
+bool is_error_response(const std::string& response);
+
 // split a node path like "/root/Main/Player" into ["root", "Main", "Player"]
 std::vector<std::string> split_node_path(const std::string& path);
@@ -0,0 +1,63 @@
+#include "line_framer.h"
+
+#include <cstring>
+
+void LineFramer::append(const char* data, size_t len) {
+    if (overflow || len == 0) {
+        return;
+    }
+
+    // drop returned lines once they make up most of the buffer; amortised
+    // this moves each byte a bounded number of times
+    if (consumed > 0 && consumed >= buffer.size() - consumed) {
+        buffer.erase(0, consumed);
+        scanned -= consumed;
+        consumed = 0;
+    }
+
+    buffer.append(data, len);
+}
+
+bool LineFramer::next(std::string& message) {
+    if (overflow) {
+        return false;
+    }
+
+    const char* base = buffer.data();
+    size_t start = scanned > consumed ? scanned : consumed;
+    const void* nl = start < buffer.size()
+        ? std::memchr(base + start, '\n', buffer.size() - start)
+        : nullptr;
+
+    if (!nl) {
+        // remember how far we looked so the next call only scans new bytes
+        scanned = buffer.size();
+        if (buffer.size() - consumed > max_line) {
+            overflow = true;
+            buffer.clear();
+            consumed = 0;
+            scanned = 0;
+        }
+        return false;
+    }
+
+    size_t pos = static_cast<const char*>(nl) - base;
+    message.assign(base + consumed, pos - consumed);
+    consumed = pos + 1;
+    scanned = consumed;
+
+    if (consumed == buffer.size()) {
+        buffer.clear();
+        consumed = 0;
+        scanned = 0;
+    }
+    return true;
+}
+
+std::string LineFramer::take_buffered() {
+    std::string rest = buffer.substr(consumed);
+    buffer.clear();
+    consumed = 0;
+    scanned = 0;
+    return rest;
+}
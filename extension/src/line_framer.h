@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// newline-delimited message framing for one connection (no godot dependency).
+//
+// bytes are appended as they arrive and complete lines are pulled out one at
+// a time. the search for '\n' resumes where the previous one stopped and
+// consumed bytes are only compacted away once they outweigh what is left, so
+// a long line trickling in or a burst of tiny messages stays linear in the
+// input size.
+class LineFramer {
+public:
+    // longest line accepted before the connection is considered abusive
+    static constexpr size_t DEFAULT_MAX_LINE = 64u << 20;
+
+    explicit LineFramer(size_t max_line = DEFAULT_MAX_LINE) : max_line(max_line) {}
+
+    // add received bytes (may contain NULs and any number of newlines)
+    void append(const char* data, size_t len);
+
+    // pop the next complete line (without its '\n') into message.
+    // returns false once no complete line is buffered
+    bool next(std::string& message);
+
+    // true once a partial line has grown past max_line; the caller should
+    // drop the connection. no further lines are returned after this
+    bool overflowed() const { return overflow; }
+
+    // bytes buffered but not yet returned
+    size_t buffered() const { return buffer.size() - consumed; }
+
+    // remove and return everything not yet returned as a line (used when a
+    // connection switches to another framing mid-stream)
+    std::string take_buffered();
+
+private:
+    std::string buffer;
+    size_t consumed = 0;  // bytes at the front already returned as lines
+    size_t scanned = 0;   // bytes at the front known to hold no unreturned '\n'
+    size_t max_line;
+    bool overflow = false;
+};
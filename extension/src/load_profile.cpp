@@ -0,0 +1,192 @@
+#include "load_profile.h"
+
+#include <algorithm>
+#include <map>
+
+using json = nlohmann::json;
+
+int32_t LoadProfile::push(std::string_view path, bool threaded, int64_t now_us, std::vector<int32_t>& stack) {
+    if (log.size() >= max_records) {
+        dropped_count++;
+        return -1;
+    }
+    LoadRecord record;
+    record.path = std::string(path);
+    record.start_us = now_us;
+    record.threaded = threaded;
+    // an over-the-cap parent is -1 too, so depth comes from the stack
+    record.depth = static_cast<uint32_t>(stack.size());
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        if (*it >= 0) {
+            record.parent = *it;
+            break;
+        }
+    }
+    log.push_back(std::move(record));
+    child_us.push_back(0);
+    return static_cast<int32_t>(log.size() - 1);
+}
+
+int32_t LoadProfile::begin(std::string_view path, bool threaded, int64_t now_us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<int32_t>& stack = open_loads[std::this_thread::get_id()];
+    int32_t index = push(path, threaded, now_us, stack);
+    stack.push_back(index);
+    return index;
+}
+
+void LoadProfile::end(int32_t index, std::string_view type, int64_t size, bool ok, int64_t now_us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = open_loads.find(std::this_thread::get_id());
+    if (it != open_loads.end() && !it->second.empty()) {
+        it->second.pop_back();
+        if (it->second.empty()) {
+            open_loads.erase(it);
+        }
+    }
+    if (index < 0 || static_cast<size_t>(index) >= log.size()) {
+        return;
+    }
+    LoadRecord& record = log[static_cast<size_t>(index)];
+    record.type = std::string(type);
+    record.size = size;
+    record.failed = !ok;
+    record.open = false;
+    record.total_us = std::max<int64_t>(now_us - record.start_us, 0);
+    record.self_us = std::max<int64_t>(record.total_us - child_us[static_cast<size_t>(index)], 0);
+    if (record.parent >= 0) {
+        child_us[static_cast<size_t>(record.parent)] += record.total_us;
+    }
+}
+
+void LoadProfile::cache_hit(std::string_view path, int64_t now_us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<int32_t>& stack = open_loads[std::this_thread::get_id()];
+    int32_t index = push(path, false, now_us, stack);
+    if (stack.empty()) {
+        open_loads.erase(std::this_thread::get_id());
+    }
+    if (index >= 0) {
+        LoadRecord& record = log[static_cast<size_t>(index)];
+        record.cache_hit = true;
+        record.open = false;
+    }
+}
+
+std::vector<LoadRecord> LoadProfile::records() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return log;
+}
+
+uint64_t LoadProfile::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped_count;
+}
+
+std::string_view dependency_path(std::string_view entry) {
+    // path, path::type, uid::type::path (type possibly empty)
+    size_t first = entry.find("::");
+    if (first == std::string_view::npos) {
+        return entry;
+    }
+    size_t second = entry.find("::", first + 2);
+    if (second == std::string_view::npos || second + 2 == entry.size()) {
+        return entry.substr(0, first);
+    }
+    return entry.substr(second + 2);
+}
+
+// helper: microseconds as fractional milliseconds
+static double ms(int64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+json load_profile_json(const std::vector<LoadRecord>& records, uint64_t dropped, size_t limit, bool by_total) {
+    size_t loads = 0;
+    size_t cache_hits = 0;
+    size_t failed = 0;
+    size_t pending = 0;
+    int64_t first_us = 0;
+    int64_t last_us = 0;
+    int64_t self_us = 0;
+    std::map<std::string, std::pair<size_t, int64_t>> by_type;  // type -> (count, self)
+    std::vector<size_t> ranked;
+    std::vector<uint32_t> hits(records.size(), 0);  // cached dependencies per load
+    for (size_t i = 0; i < records.size(); i++) {
+        const LoadRecord& r = records[i];
+        if (r.cache_hit) {
+            cache_hits++;
+            if (r.parent >= 0) {
+                hits[static_cast<size_t>(r.parent)]++;
+            }
+            continue;
+        }
+        if (loads++ == 0 || r.start_us < first_us) {
+            first_us = r.start_us;
+        }
+        if (r.open) {
+            pending++;
+            continue;
+        }
+        if (r.failed) {
+            failed++;
+        }
+        last_us = std::max(last_us, r.start_us + r.total_us);
+        self_us += r.self_us;
+        auto& t = by_type[r.type.empty() ? "(failed)" : r.type];
+        t.first++;
+        t.second += r.self_us;
+        ranked.push_back(i);
+    }
+
+    auto cost = [&](size_t i) { return by_total ? records[i].total_us : records[i].self_us; };
+    size_t n = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(n), ranked.end(),
+                      [&](size_t a, size_t b) { return cost(a) != cost(b) ? cost(a) > cost(b) : a < b; });
+
+    json top = json::array();
+    for (size_t k = 0; k < n; k++) {
+        const LoadRecord& r = records[ranked[k]];
+        json chain = json::array();
+        for (int32_t p = r.parent; p >= 0; p = records[static_cast<size_t>(p)].parent) {
+            chain.push_back(records[static_cast<size_t>(p)].path);
+        }
+        std::reverse(chain.begin(), chain.end());
+        json entry = {
+            {"path", r.path},
+            {"type", r.type},
+            {"self_ms", ms(r.self_us)},
+            {"total_ms", ms(r.total_us)},
+            {"start_ms", ms(r.start_us - first_us)},
+            {"size", r.size},
+            {"threaded", r.threaded},
+            {"cache_hits", hits[ranked[k]]},
+            {"chain", std::move(chain)}
+        };
+        if (r.failed) {
+            entry["failed"] = true;
+        }
+        top.push_back(std::move(entry));
+    }
+
+    std::vector<std::pair<std::string, std::pair<size_t, int64_t>>> types(by_type.begin(), by_type.end());
+    std::stable_sort(types.begin(), types.end(),
+                     [](const auto& a, const auto& b) { return a.second.second > b.second.second; });
+    json type_list = json::array();
+    for (size_t i = 0; i < types.size() && i < limit; i++) {
+        type_list.push_back({{"type", types[i].first}, {"count", types[i].second.first},
+                             {"self_ms", ms(types[i].second.second)}});
+    }
+
+    return {
+        {"loads", loads},
+        {"cache_hits", cache_hits},
+        {"failed", failed},
+        {"pending", pending},
+        {"dropped", dropped},
+        {"wall_ms", ms(std::max<int64_t>(last_us - first_us, 0))},
+        {"self_ms", ms(self_us)},
+        {"by_type", std::move(type_list)},
+        {"top", std::move(top)}
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// per-resource load timings for one game run (no godot dependency).
+//
+// the profiling loader (profiling_loader.h) calls begin() when a load
+// reaches it and end() when it's done. loads that start while another is
+// open on the same thread are its dependencies: they get it as parent, and
+// their time is taken out of its self time. dependencies that were already
+// cached never reach a loader, so the parent reports them with cache_hit().
+// loads run on worker threads too, so everything is behind one mutex; a
+// load is a few hundred microseconds at best, so it's never contended in
+// practice.
+
+struct LoadRecord {
+    std::string path;
+    std::string type;           // class of the loaded resource, "" until it ends
+    int32_t parent = -1;        // index of the load that pulled it in
+    uint32_t depth = 0;
+    int64_t start_us = 0;
+    int64_t total_us = 0;       // including nested loads
+    int64_t self_us = 0;        // excluding them
+    int64_t size = -1;          // bytes of the file read (the imported one
+                                // for imported resources), -1 unknown
+    bool threaded = false;      // off the main thread or with sub-threads
+    bool cache_hit = false;     // already cached: no load happened
+    bool failed = false;
+    bool open = true;
+};
+
+// loads recorded before new ones are only counted
+constexpr size_t LOAD_PROFILE_MAX = 100000;
+
+class LoadProfile {
+public:
+    explicit LoadProfile(size_t max_records = LOAD_PROFILE_MAX) : max_records(max_records) {}
+
+    // returns the record's index, -1 when over the cap (pass it to end() all
+    // the same)
+    int32_t begin(std::string_view path, bool threaded, int64_t now_us);
+    void end(int32_t index, std::string_view type, int64_t size, bool ok, int64_t now_us);
+    // a dependency of the calling thread's open load that was already cached
+    void cache_hit(std::string_view path, int64_t now_us);
+
+    std::vector<LoadRecord> records() const;
+    uint64_t dropped() const;
+
+private:
+    int32_t push(std::string_view path, bool threaded, int64_t now_us, std::vector<int32_t>& stack);
+
+    size_t max_records;
+    mutable std::mutex mutex;
+    std::vector<LoadRecord> log;
+    std::vector<int64_t> child_us;      // nested time per record
+    std::unordered_map<std::thread::id, std::vector<int32_t>> open_loads;
+    uint64_t dropped_count = 0;
+};
+
+// "uid://abc::::res://a.png" / "res://a.png::Texture2D" -> "res://a.png":
+// the path in a ResourceLoader.get_dependencies() entry
+std::string_view dependency_path(std::string_view entry);
+
+// the report: totals, self time per type and the top loads by self (or
+// total) time, each with the chain of loads that triggered it, outermost
+// first
+nlohmann::json load_profile_json(const std::vector<LoadRecord>& records, uint64_t dropped, size_t limit,
+                                 bool by_total);
@@ -1,9 +1,18 @@
 #include "message_handler.h"
 #include "editor_control_finder.h"
 #include "debugger_plugin.h"
+#include "server_stats.h"
+#include "trace.h"
+#include "editor_serializers.h"
+#include "godot_views.h"
+#include "instance_registry.h"
+#include "output_archive.h"
+#include "text_transcode.h"
+#include "runtime_commands.h"
 
 #include <nlohmann/json.hpp>
 #include <godot_cpp/classes/editor_interface.hpp>
+#include <godot_cpp/classes/editor_inspector.hpp>
 #include <godot_cpp/classes/rich_text_label.hpp>
 #include <godot_cpp/classes/label.hpp>
 #include <godot_cpp/classes/tree.hpp>
@@ -17,92 +26,124 @@
 #include <godot_cpp/classes/viewport_texture.hpp>
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/classes/packet_peer_udp.hpp>
+#include <godot_cpp/classes/marshalls.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/variant/packed_int64_array.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/color.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
 // nlohmann::json lives in a versioned namespace, alias it for convenience
 using json = nlohmann::json;
 using namespace godot;
 
-std::string MessageHandler::handle(const std::string& message) {
-    // parse JSON without exceptions (godot-cpp disables exceptions)
-    json request = json::parse(message, nullptr, false);
+MessageHandler::MessageHandler() {
+    dispatcher.set_cache(&cache);
+    dispatcher.set_arena(&arena);
+    output_governor.set_max_lines(default_output_max_lines());
 
-    // check if parsing failed - parse returns discarded value on error
-    if (request.is_discarded()) {
-        return R"({"id":null,"error":{"code":-32700,"message":"Parse error"}})";
-    }
+    // adapters from member handlers to the dispatcher's (id, params_str) signature
+    auto no_params = [this](std::string (MessageHandler::*fn)(int64_t)) {
+        return [this, fn](int64_t id, const std::string&) { return (this->*fn)(id); };
+    };
+    auto with_params = [this](std::string (MessageHandler::*fn)(int64_t, const std::string&)) {
+        return [this, fn](int64_t id, const std::string& params_str) { return (this->*fn)(id, params_str); };
+    };
+    auto task = [this](RpcTask (MessageHandler::*fn)(int64_t, std::string, RpcContext&)) {
+        return [this, fn](int64_t id, std::string params_str, RpcContext& ctx) {
+            return (this->*fn)(id, std::move(params_str), ctx);
+        };
+    };
 
-    // extract the request id
-    int64_t id = 0;
-    if (request.contains("id")) {
-        if (request["id"].is_number_integer()) {
-            id = request["id"].get<int64_t>();
-        } else if (request["id"].is_number_float()) {
-            id = static_cast<int64_t>(request["id"].get<double>());
-        }
+    dispatcher.add("ping", no_params(&MessageHandler::handle_ping));
+    dispatcher.add("run_main_scene", with_params(&MessageHandler::handle_run_main_scene), CachePolicy::invalidates);
+    dispatcher.add("run_scene", with_params(&MessageHandler::handle_run_scene), CachePolicy::invalidates);
+    dispatcher.add("run_current_scene", with_params(&MessageHandler::handle_run_current_scene), CachePolicy::invalidates);
+    dispatcher.add("stop_scene", no_params(&MessageHandler::handle_stop_scene), CachePolicy::invalidates);
+    dispatcher.add("get_output", with_params(&MessageHandler::handle_get_output));
+    dispatcher.add("get_debugger_errors", no_params(&MessageHandler::handle_get_debugger_errors), CachePolicy::cached);
+    dispatcher.add("get_monitors", no_params(&MessageHandler::handle_get_monitors));
+    dispatcher.add("get_debugger_stack_trace", no_params(&MessageHandler::handle_get_debugger_stack_trace), CachePolicy::cached);
+    dispatcher.add("get_debugger_locals", no_params(&MessageHandler::handle_get_debugger_locals), CachePolicy::cached);
+    dispatcher.add_task("get_remote_scene_tree", task(&MessageHandler::handle_get_remote_scene_tree));
+    dispatcher.add_task("get_remote_node_properties", task(&MessageHandler::handle_get_remote_node_properties), CachePolicy::invalidates);
+    dispatcher.add("set_breakpoint", with_params(&MessageHandler::handle_set_breakpoint), CachePolicy::invalidates);
+    dispatcher.add("clear_breakpoints", no_params(&MessageHandler::handle_clear_breakpoints), CachePolicy::invalidates);
+    dispatcher.add("get_debugger_state", no_params(&MessageHandler::handle_get_debugger_state));
+    dispatcher.add("debug_continue", no_params(&MessageHandler::handle_debug_continue), CachePolicy::invalidates);
+    dispatcher.add_task("debug_step", task(&MessageHandler::handle_debug_step), CachePolicy::invalidates);
+    dispatcher.add("debug_break", no_params(&MessageHandler::handle_debug_break), CachePolicy::invalidates);
+    dispatcher.add_task("get_screenshot", task(&MessageHandler::handle_get_screenshot));
+    dispatcher.add("get_server_stats", with_params(&MessageHandler::handle_get_server_stats));
+    dispatcher.add("set_tracing", with_params(&MessageHandler::handle_set_tracing));
+    dispatcher.add("export_trace", with_params(&MessageHandler::handle_export_trace));
+    dispatcher.add("list_instances", no_params(&MessageHandler::handle_list_instances));
+    dispatcher.add("list_output_sessions", no_params(&MessageHandler::handle_list_output_sessions));
+    dispatcher.add("get_output_stats", with_params(&MessageHandler::handle_get_output_stats));
+    dispatcher.add("set_output_governor", with_params(&MessageHandler::handle_set_output_governor));
+
+    // priority lanes (request_lanes.h): stopping or breaking the game must
+    // not wait behind screenshots and tree dumps. everything else is
+    // interactive
+    for (const char* method : {"ping", "stop_scene", "debug_break", "debug_continue", "debug_step"}) {
+        dispatcher.set_lane(method, Lane::control);
+    }
+    for (const char* method : {"get_output", "get_remote_scene_tree", "get_remote_node_properties",
+                               "get_screenshot", "export_trace"}) {
+        dispatcher.set_lane(method, Lane::bulk);
     }
+}
 
-    // extract the method name
-    if (!request.contains("method") || !request["method"].is_string()) {
-        return make_error(id, -32600, "Invalid request: missing method");
-    }
-    std::string method = request["method"].get<std::string>();
-
-    // extract params as string (re-serialize for handlers to parse)
-    // this avoids passing json objects across the header boundary
-    std::string params_str = "{}";
-    if (request.contains("params") && request["params"].is_object()) {
-        params_str = request["params"].dump();
-    }
-
-    // route to the appropriate handler
-    if (method == "ping") {
-        return handle_ping(id);
-    } else if (method == "run_main_scene") {
-        return handle_run_main_scene(id, params_str);
-    } else if (method == "run_scene") {
-        return handle_run_scene(id, params_str);
-    } else if (method == "run_current_scene") {
-        return handle_run_current_scene(id, params_str);
-    } else if (method == "stop_scene") {
-        return handle_stop_scene(id);
-    } else if (method == "get_output") {
-        return handle_get_output(id, params_str);
-    } else if (method == "get_debugger_errors") {
-        return handle_get_debugger_errors(id);
-    } else if (method == "get_monitors") {
-        return handle_get_monitors(id);
-    } else if (method == "get_debugger_stack_trace") {
-        return handle_get_debugger_stack_trace(id);
-    } else if (method == "get_debugger_locals") {
-        return handle_get_debugger_locals(id);
-    } else if (method == "get_remote_scene_tree") {
-        return handle_get_remote_scene_tree(id);
-    } else if (method == "get_remote_node_properties") {
-        return handle_get_remote_node_properties(id, params_str);
-    } else if (method == "set_breakpoint") {
-        return handle_set_breakpoint(id, params_str);
-    } else if (method == "clear_breakpoints") {
-        return handle_clear_breakpoints(id);
-    } else if (method == "get_debugger_state") {
-        return handle_get_debugger_state(id);
-    } else if (method == "debug_continue") {
-        return handle_debug_continue(id);
-    } else if (method == "debug_step") {
-        return handle_debug_step(id, params_str);
-    } else if (method == "debug_break") {
-        return handle_debug_break(id);
-    } else if (method == "get_screenshot") {
-        return handle_get_screenshot(id, params_str);
-    } else {
-        return make_error(id, -32601, "Method not found: " + method);
-    }
+Lane MessageHandler::lane_of(const std::string& message) const {
+    return dispatcher.lane_of(message);
+}
+
+std::string MessageHandler::handle(const std::string& message, RpcContext* ctx) {
+    // parsing, routing and instrumentation live in the godot-free dispatcher
+    return dispatcher.handle(message, ctx);
+}
+
+void MessageHandler::set_server_stats(ServerStats* stats) {
+    server_stats = stats;
+    dispatcher.set_stats(stats);
+    encoder.set_stats(stats);
+}
+
+std::string MessageHandler::respond(int64_t id, const json& result) {
+    return encoder.encode(id, result, dispatcher.context());
+}
+
+std::string MessageHandler::respond(int64_t id, const arena_json& result) {
+    return encoder.encode(id, result, dispatcher.context());
+}
+
+std::string MessageHandler::respond(int64_t id, const json& result, RpcContext& ctx) {
+    return encoder.encode(id, result, &ctx);
+}
+
+void MessageHandler::process_frame() {
+    frames.tick();
+    dispatcher.finish_tasks();
 }
 
 std::string MessageHandler::handle_ping(int64_t id) {
-    return make_result(id, R"({"status":"ok"})");
+    return respond(id, arena_json{{"status", "ok"}});
+}
+
+// helper: games inherit the editor's environment. only a run_scene that asks
+// for profile_loads exports PROFILE_LOADS_ENV; every other launch clears it
+static void export_load_profiling(bool on) {
+    if (on) {
+        OS::get_singleton()->set_environment(PROFILE_LOADS_ENV, "1");
+    } else {
+        OS::get_singleton()->unset_environment(PROFILE_LOADS_ENV);
+    }
 }
 
 std::string MessageHandler::handle_run_main_scene(int64_t id, const std::string& params_str) {
@@ -116,15 +157,16 @@ std::string MessageHandler::handle_run_main_scene(int64_t id, const std::string&
         return make_error(id, -32000, "A scene is already running. Stop it first with stop_scene.");
     }
 
+    export_load_profiling(false);
     editor->play_main_scene();
     schedule_auto_stop(params_str);
 
-    return make_result(id, R"({"success":true,"action":"run_main_scene"})");
+    return respond(id, arena_json{{"success", true}, {"action", "run_main_scene"}});
 }
 
 std::string MessageHandler::handle_run_scene(int64_t id, const std::string& params_str) {
     // parse params to get scene_path
-    json params = json::parse(params_str, nullptr, false);
+    arena_json params = arena_json::parse(params_str, nullptr, false);
     if (params.is_discarded()) {
         return make_error(id, -32602, "Invalid params");
     }
@@ -133,6 +175,8 @@ std::string MessageHandler::handle_run_scene(int64_t id, const std::string& para
         return make_error(id, -32602, "Missing required param: scene_path");
     }
     std::string scene_path = params["scene_path"].get<std::string>();
+    bool profile_loads = params.contains("profile_loads") && params["profile_loads"].is_boolean() &&
+                         params["profile_loads"].get<bool>();
 
     EditorInterface* editor = EditorInterface::get_singleton();
     if (!editor) {
@@ -144,16 +188,18 @@ std::string MessageHandler::handle_run_scene(int64_t id, const std::string& para
         return make_error(id, -32000, "A scene is already running. Stop it first with stop_scene.");
     }
 
+    export_load_profiling(profile_loads);
     editor->play_custom_scene(String(scene_path.c_str()));
     schedule_auto_stop(params_str);
 
     // build result with scene_path included
-    json result = {
+    arena_json result = {
         {"success", true},
         {"action", "run_scene"},
-        {"scene_path", scene_path}
+        {"scene_path", scene_path},
+        {"profile_loads", profile_loads}
     };
-    return make_result(id, result.dump());
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_run_current_scene(int64_t id, const std::string& params_str) {
@@ -167,10 +213,11 @@ std::string MessageHandler::handle_run_current_scene(int64_t id, const std::stri
         return make_error(id, -32000, "A scene is already running. Stop it first with stop_scene.");
     }
 
+    export_load_profiling(false);
     editor->play_current_scene();
     schedule_auto_stop(params_str);
 
-    return make_result(id, R"({"success":true,"action":"run_current_scene"})");
+    return respond(id, arena_json{{"success", true}, {"action", "run_current_scene"}});
 }
 
 std::string MessageHandler::handle_stop_scene(int64_t id) {
@@ -181,7 +228,7 @@ std::string MessageHandler::handle_stop_scene(int64_t id) {
 
     editor->stop_playing_scene();
 
-    return make_result(id, R"({"success":true,"action":"stop_scene"})");
+    return respond(id, arena_json{{"success", true}, {"action", "stop_scene"}});
 }
 
 void MessageHandler::schedule_auto_stop(const std::string& params_str) {
@@ -190,7 +237,7 @@ void MessageHandler::schedule_auto_stop(const std::string& params_str) {
     }
 
     // parse params to extract timeout_seconds
-    json params = json::parse(params_str, nullptr, false);
+    arena_json params = arena_json::parse(params_str, nullptr, false);
     double timeout = 0.0;
 
     if (!params.is_discarded() &&
@@ -215,9 +262,17 @@ std::string MessageHandler::handle_get_output(int64_t id, const std::string& par
     }
 
     // parse params to get new_only and clear flags
-    json params = json::parse(params_str, nullptr, false);
+    arena_json params = arena_json::parse(params_str, nullptr, false);
     bool new_only = false;
     bool clear = false;
+    if (params.is_object()) {
+        // any range parameter reads the archive instead of the panel
+        for (const char* key : {"session", "from_seq", "to_seq", "since", "until", "limit", "level"}) {
+            if (params.contains(key)) {
+                return query_output_archive(id, params);
+            }
+        }
+    }
     if (!params.is_discarded()) {
         if (params.contains("new_only") && params["new_only"].is_boolean()) {
             new_only = params["new_only"].get<bool>();
@@ -247,15 +302,13 @@ std::string MessageHandler::handle_get_output(int64_t id, const std::string& par
         control_finder->last_output_length = full_length;
     }
 
-    // convert godot String to std::string for JSON
-    std::string output_str = output_text.utf8().get_data();
-
-    json result = {
-        {"output", output_str},
+    // the output can be megabytes: transcode it from the String's buffer
+    // straight into the response instead of through a CharString and the DOM
+    arena_json result = {
         {"length", static_cast<int64_t>(output_text.length())},
         {"total_length", full_length}
     };
-    return make_result(id, result.dump());
+    return encoder.encode_text(id, result, "output", utf32_view(output_text), dispatcher.context());
 }
 
 std::string MessageHandler::handle_get_debugger_errors(int64_t id) {
@@ -268,54 +321,13 @@ std::string MessageHandler::handle_get_debugger_errors(int64_t id) {
         return make_error(id, -32000, "Debugger Errors tree not found");
     }
 
-    std::string errors = get_tree_text(tree);
+    std::string errors = tree_text(GodotTreeView(tree));
 
-    json result = {
-        {"errors", errors},
-        {"length", static_cast<int64_t>(errors.length())}
+    arena_json result = {
+        {"length", static_cast<int64_t>(errors.length())},
+        {"errors", std::move(errors)}
     };
-    return make_result(id, result.dump());
-}
-
-std::string MessageHandler::get_tree_text(Tree* tree) {
-    TreeItem* root = tree->get_root();
-    if (!root) {
-        return "";
-    }
-    return get_tree_item_text(root, 0);
-}
-
-std::string MessageHandler::get_tree_item_text(TreeItem* item, int depth) {
-    std::string result;
-    std::string indent(depth * 2, ' ');  // 2 spaces per depth level
-
-    // get text from all columns, join with " | "
-    Tree* tree = item->get_tree();
-    int col_count = tree->get_columns();
-    std::string line;
-
-    for (int col = 0; col < col_count; col++) {
-        String text = item->get_text(col);
-        if (text.length() > 0) {
-            if (!line.empty()) {
-                line += " | ";
-            }
-            line += text.utf8().get_data();
-        }
-    }
-
-    if (!line.empty()) {
-        result += indent + line + "\n";
-    }
-
-    // recurse into children
-    TreeItem* child = item->get_first_child();
-    while (child) {
-        result += get_tree_item_text(child, depth + 1);
-        child = child->get_next();
-    }
-
-    return result;
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_get_monitors(int64_t id) {
@@ -328,50 +340,14 @@ std::string MessageHandler::handle_get_monitors(int64_t id) {
         return make_error(id, -32000, "Monitors tree not found");
     }
 
-    TreeItem* root = tree->get_root();
-    if (!root) {
-        // empty tree - return empty monitors array
-        json result = {
-            {"monitors", json::array()},
-            {"count", 0}
-        };
-        return make_result(id, result.dump());
-    }
-
-    // monitors tree structure: root -> groups (Time, Memory, etc) -> metrics
-    // each metric has name in col 0, value in col 1
-    json monitors = json::array();
-
-    TreeItem* group = root->get_first_child();
-    while (group) {
-        String group_name_gd = group->get_text(0);
-        std::string group_name = group_name_gd.utf8().get_data();
-
-        json metrics = json::array();
-        TreeItem* metric = group->get_first_child();
-        while (metric) {
-            String name_gd = metric->get_text(0);
-            String value_gd = metric->get_text(1);
-            metrics.push_back({
-                {"name", std::string(name_gd.utf8().get_data())},
-                {"value", std::string(value_gd.utf8().get_data())}
-            });
-            metric = metric->get_next();
-        }
-
-        monitors.push_back({
-            {"group", group_name},
-            {"metrics", metrics}
-        });
-
-        group = group->get_next();
-    }
+    // empty tree gives an empty monitors array
+    json monitors = monitors_json(GodotTreeView(tree));
 
     json result = {
         {"monitors", monitors},
         {"count", static_cast<int64_t>(monitors.size())}
     };
-    return make_result(id, result.dump());
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_get_debugger_stack_trace(int64_t id) {
@@ -383,13 +359,11 @@ std::string MessageHandler::handle_get_debugger_stack_trace(int64_t id) {
     std::string error_msg;
     RichTextLabel* rtl = control_finder->get_stack_trace_label();
     if (rtl) {
-        String text = rtl->get_parsed_text();
-        error_msg = text.utf8().get_data();
+        error_msg = utf32_to_utf8(utf32_view(rtl->get_parsed_text()));
     } else {
         Label* lbl = control_finder->get_stack_trace_label_44();
         if (lbl) {
-            String text = lbl->get_text();
-            error_msg = text.utf8().get_data();
+            error_msg = utf32_to_utf8(utf32_view(lbl->get_text()));
         }
     }
 
@@ -397,7 +371,7 @@ std::string MessageHandler::handle_get_debugger_stack_trace(int64_t id) {
     std::string frames;
     Tree* tree = control_finder->get_stack_frames_tree();
     if (tree) {
-        frames = get_tree_text(tree);
+        frames = tree_text(GodotTreeView(tree));
     }
 
     // require at least one control to be found
@@ -417,165 +391,11 @@ std::string MessageHandler::handle_get_debugger_stack_trace(int64_t id) {
         combined += frames;
     }
 
-    json result = {
-        {"stack_trace", combined},
-        {"length", static_cast<int64_t>(combined.length())}
+    arena_json result = {
+        {"length", static_cast<int64_t>(combined.length())},
+        {"stack_trace", std::move(combined)}
     };
-    return make_result(id, result.dump());
-}
-
-// helper: recursively find all descendants matching a class name
-static std::vector<Node*> find_children_by_class(Node* root, const char* class_name) {
-    std::vector<Node*> results;
-
-    int child_count = root->get_child_count();
-    for (int i = 0; i < child_count; i++) {
-        Node* child = root->get_child(i);
-        if (child->is_class(class_name)) {
-            results.push_back(child);
-        }
-        // recurse into children
-        auto nested = find_children_by_class(child, class_name);
-        results.insert(results.end(), nested.begin(), nested.end());
-    }
-
-    return results;
-}
-
-// helper: extract value from an EditorProperty* node based on its type
-static std::string extract_property_value(Node* node, const std::string& cls) {
-    // EditorPropertyNil
-    if (cls == "EditorPropertyNil") {
-        return "null";
-    }
-
-    // EditorPropertyInteger, EditorPropertyFloat -> find EditorSpinSlider
-    if (cls == "EditorPropertyInteger" || cls == "EditorPropertyFloat") {
-        auto sliders = find_children_by_class(node, "EditorSpinSlider");
-        if (!sliders.empty() && sliders[0]->has_method("get_value")) {
-            Variant val = sliders[0]->call("get_value");
-            return String(val).utf8().get_data();
-        }
-    }
-
-    // EditorPropertyText -> find LineEdit
-    if (cls == "EditorPropertyText") {
-        auto edits = find_children_by_class(node, "LineEdit");
-        if (!edits.empty()) {
-            LineEdit* le = Object::cast_to<LineEdit>(edits[0]);
-            if (le) {
-                return le->get_text().utf8().get_data();
-            }
-        }
-    }
-
-    // EditorPropertyCheck -> find CheckBox
-    if (cls == "EditorPropertyCheck") {
-        auto boxes = find_children_by_class(node, "CheckBox");
-        if (!boxes.empty()) {
-            CheckBox* cb = Object::cast_to<CheckBox>(boxes[0]);
-            if (cb) {
-                return cb->is_pressed() ? "true" : "false";
-            }
-        }
-    }
-
-    // EditorPropertyVector2/3/4 -> find multiple EditorSpinSliders
-    if (cls.find("EditorPropertyVector") == 0) {
-        auto sliders = find_children_by_class(node, "EditorSpinSlider");
-        if (!sliders.empty()) {
-            std::string result = "(";
-            for (size_t i = 0; i < sliders.size(); i++) {
-                if (i > 0) result += ", ";
-                if (sliders[i]->has_method("get_value")) {
-                    Variant val = sliders[i]->call("get_value");
-                    result += String(val).utf8().get_data();
-                }
-            }
-            result += ")";
-            return result;
-        }
-    }
-
-    // EditorPropertyObjectID, EditorPropertyArray -> find Button text
-    if (cls == "EditorPropertyObjectID" || cls == "EditorPropertyArray") {
-        auto buttons = find_children_by_class(node, "Button");
-        if (!buttons.empty()) {
-            Button* btn = Object::cast_to<Button>(buttons[0]);
-            if (btn) {
-                return btn->get_text().utf8().get_data();
-            }
-        }
-    }
-
-    // fallback: try to find LineEdit, Label (with different text), or Button
-    auto line_edits = find_children_by_class(node, "LineEdit");
-    if (!line_edits.empty()) {
-        LineEdit* le = Object::cast_to<LineEdit>(line_edits[0]);
-        if (le) {
-            return le->get_text().utf8().get_data();
-        }
-    }
-
-    auto buttons = find_children_by_class(node, "Button");
-    if (!buttons.empty()) {
-        Button* btn = Object::cast_to<Button>(buttons[0]);
-        if (btn) {
-            return btn->get_text().utf8().get_data();
-        }
-    }
-
-    return "";
-}
-
-// helper: recursively collect EditorProperty* nodes and extract name/value
-static void collect_editor_properties(Node* node, json& properties) {
-    String class_name = node->get_class();
-    std::string cls = class_name.utf8().get_data();
-
-    // check if this is an EditorProperty* subclass
-    if (cls.rfind("EditorProperty", 0) == 0) {
-        std::string prop_name;
-        std::string prop_value;
-
-        // try to get label via get_label() method (EditorProperty has this)
-        if (node->has_method("get_label")) {
-            String label = node->call("get_label");
-            prop_name = label.utf8().get_data();
-        }
-
-        // fallback: look for Label child with property name
-        if (prop_name.empty()) {
-            auto labels = find_children_by_class(node, "Label");
-            for (Node* lbl_node : labels) {
-                Label* lbl = Object::cast_to<Label>(lbl_node);
-                if (lbl) {
-                    String text = lbl->get_text();
-                    if (text.length() > 0) {
-                        prop_name = text.utf8().get_data();
-                        break;
-                    }
-                }
-            }
-        }
-
-        // extract value based on type
-        prop_value = extract_property_value(node, cls);
-
-        if (!prop_name.empty()) {
-            properties.push_back({
-                {"name", prop_name},
-                {"value", prop_value},
-                {"type", cls}
-            });
-        }
-    }
-
-    // recurse into children
-    int count = node->get_child_count();
-    for (int i = 0; i < count; i++) {
-        collect_editor_properties(node->get_child(i), properties);
-    }
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_get_debugger_locals(int64_t id) {
@@ -591,149 +411,73 @@ std::string MessageHandler::handle_get_debugger_locals(int64_t id) {
     // extract properties from inspector
     // note: frame_index selection not implemented yet (would require async handling)
     json locals = json::array();
-    collect_editor_properties(inspector, locals);
+    {
+        PEEK_TRACE_SCOPE("collect_editor_properties");
+        collect_editor_properties(GodotNodeView(), inspector, locals);
+    }
 
     json result = {
         {"locals", locals},
         {"count", static_cast<int64_t>(locals.size())},
         {"frame_index", -1}
     };
-    return make_result(id, result.dump());
+    return respond(id, result);
 }
 
-// helper: extract scene tree text with type info from tooltips
-static std::string get_scene_tree_item_text(TreeItem* item, int depth) {
-    std::string result;
-    std::string indent(depth * 2, ' ');
-
-    // get node name from column 0
-    String node_name = item->get_text(0);
-    if (node_name.length() > 0) {
-        std::string name_str = node_name.utf8().get_data();
-
-        // try to get node type from tooltip
-        String tooltip = item->get_tooltip_text(0);
-        std::string type_str;
-        if (tooltip.length() > 0) {
-            // tooltip often contains "NodeName (Type)" or type info
-            std::string tt = tooltip.utf8().get_data();
-            size_t paren_pos = tt.find('(');
-            if (paren_pos != std::string::npos) {
-                size_t end_paren = tt.find(')', paren_pos);
-                if (end_paren != std::string::npos) {
-                    type_str = tt.substr(paren_pos + 1, end_paren - paren_pos - 1);
-                }
-            }
-        }
-
-        // build output line: "  NodeName (Type)" or just "  NodeName"
-        result += indent + name_str;
-        if (!type_str.empty()) {
-            result += " (" + type_str + ")";
-        }
-        result += "\n";
-    }
-
-    // recurse into children
-    TreeItem* child = item->get_first_child();
-    while (child) {
-        result += get_scene_tree_item_text(child, depth + 1);
-        child = child->get_next();
-    }
-
-    return result;
+// helper: the remote tree has been filled in by the debugger
+static bool has_content(Tree* tree) {
+    TreeItem* root = tree ? tree->get_root() : nullptr;
+    return root && root->get_child_count() > 0;
 }
 
-std::string MessageHandler::handle_get_remote_scene_tree(int64_t id) {
+RpcTask MessageHandler::handle_get_remote_scene_tree(int64_t id, std::string, RpcContext& ctx) {
     if (!control_finder) {
-        return make_error(id, -32000, "Control finder not initialized");
+        co_return make_error(id, -32000, "Control finder not initialized");
     }
 
     // try without clicking first
     Tree* tree = control_finder->get_remote_scene_tree(false);
-    TreeItem* root = tree ? tree->get_root() : nullptr;
-    bool has_content = root && root->get_child_count() > 0;
+    bool populated = has_content(tree);
 
-    // if empty, click Remote button
-    // note: tree won't populate until next frame, caller should retry
-    bool clicked_button = false;
-    if (!has_content) {
+    // if empty, click Remote button. the debugger fills the tree in over the
+    // next few frames; wait for it here instead of making the caller retry
+    if (!populated) {
         control_finder->get_remote_scene_tree(true);
-        clicked_button = true;
-
-        // re-check tree after click (might already have content if Remote was selected)
+        populated = co_await frames.until([this] {
+            return has_content(control_finder->get_remote_scene_tree(false));
+        }, REMOTE_TREE_WAIT_MS);
+        // widgets may have been rebuilt while we waited
         tree = control_finder->get_remote_scene_tree(false);
-        root = tree ? tree->get_root() : nullptr;
-        has_content = root && root->get_child_count() > 0;
     }
 
     if (!tree) {
-        return make_error(id, -32000, "Remote scene tree not found (is game running?)");
+        co_return make_error(id, -32000, "Remote scene tree not found (is game running?)");
     }
 
-    // if we clicked the button but tree is still empty, tell caller to retry
-    if (!has_content && clicked_button) {
+    // still empty after waiting: old clients know to retry on pending
+    if (!populated) {
         json result = {
             {"tree", ""},
             {"length", 0},
             {"pending", true},
-            {"message", "Remote button clicked, retry in ~100ms to get tree data"}
+            {"message", "Remote tree still populating, retry shortly"}
         };
-        return make_result(id, result.dump());
-    }
-
-    if (!root || !has_content) {
-        return make_error(id, -32000, "Remote scene tree is empty (is game running?)");
+        co_return respond(id, result, ctx);
     }
 
     // extract tree with type info
-    std::string tree_text = get_scene_tree_item_text(root, 0);
+    std::string text = scene_tree_text(GodotTreeView(tree));
 
     json result = {
-        {"tree", tree_text},
-        {"length", static_cast<int64_t>(tree_text.length())},
+        {"tree", text},
+        {"length", static_cast<int64_t>(text.length())},
         {"pending", false}
     };
-    return make_result(id, result.dump());
+    co_return respond(id, result, ctx);
 }
 
 // split_node_path is now a free function in json_rpc.h/cpp
 
-TreeItem* MessageHandler::find_tree_item_by_path(TreeItem* root, const std::vector<std::string>& path_parts) {
-    if (path_parts.empty()) {
-        return root;
-    }
-
-    TreeItem* current = root;
-    size_t start_idx = 0;
-
-    // if first part matches root's text, skip it
-    String root_text = root->get_text(0);
-    if (!path_parts.empty() && path_parts[0] == root_text.utf8().get_data()) {
-        start_idx = 1;
-    }
-
-    // navigate through remaining parts
-    for (size_t i = start_idx; i < path_parts.size(); i++) {
-        bool found = false;
-        TreeItem* child = current->get_first_child();
-        while (child) {
-            String child_text = child->get_text(0);
-            if (path_parts[i] == child_text.utf8().get_data()) {
-                current = child;
-                found = true;
-                break;
-            }
-            child = child->get_next();
-        }
-        if (!found) {
-            return nullptr;
-        }
-    }
-
-    return current;
-}
-
 bool MessageHandler::trigger_remote_inspection(Tree* tree, TreeItem* item) {
     // get object_id from metadata (column 0)
     Variant meta = item->get_metadata(0);
@@ -761,94 +505,100 @@ bool MessageHandler::trigger_remote_inspection(Tree* tree, TreeItem* item) {
     return true;
 }
 
-std::string MessageHandler::handle_get_remote_node_properties(int64_t id, const std::string& params_str) {
+// helper: instance id of what the inspector shows, 0 for nothing
+static uint64_t inspected_object(Control* inspector) {
+    EditorInspector* ei = Object::cast_to<EditorInspector>(inspector);
+    Object* edited = ei ? ei->get_edited_object() : nullptr;
+    return edited ? static_cast<uint64_t>(edited->get_instance_id()) : 0;
+}
+
+RpcTask MessageHandler::handle_get_remote_node_properties(int64_t id, std::string params_str, RpcContext& ctx) {
     if (!control_finder) {
-        return make_error(id, -32000, "Control finder not initialized");
+        co_return make_error(id, -32000, "Control finder not initialized");
     }
 
     // parse node_path from params
     json params = json::parse(params_str, nullptr, false);
     if (params.is_discarded() || !params.contains("node_path") || !params["node_path"].is_string()) {
-        return make_error(id, -32602, "Missing required param: node_path");
+        co_return make_error(id, -32602, "Missing required param: node_path");
     }
     std::string node_path = params["node_path"].get<std::string>();
 
-    // ensure remote tree exists (click Remote button if needed)
+    // pending results are only left for when a wait below times out
+    json pending = {
+        {"node_path", node_path},
+        {"properties", json::array()},
+        {"count", 0},
+        {"pending", true}
+    };
+
+    // ensure remote tree exists (click Remote button if needed) and wait for
+    // the debugger to populate it
     Tree* tree = control_finder->get_remote_scene_tree(true);
     if (!tree) {
-        return make_error(id, -32000, "Remote scene tree not found (is game running?)");
+        co_return make_error(id, -32000, "Remote scene tree not found (is game running?)");
     }
-
-    TreeItem* root = tree->get_root();
-    if (!root || root->get_child_count() == 0) {
-        // tree not populated yet - return pending
-        json result = {
-            {"node_path", node_path},
-            {"properties", json::array()},
-            {"count", 0},
-            {"pending", true},
-            {"message", "Remote tree populating, retry in ~200ms"}
-        };
-        return make_result(id, result.dump());
+    if (!has_content(tree)) {
+        bool populated = co_await frames.until([this] {
+            return has_content(control_finder->get_remote_scene_tree(false));
+        }, REMOTE_TREE_WAIT_MS);
+        tree = control_finder->get_remote_scene_tree(false);
+        if (!populated || !tree) {
+            pending["message"] = "Remote tree still populating, retry shortly";
+            ctx.no_cache = true;
+            co_return respond(id, pending, ctx);
+        }
     }
 
     // find main inspector
-    Control* inspector = control_finder->get_main_inspector();
-    if (!inspector) {
-        return make_error(id, -32000, "Main inspector not found");
+    if (!control_finder->get_main_inspector()) {
+        co_return make_error(id, -32000, "Main inspector not found");
     }
 
     // parse path and find target node
     auto path_parts = split_node_path(node_path);
-    TreeItem* target = find_tree_item_by_path(root, path_parts);
+    TreeItem* target = GodotTreeView::item(find_item_by_path(GodotTreeView(tree), tree->get_root(), path_parts));
     if (!target) {
-        return make_error(id, -32000, "Node not found in remote tree: " + node_path);
+        co_return make_error(id, -32000, "Node not found in remote tree: " + node_path);
     }
 
-    // check if this node is already selected in the tree
-    // if so, don't re-trigger (this allows retry to work)
-    TreeItem* selected = tree->get_selected();
-    bool already_selected = (selected == target);
-
-    if (!already_selected) {
-        // trigger inspection (select + emit signal)
+    // select it unless it already is. the game sends the object back over
+    // the debugger connection and the inspector switches to it a few
+    // frames later; until then it still shows the previous selection
+    if (tree->get_selected() != target) {
+        uint64_t before = inspected_object(control_finder->get_main_inspector());
         trigger_remote_inspection(tree, target);
-
-        // return pending - caller should retry after delay
-        json result = {
-            {"node_path", node_path},
-            {"properties", json::array()},
-            {"count", 0},
-            {"pending", true},
-            {"message", "Inspection triggered, retry in ~300ms"}
-        };
-        return make_result(id, result.dump());
+        co_await frames.until([this, before] {
+            return inspected_object(control_finder->get_main_inspector()) != before;
+        }, INSPECTOR_WAIT_MS);
     }
 
-    // node is already selected, inspector should be populated
+    // then for its properties to be laid out
     json props = json::array();
-    collect_editor_properties(inspector, props);
+    bool ready = co_await frames.until([this, &props] {
+        Control* inspector = control_finder->get_main_inspector();
+        if (!inspector) {
+            return false;
+        }
+        PEEK_TRACE_SCOPE("collect_editor_properties");
+        props = json::array();
+        collect_editor_properties(GodotNodeView(), inspector, props);
+        return !props.empty();
+    }, INSPECTOR_WAIT_MS);
 
-    if (props.empty()) {
-        // still no properties - maybe inspector not ready yet, try one more time
-        json result = {
-            {"node_path", node_path},
-            {"properties", json::array()},
-            {"count", 0},
-            {"pending", true},
-            {"message", "Inspector may still be loading, retry in ~300ms"}
-        };
-        return make_result(id, result.dump());
+    if (!ready) {
+        pending["message"] = "Inspector still loading, retry shortly";
+        ctx.no_cache = true;
+        co_return respond(id, pending, ctx);
     }
 
-    // have properties - return them
     json result = {
         {"node_path", node_path},
         {"properties", props},
         {"count", static_cast<int64_t>(props.size())},
         {"pending", false}
     };
-    return make_result(id, result.dump());
+    co_return respond(id, result, ctx);
 }
 
 // ============================================================================
@@ -860,7 +610,7 @@ std::string MessageHandler::handle_set_breakpoint(int64_t id, const std::string&
         return make_error(id, -32000, "Debugger plugin not initialized");
     }
 
-    json params = json::parse(params_str, nullptr, false);
+    arena_json params = arena_json::parse(params_str, nullptr, false);
     if (params.is_discarded()) {
         return make_error(id, -32602, "Invalid params");
     }
@@ -878,13 +628,13 @@ std::string MessageHandler::handle_set_breakpoint(int64_t id, const std::string&
 
     debugger_plugin->set_breakpoint(String(path.c_str()), line, enabled);
 
-    json result = {
+    arena_json result = {
         {"success", true},
         {"path", path},
         {"line", line},
         {"enabled", enabled}
     };
-    return make_result(id, result.dump());
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_clear_breakpoints(int64_t id) {
@@ -894,8 +644,8 @@ std::string MessageHandler::handle_clear_breakpoints(int64_t id) {
 
     debugger_plugin->clear_all_breakpoints();
 
-    json result = {{"success", true}};
-    return make_result(id, result.dump());
+    arena_json result = {{"success", true}};
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_get_debugger_state(int64_t id) {
@@ -910,13 +660,13 @@ std::string MessageHandler::handle_get_debugger_state(int64_t id) {
         is_playing = editor->is_playing_scene();
     }
 
-    json result = {
+    arena_json result = {
         {"paused", debugger_plugin->is_paused()},
         {"active", debugger_plugin->is_session_active()},
         {"debuggable", debugger_plugin->is_debuggable()},
         {"is_playing", is_playing}
     };
-    return make_result(id, result.dump());
+    return respond(id, result);
 }
 
 std::string MessageHandler::handle_debug_continue(int64_t id) {
@@ -926,13 +676,13 @@ std::string MessageHandler::handle_debug_continue(int64_t id) {
 
     debugger_plugin->continue_execution();
 
-    json result = {{"success", true}};
-    return make_result(id, result.dump());
+    arena_json result = {{"success", true}};
+    return respond(id, result);
 }
 
-std::string MessageHandler::handle_debug_step(int64_t id, const std::string& params_str) {
+RpcTask MessageHandler::handle_debug_step(int64_t id, std::string params_str, RpcContext& ctx) {
     if (!debugger_plugin) {
-        return make_error(id, -32000, "Debugger plugin not initialized");
+        co_return make_error(id, -32000, "Debugger plugin not initialized");
     }
 
     json params = json::parse(params_str, nullptr, false);
@@ -948,14 +698,19 @@ std::string MessageHandler::handle_debug_step(int64_t id, const std::string& par
     } else if (mode == "out") {
         debugger_plugin->step_out();
     } else {
-        return make_error(id, -32602, "Invalid mode: " + mode + " (expected: into, over, out)");
+        co_return make_error(id, -32602, "Invalid mode: " + mode + " (expected: into, over, out)");
     }
 
+    // answer once the game has stopped on the next line, so a following
+    // stack trace or locals request sees the new position
+    bool paused = co_await frames.signal(debugger_plugin->break_signal(), STEP_WAIT_MS);
+
     json result = {
         {"success", true},
-        {"mode", mode}
+        {"mode", mode},
+        {"paused", paused}
     };
-    return make_result(id, result.dump());
+    co_return respond(id, result, ctx);
 }
 
 std::string MessageHandler::handle_debug_break(int64_t id) {
@@ -965,15 +720,461 @@ std::string MessageHandler::handle_debug_break(int64_t id) {
 
     debugger_plugin->request_break();
 
-    json result = {{"success", true}};
-    return make_result(id, result.dump());
+    arena_json result = {{"success", true}};
+    return respond(id, result);
+}
+
+// ============================================================================
+// discovery handlers
+// ============================================================================
+
+std::string MessageHandler::handle_list_instances(int64_t id) {
+    // every live editor in the registry, this one included; listing also
+    // prunes entries left behind by editors that died
+    InstanceRegistry registry;
+    json instances = json::array();
+    for (const InstanceInfo& info : registry.list()) {
+        instances.push_back(instance_json(info));
+    }
+
+    json result = {
+        {"pid", static_cast<int64_t>(OS::get_singleton()->get_process_id())},
+        {"registry", registry.directory()},
+        {"instances", instances}
+    };
+    return respond(id, result);
+}
+
+// ============================================================================
+// output archive
+// ============================================================================
+
+bool MessageHandler::begin_output_session() {
+    if (!output_archive) {
+        return false;
+    }
+    // lines still unarchived belong to the session that printed them
+    archive_output(true);
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    output_columns.clear();
+    last_output_level = OutputLevel::print;
+    output_session_start_ns = stats_now_ns();
+    return output_archive->begin_session(now_ms);
+}
+
+void MessageHandler::archive_output(bool force) {
+    if (!output_archive || !control_finder || output_archive->current_session() == 0) {
+        return;
+    }
+    uint64_t now = stats_now_ns() / 1000000;
+    if (!force && now - last_archive_ms < ARCHIVE_CAPTURE_MS) {
+        return;
+    }
+    last_archive_ms = now;
+
+    RichTextLabel* output = control_finder->get_output_panel();
+    if (!output) {
+        return;
+    }
+    // every message ends its own paragraph: while the count stands still
+    // there is nothing new to read
+    int64_t paragraphs = output->get_paragraph_count();
+    if (paragraphs == archived_paragraphs) {
+        return;
+    }
+
+    String text = output->get_parsed_text();
+    std::u32string_view view = utf32_view(text);
+    if (!archived_tail_in_place(view)) {
+        // EditorLog rebuilds the label from its own message list when a
+        // filter, the search or collapsing changes: trimmed lines come back
+        // and every offset moves. the archived tail found elsewhere marks
+        // such a rebuild, and only what follows it is new. without it the
+        // panel was cleared (and maybe refilled since the last capture)
+        size_t at = view.rfind(archived_tail);
+        if (at != std::u32string_view::npos) {
+            archived_length = static_cast<int64_t>(at + archived_tail.size());
+            archived_tail_end = archived_length;
+        } else {
+            archived_length = 0;
+            archived_tail.clear();
+        }
+    }
+    archived_paragraphs = paragraphs;
+
+    // whole lines only; one still being written waits for its newline
+    int64_t end = text.rfind("\n");
+    if (end < archived_length) {
+        // nothing new, but a rebuild may have brought trimmed lines back
+        govern_output_panel(output, text.length());
+        return;
+    }
+    std::string utf8 = utf32_to_utf8(view.substr(archived_length, end - archived_length));
+    archived_length = end + 1;
+    size_t tail = std::min<size_t>(static_cast<size_t>(archived_length), ARCHIVE_TAIL_CHARS);
+    archived_tail.assign(view.substr(static_cast<size_t>(archived_length) - tail, tail));
+    archived_tail_end = archived_length;
+
+    // every line of this batch shares its capture time, frame and session
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch()).count();
+    LineMeta meta;
+    meta.mono_ms = (stats_now_ns() - output_session_start_ns) / 1000000;
+    meta.capture_frame = Engine::get_singleton()->get_process_frames();
+    meta.debug_session = debugger_plugin ? debugger_plugin->active_session_id() : -1;
+
+    const char* data = utf8.data();
+    size_t size = utf8.size();
+    size_t start = 0;
+    while (start <= size) {
+        const char* nl = static_cast<const char*>(memchr(data + start, '\n', size - start));
+        size_t stop = nl ? static_cast<size_t>(nl - data) : size;
+        std::string line(data + start, stop - start);
+        meta.level = last_output_level = classify_output_line(line, last_output_level);
+        uint64_t seq = output_archive->append(line, now_ms, static_cast<uint32_t>(meta.level));
+        if (seq != 0) {
+            output_columns.append(seq, meta);
+        }
+        start = stop + 1;
+    }
+
+    // everything on the panel is archived now, so its top can go
+    govern_output_panel(output, text.length());
+}
+
+bool MessageHandler::archived_tail_in_place(std::u32string_view text) const {
+    if (archived_tail.empty()) {
+        return true;
+    }
+    if (archived_tail_end > static_cast<int64_t>(text.size()) ||
+        archived_tail_end < static_cast<int64_t>(archived_tail.size())) {
+        return false;
+    }
+    return text.substr(static_cast<size_t>(archived_tail_end) - archived_tail.size(), archived_tail.size()) ==
+           archived_tail;
+}
+
+void MessageHandler::govern_output_panel(RichTextLabel* output, int64_t length) {
+    size_t paragraphs = static_cast<size_t>(std::max<int64_t>(archived_paragraphs, 0));
+    size_t trim = output_governor.lines_to_trim(paragraphs);
+    if (trim == 0 || archived_length != length) {
+        return;  // under the cap, or a line is still half-written
+    }
+
+    // EditorLog keeps every message in a list of its own and rebuilds the
+    // panel from it, so trimming the label alone leaves that list growing.
+    // its Clear button empties both
+    Button* clear = control_finder->get_output_clear_button();
+    if (clear) {
+        clear->emit_signal("pressed");
+        String summary = String::utf8(output_governor.record_trim(paragraphs).c_str());
+        output->push_color(Color(0.6, 0.6, 0.6));
+        output->add_text(summary);
+        output->pop();
+        output->newline();
+
+        // the summary is all that's left and isn't output. it stands in for
+        // the archived tail: a rebuild drops it, and then everything on the
+        // panel arrived after the clear
+        String after = output->get_parsed_text();
+        std::u32string_view view = utf32_view(after);
+        archived_length = after.length();
+        archived_paragraphs = output->get_paragraph_count();
+        archived_tail.assign(view.substr(view.size() - std::min(view.size(), ARCHIVE_TAIL_CHARS)));
+        archived_tail_end = archived_length;
+        control_finder->last_output_length = 0;
+        return;
+    }
+
+    // no Clear button found: trim the label only. one relayout for the
+    // whole batch, not one per paragraph
+    for (size_t i = 0; i < trim; i++) {
+        output->remove_paragraph(0, i + 1 < trim);
+    }
+    String summary = String::utf8(output_governor.record_trim(trim).c_str());
+    output->push_color(Color(0.6, 0.6, 0.6));
+    output->add_text(summary);
+    output->pop();
+    output->newline();
+
+    // the summary isn't output, and offsets into the panel moved up by
+    // what was removed
+    String after = output->get_parsed_text();
+    int64_t removed = length - (after.length() - summary.length() - 1);
+    archived_length = after.length();
+    archived_paragraphs = output->get_paragraph_count();
+    archived_tail_end -= removed;
+    control_finder->last_output_length = std::max<int64_t>(control_finder->last_output_length - removed, 0);
+}
+
+std::string MessageHandler::handle_set_output_governor(int64_t id, const std::string& params_str) {
+    if (!output_archive) {
+        // trimming the panel is only safe while the archive has every line
+        return make_error(id, -32000, "Output archive is disabled");
+    }
+    arena_json params = arena_json::parse(params_str, nullptr, false);
+    if (!params.is_object() || !params.contains("max_lines") || !params["max_lines"].is_number_integer() ||
+        params["max_lines"].get<int64_t>() < 0) {
+        return make_error(id, -32602, "Missing required param: max_lines (0 turns the governor off)");
+    }
+    output_governor.set_max_lines(static_cast<size_t>(params["max_lines"].get<int64_t>()));
+    // apply the new cap now rather than on the next new line
+    archived_paragraphs = -1;
+    archive_output(true);
+
+    arena_json result = {
+        {"max_lines", output_governor.max_lines()},
+        {"trimmed_lines", output_governor.trimmed_lines()},
+        {"trims", output_governor.trims()}
+    };
+    return respond(id, result);
+}
+
+std::string MessageHandler::query_output_archive(int64_t id, const arena_json& params) {
+    if (!output_archive) {
+        return make_error(id, -32000, "Output archive is disabled");
+    }
+
+    ArchiveQuery q;
+    q.limit = ARCHIVE_DEFAULT_LIMIT;
+    if (params.contains("session") && params["session"].is_number_integer()) {
+        q.session = params["session"].get<int64_t>();
+    }
+    if (params.contains("from_seq") && params["from_seq"].is_number_integer()) {
+        q.from_seq = static_cast<uint64_t>(std::max<int64_t>(params["from_seq"].get<int64_t>(), 0));
+    }
+    if (params.contains("to_seq") && params["to_seq"].is_number_integer()) {
+        q.to_seq = static_cast<uint64_t>(std::max<int64_t>(params["to_seq"].get<int64_t>(), 0));
+    }
+    if (params.contains("since") && params["since"].is_number_integer()) {
+        q.from_ms = params["since"].get<int64_t>();
+    }
+    if (params.contains("until") && params["until"].is_number_integer()) {
+        q.to_ms = params["until"].get<int64_t>();
+    }
+    // "error" or ["error", "warning"]
+    if (params.contains("level")) {
+        const arena_json& level = params["level"];
+        std::vector<std::string> names;
+        if (level.is_string()) {
+            names.push_back(level.get<std::string>());
+        } else if (level.is_array()) {
+            for (const auto& name : level) {
+                names.push_back(name.is_string() ? name.get<std::string>() : std::string());
+            }
+        }
+        for (const std::string& name : names) {
+            OutputLevel parsed;
+            if (!parse_output_level(name, parsed)) {
+                return make_error(id, -32602, "level must be print, warning or error");
+            }
+            q.level_mask |= 1u << static_cast<uint32_t>(parsed);
+        }
+    }
+    if (params.contains("limit") && params["limit"].is_number_integer()) {
+        int64_t limit = params["limit"].get<int64_t>();
+        if (limit <= 0 || limit > ARCHIVE_MAX_LIMIT) {
+            return make_error(id, -32602, "limit must be between 1 and " + std::to_string(ARCHIVE_MAX_LIMIT));
+        }
+        q.limit = static_cast<size_t>(limit);
+    }
+
+    // the live session includes whatever reached the panel this frame
+    if (q.session == 0) {
+        archive_output(true);
+    }
+
+    ArchiveResult r = output_archive->query(q);
+    if (r.session == 0) {
+        return make_error(id, -32602, "No such output session");
+    }
+
+    // the live session still has the rest of each line's metadata
+    bool live = r.session == output_archive->current_session();
+    arena_json lines = arena_json::array();
+    for (const ArchiveRecord& record : r.records) {
+        arena_json line = {
+            {"seq", record.seq},
+            {"time", record.time_ms},
+            {"level", output_level_name(static_cast<OutputLevel>(record.flags & 0xff))},
+            {"text", record.text}
+        };
+        LineMeta meta;
+        if (live && output_columns.get(record.seq, meta)) {
+            line["mono_ms"] = meta.mono_ms;
+            line["capture_frame"] = meta.capture_frame;
+            line["debug_session"] = meta.debug_session;
+        }
+        lines.push_back(std::move(line));
+    }
+    arena_json result = {
+        {"session", r.session},
+        {"lines", std::move(lines)},
+        {"truncated", r.truncated}
+    };
+    if (r.truncated && !r.records.empty()) {
+        result["next_seq"] = r.records.back().seq + 1;
+    }
+    return respond(id, result);
+}
+
+std::string MessageHandler::handle_list_output_sessions(int64_t id) {
+    if (!output_archive) {
+        return make_error(id, -32000, "Output archive is disabled");
+    }
+    archive_output(true);
+
+    arena_json sessions = arena_json::array();
+    for (const ArchiveSession& s : output_archive->list_sessions()) {
+        sessions.push_back({
+            {"session", s.id},
+            {"first_seq", s.first_seq},
+            {"last_seq", s.last_seq},
+            {"first_time", s.first_ms},
+            {"last_time", s.last_ms},
+            {"bytes", s.bytes},
+            {"segments", s.segments}
+        });
+    }
+    arena_json result = {
+        {"directory", output_archive->directory()},
+        {"current", output_archive->current_session()},
+        {"disk_bytes", output_archive->disk_bytes()},
+        {"sessions", std::move(sessions)}
+    };
+    return respond(id, result);
+}
+
+std::string MessageHandler::handle_get_output_stats(int64_t id, const std::string& params_str) {
+    if (!output_archive) {
+        return make_error(id, -32000, "Output archive is disabled");
+    }
+
+    uint64_t bucket_ms = 1000;
+    uint64_t from_ms = 0;
+    uint64_t to_ms = std::numeric_limits<uint64_t>::max();
+    arena_json params = arena_json::parse(params_str, nullptr, false);
+    if (params.is_object()) {
+        if (params.contains("bucket_ms") && params["bucket_ms"].is_number_integer()) {
+            int64_t v = params["bucket_ms"].get<int64_t>();
+            if (v <= 0) {
+                return make_error(id, -32602, "bucket_ms must be positive");
+            }
+            bucket_ms = static_cast<uint64_t>(v);
+        }
+        if (params.contains("from_ms") && params["from_ms"].is_number_integer()) {
+            from_ms = static_cast<uint64_t>(std::max<int64_t>(params["from_ms"].get<int64_t>(), 0));
+        }
+        if (params.contains("to_ms") && params["to_ms"].is_number_integer()) {
+            to_ms = static_cast<uint64_t>(std::max<int64_t>(params["to_ms"].get<int64_t>(), 0));
+        }
+    }
+    archive_output(true);
+
+    // counted from the metadata columns alone; no text is read
+    uint64_t totals[OUTPUT_LEVEL_COUNT] = {};
+    arena_json buckets = arena_json::array();
+    for (const OutputColumns::Bucket& b : output_columns.histogram(from_ms, to_ms, bucket_ms)) {
+        arena_json bucket = {{"t", b.start_ms}, {"capture_frames", {b.first_capture_frame, b.last_capture_frame}}};
+        for (int level = 0; level < OUTPUT_LEVEL_COUNT; level++) {
+            bucket[output_level_name(static_cast<OutputLevel>(level))] = b.counts[level];
+            totals[level] += b.counts[level];
+        }
+        buckets.push_back(std::move(bucket));
+    }
+    arena_json total = arena_json::object();
+    for (int level = 0; level < OUTPUT_LEVEL_COUNT; level++) {
+        total[output_level_name(static_cast<OutputLevel>(level))] = totals[level];
+    }
+
+    arena_json result = {
+        {"session", output_archive->current_session()},
+        {"first_seq", output_columns.first_seq()},
+        {"lines", output_columns.size()},
+        {"bucket_ms", bucket_ms},
+        {"totals", std::move(total)},
+        {"buckets", std::move(buckets)}
+    };
+    return respond(id, result);
+}
+
+// ============================================================================
+// instrumentation handlers
+// ============================================================================
+
+std::string MessageHandler::handle_get_server_stats(int64_t id, const std::string& params_str) {
+    if (!server_stats) {
+        return make_error(id, -32000, "Server stats not initialized");
+    }
+
+    arena_json params = arena_json::parse(params_str, nullptr, false);
+    bool reset = false;
+    if (!params.is_discarded() && params.contains("reset") && params["reset"].is_boolean()) {
+        reset = params["reset"].get<bool>();
+    }
+
+    // snapshot first so a reset call still returns what it cleared
+    std::string snapshot = server_stats->to_json();
+    if (reset) {
+        server_stats->reset();
+    }
+    return make_result(id, snapshot);
+}
+
+std::string MessageHandler::handle_set_tracing(int64_t id, const std::string& params_str) {
+#if GODOT_PEEK_TRACE
+    arena_json params = arena_json::parse(params_str, nullptr, false);
+    if (params.is_discarded() || !params.contains("enabled") || !params["enabled"].is_boolean()) {
+        return make_error(id, -32602, "Missing required param: enabled");
+    }
+    bool enabled = params["enabled"].get<bool>();
+
+    // clear defaults to true when starting so each capture is self-contained
+    bool clear = enabled;
+    if (params.contains("clear") && params["clear"].is_boolean()) {
+        clear = params["clear"].get<bool>();
+    }
+    if (clear) {
+        trace_clear();
+    }
+    trace_set_enabled(enabled);
+
+    arena_json result = {
+        {"enabled", enabled},
+        {"events", static_cast<int64_t>(trace_event_count())}
+    };
+    return respond(id, result);
+#else
+    (void)params_str;
+    return make_error(id, -32000, "Tracing was compiled out (GODOT_PEEK_TRACE=0)");
+#endif
+}
+
+std::string MessageHandler::handle_export_trace(int64_t id, const std::string& params_str) {
+    arena_json params = arena_json::parse(params_str, nullptr, false);
+    std::string path = "/tmp/godot_peek_trace.json";
+    if (!params.is_discarded() && params.contains("path") && params["path"].is_string()) {
+        path = params["path"].get<std::string>();
+    }
+
+    if (!trace_export_chrome(path)) {
+        return make_error(id, -32000, "Failed to write trace file: " + path);
+    }
+
+    arena_json result = {
+        {"path", path},
+        {"events", static_cast<int64_t>(trace_event_count())},
+        {"enabled", trace_enabled()}
+    };
+    return respond(id, result);
 }
 
 // ============================================================================
 // screenshot handlers
 // ============================================================================
 
-std::string MessageHandler::handle_get_screenshot(int64_t id, const std::string& params_str) {
+RpcTask MessageHandler::handle_get_screenshot(int64_t id, std::string params_str, RpcContext& ctx) {
     json params = json::parse(params_str, nullptr, false);
     std::string target;
 
@@ -982,19 +1183,55 @@ std::string MessageHandler::handle_get_screenshot(int64_t id, const std::string&
     }
 
     if (target.empty()) {
-        return make_error(id, -32602, "Missing required parameter: target");
+        co_return make_error(id, -32602, "Missing required parameter: target");
+    }
+
+    // inline: return the PNG itself instead of only a file path
+    bool inline_data = false;
+    if (params.contains("inline") && params["inline"].is_boolean()) {
+        inline_data = params["inline"].get<bool>();
     }
 
     if (target == "editor") {
-        return capture_editor(id);
-    } else if (target == "game") {
-        return capture_game(id);
-    } else {
-        return make_error(id, -32602, "Invalid target: " + target + " (expected: editor, game)");
+        co_return capture_editor(id, inline_data, ctx);
+    }
+    if (target != "game") {
+        co_return make_error(id, -32602, "Invalid target: " + target + " (expected: editor, game)");
+    }
+
+    Ref<PacketPeerUDP> udp;
+    std::string error = request_game_screenshot(udp);
+    if (!error.empty()) {
+        co_return make_error(id, -32000, error);
+    }
+
+    // the game grabs its viewport and answers within a few frames; wait for
+    // it without blocking the editor
+    bool answered = co_await frames.until([udp] { return udp->get_available_packet_count() > 0; },
+                                          SCREENSHOT_WAIT_MS);
+    if (!answered) {
+        co_return make_error(id, -32000, "Timeout waiting for game screenshot. Is screenshot_listener.gd added as autoload in your project?");
+    }
+    co_return read_game_screenshot(id, udp, inline_data, ctx);
+}
+
+void MessageHandler::attach_image(const PackedByteArray& png, json& result, RpcContext& ctx) {
+    result["format"] = "png";
+    result["size"] = png.size();
+
+    if (ctx.binary_frames) {
+        // raw bytes ride in a binary frame right after this response
+        result["attachment"] = ctx.attachments.size();
+        ctx.attachments.emplace_back(reinterpret_cast<const char*>(png.ptr()), png.size());
+        return;
     }
+
+    String b64 = Marshalls::get_singleton()->raw_to_base64(png);
+    result["data_base64"] = std::string(b64.utf8().get_data());
 }
 
-std::string MessageHandler::capture_editor(int64_t id) {
+std::string MessageHandler::capture_editor(int64_t id, bool inline_data, RpcContext& ctx) {
+    PEEK_TRACE_SCOPE("capture_editor");
     EditorInterface* editor = EditorInterface::get_singleton();
     if (!editor) {
         return make_error(id, -32000, "EditorInterface not available");
@@ -1056,8 +1293,30 @@ std::string MessageHandler::capture_editor(int64_t id) {
         return make_error(id, -32000, "No editor viewports available (both too small or empty)");
     }
 
+    if (inline_data) {
+        PackedByteArray png;
+        {
+            PEEK_TRACE_SCOPE("save_png_to_buffer");
+            png = combined->save_png_to_buffer();
+        }
+        if (png.is_empty()) {
+            return make_error(id, -32000, "Failed to encode screenshot");
+        }
+        json result = {
+            {"target", "editor"},
+            {"width", width},
+            {"height", height}
+        };
+        attach_image(png, result, ctx);
+        return respond(id, result, ctx);
+    }
+
     const char* path = "/tmp/godot_peek_editor_screenshot.png";
-    Error err = combined->save_png(path);
+    Error err;
+    {
+        PEEK_TRACE_SCOPE("save_png");
+        err = combined->save_png(path);
+    }
     if (err != OK) {
         return make_error(id, -32000, "Failed to save screenshot");
     }
@@ -1068,26 +1327,25 @@ std::string MessageHandler::capture_editor(int64_t id) {
         {"width", width},
         {"height", height}
     };
-    return make_result(id, result.dump());
+    return respond(id, result, ctx);
 }
 
-std::string MessageHandler::capture_game(int64_t id) {
+std::string MessageHandler::request_game_screenshot(Ref<PacketPeerUDP>& udp) {
     EditorInterface* editor = EditorInterface::get_singleton();
     if (!editor) {
-        return make_error(id, -32000, "EditorInterface not available");
+        return "EditorInterface not available";
     }
 
     if (!editor->is_playing_scene()) {
-        return make_error(id, -32000, "Game is not running");
+        return "Game is not running";
     }
 
     // send UDP request to screenshot_listener in game
-    Ref<PacketPeerUDP> udp;
     udp.instantiate();
 
     Error err = udp->set_dest_address("127.0.0.1", 6971);
     if (err != OK) {
-        return make_error(id, -32000, "Failed to set UDP destination");
+        return "Failed to set UDP destination";
     }
 
     // send screenshot request
@@ -1100,36 +1358,39 @@ std::string MessageHandler::capture_game(int64_t id) {
 
     err = udp->put_packet(packet);
     if (err != OK) {
-        return make_error(id, -32000, "Failed to send UDP request");
+        return "Failed to send UDP request";
     }
+    return "";
+}
 
-    // poll for response with timeout (max ~1 second)
-    // game should respond quickly since it just grabs viewport
-    for (int attempt = 0; attempt < 20; attempt++) {
-        OS::get_singleton()->delay_msec(50);  // 50ms delay
-
-        if (udp->get_available_packet_count() > 0) {
-            PackedByteArray response = udp->get_packet();
-            std::string resp_str((const char*)response.ptr(), response.size());
+std::string MessageHandler::read_game_screenshot(int64_t id, const Ref<PacketPeerUDP>& udp, bool inline_data,
+                                                 RpcContext& ctx) {
+    PackedByteArray response = udp->get_packet();
+    std::string resp_str((const char*)response.ptr(), response.size());
 
-            json resp = json::parse(resp_str, nullptr, false);
-            if (resp.is_discarded()) {
-                return make_error(id, -32000, "Invalid response from screenshot listener");
-            }
+    json resp = json::parse(resp_str, nullptr, false);
+    if (resp.is_discarded()) {
+        return make_error(id, -32000, "Invalid response from screenshot listener");
+    }
 
-            if (resp.contains("error")) {
-                return make_error(id, -32000, "Screenshot listener error: " + resp["error"].get<std::string>());
-            }
+    if (resp.contains("error")) {
+        return make_error(id, -32000, "Screenshot listener error: " + resp["error"].get<std::string>());
+    }
 
-            json result = {
-                {"path", resp.value("path", "/tmp/godot_peek_game_screenshot.png")},
-                {"target", "game"},
-                {"width", resp.value("width", 0)},
-                {"height", resp.value("height", 0)}
-            };
-            return make_result(id, result.dump());
+    json result = {
+        {"path", resp.value("path", "/tmp/godot_peek_game_screenshot.png")},
+        {"target", "game"},
+        {"width", resp.value("width", 0)},
+        {"height", resp.value("height", 0)}
+    };
+    if (inline_data) {
+        // the game writes the PNG to disk; read it back for the client
+        String path = String::utf8(result["path"].get<std::string>().c_str());
+        PackedByteArray png = FileAccess::get_file_as_bytes(path);
+        if (png.is_empty()) {
+            return make_error(id, -32000, "Failed to read game screenshot");
         }
+        attach_image(png, result, ctx);
     }
-
-    return make_error(id, -32000, "Timeout waiting for game screenshot. Is screenshot_listener.gd added as autoload in your project?");
+    return respond(id, result, ctx);
 }
@@ -1,18 +1,34 @@
 #pragma once
 
 #include "json_rpc.h"
+#include "rpc_dispatcher.h"
+#include "response_encoding.h"
+#include "response_cache.h"
+#include "request_arena.h"
+#include "frame_task.h"
+#include "output_columns.h"
+#include "output_governor.h"
+
+#include <nlohmann/json.hpp>
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <vector>
 
 // forward declarations
 class EditorControlFinder;
+class ServerStats;
+class OutputArchive;
 namespace godot {
     class Node;
+    class RichTextLabel;
     class Tree;
     class TreeItem;
     class GodotPeekDebuggerPlugin;
+    class PackedByteArray;
+    class PacketPeerUDP;
+    template <typename T> class Ref;
 }
 
 // callback for scene launch events (used by plugin for auto-stop timer)
@@ -20,10 +36,22 @@ using SceneLaunchCallback = std::function<void(double timeout_seconds)>;
 
 class MessageHandler {
 public:
+    // registers every handler with the dispatcher
+    MessageHandler();
+
+    // handlers capture this, so the handler can't be copied
+    MessageHandler(const MessageHandler&) = delete;
+    MessageHandler& operator=(const MessageHandler&) = delete;
+
     // process a JSON-RPC message and return the response
     // input: {"id": 1, "method": "ping", "params": {...}}
     // output: {"id": 1, "result": {...}} or {"id": 1, "error": {...}}
-    std::string handle(const std::string& message);
+    // ctx carries the transport details (binary framing, attachments) when
+    // called from the socket server
+    std::string handle(const std::string& message, RpcContext* ctx = nullptr);
+
+    // priority lane of a raw message (the socket server's classifier)
+    Lane lane_of(const std::string& message) const;
 
     // set callback for scene launch (to schedule auto-stop)
     void set_scene_launch_callback(SceneLaunchCallback cb) { on_scene_launch = cb; }
@@ -34,7 +62,62 @@ public:
     // set the debugger plugin (injected by plugin)
     void set_debugger_plugin(godot::GodotPeekDebuggerPlugin* plugin) { debugger_plugin = plugin; }
 
+    // set the stats sink (injected by plugin, shared with the socket server)
+    void set_server_stats(ServerStats* stats);
+
+    // set the output archive (injected by plugin; null leaves it off)
+    void set_output_archive(OutputArchive* archive) { output_archive = archive; }
+
+    // start a new archive session (editor start, each game launch); its
+    // line metadata starts over too. false if the archive can't be written
+    bool begin_output_session();
+
+    // copy lines added to the Output panel since the last call into the
+    // archive. each frame costs a paragraph count; the panel text is only
+    // read when that changed, and at most every ARCHIVE_CAPTURE_MS unless
+    // forced. reading it costs the whole panel, which the governor bounds
+    void archive_output(bool force = false);
+
+    // editor/debugger state may have changed: cached read results are stale
+    void invalidate_cache() { cache.bump(); }
+
+    // resume multi-frame handlers whose wait is over and hand their
+    // responses to the transport. call each frame before polling the socket
+    void process_frame();
+
 private:
+    // results of cacheable read methods (see response_cache.h)
+    ResponseCache cache;
+
+    // method name -> handler routing (godot-free, see rpc_dispatcher.h)
+    RpcDispatcher dispatcher;
+
+    // result DOM -> response in the connection's encoding
+    ResponseEncoder encoder;
+    std::string respond(int64_t id, const nlohmann::json& result);
+    std::string respond(int64_t id, const arena_json& result);
+    // for multi-frame handlers, which outlive the dispatcher's current context
+    std::string respond(int64_t id, const nlohmann::json& result, RpcContext& ctx);
+
+    // multi-frame handlers (frame_task.h) wait here; ticked by process_frame
+    FrameScheduler frames;
+
+    // how long multi-frame handlers wait before answering anyway (ms)
+    static constexpr uint32_t REMOTE_TREE_WAIT_MS = 2000;
+    static constexpr uint32_t INSPECTOR_WAIT_MS = 1000;
+    static constexpr uint32_t SCREENSHOT_WAIT_MS = 1000;
+    static constexpr uint32_t STEP_WAIT_MS = 2000;
+
+    // output archive capture interval, and the get_output line limits
+    static constexpr uint64_t ARCHIVE_CAPTURE_MS = 100;
+    static constexpr int64_t ARCHIVE_DEFAULT_LIMIT = 200;
+    static constexpr int64_t ARCHIVE_MAX_LIMIT = 10000;
+    // characters at the end of the archived text kept to spot a cleared panel
+    static constexpr size_t ARCHIVE_TAIL_CHARS = 256;
+
+    // backs the JSON DOMs of the request being handled (see request_arena.h)
+    RequestArena arena;
+
     // individual method handlers
     std::string handle_ping(int64_t id);
     std::string handle_run_main_scene(int64_t id, const std::string& params_str);
@@ -42,38 +125,79 @@ private:
     std::string handle_run_current_scene(int64_t id, const std::string& params_str);
     std::string handle_stop_scene(int64_t id);
     std::string handle_get_output(int64_t id, const std::string& params_str);
+    std::string query_output_archive(int64_t id, const arena_json& params);
+    std::string handle_list_output_sessions(int64_t id);
+    std::string handle_get_output_stats(int64_t id, const std::string& params_str);
+    std::string handle_set_output_governor(int64_t id, const std::string& params_str);
+
+    // clear (or, failing that, trim) the panel once it is over the
+    // governor's cap (archive_output calls it with everything archived)
+    void govern_output_panel(godot::RichTextLabel* output, int64_t length);
+    // whether the panel text still has the archived tail where it was left
+    bool archived_tail_in_place(std::u32string_view text) const;
     std::string handle_get_debugger_errors(int64_t id);
     std::string handle_get_monitors(int64_t id);
     std::string handle_get_debugger_stack_trace(int64_t id);
     std::string handle_get_debugger_locals(int64_t id);
-    std::string handle_get_remote_scene_tree(int64_t id);
-    std::string handle_get_remote_node_properties(int64_t id, const std::string& params_str);
+    RpcTask handle_get_remote_scene_tree(int64_t id, std::string params_str, RpcContext& ctx);
+    RpcTask handle_get_remote_node_properties(int64_t id, std::string params_str, RpcContext& ctx);
 
     // debugger control handlers
     std::string handle_set_breakpoint(int64_t id, const std::string& params_str);
     std::string handle_clear_breakpoints(int64_t id);
     std::string handle_get_debugger_state(int64_t id);
     std::string handle_debug_continue(int64_t id);
-    std::string handle_debug_step(int64_t id, const std::string& params_str);
+    RpcTask handle_debug_step(int64_t id, std::string params_str, RpcContext& ctx);
     std::string handle_debug_break(int64_t id);
 
+    // discovery
+    std::string handle_list_instances(int64_t id);
+
+    // instrumentation
+    std::string handle_get_server_stats(int64_t id, const std::string& params_str);
+    std::string handle_set_tracing(int64_t id, const std::string& params_str);
+    std::string handle_export_trace(int64_t id, const std::string& params_str);
+
     // screenshot handlers
-    std::string handle_get_screenshot(int64_t id, const std::string& params_str);
-    std::string capture_editor(int64_t id);
-    std::string capture_game(int64_t id);
+    RpcTask handle_get_screenshot(int64_t id, std::string params_str, RpcContext& ctx);
+    std::string capture_editor(int64_t id, bool inline_data, RpcContext& ctx);
+
+    // game screenshots go through screenshot_listener.gd over UDP: send the
+    // request (returns an error message, empty on success), then read the
+    // answer once a packet has arrived
+    std::string request_game_screenshot(godot::Ref<godot::PacketPeerUDP>& udp);
+    std::string read_game_screenshot(int64_t id, const godot::Ref<godot::PacketPeerUDP>& udp, bool inline_data,
+                                     RpcContext& ctx);
+
+    // add PNG bytes to a screenshot result: a binary attachment on framed
+    // connections, base64 in the JSON otherwise
+    void attach_image(const godot::PackedByteArray& png, nlohmann::json& result, RpcContext& ctx);
 
     // extract timeout and trigger callback
     void schedule_auto_stop(const std::string& params_str);
 
-    // helper to extract text from a Tree widget (recursive traversal)
-    std::string get_tree_text(godot::Tree* tree);
-    std::string get_tree_item_text(godot::TreeItem* item, int depth);
-
-    // helpers for remote node inspection
-    godot::TreeItem* find_tree_item_by_path(godot::TreeItem* root, const std::vector<std::string>& path_parts);
+    // helper for remote node inspection (tree walking lives in editor_serializers.h)
     bool trigger_remote_inspection(godot::Tree* tree, godot::TreeItem* item);
 
     SceneLaunchCallback on_scene_launch;
     EditorControlFinder* control_finder = nullptr;
     godot::GodotPeekDebuggerPlugin* debugger_plugin = nullptr;
+    ServerStats* server_stats = nullptr;
+
+    // output archive capture state (see archive_output)
+    OutputArchive* output_archive = nullptr;
+    int64_t archived_length = 0;        // panel characters already archived
+    int64_t archived_paragraphs = -1;   // panel paragraph count at that point
+    std::u32string archived_tail;       // the last archived characters
+    int64_t archived_tail_end = 0;      // panel offset just past them
+    uint64_t last_archive_ms = 0;
+
+    // level, time, frame and debugger session of each line in the current
+    // archive session (see output_columns.h)
+    OutputColumns output_columns;
+    OutputLevel last_output_level = OutputLevel::print;
+    uint64_t output_session_start_ns = 0;
+
+    // keeps the Output panel short under log floods (see output_governor.h)
+    OutputGovernor output_governor;
 };
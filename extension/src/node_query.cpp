@@ -0,0 +1,495 @@
+#include "node_query.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+using json = nlohmann::json;
+
+// --- selector parsing ---
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_ident(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// helper: a bare value as a number, if all of it is one
+static bool parse_number(const std::string& text, json& out) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long long i = std::strtoll(text.c_str(), &end, 10);
+    if (errno == 0 && *end == '\0') {
+        out = static_cast<int64_t>(i);
+        return true;
+    }
+    double d = std::strtod(text.c_str(), &end);
+    if (*end == '\0') {
+        out = d;
+        return true;
+    }
+    return false;
+}
+
+// helper: the inside of a [prop op value] term
+static bool parse_test(const std::string& text, PropertyTest& out, std::string& error) {
+    size_t i = 0;
+    while (i < text.size() && is_space(text[i])) {
+        i++;
+    }
+    size_t start = i;
+    while (i < text.size() && !is_space(text[i]) && text[i] != '=' && text[i] != '!' && text[i] != '<' &&
+           text[i] != '>') {
+        i++;
+    }
+    out.property = text.substr(start, i - start);
+    if (out.property.empty()) {
+        error = "missing property name in [" + text + "]";
+        return false;
+    }
+    while (i < text.size() && is_space(text[i])) {
+        i++;
+    }
+
+    static const struct {
+        const char* text;
+        CompareOp op;
+    } ops[] = {
+        {"==", CompareOp::eq}, {"!=", CompareOp::ne}, {"<=", CompareOp::le},
+        {">=", CompareOp::ge}, {"<", CompareOp::lt},  {">", CompareOp::gt},  {"=", CompareOp::eq},
+    };
+    bool found = false;
+    for (const auto& op : ops) {
+        size_t len = std::char_traits<char>::length(op.text);
+        if (text.compare(i, len, op.text) == 0) {
+            out.op = op.op;
+            i += len;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        error = "missing operator in [" + text + "]";
+        return false;
+    }
+
+    while (i < text.size() && is_space(text[i])) {
+        i++;
+    }
+    size_t end = text.size();
+    while (end > i && is_space(text[end - 1])) {
+        end--;
+    }
+    std::string value = text.substr(i, end - i);
+    if (value.empty()) {
+        error = "missing value in [" + text + "]";
+        return false;
+    }
+
+    if (value.front() == '"') {
+        std::string s;
+        size_t j = 1;
+        for (; j < value.size() && value[j] != '"'; j++) {
+            if (value[j] == '\\' && j + 1 < value.size()) {
+                j++;
+            }
+            s += value[j];
+        }
+        if (j != value.size() - 1) {
+            error = "unterminated string in [" + text + "]";
+            return false;
+        }
+        out.value = s;
+    } else if (value == "true" || value == "false") {
+        out.value = value == "true";
+    } else if (value == "null") {
+        out.value = nullptr;
+    } else if (!parse_number(value, out.value)) {
+        out.value = value;
+    }
+    return true;
+}
+
+bool parse_selector(const std::string& text, NodeSelector& out, std::string& error) {
+    out = NodeSelector();
+    size_t i = 0;
+    size_t n = text.size();
+    // the end of a #name or .group term
+    auto word_end = [&](size_t from) {
+        while (from < n && !is_space(text[from]) && text[from] != '[' && text[from] != ':' && text[from] != '#' &&
+               text[from] != '.') {
+            from++;
+        }
+        return from;
+    };
+
+    while (i < n) {
+        char c = text[i];
+        if (is_space(c)) {
+            i++;
+        } else if (c == '/') {
+            size_t end = i;
+            while (end < n && !is_space(text[end]) && text[end] != '[') {
+                end++;
+            }
+            out.root = text.substr(i, end - i);
+            if (out.root.size() > 1 && out.root.back() == '/') {
+                out.root.pop_back();
+            }
+            i = end;
+        } else if (c == '#' || c == '.') {
+            size_t end = word_end(i + 1);
+            if (end == i + 1) {
+                error = std::string("empty ") + (c == '#' ? "name" : "group") + " at " + std::to_string(i);
+                return false;
+            }
+            (c == '#' ? out.name_glob : out.group) = text.substr(i + 1, end - i - 1);
+            i = end;
+        } else if (c == '[') {
+            // quoted values may hold a ]
+            size_t end = i + 1;
+            bool quoted = false;
+            for (; end < n && (quoted || text[end] != ']'); end++) {
+                if (text[end] == '\\' && quoted) {
+                    end++;
+                } else if (text[end] == '"') {
+                    quoted = !quoted;
+                }
+            }
+            if (end >= n) {
+                error = "unclosed [ at " + std::to_string(i);
+                return false;
+            }
+            PropertyTest test;
+            if (!parse_test(text.substr(i + 1, end - i - 1), test, error)) {
+                return false;
+            }
+            out.tests.push_back(std::move(test));
+            i = end + 1;
+        } else if (c == ':') {
+            static const std::string depth = ":depth(";
+            size_t close = text.find(')', i);
+            if (text.compare(i, depth.size(), depth) != 0 || close == std::string::npos) {
+                error = "expected :depth(n) at " + std::to_string(i);
+                return false;
+            }
+            json value;
+            std::string digits = text.substr(i + depth.size(), close - i - depth.size());
+            if (!parse_number(digits, value) || !value.is_number_integer() || value.get<int64_t>() < 1) {
+                error = "depth must be a positive integer, got '" + digits + "'";
+                return false;
+            }
+            out.max_depth = static_cast<int>(std::min<int64_t>(value.get<int64_t>(), 1 << 20));
+            i = close + 1;
+        } else if (is_ident(c)) {
+            size_t end = i;
+            while (end < n && is_ident(text[end])) {
+                end++;
+            }
+            if (!out.type.empty()) {
+                error = "more than one type ('" + out.type + "' and '" + text.substr(i, end - i) + "')";
+                return false;
+            }
+            out.type = text.substr(i, end - i);
+            i = end;
+        } else {
+            error = std::string("unexpected '") + c + "' at " + std::to_string(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool glob_match(const std::string& pattern, const std::string& text) {
+    // backtrack only to the most recent *, which is enough for * and ?
+    size_t p = 0;
+    size_t t = 0;
+    size_t star = std::string::npos;
+    size_t resume = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            p++;
+            t++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            t = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+bool compare_values(const json& actual, CompareOp op, const json& expected) {
+    int order = 0;
+    bool ordered = true;
+    if (actual.is_number() && expected.is_number()) {
+        if (actual.is_number_integer() && expected.is_number_integer()) {
+            int64_t a = actual.get<int64_t>();
+            int64_t b = expected.get<int64_t>();
+            order = a < b ? -1 : (a > b ? 1 : 0);
+        } else {
+            double a = actual.get<double>();
+            double b = expected.get<double>();
+            order = a < b ? -1 : (a > b ? 1 : 0);
+        }
+    } else if (actual.is_string() && expected.is_string()) {
+        int c = actual.get_ref<const std::string&>().compare(expected.get_ref<const std::string&>());
+        order = c < 0 ? -1 : (c > 0 ? 1 : 0);
+    } else {
+        // bools, nulls and mismatched types: equality only
+        ordered = false;
+        order = actual == expected ? 0 : 1;
+    }
+
+    switch (op) {
+        case CompareOp::eq: return order == 0;
+        case CompareOp::ne: return order != 0;
+        case CompareOp::lt: return ordered && order < 0;
+        case CompareOp::le: return ordered && order <= 0;
+        case CompareOp::gt: return ordered && order > 0;
+        case CompareOp::ge: return ordered && order >= 0;
+    }
+    return false;
+}
+
+// --- NodeClassIndex ---
+
+void NodeClassIndex::add(NodeHandle node, const std::string& class_name) {
+    if (slots.count(node)) {
+        remove(node);
+    }
+    auto [it, inserted] = class_ids.emplace(class_name, static_cast<uint32_t>(class_names.size()));
+    if (inserted) {
+        class_names.push_back(class_name);
+        members.emplace_back();
+    }
+    std::vector<NodeHandle>& list = members[it->second];
+    slots[node] = Slot{it->second, list.size()};
+    list.push_back(node);
+}
+
+void NodeClassIndex::remove(NodeHandle node) {
+    auto it = slots.find(node);
+    if (it == slots.end()) {
+        return;
+    }
+    // swap the last member of the class into the hole
+    std::vector<NodeHandle>& list = members[it->second.class_id];
+    size_t position = it->second.position;
+    if (position + 1 != list.size()) {
+        list[position] = list.back();
+        slots[list[position]].position = position;
+    }
+    list.pop_back();
+    slots.erase(it);
+}
+
+void NodeClassIndex::clear() {
+    class_ids.clear();
+    class_names.clear();
+    members.clear();
+    slots.clear();
+}
+
+void NodeClassIndex::collect(const SceneView& view, const std::string& base, std::vector<NodeHandle>& out) const {
+    for (size_t id = 0; id < class_names.size(); id++) {
+        if (!members[id].empty() && view.inherits(class_names[id], base)) {
+            out.insert(out.end(), members[id].begin(), members[id].end());
+        }
+    }
+}
+
+// --- queries ---
+
+NodeQueryResult run_node_query(const SceneView& view, const NodeSelector& sel,
+                               const std::vector<std::string>& properties, size_t limit,
+                               const NodeClassIndex* index) {
+    NodeQueryResult result;
+    NodeHandle root = view.find(sel.root);
+    if (!root) {
+        result.root_found = false;
+        return result;
+    }
+    limit = std::clamp<size_t>(limit, 1, NODE_QUERY_MAX_LIMIT);
+
+    // cheapest tests first; the candidate source already vouches for its own
+    auto matches = [&](NodeHandle node, bool check_type, bool check_group) {
+        if (check_type && !sel.type.empty() && !view.is_class(node, sel.type)) {
+            return false;
+        }
+        if (check_group && !sel.group.empty() && !view.in_group(node, sel.group)) {
+            return false;
+        }
+        if (!sel.name_glob.empty() && !glob_match(sel.name_glob, view.name(node))) {
+            return false;
+        }
+        json value;
+        for (const PropertyTest& test : sel.tests) {
+            if (!view.property(node, test.property, value) || !compare_values(value, test.op, test.value)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // false once the limit is hit with another match in hand
+    auto emit = [&](NodeHandle node) {
+        if (result.matches.size() == limit) {
+            result.truncated = true;
+            return false;
+        }
+        NodeMatch m;
+        m.node = node;
+        m.path = view.path(node);
+        m.class_name = view.class_name(node);
+        m.properties = json::object();
+        json value;
+        for (const std::string& name : properties) {
+            if (view.property(node, name, value)) {
+                m.properties[name] = std::move(value);
+            }
+        }
+        result.matches.push_back(std::move(m));
+        return true;
+    };
+
+    std::vector<NodeHandle> candidates;
+    bool from_group = !sel.group.empty();
+    bool from_index = !from_group && !sel.type.empty() && index && index->size() > 0;
+    if (from_group) {
+        result.source = "group";
+        view.group_members(sel.group, candidates);
+    } else if (from_index) {
+        result.source = "class_index";
+        index->collect(view, sel.type, candidates);
+    }
+
+    if (from_group || from_index) {
+        for (NodeHandle node : candidates) {
+            result.visited++;
+            // a descendant of root, within the depth limit
+            int depth = 0;
+            NodeHandle p = node;
+            while (p && p != root) {
+                p = view.parent(p);
+                depth++;
+            }
+            if (!p || depth == 0 || (sel.max_depth > 0 && depth > sel.max_depth)) {
+                continue;
+            }
+            if (matches(node, !from_index, !from_group) && !emit(node)) {
+                break;
+            }
+        }
+        return result;
+    }
+
+    // walk the subtree in tree order
+    std::vector<std::pair<NodeHandle, int>> stack;
+    for (int i = view.child_count(root) - 1; i >= 0; i--) {
+        stack.emplace_back(view.child(root, i), 1);
+    }
+    while (!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+        result.visited++;
+        if (matches(node, true, true) && !emit(node)) {
+            break;
+        }
+        if (sel.max_depth == 0 || depth < sel.max_depth) {
+            for (int i = view.child_count(node) - 1; i >= 0; i--) {
+                stack.emplace_back(view.child(node, i), depth + 1);
+            }
+        }
+    }
+    return result;
+}
+
+bool query_nodes(const SceneView& view, const json& params, const NodeClassIndex* index, json& result,
+                 std::string& error) {
+    NodeSelector sel;
+    std::string selector = params.contains("selector") && params["selector"].is_string()
+                               ? params["selector"].get<std::string>()
+                               : std::string();
+    if (!parse_selector(selector, sel, error)) {
+        return false;
+    }
+
+    std::vector<std::string> properties;
+    if (params.contains("properties")) {
+        const json& p = params["properties"];
+        if (p.is_array()) {
+            for (const json& name : p) {
+                if (name.is_string()) {
+                    properties.push_back(name.get<std::string>());
+                }
+            }
+        } else if (p.is_string()) {
+            const std::string& list = p.get_ref<const std::string&>();
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = std::min(list.find(',', start), list.size());
+                size_t a = start;
+                size_t b = comma;
+                while (a < b && is_space(list[a])) {
+                    a++;
+                }
+                while (b > a && is_space(list[b - 1])) {
+                    b--;
+                }
+                if (b > a) {
+                    properties.push_back(list.substr(a, b - a));
+                }
+                start = comma + 1;
+            }
+        }
+    }
+
+    size_t limit = NODE_QUERY_DEFAULT_LIMIT;
+    if (params.contains("limit")) {
+        json value = params["limit"];
+        if (value.is_string() && !parse_number(value.get<std::string>(), value)) {
+            error = "limit must be a number";
+            return false;
+        }
+        if (!value.is_number() || value.get<double>() < 1) {
+            error = "limit must be a positive number";
+            return false;
+        }
+        limit = static_cast<size_t>(std::min(value.get<double>(), static_cast<double>(NODE_QUERY_MAX_LIMIT)));
+    }
+
+    NodeQueryResult r = run_node_query(view, sel, properties, limit, index);
+    if (!r.root_found) {
+        error = "no node at " + sel.root;
+        return false;
+    }
+
+    json matches = json::array();
+    for (NodeMatch& m : r.matches) {
+        json entry = {{"path", std::move(m.path)}, {"class", std::move(m.class_name)}};
+        if (!properties.empty()) {
+            entry["properties"] = std::move(m.properties);
+        }
+        matches.push_back(std::move(entry));
+    }
+    result = {
+        {"matches", std::move(matches)},
+        {"count", r.matches.size()},
+        {"truncated", r.truncated},
+        {"visited", r.visited},
+        {"source", r.source}
+    };
+    return true;
+}
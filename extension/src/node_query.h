@@ -0,0 +1,153 @@
+#pragma once
+
+#include "editor_views.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// selector queries over the running scene tree (no godot dependency).
+//
+// the game runtime answers query_nodes with the paths (and chosen
+// properties) of the nodes a compact selector matches, so finding "every
+// awake RigidBody3D under the level" is one request instead of a tree dump
+// plus one property request per candidate:
+//
+//   /root/Level RigidBody3D [sleeping == false] [mass > 2]
+//   Area2D #Hitbox* .enemies :depth(3)
+//
+// terms, all optional and all required to match:
+//   /path          the subtree to search (default /root); its descendants
+//                  are searched, not the node itself
+//   Type           native class, subclasses included (like is_class())
+//   #glob          node name, with * and ? wildcards
+//   .group         member of the group
+//   [prop op val]  property test; op is == != < <= > >=, val is a number,
+//                  true, false, null, a "quoted" or a bare string
+//   :depth(n)      at most n levels below the root
+//
+// candidates come from the narrowest index available: the group's member
+// list (godot keeps one per group), else the class index the runtime
+// maintains, else a walk of the subtree.
+
+// the running scene tree; the game implementation is GodotSceneView
+// (godot_views.h), tests and benchmarks use MockSceneTree
+class SceneView {
+public:
+    virtual ~SceneView() = default;
+
+    // absolute node path -> node, nullptr if there is none
+    virtual NodeHandle find(const std::string& path) const = 0;
+    virtual NodeHandle parent(NodeHandle node) const = 0;
+    virtual int child_count(NodeHandle node) const = 0;
+    virtual NodeHandle child(NodeHandle node, int index) const = 0;
+
+    virtual std::string name(NodeHandle node) const = 0;
+    virtual std::string path(NodeHandle node) const = 0;
+    virtual std::string class_name(NodeHandle node) const = 0;
+    // exact class or any base class, like Object::is_class()
+    virtual bool is_class(NodeHandle node, const std::string& class_name) const = 0;
+    // ClassDB::is_parent_class(): cls is base or derives from it
+    virtual bool inherits(const std::string& cls, const std::string& base) const = 0;
+
+    virtual bool in_group(NodeHandle node, const std::string& group) const = 0;
+    virtual void group_members(const std::string& group, std::vector<NodeHandle>& out) const = 0;
+
+    // the property as JSON: bools and numbers as themselves, everything else
+    // as its str() text. false when the node has no such property
+    virtual bool property(NodeHandle node, const std::string& name, nlohmann::json& out) const = 0;
+};
+
+enum class CompareOp {
+    eq,
+    ne,
+    lt,
+    le,
+    gt,
+    ge,
+};
+
+struct PropertyTest {
+    std::string property;
+    CompareOp op = CompareOp::eq;
+    nlohmann::json value;
+};
+
+struct NodeSelector {
+    std::string root = "/root";
+    std::string type;           // "" for any
+    std::string name_glob;      // "" for any
+    std::string group;          // "" for any
+    std::vector<PropertyTest> tests;
+    int max_depth = 0;          // 0: unlimited
+};
+
+// parse the compact selector form. false, with error set, on a malformed term
+bool parse_selector(const std::string& text, NodeSelector& out, std::string& error);
+
+// name glob with * (any run) and ? (one character)
+bool glob_match(const std::string& pattern, const std::string& text);
+
+// one property test against a value; numbers compare numerically, strings
+// lexically, anything else only for (in)equality
+bool compare_values(const nlohmann::json& actual, CompareOp op, const nlohmann::json& expected);
+
+// node class -> nodes, kept current by the game runtime from the scene
+// tree's node_added / node_removed signals
+class NodeClassIndex {
+public:
+    void add(NodeHandle node, const std::string& class_name);
+    void remove(NodeHandle node);
+    void clear();
+
+    size_t size() const { return slots.size(); }
+
+    // nodes whose class is base or inherits from it, in no particular order
+    void collect(const SceneView& view, const std::string& base, std::vector<NodeHandle>& out) const;
+
+private:
+    struct Slot {
+        uint32_t class_id = 0;
+        size_t position = 0;
+    };
+
+    std::unordered_map<std::string, uint32_t> class_ids;
+    std::vector<std::string> class_names;           // by id
+    std::vector<std::vector<NodeHandle>> members;   // by id
+    std::unordered_map<NodeHandle, Slot> slots;
+};
+
+constexpr size_t NODE_QUERY_DEFAULT_LIMIT = 100;
+constexpr size_t NODE_QUERY_MAX_LIMIT = 10000;
+
+struct NodeMatch {
+    NodeHandle node = nullptr;
+    std::string path;
+    std::string class_name;
+    nlohmann::json properties;  // the requested ones the node has
+};
+
+struct NodeQueryResult {
+    bool root_found = true;
+    std::vector<NodeMatch> matches;
+    bool truncated = false;     // limit reached with candidates left
+    size_t visited = 0;         // candidates tested
+    const char* source = "walk";  // "walk", "group" or "class_index"
+};
+
+// run sel over view. index may be nullptr (no class index yet). matches are
+// in tree order for a walk and unordered from an index
+NodeQueryResult run_node_query(const SceneView& view, const NodeSelector& sel,
+                               const std::vector<std::string>& properties, size_t limit,
+                               const NodeClassIndex* index);
+
+// run_node_query() for the params of a query_nodes request: selector
+// (string), properties (array, or a comma-separated string) and limit (a
+// number or numeric string, as the udp transport sends). false, with error
+// set, for bad params
+bool query_nodes(const SceneView& view, const nlohmann::json& params, const NodeClassIndex* index,
+                 nlohmann::json& result, std::string& error);
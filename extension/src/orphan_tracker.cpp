@@ -0,0 +1,125 @@
+#include "orphan_tracker.h"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+uint32_t OrphanTracker::intern(std::string_view class_name, std::string_view script, std::string_view scene_file) {
+    scratch.assign(class_name);
+    scratch += '\0';
+    scratch.append(script);
+    scratch += '\0';
+    scratch.append(scene_file);
+    auto it = key_ids.find(scratch);
+    if (it != key_ids.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(keys.size());
+    keys.push_back(OrphanKey{std::string(class_name), std::string(script), std::string(scene_file)});
+    key_ids.emplace(scratch, id);
+    return id;
+}
+
+void OrphanTracker::detached(const DetachedNode& node) {
+    auto it = nodes.find(node.id);
+    if (it != nodes.end()) {
+        it->second = node;
+        return;
+    }
+    if (nodes.size() >= max_entries) {
+        dropped_count++;
+        return;
+    }
+    nodes.emplace(node.id, node);
+}
+
+void OrphanTracker::attached(uint64_t id) {
+    nodes.erase(id);
+}
+
+void OrphanTracker::clear() {
+    nodes.clear();
+    dropped_count = 0;
+}
+
+size_t OrphanTracker::sweep(const std::function<DetachedState(uint64_t id)>& state) {
+    for (auto it = nodes.begin(); it != nodes.end(); ) {
+        DetachedState s = state(it->first);
+        if (s == DetachedState::freed || s == DetachedState::in_tree) {
+            it = nodes.erase(it);
+            continue;
+        }
+        it->second.root = s == DetachedState::orphan_root;
+        ++it;
+    }
+    return nodes.size();
+}
+
+json orphan_groups_json(const OrphanTracker& tracker, size_t limit, size_t samples, int64_t now_ms,
+                        const std::function<json(const DetachedNode&)>& describe) {
+    struct Group {
+        uint32_t key = 0;
+        size_t count = 0;
+        size_t roots = 0;
+        int64_t oldest_ms = 0;
+        std::vector<const DetachedNode*> sample_roots;
+    };
+    std::unordered_map<uint32_t, Group> by_key;
+    size_t roots = 0;
+    for (const auto& [id, node] : tracker.all()) {
+        Group& g = by_key[node.key];
+        g.key = node.key;
+        if (g.count++ == 0 || node.time_ms < g.oldest_ms) {
+            g.oldest_ms = node.time_ms;
+        }
+        if (node.root) {
+            g.roots++;
+            roots++;
+            g.sample_roots.push_back(&node);
+        }
+    }
+
+    std::vector<Group*> groups;
+    groups.reserve(by_key.size());
+    for (auto& [key, g] : by_key) {
+        groups.push_back(&g);
+    }
+    std::sort(groups.begin(), groups.end(), [](const Group* a, const Group* b) {
+        return a->count != b->count ? a->count > b->count : a->key < b->key;
+    });
+
+    json out = json::array();
+    for (size_t i = 0; i < groups.size() && i < limit; i++) {
+        Group& g = *groups[i];
+        const OrphanKey& key = tracker.key(g.key);
+        json entry = {
+            {"class", key.class_name},
+            {"count", g.count},
+            {"roots", g.roots},
+            {"oldest_s", static_cast<double>(now_ms - g.oldest_ms) / 1000.0}
+        };
+        if (!key.script.empty()) {
+            entry["script"] = key.script;
+        }
+        if (!key.scene_file.empty()) {
+            entry["scene_file"] = key.scene_file;
+        }
+        // the longest-lived roots are the likeliest leaks
+        size_t n = std::min(samples, g.sample_roots.size());
+        std::partial_sort(g.sample_roots.begin(), g.sample_roots.begin() + static_cast<std::ptrdiff_t>(n),
+                          g.sample_roots.end(),
+                          [](const DetachedNode* a, const DetachedNode* b) { return a->time_ms < b->time_ms; });
+        json sample_list = json::array();
+        for (size_t j = 0; j < n; j++) {
+            sample_list.push_back(describe(*g.sample_roots[j]));
+        }
+        entry["samples"] = std::move(sample_list);
+        out.push_back(std::move(entry));
+    }
+    return {
+        {"tracked", tracker.size()},
+        {"roots", roots},
+        {"dropped", tracker.dropped()},
+        {"groups", std::move(out)}
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// orphan node tracking (no godot dependency).
+//
+// godot counts orphan nodes (alive, outside the tree) but can't say which
+// they are. the game runtime records every node that leaves the tree
+// (SceneTree.node_removed) here, forgets it again when it comes back
+// (node_added), and periodically sweeps out the ones that were freed. what's
+// left are orphans, each tagged with its class, script and the scene file it
+// was instantiated from, the parent it was detached from and when.
+//
+// an entry is 48 bytes and recording one allocates nothing once its
+// class/script/scene key has been seen. nodes that never entered the tree
+// (Node.new() never added) aren't seen; the engine's orphan count minus the
+// tracked ones reports them as untracked.
+
+struct OrphanKey {
+    std::string class_name;
+    std::string script;         // resource path, "" for none
+    std::string scene_file;     // scene_file_path, "" unless a scene's root
+};
+
+struct DetachedNode {
+    uint64_t id = 0;            // ObjectID
+    uint64_t parent_id = 0;     // the parent it was removed from, 0 if none
+    uint32_t key = 0;           // OrphanTracker::intern()
+    bool root = false;          // no parent at the last sweep
+    int64_t time_ms = 0;        // unix ms it left the tree
+    uint64_t frame = 0;
+};
+
+enum class DetachedState {
+    freed,
+    in_tree,
+    orphan_root,                // no parent: free this one
+    orphan_child,               // under an orphan root
+};
+
+// entries kept before new detaches are dropped (and counted)
+constexpr size_t ORPHAN_TRACK_MAX = 1 << 18;
+
+class OrphanTracker {
+public:
+    explicit OrphanTracker(size_t max_entries = ORPHAN_TRACK_MAX) : max_entries(max_entries) {}
+
+    uint32_t intern(std::string_view class_name, std::string_view script, std::string_view scene_file);
+    const OrphanKey& key(uint32_t id) const { return keys[id]; }
+
+    void detached(const DetachedNode& node);
+    void attached(uint64_t id);
+    void clear();
+
+    // ask state() about every entry; drop the freed and re-added ones and
+    // mark the roots. returns the entries left
+    size_t sweep(const std::function<DetachedState(uint64_t id)>& state);
+
+    size_t size() const { return nodes.size(); }
+    uint64_t dropped() const { return dropped_count; }
+    const std::unordered_map<uint64_t, DetachedNode>& all() const { return nodes; }
+
+private:
+    size_t max_entries;
+    uint64_t dropped_count = 0;
+    std::unordered_map<uint64_t, DetachedNode> nodes;
+
+    std::vector<OrphanKey> keys;
+    std::unordered_map<std::string, uint32_t> key_ids;  // class '\0' script '\0' scene
+    std::string scratch;
+};
+
+// the orphans of a swept tracker grouped by key, largest group first.
+// describe() turns up to samples roots per group into JSON (godot resolves
+// names and parent paths); now_ms dates the ages
+nlohmann::json orphan_groups_json(const OrphanTracker& tracker, size_t limit, size_t samples, int64_t now_ms,
+                                  const std::function<nlohmann::json(const DetachedNode&)>& describe);
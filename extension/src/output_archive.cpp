@@ -0,0 +1,491 @@
+#include "output_archive.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include <dirent.h>    // opendir(), readdir()
+#include <fcntl.h>     // open()
+#include <sys/mman.h>  // mmap()
+#include <sys/stat.h>  // mkdir(), fstat()
+#include <unistd.h>    // ftruncate(), pread(), unlink()
+
+// on-disk layout. everything is little-endian host order: the archive is
+// only ever read back on the machine that wrote it
+
+struct SegmentHeader {
+    char magic[8];
+    int64_t session;
+    uint64_t first_seq;
+    uint64_t reserved;
+};
+static_assert(sizeof(SegmentHeader) == 32);
+
+// followed by length bytes of text, padded to 8. a zero seq marks the end of
+// the records (the rest of a preallocated segment is zero-filled)
+struct RecordHeader {
+    uint64_t seq;
+    int64_t time_ms;
+    uint32_t length;
+    uint32_t flags;     // ArchiveRecord::flags
+};
+static_assert(sizeof(RecordHeader) == 24);
+
+struct IndexEntry {
+    uint64_t seq;
+    int64_t time_ms;
+    uint64_t offset;    // of the record in the .log file
+};
+static_assert(sizeof(IndexEntry) == 24);
+
+static constexpr char SEGMENT_MAGIC[8] = {'P', 'E', 'E', 'K', 'O', 'U', 'T', '1'};
+
+static uint64_t pad8(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+// a whole file mapped read-only (empty when it can't be opened or is empty)
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) {
+                data = static_cast<const char*>(p);
+                size = static_cast<uint64_t>(st.st_size);
+            }
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data = nullptr;
+    uint64_t size = 0;
+};
+
+// the record at off, if there is one. text points into the mapping
+static bool read_record(const MappedFile& log, uint64_t off, RecordHeader& header, const char*& text) {
+    if (off + sizeof(RecordHeader) > log.size) {
+        return false;
+    }
+    memcpy(&header, log.data + off, sizeof(header));
+    if (header.seq == 0 || off + sizeof(RecordHeader) + header.length > log.size) {
+        return false;
+    }
+    text = log.data + off + sizeof(RecordHeader);
+    return true;
+}
+
+static uint64_t record_size(const RecordHeader& header) {
+    return sizeof(RecordHeader) + pad8(header.length);
+}
+
+static size_t index_entries(const MappedFile& idx) {
+    return static_cast<size_t>(idx.size / sizeof(IndexEntry));
+}
+
+static IndexEntry index_entry(const MappedFile& idx, size_t i) {
+    IndexEntry e;
+    memcpy(&e, idx.data + i * sizeof(IndexEntry), sizeof(e));
+    return e;
+}
+
+// the first index entry of a segment without mapping it. false when the
+// segment has no records yet
+static bool first_index_entry(const std::string& path, IndexEntry& e) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = pread(fd, &e, sizeof(e), 0) == static_cast<ssize_t>(sizeof(e));
+    close(fd);
+    return ok;
+}
+
+// mkdir -p
+static bool make_dirs(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); pos++) {
+        if (pos == path.size() || path[pos] == '/') {
+            std::string part = path.substr(0, pos);
+            if (mkdir(part.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string default_archive_dir(const std::string& project_hash) {
+    const char* env = std::getenv("GODOT_PEEK_ARCHIVE");
+    std::string base = env && *env ? env : "/tmp/godot-peek-archive";
+    return base + "/" + project_hash;
+}
+
+// --- OutputArchive ---
+
+OutputArchive::OutputArchive(std::string dir, uint64_t max_bytes, uint64_t segment_bytes)
+    : dir(std::move(dir)), max_bytes(max_bytes), segment_bytes(segment_bytes) {
+}
+
+OutputArchive::~OutputArchive() {
+    end_session();
+}
+
+std::string OutputArchive::segment_path(int64_t session, uint32_t number, const char* ext) const {
+    char name[64];
+    snprintf(name, sizeof(name), "/%013lld-%06u.%s", static_cast<long long>(session), number, ext);
+    return dir + name;
+}
+
+std::vector<OutputArchive::SegmentFile> OutputArchive::catalog() const {
+    std::map<std::pair<int64_t, uint32_t>, uint64_t> sizes;
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return {};
+    }
+    while (dirent* entry = readdir(d)) {
+        long long session = 0;
+        unsigned number = 0;
+        char ext[4] = {};
+        if (sscanf(entry->d_name, "%lld-%u.%3s", &session, &number, ext) != 3 ||
+            (strcmp(ext, "log") != 0 && strcmp(ext, "idx") != 0)) {
+            continue;
+        }
+        struct stat st;
+        std::string path = dir + "/" + entry->d_name;
+        uint64_t bytes = stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        sizes[{static_cast<int64_t>(session), static_cast<uint32_t>(number)}] += bytes;
+    }
+    closedir(d);
+
+    // std::map keeps them ordered by (session, segment), i.e. oldest first
+    std::vector<SegmentFile> files;
+    files.reserve(sizes.size());
+    for (const auto& [key, bytes] : sizes) {
+        files.push_back(SegmentFile{key.first, key.second, bytes});
+    }
+    return files;
+}
+
+bool OutputArchive::begin_session(int64_t now_ms) {
+    end_session();
+    if (!make_dirs(dir)) {
+        return false;
+    }
+
+    // ids are start times, but must stay unique and increasing even if two
+    // sessions start in the same millisecond or the clock went back
+    int64_t id = now_ms;
+    std::vector<SegmentFile> files = catalog();
+    if (!files.empty() && files.back().session >= id) {
+        id = files.back().session + 1;
+    }
+
+    session_id = id;
+    segment_number = 0;
+    next_seq = 1;
+    last_ms = now_ms;
+    if (!open_segment(0, 0)) {
+        session_id = 0;
+        return false;
+    }
+    enforce_retention();
+    return true;
+}
+
+void OutputArchive::end_session() {
+    seal_segment();
+    session_id = 0;
+}
+
+bool OutputArchive::open_segment(uint32_t number, uint64_t min_bytes) {
+    capacity = std::max(segment_bytes, sizeof(SegmentHeader) + min_bytes);
+    std::string log_path = segment_path(session_id, number, "log");
+    log_fd = open(log_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (log_fd < 0) {
+        return false;
+    }
+    // preallocated so appends are plain stores into the mapping
+    void* p = MAP_FAILED;
+    if (ftruncate(log_fd, static_cast<off_t>(capacity)) == 0) {
+        p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, log_fd, 0);
+    }
+    idx_fd = open(segment_path(session_id, number, "idx").c_str(),
+                  O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (p == MAP_FAILED || idx_fd < 0) {
+        if (p != MAP_FAILED) {
+            munmap(p, capacity);
+        }
+        close(log_fd);
+        log_fd = -1;
+        if (idx_fd >= 0) {
+            close(idx_fd);
+            idx_fd = -1;
+        }
+        unlink(log_path.c_str());
+        unlink(segment_path(session_id, number, "idx").c_str());
+        return false;
+    }
+
+    map = static_cast<char*>(p);
+    SegmentHeader header = {};
+    memcpy(header.magic, SEGMENT_MAGIC, sizeof(header.magic));
+    header.session = session_id;
+    header.first_seq = next_seq;
+    memcpy(map, &header, sizeof(header));
+
+    segment_number = number;
+    used = sizeof(SegmentHeader);
+    since_index = ARCHIVE_INDEX_STRIDE;  // the first record is always indexed
+    return true;
+}
+
+void OutputArchive::seal_segment() {
+    if (map) {
+        munmap(map, capacity);
+        map = nullptr;
+    }
+    if (log_fd >= 0) {
+        // drop the unused preallocation
+        if (ftruncate(log_fd, static_cast<off_t>(used)) != 0) {
+            // the zero tail still reads as the end of the records
+        }
+        close(log_fd);
+        log_fd = -1;
+    }
+    if (idx_fd >= 0) {
+        close(idx_fd);
+        idx_fd = -1;
+    }
+}
+
+void OutputArchive::enforce_retention() {
+    std::vector<SegmentFile> files = catalog();
+    // the live segment is preallocated already, but its index still grows
+    uint64_t total = (capacity / ARCHIVE_INDEX_STRIDE + 1) * sizeof(IndexEntry);
+    for (const SegmentFile& f : files) {
+        total += f.bytes;
+    }
+    for (const SegmentFile& f : files) {
+        if (total <= max_bytes) {
+            break;
+        }
+        if (f.session == session_id && f.number == segment_number) {
+            continue;
+        }
+        unlink(segment_path(f.session, f.number, "log").c_str());
+        unlink(segment_path(f.session, f.number, "idx").c_str());
+        total -= f.bytes;
+    }
+}
+
+uint64_t OutputArchive::append(const std::string& line, int64_t now_ms, uint32_t flags) {
+    if (!map) {
+        return 0;
+    }
+    int64_t time_ms = std::max(now_ms, last_ms);
+    uint64_t length = std::min<uint64_t>(line.size(), UINT32_MAX);
+    uint64_t size = sizeof(RecordHeader) + pad8(length);
+
+    if (used + size > capacity) {
+        seal_segment();
+        if (!open_segment(segment_number + 1, size)) {
+            return 0;
+        }
+        enforce_retention();
+    }
+
+    if (since_index >= ARCHIVE_INDEX_STRIDE) {
+        IndexEntry e = {next_seq, time_ms, used};
+        if (write(idx_fd, &e, sizeof(e)) != static_cast<ssize_t>(sizeof(e))) {
+            return 0;
+        }
+        since_index = 0;
+    }
+
+    // text first, header last: a reader never sees a seq without its text
+    RecordHeader header = {next_seq, time_ms, static_cast<uint32_t>(length), flags};
+    memcpy(map + used + sizeof(RecordHeader), line.data(), length);
+    memcpy(map + used, &header, sizeof(header));
+    used += size;
+    since_index += size;
+    last_ms = time_ms;
+    return next_seq++;
+}
+
+uint64_t OutputArchive::disk_bytes() const {
+    uint64_t total = 0;
+    for (const SegmentFile& f : catalog()) {
+        total += f.bytes;
+    }
+    return total;
+}
+
+std::vector<ArchiveSession> OutputArchive::list_sessions() const {
+    std::vector<SegmentFile> files = catalog();
+    std::vector<ArchiveSession> sessions;
+    size_t begin = 0;
+    while (begin < files.size()) {
+        size_t end = begin;
+        ArchiveSession s;
+        s.id = files[begin].session;
+        while (end < files.size() && files[end].session == s.id) {
+            s.bytes += files[end].bytes;
+            s.segments++;
+            end++;
+        }
+
+        IndexEntry first;
+        for (size_t i = begin; i < end; i++) {
+            if (first_index_entry(segment_path(s.id, files[i].number, "idx"), first)) {
+                s.first_seq = first.seq;
+                s.first_ms = first.time_ms;
+                break;
+            }
+        }
+
+        // the last line: scan the newest segment with records from its last
+        // index entry on
+        for (size_t i = end; i-- > begin && s.first_seq != 0;) {
+            MappedFile idx(segment_path(s.id, files[i].number, "idx"));
+            size_t n = index_entries(idx);
+            if (n == 0) {
+                continue;
+            }
+            MappedFile log(segment_path(s.id, files[i].number, "log"));
+            RecordHeader header;
+            const char* text;
+            for (uint64_t off = index_entry(idx, n - 1).offset; read_record(log, off, header, text);
+                 off += record_size(header)) {
+                s.last_seq = header.seq;
+                s.last_ms = header.time_ms;
+            }
+            break;
+        }
+
+        sessions.push_back(s);
+        begin = end;
+    }
+    return sessions;
+}
+
+// where a scan for key >= value starts within one session's segments:
+// the last segment starting at or before value, then the last index entry
+// at or before it. both searches are binary
+template <typename Key>
+static std::pair<size_t, uint64_t> locate(const std::vector<std::string>& idx_paths, Key key,
+                                          decltype(key(IndexEntry{})) value) {
+    size_t lo = 0;
+    size_t hi = idx_paths.size();
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        IndexEntry e;
+        // a segment without records can only be the newest one
+        if (first_index_entry(idx_paths[mid], e) && key(e) <= value) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    MappedFile idx(idx_paths[lo]);
+    size_t n = index_entries(idx);
+    if (n == 0) {
+        return {lo, sizeof(SegmentHeader)};
+    }
+    size_t a = 0;
+    size_t b = n;
+    while (b - a > 1) {
+        size_t mid = (a + b) / 2;
+        if (key(index_entry(idx, mid)) <= value) {
+            a = mid;
+        } else {
+            b = mid;
+        }
+    }
+    return {lo, index_entry(idx, a).offset};
+}
+
+ArchiveResult OutputArchive::query(const ArchiveQuery& q) const {
+    ArchiveResult result;
+    std::vector<SegmentFile> files = catalog();
+    if (files.empty()) {
+        return result;
+    }
+
+    // resolve the session: ids in age order, relative to the current one
+    std::vector<int64_t> ids;
+    for (const SegmentFile& f : files) {
+        if (ids.empty() || ids.back() != f.session) {
+            ids.push_back(f.session);
+        }
+    }
+    int64_t id = q.session;
+    if (id <= 0) {
+        auto base = std::find(ids.begin(), ids.end(), session_id);
+        int64_t pos = (base == ids.end() ? static_cast<int64_t>(ids.size()) - 1 : base - ids.begin()) + id;
+        if (pos < 0) {
+            return result;
+        }
+        id = ids[static_cast<size_t>(pos)];
+    } else if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+        return result;
+    }
+    result.session = id;
+
+    std::vector<std::string> idx_paths;
+    std::vector<std::string> log_paths;
+    for (const SegmentFile& f : files) {
+        if (f.session == id) {
+            idx_paths.push_back(segment_path(id, f.number, "idx"));
+            log_paths.push_back(segment_path(id, f.number, "log"));
+        }
+    }
+
+    // start from whichever bound is further in; both keys only grow
+    std::pair<size_t, uint64_t> start = locate(idx_paths, [](const IndexEntry& e) { return e.seq; }, q.from_seq);
+    if (q.from_ms != std::numeric_limits<int64_t>::min()) {
+        std::pair<size_t, uint64_t> by_time =
+            locate(idx_paths, [](const IndexEntry& e) { return e.time_ms; }, q.from_ms);
+        start = std::max(start, by_time);
+    }
+
+    uint64_t off = start.second;
+    for (size_t i = start.first; i < log_paths.size(); i++, off = sizeof(SegmentHeader)) {
+        MappedFile log(log_paths[i]);
+        RecordHeader header;
+        const char* text;
+        for (; read_record(log, off, header, text); off += record_size(header)) {
+            if (header.seq > q.to_seq || header.time_ms > q.to_ms) {
+                return result;
+            }
+            uint32_t level = header.flags & 0xff;
+            if (header.seq < q.from_seq || header.time_ms < q.from_ms ||
+                (q.level_mask != 0 && (level >= 32 || !(q.level_mask & (1u << level))))) {
+                continue;
+            }
+            if (result.records.size() >= q.limit) {
+                result.truncated = true;
+                return result;
+            }
+            result.records.push_back(
+                ArchiveRecord{header.seq, header.time_ms, header.flags, std::string(text, header.length)});
+        }
+    }
+    return result;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// persistent archive of captured output lines (no godot dependency).
+//
+// every session (one per editor start and per game launch) writes
+// append-only segment files into the archive directory:
+//   <session>-<segment>.log  memory-mapped records, preallocated to
+//                            ARCHIVE_SEGMENT_BYTES and trimmed when sealed
+//   <session>-<segment>.idx  sparse index: one (seq, time, offset) entry per
+//                            ARCHIVE_INDEX_STRIDE bytes of records
+// sessions are named by their start time (unix ms), so sorting file names
+// sorts them by age.
+//
+// a query binary-searches the segments of a session and then the index of
+// one segment, and scans at most one stride of records before the first
+// match, so looking up a range or a point in time costs O(log n) plus the
+// lines returned. when the directory grows past the size budget the oldest
+// segments are deleted; the one being written never is.
+
+constexpr uint64_t ARCHIVE_SEGMENT_BYTES = 4ull << 20;
+constexpr uint64_t ARCHIVE_MAX_BYTES = 256ull << 20;
+constexpr uint64_t ARCHIVE_INDEX_STRIDE = 4096;
+
+// $GODOT_PEEK_ARCHIVE/<project_hash>, or /tmp/godot-peek-archive/<project_hash>
+std::string default_archive_dir(const std::string& project_hash);
+
+// one archived line
+struct ArchiveRecord {
+    uint64_t seq = 0;       // 1-based, per session
+    int64_t time_ms = 0;    // unix ms, never decreasing within a session
+    uint32_t flags = 0;     // low byte: OutputLevel (output_columns.h)
+    std::string text;
+};
+
+// what list_sessions reports per session still (partly) on disk
+struct ArchiveSession {
+    int64_t id = 0;             // start time, unix ms
+    uint64_t first_seq = 0;     // 0 when the session has no lines
+    uint64_t last_seq = 0;
+    int64_t first_ms = 0;
+    int64_t last_ms = 0;
+    uint64_t bytes = 0;         // on disk, index included
+    uint32_t segments = 0;
+};
+
+struct ArchiveQuery {
+    // 0: the session being written (or the newest one). negative: that many
+    // sessions before it. anything else: a session id
+    int64_t session = 0;
+    uint64_t from_seq = 0;
+    uint64_t to_seq = std::numeric_limits<uint64_t>::max();
+    int64_t from_ms = std::numeric_limits<int64_t>::min();
+    int64_t to_ms = std::numeric_limits<int64_t>::max();
+    uint32_t level_mask = 0;    // bit n: lines whose flags level is n. 0: all
+    size_t limit = 1000;
+};
+
+struct ArchiveResult {
+    int64_t session = 0;        // resolved id, 0 if there was no such session
+    std::vector<ArchiveRecord> records;
+    bool truncated = false;     // limit reached before the end of the range
+};
+
+class OutputArchive {
+public:
+    explicit OutputArchive(std::string dir, uint64_t max_bytes = ARCHIVE_MAX_BYTES,
+                           uint64_t segment_bytes = ARCHIVE_SEGMENT_BYTES);
+    ~OutputArchive();
+
+    OutputArchive(const OutputArchive&) = delete;
+    OutputArchive& operator=(const OutputArchive&) = delete;
+
+    // seal the current session (if any) and start a new one. false if the
+    // directory or the first segment can't be created
+    bool begin_session(int64_t now_ms);
+
+    // seal the current session; appends are dropped until the next one
+    void end_session();
+
+    // archive one line (without its newline). returns its seq, 0 if there is
+    // no session or the write failed
+    uint64_t append(const std::string& line, int64_t now_ms, uint32_t flags = 0);
+
+    // id of the session being written, 0 if none
+    int64_t current_session() const { return session_id; }
+
+    // every session on disk, oldest first
+    std::vector<ArchiveSession> list_sessions() const;
+
+    ArchiveResult query(const ArchiveQuery& q) const;
+
+    // size of all segment and index files
+    uint64_t disk_bytes() const;
+
+    const std::string& directory() const { return dir; }
+
+private:
+    struct SegmentFile {
+        int64_t session = 0;
+        uint32_t number = 0;
+        uint64_t bytes = 0;
+    };
+
+    std::string segment_path(int64_t session, uint32_t number, const char* ext) const;
+    std::vector<SegmentFile> catalog() const;
+    bool open_segment(uint32_t number, uint64_t min_bytes);
+    void seal_segment();
+    void enforce_retention();
+
+    std::string dir;
+    uint64_t max_bytes;
+    uint64_t segment_bytes;
+
+    // the segment being written
+    int64_t session_id = 0;
+    uint32_t segment_number = 0;
+    int log_fd = -1;
+    int idx_fd = -1;
+    char* map = nullptr;
+    uint64_t capacity = 0;
+    uint64_t used = 0;
+    uint64_t since_index = 0;   // record bytes since the last index entry
+    uint64_t next_seq = 1;
+    int64_t last_ms = 0;
+};
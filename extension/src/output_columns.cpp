@@ -0,0 +1,139 @@
+#include "output_columns.h"
+
+#include <algorithm>
+#include <limits>
+
+const char* output_level_name(OutputLevel level) {
+    switch (level) {
+        case OutputLevel::warning: return "warning";
+        case OutputLevel::error: return "error";
+        default: return "print";
+    }
+}
+
+bool parse_output_level(const std::string& name, OutputLevel& level) {
+    for (int i = 0; i < OUTPUT_LEVEL_COUNT; i++) {
+        if (name == output_level_name(static_cast<OutputLevel>(i))) {
+            level = static_cast<OutputLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+OutputLevel classify_output_line(std::string_view line, OutputLevel previous) {
+    // "   at: func (file:line)" and "   <GDScript Source>..." under an error
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+        return OutputLevel::print;
+    }
+    if (start > 0 && (line.compare(start, 3, "at:") == 0 || line[start] == '<')) {
+        return previous;
+    }
+
+    // "ERROR: ...", "SCRIPT ERROR: ...", "USER WARNING: ...": an all-caps
+    // tag before the first colon
+    size_t colon = line.find(':');
+    if (colon != std::string_view::npos && colon > 0 && colon <= 24) {
+        std::string_view tag = line.substr(0, colon);
+        bool caps = std::all_of(tag.begin(), tag.end(), [](char c) { return (c >= 'A' && c <= 'Z') || c == ' '; });
+        if (caps && tag.find("ERROR") != std::string_view::npos) {
+            return OutputLevel::error;
+        }
+        if (caps && tag.find("WARNING") != std::string_view::npos) {
+            return OutputLevel::warning;
+        }
+    }
+
+    // "E 0:00:01:234 ..." / "W 0:00:01:234 ..." as the debugger formats them
+    if (line.size() > 3 && (line[0] == 'E' || line[0] == 'W') && line[1] == ' ' && line[2] >= '0' &&
+        line[2] <= '9' && line[3] == ':') {
+        return line[0] == 'E' ? OutputLevel::error : OutputLevel::warning;
+    }
+    return OutputLevel::print;
+}
+
+// --- OutputColumns ---
+
+void OutputColumns::clear() {
+    base_seq = 0;
+    base_capture_frame = 0;
+    levels.clear();
+    mono.clear();
+    capture_frames.clear();
+    debug_runs.clear();
+}
+
+void OutputColumns::append(uint64_t seq, const LineMeta& meta) {
+    if (levels.empty() || seq != base_seq + levels.size()) {
+        clear();
+        base_seq = seq;
+        base_capture_frame = meta.capture_frame;
+    }
+    if (levels.size() >= max_rows) {
+        evict(std::max<size_t>(max_rows / 4, 1));
+    }
+
+    constexpr uint64_t max32 = std::numeric_limits<uint32_t>::max();
+    levels.push_back(static_cast<uint8_t>(meta.level));
+    mono.push_back(static_cast<uint32_t>(std::min(meta.mono_ms, max32)));
+    uint64_t frame = meta.capture_frame - std::min(meta.capture_frame, base_capture_frame);
+    capture_frames.push_back(static_cast<uint32_t>(std::min(frame, max32)));
+    if (debug_runs.empty() || debug_runs.back().second != meta.debug_session) {
+        debug_runs.emplace_back(seq, meta.debug_session);
+    }
+}
+
+void OutputColumns::evict(size_t rows) {
+    rows = std::min(rows, levels.size());
+    levels.erase(levels.begin(), levels.begin() + rows);
+    mono.erase(mono.begin(), mono.begin() + rows);
+    capture_frames.erase(capture_frames.begin(), capture_frames.begin() + rows);
+    base_seq += rows;
+
+    // keep the run that covers the new first row
+    size_t keep = 0;
+    while (keep + 1 < debug_runs.size() && debug_runs[keep + 1].first <= base_seq) {
+        keep++;
+    }
+    debug_runs.erase(debug_runs.begin(), debug_runs.begin() + keep);
+}
+
+bool OutputColumns::get(uint64_t seq, LineMeta& meta) const {
+    if (levels.empty() || seq < base_seq || seq - base_seq >= levels.size()) {
+        return false;
+    }
+    size_t row = static_cast<size_t>(seq - base_seq);
+    meta.level = static_cast<OutputLevel>(levels[row]);
+    meta.mono_ms = mono[row];
+    meta.capture_frame = base_capture_frame + capture_frames[row];
+
+    auto run = std::upper_bound(debug_runs.begin(), debug_runs.end(), seq,
+                                [](uint64_t s, const std::pair<uint64_t, int32_t>& r) { return s < r.first; });
+    meta.debug_session = run == debug_runs.begin() ? -1 : std::prev(run)->second;
+    return true;
+}
+
+std::vector<OutputColumns::Bucket> OutputColumns::histogram(uint64_t from_ms, uint64_t to_ms, uint64_t bucket_ms) const {
+    std::vector<Bucket> buckets;
+    if (bucket_ms == 0 || from_ms > to_ms) {
+        return buckets;
+    }
+    // the mono column never decreases
+    constexpr uint64_t max32 = std::numeric_limits<uint32_t>::max();
+    auto it = std::lower_bound(mono.begin(), mono.end(), static_cast<uint32_t>(std::min(from_ms, max32)));
+    for (size_t row = static_cast<size_t>(it - mono.begin()); row < mono.size() && mono[row] <= to_ms; row++) {
+        uint64_t start = mono[row] / bucket_ms * bucket_ms;
+        uint64_t frame = base_capture_frame + capture_frames[row];
+        if (buckets.empty() || buckets.back().start_ms != start) {
+            Bucket b;
+            b.start_ms = start;
+            b.first_capture_frame = frame;
+            buckets.push_back(b);
+        }
+        Bucket& b = buckets.back();
+        b.counts[levels[row]]++;
+        b.last_capture_frame = frame;
+    }
+    return buckets;
+}
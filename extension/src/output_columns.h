@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// per-line metadata for archived output (no godot dependency).
+//
+// the archive (output_archive.h) keeps each line's text and wall-clock time,
+// plus its level in the record flags. what only matters while a session is
+// live - a monotonic timestamp, the editor frame it was captured in and the
+// debugger session it came from - lives here, one column per field, so
+// counting errors per second over a whole session touches a few bytes per
+// line and never the text.
+
+enum class OutputLevel : uint8_t {
+    print = 0,
+    warning = 1,
+    error = 2,
+};
+constexpr int OUTPUT_LEVEL_COUNT = 3;
+
+const char* output_level_name(OutputLevel level);
+
+// "print" / "warning" / "error"; false for anything else
+bool parse_output_level(const std::string& name, OutputLevel& level);
+
+// the level of one Output panel line, from the prefixes godot prints errors
+// and warnings with ("ERROR:", "SCRIPT ERROR:", "USER WARNING:", ...).
+// continuation lines ("   at: ...", "   <GDScript Source>...") belong to the
+// message above them and keep previous
+OutputLevel classify_output_line(std::string_view line, OutputLevel previous);
+
+struct LineMeta {
+    OutputLevel level = OutputLevel::print;
+    uint64_t mono_ms = 0;       // monotonic, since the archive session began
+    uint64_t capture_frame = 0; // editor process frame the line was captured in,
+                                // not the game frame that printed it
+    int32_t debug_session = -1; // debugger session id, -1 when none
+};
+
+// bound on the rows kept in memory; the oldest quarter goes when it's hit
+constexpr size_t OUTPUT_COLUMNS_MAX_ROWS = 1 << 20;
+
+class OutputColumns {
+public:
+    explicit OutputColumns(size_t max_rows = OUTPUT_COLUMNS_MAX_ROWS) : max_rows(max_rows) {}
+
+    // drop every row; the next append sets the first seq
+    void clear();
+
+    // metadata for the line archived as seq. seqs are consecutive; a gap
+    // (a line the archive couldn't write) starts the columns over at seq
+    void append(uint64_t seq, const LineMeta& meta);
+
+    // false when seq was never appended or has been evicted
+    bool get(uint64_t seq, LineMeta& meta) const;
+
+    uint64_t first_seq() const { return base_seq; }
+    size_t size() const { return levels.size(); }
+
+    struct Bucket {
+        uint64_t start_ms = 0;                     // mono_ms of the bucket start
+        uint64_t counts[OUTPUT_LEVEL_COUNT] = {};  // lines per level
+        uint64_t first_capture_frame = 0;
+        uint64_t last_capture_frame = 0;
+    };
+
+    // lines per level in bucket_ms wide buckets over [from_ms, to_ms],
+    // oldest first. empty buckets are left out
+    std::vector<Bucket> histogram(uint64_t from_ms, uint64_t to_ms, uint64_t bucket_ms) const;
+
+private:
+    void evict(size_t rows);
+
+    size_t max_rows;
+    uint64_t base_seq = 0;      // seq of row 0
+    uint64_t base_capture_frame = 0;    // capture_frames are relative to this
+
+    // one entry per line
+    std::vector<uint8_t> levels;
+    std::vector<uint32_t> mono;             // ms since the session began
+    std::vector<uint32_t> capture_frames;   // relative to base_capture_frame
+
+    // debugger session changes rarely: (first seq, id) runs
+    std::vector<std::pair<uint64_t, int32_t>> debug_runs;
+};
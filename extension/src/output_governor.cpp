@@ -0,0 +1,30 @@
+#include "output_governor.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+size_t default_output_max_lines() {
+    const char* env = std::getenv("GODOT_PEEK_OUTPUT_MAX_LINES");
+    if (!env || !*env) {
+        return OUTPUT_GOVERNOR_DEFAULT_LINES;
+    }
+    return static_cast<size_t>(std::strtoull(env, nullptr, 10));
+}
+
+void OutputGovernor::set_max_lines(size_t lines) {
+    cap = lines == 0 ? 0 : std::max(lines, OUTPUT_GOVERNOR_MIN_LINES);
+}
+
+size_t OutputGovernor::lines_to_trim(size_t paragraphs) const {
+    if (cap == 0 || paragraphs <= cap) {
+        return 0;
+    }
+    return paragraphs - cap * 3 / 4;
+}
+
+std::string OutputGovernor::record_trim(size_t removed) {
+    trimmed += removed;
+    trim_count++;
+    return "[godot peek] " + std::to_string(removed) + " older lines removed from this panel (" +
+           std::to_string(trimmed) + " so far); the full output is in the archive (get_output with session/from_seq)";
+}
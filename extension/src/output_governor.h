@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// caps the editor's Output panel while the archive keeps everything
+// (no godot dependency; the panel edits live in MessageHandler).
+//
+// a RichTextLabel gets slower to lay out, draw and read back with every
+// paragraph, and EditorLog keeps every message in a list of its own, so a
+// game printing each frame drags the whole editor down and grows its
+// memory. once the panel holds more than max_lines paragraphs the Output
+// dock is cleared through its own Clear button, which empties both, and a
+// summary line says how much went where. when that button can't be found
+// only the label is trimmed, down to three quarters of the cap so it
+// happens once per quarter-cap of new lines rather than on every one. the
+// lines themselves are already in the output archive (output_archive.h) by
+// then.
+
+// the smallest cap that makes sense: below this the summaries would be
+// most of what's left
+constexpr size_t OUTPUT_GOVERNOR_MIN_LINES = 100;
+
+// the cap when nothing sets one: well past what anyone scrolls back
+// through, small enough that reading the panel back stays cheap
+constexpr size_t OUTPUT_GOVERNOR_DEFAULT_LINES = 10000;
+
+// $GODOT_PEEK_OUTPUT_MAX_LINES (0 turns the governor off), else
+// OUTPUT_GOVERNOR_DEFAULT_LINES
+size_t default_output_max_lines();
+
+class OutputGovernor {
+public:
+    // 0 turns the governor off; other values are raised to the minimum
+    void set_max_lines(size_t lines);
+    size_t max_lines() const { return cap; }
+
+    // paragraphs to drop from the top of a panel holding this many (when
+    // trimming the label), 0 while it is under the cap
+    size_t lines_to_trim(size_t paragraphs) const;
+
+    // count a trim and return the summary line to show for it
+    std::string record_trim(size_t removed);
+
+    uint64_t trimmed_lines() const { return trimmed; }
+    uint64_t trims() const { return trim_count; }
+
+private:
+    size_t cap = 0;
+    uint64_t trimmed = 0;
+    uint64_t trim_count = 0;
+};
@@ -0,0 +1,202 @@
+#include "physics_probe.h"
+
+#include <algorithm>
+
+using json = nlohmann::json;
+
+void PhysicsTickTimer::stop(int64_t now_us) {
+    if (started_us < 0) {
+        return;
+    }
+    int64_t us = std::max<int64_t>(now_us - started_us, 0);
+    started_us = -1;
+    window.ticks++;
+    window.total_us += us;
+    window.max_us = std::max(window.max_us, us);
+}
+
+TickStats PhysicsTickTimer::take() {
+    TickStats out = window;
+    window = TickStats{};
+    return out;
+}
+
+void PhysicsSampleStore::begin() {
+    pass_spaces.clear();
+    pass_processors.clear();
+}
+
+void PhysicsSampleStore::add_body(uint64_t space, uint8_t dims, BodyKind kind, bool active, bool frozen) {
+    SpaceCounts& s = pass_spaces[space];
+    s.space = space;
+    s.dims = dims;
+    switch (kind) {
+        case BodyKind::rigid:
+            s.rigid++;
+            s.rigid_active += active ? 1 : 0;
+            s.rigid_frozen += frozen ? 1 : 0;
+            break;
+        case BodyKind::character:
+            s.character++;
+            break;
+        case BodyKind::static_body:
+            s.static_bodies++;
+            break;
+        case BodyKind::area:
+            s.areas++;
+            break;
+    }
+}
+
+void PhysicsSampleStore::add_processor(std::string_view class_name, std::string_view script) {
+    scratch.assign(class_name);
+    scratch += '\0';
+    scratch.append(script);
+    auto it = key_ids.find(scratch);
+    uint32_t id;
+    if (it != key_ids.end()) {
+        id = it->second;
+    } else {
+        id = static_cast<uint32_t>(keys.size());
+        keys.push_back(CountKey{std::string(class_name), std::string(script)});
+        key_ids.emplace(scratch, id);
+    }
+    pass_processors[id]++;
+}
+
+const PhysicsSample& PhysicsSampleStore::commit(int64_t time_ms, uint64_t frame, const TickStats& tree,
+                                                double physics_ms, const PhysicsServerCounts& server_2d,
+                                                const PhysicsServerCounts& server_3d) {
+    PhysicsSample sample;
+    sample.id = next_id++;
+    sample.time_ms = time_ms;
+    sample.frame = frame;
+    sample.tree = tree;
+    sample.physics_ms = physics_ms;
+    sample.server_2d = server_2d;
+    sample.server_3d = server_3d;
+    sample.spaces.reserve(pass_spaces.size());
+    for (const auto& [space, counts] : pass_spaces) {
+        sample.spaces.push_back(counts);
+    }
+    std::sort(sample.spaces.begin(), sample.spaces.end(),
+              [](const SpaceCounts& a, const SpaceCounts& b) { return a.space < b.space; });
+    sample.processors.assign(pass_processors.begin(), pass_processors.end());
+    std::sort(sample.processors.begin(), sample.processors.end());
+    begin();
+
+    if (samples.size() >= max_samples) {
+        samples.pop_front();
+    }
+    samples.push_back(std::move(sample));
+    return samples.back();
+}
+
+double physics_server_ms(const PhysicsSample& sample) {
+    if (sample.physics_ms < 0 || sample.tree.ticks == 0) {
+        return -1;
+    }
+    return std::max(sample.physics_ms - static_cast<double>(sample.tree.max_us) / 1000.0, 0.0);
+}
+
+// helper: the scene tree pass as {ticks, avg_ms, max_ms}
+static json tree_json(const TickStats& tree) {
+    double avg = tree.ticks ? static_cast<double>(tree.total_us) / static_cast<double>(tree.ticks) / 1000.0 : 0.0;
+    return {{"ticks", tree.ticks}, {"avg_ms", avg}, {"max_ms", static_cast<double>(tree.max_us) / 1000.0}};
+}
+
+// helper: server process info as {active_objects, collision_pairs, islands}
+static json server_json(const PhysicsServerCounts& server) {
+    return {{"active_objects", server.active_objects},
+            {"collision_pairs", server.collision_pairs},
+            {"islands", server.islands}};
+}
+
+json physics_sample_json(const PhysicsSampleStore& store, const PhysicsSample& sample, size_t top) {
+    json spaces = json::array();
+    for (const SpaceCounts& s : sample.spaces) {
+        spaces.push_back({
+            {"space", s.space},
+            {"dims", s.dims},
+            {"rigid", s.rigid},
+            {"rigid_active", s.rigid_active},
+            {"rigid_frozen", s.rigid_frozen},
+            {"character", s.character},
+            {"static", s.static_bodies},
+            {"areas", s.areas}
+        });
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> largest = sample.processors;
+    size_t n = std::min(top, largest.size());
+    std::partial_sort(largest.begin(), largest.begin() + static_cast<std::ptrdiff_t>(n), largest.end(),
+                      [](const auto& x, const auto& y) { return x.second > y.second; });
+    json processors = json::array();
+    uint64_t processing = 0;
+    for (const auto& [key, nodes] : sample.processors) {
+        processing += nodes;
+    }
+    for (size_t i = 0; i < n; i++) {
+        const CountKey& key = store.key(largest[i].first);
+        json entry = {{"class", key.class_name}, {"nodes", largest[i].second}};
+        if (!key.script.empty()) {
+            entry["script"] = key.script;
+        }
+        processors.push_back(std::move(entry));
+    }
+
+    return {
+        {"id", sample.id},
+        {"time_ms", sample.time_ms},
+        {"frame", sample.frame},
+        {"tree", tree_json(sample.tree)},
+        {"physics_ms", sample.physics_ms},
+        {"server_ms", physics_server_ms(sample)},
+        {"server_2d", server_json(sample.server_2d)},
+        {"server_3d", server_json(sample.server_3d)},
+        {"spaces", std::move(spaces)},
+        {"physics_processing", processing},
+        {"processors", std::move(processors)}
+    };
+}
+
+json physics_series_json(const PhysicsSampleStore& store, int64_t since_id, size_t limit) {
+    const auto& samples = store.all();
+    // ids are consecutive: skip straight to the first one wanted
+    size_t first = 0;
+    if (!samples.empty() && since_id >= samples.front().id) {
+        first = std::min(static_cast<size_t>(since_id - samples.front().id + 1), samples.size());
+    }
+    if (samples.size() - first > limit) {
+        first = samples.size() - limit;
+    }
+
+    json rows = json::array();
+    for (size_t i = first; i < samples.size(); i++) {
+        const PhysicsSample& s = samples[i];
+        uint64_t bodies = 0;
+        uint64_t awake = 0;
+        for (const SpaceCounts& space : s.spaces) {
+            bodies += space.rigid + space.character + space.static_bodies + space.areas;
+            awake += space.rigid_active;
+        }
+        json row = tree_json(s.tree);
+        row["id"] = s.id;
+        row["time_ms"] = s.time_ms;
+        row["physics_ms"] = s.physics_ms;
+        row["server_ms"] = physics_server_ms(s);
+        row["bodies"] = bodies;
+        row["rigid_active"] = awake;
+        row["active_objects"] = std::max<int64_t>(s.server_2d.active_objects, 0) +
+                                std::max<int64_t>(s.server_3d.active_objects, 0);
+        row["collision_pairs"] = std::max<int64_t>(s.server_2d.collision_pairs, 0) +
+                                 std::max<int64_t>(s.server_3d.collision_pairs, 0);
+        row["islands"] = std::max<int64_t>(s.server_2d.islands, 0) + std::max<int64_t>(s.server_3d.islands, 0);
+        rows.push_back(std::move(row));
+    }
+    return {
+        {"samples", std::move(rows)},
+        {"stored", samples.size()},
+        {"newest", samples.empty() ? 0 : samples.back().id}
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include "count_snapshots.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// physics cost samples for the game runtime (no godot dependency).
+//
+// a sample is one pass over the tree plus the engine's physics monitors:
+// bodies per physics space (how many rigid bodies are awake), the 2d / 3d
+// servers' active object, collision pair and island counts, and the nodes
+// that run _physics_process per class and script. PhysicsTickTimer adds how
+// long the scene tree's physics pass took per tick since the previous
+// sample: the runtime starts it on SceneTree.physics_frame and stops it from
+// a node that physics-processes last. godot doesn't expose broadphase or
+// solver times, so what the engine's physics tick took beyond that pass
+// (server sync, body callbacks, the step) is reported as the server's
+// share. samples go in a ring like the count snapshots (count_snapshots.h)
+// and are read back as a series.
+
+enum class BodyKind : uint8_t {
+    rigid,
+    character,
+    static_body,    // StaticBody / AnimatableBody
+    area,
+};
+
+struct SpaceCounts {
+    uint64_t space = 0;         // RID id of the World2D / World3D space
+    uint8_t dims = 3;
+    uint32_t rigid = 0;
+    uint32_t rigid_active = 0;  // neither sleeping nor frozen
+    uint32_t rigid_frozen = 0;
+    uint32_t character = 0;
+    uint32_t static_bodies = 0;
+    uint32_t areas = 0;
+};
+
+// PhysicsServer2D / 3D process info, -1 when unknown
+struct PhysicsServerCounts {
+    int64_t active_objects = -1;
+    int64_t collision_pairs = -1;
+    int64_t islands = -1;
+};
+
+// the scene tree's physics pass over some ticks
+struct TickStats {
+    uint64_t ticks = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+};
+
+class PhysicsTickTimer {
+public:
+    void start(int64_t now_us) { started_us = now_us; }
+    // a stop without a start (the first tick after enabling) is ignored
+    void stop(int64_t now_us);
+    // the ticks so far, and start a new window
+    TickStats take();
+
+private:
+    int64_t started_us = -1;
+    TickStats window;
+};
+
+struct PhysicsSample {
+    int64_t id = 0;             // 1-based, per store
+    int64_t time_ms = 0;        // unix ms
+    uint64_t frame = 0;         // physics frame it was taken in
+    TickStats tree;             // since the previous sample
+    double physics_ms = -1;     // engine: slowest physics tick in the last second
+    PhysicsServerCounts server_2d;
+    PhysicsServerCounts server_3d;
+    std::vector<SpaceCounts> spaces;                        // by space id
+    std::vector<std::pair<uint32_t, uint32_t>> processors;  // (key id, nodes), by key id
+};
+
+// samples kept before the oldest goes: ten minutes at one per second
+constexpr size_t PHYSICS_SAMPLES_MAX = 600;
+
+class PhysicsSampleStore {
+public:
+    explicit PhysicsSampleStore(size_t max_samples = PHYSICS_SAMPLES_MAX) : max_samples(max_samples) {}
+
+    // one pass: begin(), add_body() / add_processor() per node, commit()
+    void begin();
+    void add_body(uint64_t space, uint8_t dims, BodyKind kind, bool active, bool frozen);
+    void add_processor(std::string_view class_name, std::string_view script);
+    const PhysicsSample& commit(int64_t time_ms, uint64_t frame, const TickStats& tree, double physics_ms,
+                                const PhysicsServerCounts& server_2d, const PhysicsServerCounts& server_3d);
+
+    const CountKey& key(uint32_t id) const { return keys[id]; }
+    const std::deque<PhysicsSample>& all() const { return samples; }
+    const PhysicsSample* newest() const { return samples.empty() ? nullptr : &samples.back(); }
+
+private:
+    size_t max_samples;
+    int64_t next_id = 1;
+    std::deque<PhysicsSample> samples;
+
+    std::vector<CountKey> keys;
+    std::unordered_map<std::string, uint32_t> key_ids;   // class '\0' script
+    std::string scratch;
+
+    // the pass in progress
+    std::unordered_map<uint64_t, SpaceCounts> pass_spaces;
+    std::unordered_map<uint32_t, uint32_t> pass_processors;
+};
+
+// the physics tick time outside the tree pass, -1 when either is unknown
+double physics_server_ms(const PhysicsSample& sample);
+
+// one sample in full: spaces and the top physics processors
+nlohmann::json physics_sample_json(const PhysicsSampleStore& store, const PhysicsSample& sample, size_t top);
+
+// the samples after since_id (0: all), oldest first, at most limit of the
+// newest, one flat row each
+nlohmann::json physics_series_json(const PhysicsSampleStore& store, int64_t since_id, size_t limit);
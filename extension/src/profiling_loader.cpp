@@ -0,0 +1,141 @@
+#include "profiling_loader.h"
+#include "runtime_commands.h"
+
+#include <godot_cpp/classes/config_file.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace godot;
+
+static Ref<ProfilingLoader> installed;
+static std::unique_ptr<LoadProfile> load_profile;
+
+// paths this thread is handing back to ResourceLoader, innermost last
+static thread_local std::vector<String> delegating;
+
+// helper: microseconds on a monotonic clock
+static int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// helper: the file ResourceLoader actually reads for path. imported
+// resources (textures, models) load the file their .import points to, picked
+// by feature tag the way ResourceFormatImporter does; exported scenes and
+// scripts may be remapped through a .remap file
+static String loaded_file(const String& path) {
+    for (const char* suffix : {".import", ".remap"}) {
+        String meta = path + suffix;
+        if (!FileAccess::file_exists(meta)) {
+            continue;
+        }
+        Ref<ConfigFile> config;
+        config.instantiate();
+        if (config->load(meta) != OK || !config->has_section("remap")) {
+            continue;
+        }
+        PackedStringArray keys = config->get_section_keys("remap");
+        for (int64_t i = 0; i < keys.size(); i++) {
+            String key = keys[i];
+            if (key == "path" || (key.begins_with("path.") && OS::get_singleton()->has_feature(key.substr(5)))) {
+                return config->get_value("remap", key);
+            }
+        }
+    }
+    return path;
+}
+
+void ProfilingLoader::_bind_methods() {
+}
+
+PackedStringArray ProfilingLoader::_get_recognized_extensions() const {
+    // claims paths through _recognize_path only, so it never shows up in
+    // extension lists (file dialogs, get_recognized_extensions)
+    return PackedStringArray();
+}
+
+bool ProfilingLoader::_recognize_path(const String& path, const StringName& type) const {
+    return delegating.empty() || delegating.back() != path;
+}
+
+bool ProfilingLoader::_handles_type(const StringName& type) const {
+    return false;
+}
+
+Variant ProfilingLoader::_load(const String& path, const String& original_path, bool use_sub_threads,
+                               int32_t cache_mode) const {
+    LoadProfile* log = load_profile.get();
+    ResourceLoader* loader = ResourceLoader::get_singleton();
+    bool deep = cache_mode == ResourceLoader::CACHE_MODE_IGNORE_DEEP ||
+                cache_mode == ResourceLoader::CACHE_MODE_REPLACE_DEEP;
+
+    // cached dependencies never reach a loader: find them before the clock
+    // starts
+    std::vector<std::string> cached;
+    if (!deep) {
+        PackedStringArray deps = loader->get_dependencies(path);
+        for (int64_t i = 0; i < deps.size(); i++) {
+            std::string entry = deps[i].utf8().get_data();
+            std::string dep(dependency_path(entry));
+            if (loader->has_cached(String::utf8(dep.c_str()))) {
+                cached.push_back(std::move(dep));
+            }
+        }
+    }
+
+    OS* os = OS::get_singleton();
+    bool threaded = use_sub_threads || os->get_thread_caller_id() != os->get_main_thread_id();
+    int32_t index = log->begin(path.utf8().get_data(), threaded, now_us());
+    for (const std::string& dep : cached) {
+        log->cache_hit(dep, now_us());
+    }
+
+    delegating.push_back(path);
+    Ref<Resource> res = loader->load(path, "", deep ? ResourceLoader::CACHE_MODE_IGNORE_DEEP
+                                                    : ResourceLoader::CACHE_MODE_IGNORE);
+    delegating.pop_back();
+    int64_t end = now_us();
+
+    // the imported file, not the source asset it came from
+    int64_t size = -1;
+    Ref<FileAccess> file = FileAccess::open(loaded_file(path), FileAccess::READ);
+    if (file.is_valid()) {
+        size = static_cast<int64_t>(file->get_length());
+    }
+    log->end(index, res.is_valid() ? std::string(res->get_class().utf8().get_data()) : std::string(), size,
+             res.is_valid(), end);
+    // a null result lets ResourceLoader try the next loader
+    return res;
+}
+
+void ProfilingLoader::install() {
+    const char* env = std::getenv(PROFILE_LOADS_ENV);
+    if (installed.is_valid() || !env || !*env || std::strcmp(env, "0") == 0) {
+        return;
+    }
+    load_profile = std::make_unique<LoadProfile>();
+    installed.instantiate();
+    ResourceLoader::get_singleton()->add_resource_format_loader(installed, true);
+}
+
+void ProfilingLoader::uninstall() {
+    if (installed.is_null()) {
+        return;
+    }
+    ResourceLoader::get_singleton()->remove_resource_format_loader(installed);
+    installed.unref();
+    load_profile.reset();
+}
+
+LoadProfile* ProfilingLoader::profile() {
+    return load_profile.get();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <godot_cpp/classes/resource_format_loader.hpp>
+
+#include "load_profile.h"
+
+namespace godot {
+
+// times every resource load of a game run into a LoadProfile
+// (load_profile.h). install() puts it at the front of ResourceLoader's list
+// when the game was started with PROFILE_LOADS_ENV set (runtime_commands.h),
+// which happens before the main scene loads.
+//
+// godot has no load hook, so this claims every path, starts the clock and
+// hands the load straight back to ResourceLoader with the cache ignored; a
+// per-thread guard makes it decline that nested request so the real loader
+// takes it. dependencies the real loader pulls in come back through here and
+// nest under it, and ResourceLoader caches whatever it returns as usual. the
+// cost: one get_dependencies() read per load (to spot the cached ones), sub-
+// thread loads run inline, and a failed load is attempted twice. fine for a
+// profiling run, which is the only time it's installed.
+class ProfilingLoader : public ResourceFormatLoader {
+    GDCLASS(ProfilingLoader, ResourceFormatLoader)
+
+protected:
+    static void _bind_methods();
+
+public:
+    PackedStringArray _get_recognized_extensions() const override;
+    bool _recognize_path(const String& path, const StringName& type) const override;
+    bool _handles_type(const StringName& type) const override;
+    Variant _load(const String& path, const String& original_path, bool use_sub_threads,
+                  int32_t cache_mode) const override;
+
+    // register with ResourceLoader if the environment asks for it
+    static void install();
+    static void uninstall();
+
+    // this run's loads, nullptr when profiling is off
+    static LoadProfile* profile();
+};
+
+}
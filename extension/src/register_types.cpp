@@ -8,10 +8,21 @@
 
 #include "godot_peek_plugin.h"
 #include "debugger_plugin.h"
+#include "godot_peek_runtime.h"
+#include "profiling_loader.h"
 
 using namespace godot;
 
 void initialize_godot_peek_module(ModuleInitializationLevel p_level) {
+    // the game-side runtime: games launched from the editor load this
+    // library too
+    if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+        GDREGISTER_CLASS(GodotPeekRuntime);
+        // before anything loads, so the main scene is profiled too
+        GDREGISTER_CLASS(ProfilingLoader);
+        ProfilingLoader::install();
+        return;
+    }
     if (p_level != MODULE_INITIALIZATION_LEVEL_EDITOR) {
         return;
     }
@@ -23,8 +34,8 @@ void initialize_godot_peek_module(ModuleInitializationLevel p_level) {
 }
 
 void uninitialize_godot_peek_module(ModuleInitializationLevel p_level) {
-    if (p_level != MODULE_INITIALIZATION_LEVEL_EDITOR) {
-        return;
+    if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
+        ProfilingLoader::uninstall();
     }
 }
 
@@ -38,7 +49,7 @@ GDExtensionBool GDE_EXPORT godot_peek_library_init(
 
     init_obj.register_initializer(initialize_godot_peek_module);
     init_obj.register_terminator(uninitialize_godot_peek_module);
-    init_obj.set_minimum_library_initialization_level(MODULE_INITIALIZATION_LEVEL_EDITOR);
+    init_obj.set_minimum_library_initialization_level(MODULE_INITIALIZATION_LEVEL_SCENE);
 
     return init_obj.init();
 }
@@ -0,0 +1,117 @@
+#include "request_arena.h"
+
+#include <new>
+
+// every ArenaAllocator allocation starts with a header recording where it
+// came from, so deallocation never needs to know which arena (if any) was
+// current when the memory was handed out
+static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+static constexpr uint64_t FROM_ARENA = 0x6172656e61ull;  // "arena"
+static constexpr uint64_t FROM_HEAP = 0x68656170ull;     // "heap"
+
+static thread_local RequestArena* current_arena = nullptr;
+
+// helper: round offset up to a multiple of align (a power of two)
+static size_t align_up(size_t offset, size_t align) {
+    return (offset + align - 1) & ~(align - 1);
+}
+
+RequestArena::RequestArena(size_t initial_capacity) {
+    add_block(initial_capacity ? initial_capacity : DEFAULT_CAPACITY);
+}
+
+RequestArena::~RequestArena() {
+    for (Block& b : blocks) {
+        ::operator delete(b.data);
+    }
+}
+
+void RequestArena::add_block(size_t size) {
+    Block b;
+    b.data = static_cast<char*>(::operator new(size));
+    b.size = size;
+    blocks.push_back(b);
+    offset = 0;
+}
+
+void* RequestArena::allocate(size_t size, size_t align) {
+    size_t start = align_up(offset, align);
+    if (start + size > blocks.back().size) {
+        // double the last block, or more if this one allocation needs it.
+        // ::operator new already aligns for max_align_t
+        size_t grow = blocks.back().size * 2;
+        add_block(grow > size ? grow : size);
+        start = 0;
+    }
+    offset = start + size;
+    used_bytes += size;
+    return blocks.back().data + start;
+}
+
+size_t RequestArena::capacity() const {
+    size_t total = 0;
+    for (const Block& b : blocks) {
+        total += b.size;
+    }
+    return total;
+}
+
+void RequestArena::reset() {
+    if (blocks.size() > 1 || blocks.back().size > MAX_RETAINED) {
+        // next time the whole request fits in one block
+        size_t total = capacity();
+        for (Block& b : blocks) {
+            ::operator delete(b.data);
+        }
+        blocks.clear();
+        add_block(total < MAX_RETAINED ? total : MAX_RETAINED);
+    }
+    offset = 0;
+    used_bytes = 0;
+}
+
+RequestArena* RequestArena::current() {
+    return current_arena;
+}
+
+ArenaScope::ArenaScope(RequestArena* arena) : arena(arena), saved(current_arena) {
+    if (arena) {
+        arena->depth++;
+        current_arena = arena;
+    }
+}
+
+ArenaScope::~ArenaScope() {
+    if (!arena) {
+        return;
+    }
+    current_arena = saved;
+    if (--arena->depth == 0) {
+        arena->reset();
+    }
+}
+
+void* arena_allocate(size_t size) {
+    char* base;
+    uint64_t source;
+    if (current_arena) {
+        base = static_cast<char*>(current_arena->allocate(HEADER_SIZE + size, HEADER_SIZE));
+        source = FROM_ARENA;
+    } else {
+        base = static_cast<char*>(::operator new(HEADER_SIZE + size));
+        source = FROM_HEAP;
+    }
+    *reinterpret_cast<uint64_t*>(base) = source;
+    return base + HEADER_SIZE;
+}
+
+void arena_deallocate(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    char* base = static_cast<char*>(p) - HEADER_SIZE;
+    // arena memory goes back all at once in reset()
+    if (*reinterpret_cast<uint64_t*>(base) == FROM_HEAP) {
+        ::operator delete(base);
+    }
+}
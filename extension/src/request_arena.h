@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// per-request monotonic allocation (no godot dependency). RpcDispatcher opens
+// an ArenaScope around each request; JSON DOMs built as arena_json inside it
+// (the decoded request, handler params, response envelopes) take their nodes
+// from the arena instead of the heap, and the whole arena is reset in one
+// step once the response has been produced. after the first few requests
+// the arena has grown to fit and steady-state requests reuse the same block.
+//
+// only DOM nodes come from the arena. string contents past the small-string
+// buffer, the parser's token buffer and stacks, the teardown stack in
+// basic_json's destructor and the response text still use the heap; a ping
+// makes 11 such allocations (pinned in test_request_arena.cpp).
+//
+// anything allocated from the arena must not outlive the scope it was made
+// in. outside a scope the allocator falls back to the heap, so the same
+// types work everywhere.
+
+class RequestArena {
+public:
+    // capacity retained across resets is capped at MAX_RETAINED so a single
+    // huge request doesn't pin its memory for the rest of the session
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+    static constexpr size_t MAX_RETAINED = 4 * 1024 * 1024;
+
+    explicit RequestArena(size_t initial_capacity = DEFAULT_CAPACITY);
+    ~RequestArena();
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    // bump-allocate size bytes (align must be a power of two)
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    // forget every allocation. if the last request spilled into extra
+    // blocks they are merged into one block big enough for it
+    void reset();
+
+    size_t used() const { return used_bytes; }        // since the last reset
+    size_t capacity() const;                          // across all blocks
+    size_t block_count() const { return blocks.size(); }
+
+    // the arena of the innermost open ArenaScope on this thread, or nullptr
+    static RequestArena* current();
+
+private:
+    friend class ArenaScope;
+
+    struct Block {
+        char* data = nullptr;
+        size_t size = 0;
+    };
+
+    void add_block(size_t size);
+
+    std::vector<Block> blocks;
+    size_t offset = 0;      // into blocks.back()
+    size_t used_bytes = 0;
+    int depth = 0;          // open scopes on this arena
+};
+
+// routes arena_json (and ArenaAllocator) allocations on this thread to arena
+// until destroyed. scopes nest; the arena is reset when its outermost scope
+// closes. a null arena makes the scope a no-op
+class ArenaScope {
+public:
+    explicit ArenaScope(RequestArena* arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    RequestArena* arena;
+    RequestArena* saved;
+};
+
+// raw allocation behind ArenaAllocator: from the current arena if a scope is
+// open, else the heap. either kind can be released with arena_deallocate
+// from anywhere (releasing arena memory is a no-op)
+void* arena_allocate(size_t size);
+void arena_deallocate(void* p) noexcept;
+
+// stateless std allocator over arena_allocate. every instance compares equal
+// because deallocation works out where the memory came from by itself
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() noexcept = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+        return static_cast<T*>(arena_allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) noexcept { arena_deallocate(p); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const noexcept { return false; }
+};
+
+// nlohmann::json with its object/array nodes and string objects in the
+// current arena. strings keep std::string, so their characters are on the
+// heap once they outgrow the small-string buffer, but values read out of it
+// (and code written against nlohmann::json) work unchanged; conversion to
+// and from nlohmann::json is implicit
+using arena_json = nlohmann::basic_json<std::map, std::vector, std::string, bool, std::int64_t,
+                                        std::uint64_t, double, ArenaAllocator>;
+
+// append value's compact JSON text to out. same output as dump(), without
+// the temporary string dump() returns and without building a serializer per
+// call (its constructor allocates an indent buffer and an output adapter)
+template <typename BasicJson>
+void append_json(std::string& out, const BasicJson& value) {
+    // the serializer is bound to target for good; out's storage is swapped
+    // in for the duration of the dump, so nothing is copied or retained
+    thread_local std::string target;
+    thread_local nlohmann::detail::serializer<BasicJson> serializer(
+        nlohmann::detail::output_adapter<char>(target), ' ');
+    struct SwapBack {
+        std::string& a;
+        std::string& b;
+        ~SwapBack() { a.swap(b); }
+    };
+    target.swap(out);
+    SwapBack restore{target, out};
+    serializer.dump(value, false, false, 0);
+}
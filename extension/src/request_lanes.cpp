@@ -0,0 +1,50 @@
+#include "request_lanes.h"
+
+const char* lane_name(Lane lane) {
+    switch (lane) {
+    case Lane::control:
+        return "control";
+    case Lane::interactive:
+        return "interactive";
+    case Lane::bulk:
+        return "bulk";
+    }
+    return "interactive";
+}
+
+// helper: skip JSON whitespace
+static size_t skip_space(const std::string& s, size_t i) {
+    while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) {
+        i++;
+    }
+    return i;
+}
+
+bool peek_method(const std::string& message, std::string& method) {
+    static const char KEY[] = "\"method\"";
+    size_t at = message.find(KEY);
+    while (at != std::string::npos) {
+        size_t i = skip_space(message, at + sizeof(KEY) - 1);
+        if (i < message.size() && message[i] == ':') {
+            i = skip_space(message, i + 1);
+            if (i >= message.size() || message[i] != '"') {
+                return false;
+            }
+            size_t end = i + 1;
+            while (end < message.size() && message[end] != '"') {
+                if (message[end] == '\\') {
+                    return false;
+                }
+                end++;
+            }
+            if (end >= message.size()) {
+                return false;
+            }
+            method.assign(message, i + 1, end - i - 1);
+            return true;
+        }
+        // "method" as a value rather than a key; keep looking
+        at = message.find(KEY, at + 1);
+    }
+    return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// request priority classes (no godot dependency). SocketServer queues every
+// complete request in its method's lane and runs the lanes in order each
+// frame: control requests (debug_break, stop_scene) run first and their
+// responses skip ahead of anything still queued for the client, interactive
+// reads next, and bulk work (screenshots, tree dumps) only while the frame
+// budget lasts. between bulk requests the server checks its sockets again so
+// a control request that arrives meanwhile doesn't wait for the rest.
+// responses can therefore arrive out of request order; clients match them
+// by id.
+
+enum class Lane : uint8_t {
+    control = 0,      // must take effect now: stop, break, continue
+    interactive = 1,  // small reads and edits (the default)
+    bulk = 2,         // large results that can wait a frame
+};
+
+constexpr size_t LANE_COUNT = 3;
+
+const char* lane_name(Lane lane);
+
+// the "method" string of a raw JSON-RPC message, found without parsing it.
+// false if there is none or it contains escapes. good enough for choosing a
+// lane; the dispatcher still does the real decode
+bool peek_method(const std::string& message, std::string& method);
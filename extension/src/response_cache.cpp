@@ -0,0 +1,35 @@
+#include "response_cache.h"
+
+std::string ResponseCache::key(const std::string& method, const std::string& params_str, uint8_t encoding) {
+    std::string k;
+    k.reserve(method.size() + params_str.size() + 2);
+    k += method;
+    k += '\0';
+    k += static_cast<char>(encoding);
+    k += params_str;
+    return k;
+}
+
+const std::string* ResponseCache::find(const std::string& key, uint64_t now_ns) const {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return nullptr;
+    }
+    const Entry& e = it->second;
+    if (e.revision != current_revision || now_ns - e.stored_ns > max_age_ns) {
+        return nullptr;
+    }
+    return &e.encoded_result;
+}
+
+void ResponseCache::store(const std::string& key, std::string encoded_result, uint64_t now_ns) {
+    // distinct keys come from distinct params; drop everything rather than
+    // grow without bound if a client keeps varying them
+    if (entries.size() >= MAX_ENTRIES && entries.find(key) == entries.end()) {
+        entries.clear();
+    }
+    Entry& e = entries[key];
+    e.revision = current_revision;
+    e.stored_ns = now_ns;
+    e.encoded_result = std::move(encoded_result);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// cache of encoded results for idempotent read methods (no godot dependency).
+//
+// entries are keyed by method + params + response encoding and stamped with
+// the revision they were produced at. the plugin bumps the revision whenever
+// editor/debugger state may have changed (game started, stopped, paused,
+// resumed, or still running), and the dispatcher bumps it after any method
+// registered as invalidating. a hit is re-wrapped with the new request id,
+// so serving it is a copy instead of a widget walk and re-serialisation.
+// max_age bounds how long an entry lives without a bump, which covers edits
+// made by hand in the editor UI that no signal reports.
+class ResponseCache {
+public:
+    static constexpr size_t MAX_ENTRIES = 64;
+    static constexpr uint64_t DEFAULT_MAX_AGE_NS = 2000000000ull;  // 2s
+
+    explicit ResponseCache(uint64_t max_age_ns = DEFAULT_MAX_AGE_NS) : max_age_ns(max_age_ns) {}
+
+    // key for one method call in one encoding
+    static std::string key(const std::string& method, const std::string& params_str, uint8_t encoding);
+
+    uint64_t revision() const { return current_revision; }
+
+    // everything cached so far is stale from now on
+    void bump() { current_revision++; }
+
+    // the encoded result stored for key at the current revision, nullptr if
+    // missing, from an older revision or older than max_age
+    const std::string* find(const std::string& key, uint64_t now_ns) const;
+
+    // remember an encoded result (the value of "result", in the key's
+    // encoding) at the current revision
+    void store(const std::string& key, std::string encoded_result, uint64_t now_ns);
+
+    size_t size() const { return entries.size(); }
+    void clear() { entries.clear(); }
+
+private:
+    struct Entry {
+        uint64_t revision = 0;
+        uint64_t stored_ns = 0;
+        std::string encoded_result;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    uint64_t current_revision = 0;
+    uint64_t max_age_ns;
+};
@@ -0,0 +1,187 @@
+#include "response_encoding.h"
+#include "frame_codec.h"
+#include "server_stats.h"
+#include "text_transcode.h"
+#include "trace.h"
+
+using json = nlohmann::json;
+
+// helper: everything before the result value in a response envelope
+static void append_result_head(std::string& out, int64_t id, uint8_t content_type) {
+    // keys in nlohmann's sorted order, so every encoding matches make_result()
+    switch (content_type) {
+        case CONTENT_MSGPACK:
+            out += '\x82';          // fixmap, 2 entries
+            out += "\xa2id";        // fixstr "id"
+            json::to_msgpack(json(id), out);
+            out += "\xa6result";    // fixstr "result"
+            break;
+        case CONTENT_CBOR:
+            out += '\xa2';          // map, 2 entries
+            out += "\x62id";        // text(2) "id"
+            json::to_cbor(json(id), out);
+            out += "\x66result";    // text(6) "result"
+            break;
+        default:
+            out += "{\"id\":";
+            out += std::to_string(id);
+            out += ",\"result\":";
+            break;
+    }
+}
+
+// room for the envelope and a result of a few fields
+static constexpr size_t RESULT_RESERVE = 128;
+
+template <typename BasicJson>
+static std::string encode_result_impl(int64_t id, const BasicJson& result, uint8_t content_type) {
+    std::string out;
+    out.reserve(RESULT_RESERVE);  // small results fit without regrowing
+    append_result_head(out, id, content_type);
+    switch (content_type) {
+        case CONTENT_MSGPACK:
+            BasicJson::to_msgpack(result, out);
+            break;
+        case CONTENT_CBOR:
+            BasicJson::to_cbor(result, out);
+            break;
+        default:
+            append_json(out, result);  // no intermediate dump() copy
+            out += '}';
+            break;
+    }
+    return out;
+}
+
+std::string encode_result(int64_t id, const json& result, uint8_t content_type) {
+    return encode_result_impl(id, result, content_type);
+}
+
+std::string encode_result(int64_t id, const arena_json& result, uint8_t content_type) {
+    return encode_result_impl(id, result, content_type);
+}
+
+std::string encode_result_text(int64_t id, const arena_json& result, const std::string& text_key,
+                               std::u32string_view text, uint8_t content_type) {
+    if (content_type == CONTENT_MSGPACK || content_type == CONTENT_CBOR) {
+        // the binary writers copy strings verbatim; only the UTF-8 step is left
+        arena_json full = result;
+        full[text_key] = utf32_to_utf8(text);
+        return encode_result(id, full, content_type);
+    }
+
+    std::string out;
+    out.reserve(text.size() + 64);
+    append_result_head(out, id, content_type);
+    out += '{';
+    // members in the DOM's (sorted) order with text_key slotted in, so the
+    // bytes match encode_result() of the DOM with the text set
+    bool text_written = false;
+    bool first = true;
+    auto write_text = [&] {
+        if (!first) {
+            out += ',';
+        }
+        append_json(out, json(text_key));
+        out += ':';
+        append_json_string(out, text);
+        text_written = true;
+        first = false;
+    };
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        if (!text_written && text_key < it.key()) {
+            write_text();
+        }
+        if (!first) {
+            out += ',';
+        }
+        append_json(out, json(it.key()));
+        out += ':';
+        append_json(out, it.value());
+        first = false;
+    }
+    if (!text_written) {
+        write_text();
+    }
+    out += "}}";
+    return out;
+}
+
+std::string wrap_result(int64_t id, const std::string& encoded_result, uint8_t content_type) {
+    std::string out;
+    out.reserve(encoded_result.size() + 32);
+    append_result_head(out, id, content_type);
+    out += encoded_result;
+    if (content_type != CONTENT_MSGPACK && content_type != CONTENT_CBOR) {
+        out += '}';
+    }
+    return out;
+}
+
+bool extract_result(const std::string& response, int64_t id, uint8_t content_type, std::string& encoded_result) {
+    std::string head;
+    append_result_head(head, id, content_type);
+    bool text = content_type != CONTENT_MSGPACK && content_type != CONTENT_CBOR;
+    size_t tail = text ? 1 : 0;
+    if (response.size() <= head.size() + tail || response.compare(0, head.size(), head) != 0 ||
+        (text && response.back() != '}')) {
+        return false;
+    }
+    encoded_result.assign(response, head.size(), response.size() - head.size() - tail);
+    return true;
+}
+
+bool transcode_response(const std::string& text, uint8_t content_type, std::string& out) {
+    arena_json parsed = arena_json::parse(text, nullptr, false);
+    if (parsed.is_discarded()) {
+        return false;
+    }
+    out.clear();
+    if (content_type == CONTENT_MSGPACK) {
+        arena_json::to_msgpack(parsed, out);
+    } else if (content_type == CONTENT_CBOR) {
+        arena_json::to_cbor(parsed, out);
+    } else {
+        append_json(out, parsed);
+    }
+    return true;
+}
+
+std::string ResponseEncoder::encode(int64_t id, const json& result, RpcContext* ctx) {
+    return encode_impl([&](uint8_t type) { return encode_result(id, result, type); }, ctx);
+}
+
+std::string ResponseEncoder::encode(int64_t id, const arena_json& result, RpcContext* ctx) {
+    return encode_impl([&](uint8_t type) { return encode_result(id, result, type); }, ctx);
+}
+
+std::string ResponseEncoder::encode_text(int64_t id, const arena_json& result, const std::string& text_key,
+                                         std::u32string_view text, RpcContext* ctx) {
+    return encode_impl([&](uint8_t type) { return encode_result_text(id, result, text_key, text, type); }, ctx);
+}
+
+template <typename Encode>
+std::string ResponseEncoder::encode_impl(const Encode& encode, RpcContext* ctx) {
+    PEEK_TRACE_SCOPE("encode_result");
+    uint8_t encoding = ctx ? ctx->encoding : CONTENT_JSON;
+
+    uint64_t start = stats ? stats_now_ns() : 0;
+    std::string out = encode(encoding);
+    if (ctx) {
+        ctx->response_type = encoding;
+    }
+    if (!stats) {
+        return out;
+    }
+
+    uint64_t encode_ns = stats_now_ns() - start;
+    stats->record_encode(encoding_name(encoding), out.size(), encode_ns);
+
+    if (encoding != CONTENT_JSON && ++binary_encodes % COMPARE_EVERY == 0) {
+        uint64_t json_start = stats_now_ns();
+        size_t json_bytes = encode(CONTENT_JSON).size();
+        stats->record_encode_comparison(encoding_name(encoding), out.size(), encode_ns,
+                                        json_bytes, stats_now_ns() - json_start);
+    }
+    return out;
+}
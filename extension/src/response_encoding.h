@@ -0,0 +1,68 @@
+#pragma once
+
+#include "rpc_context.h"
+#include "request_arena.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class ServerStats;
+
+// response encoding straight from the result DOM (no godot dependency).
+// JSON results are dumped once into the response envelope instead of the
+// dump -> parse -> dump round trip of make_result(); MessagePack and CBOR
+// results are written by nlohmann's binary writers without a text step.
+
+// a full {"id":..,"result":..} response in the given content type
+std::string encode_result(int64_t id, const nlohmann::json& result, uint8_t content_type);
+std::string encode_result(int64_t id, const arena_json& result, uint8_t content_type);
+
+// a full response whose result is result plus one large string member,
+// text_key, given as UTF-32 (a godot String's buffer). for JSON the text is
+// transcoded and escaped straight into the response (text_transcode.h), so
+// neither a UTF-8 copy nor the DOM ever holds it. result must be an object
+// without text_key
+std::string encode_result_text(int64_t id, const arena_json& result, const std::string& text_key,
+                               std::u32string_view text, uint8_t content_type);
+
+// a full response around a result that is already encoded as content_type
+// (what extract_result returned). used to serve cached results
+std::string wrap_result(int64_t id, const std::string& encoded_result, uint8_t content_type);
+
+// the encoded result inside a success response built by encode_result or
+// make_result. false for errors and anything not shaped like one
+bool extract_result(const std::string& response, int64_t id, uint8_t content_type, std::string& encoded_result);
+
+// re-encode a JSON text response (from a handler that returns text) as
+// content_type. false if text isn't valid JSON
+bool transcode_response(const std::string& text, uint8_t content_type, std::string& out);
+
+// encodes handler results for the requesting connection and records how
+// long that took per encoding
+class ResponseEncoder {
+public:
+    // every COMPARE_EVERY-th binary-encoded result is also dumped as JSON so
+    // the stats can report the size and time difference
+    static constexpr uint32_t COMPARE_EVERY = 16;
+
+    // ctx may be nullptr (JSON text, nothing recorded on it)
+    std::string encode(int64_t id, const nlohmann::json& result, RpcContext* ctx);
+    std::string encode(int64_t id, const arena_json& result, RpcContext* ctx);
+
+    // encode_result_text() for the requesting connection
+    std::string encode_text(int64_t id, const arena_json& result, const std::string& text_key,
+                            std::u32string_view text, RpcContext* ctx);
+
+    void set_stats(ServerStats* s) { stats = s; }
+
+private:
+    // encode(type) produces the response in a given content type
+    template <typename Encode>
+    std::string encode_impl(const Encode& encode, RpcContext* ctx);
+
+    ServerStats* stats = nullptr;
+    uint32_t binary_encodes = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "frame_codec.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct DeferredResponse;
+
+// per-request transport details handed from SocketServer through the
+// dispatcher to handlers (no godot dependency)
+struct RpcContext {
+    uint64_t client_id = 0;
+    // the connection negotiated length-prefixed frames (frame_codec.h), so
+    // raw binary payloads can follow the JSON response
+    bool binary_frames = false;
+    // raw payloads sent as binary frames right after the response.
+    // only honoured when binary_frames is set
+    std::vector<std::string> attachments;
+
+    // negotiated response encoding (a frame_codec.h content type)
+    uint8_t encoding = CONTENT_JSON;
+    // encoding of the string the handler returned. handlers that encode
+    // their result for the connection set this; plain JSON text is
+    // transcoded by the transport
+    uint8_t response_type = CONTENT_JSON;
+
+    // set by handlers whose result is a stand-in (still loading, retry
+    // shortly): the response cache (response_cache.h) must not keep it
+    bool no_cache = false;
+
+    // set when the handler spans several frames (frame_task.h) and hasn't
+    // finished: the response arrives here later, and the transport keeps
+    // the client's following responses queued behind it
+    std::shared_ptr<DeferredResponse> deferred;
+};
+
+// the eventual response of a multi-frame handler. ctx is the request's
+// context, copied when the handler started; its response_type and
+// attachments describe response once done is set
+struct DeferredResponse {
+    bool done = false;
+    std::string response;
+    RpcContext ctx;
+};
@@ -0,0 +1,283 @@
+#include "rpc_dispatcher.h"
+#include "json_rpc.h"
+#include "request_arena.h"
+#include "response_cache.h"
+#include "response_encoding.h"
+#include "server_stats.h"
+#include "trace.h"
+
+#include <nlohmann/json.hpp>
+
+#include <optional>
+
+using json = nlohmann::json;
+
+// helper: true if arrays/objects in text nest deeper than max_depth.
+// a linear pre-scan (brackets inside strings don't count) so hostile input is
+// rejected before the parser builds it and dump() recurses into it
+static bool nesting_exceeds(const std::string& text, int max_depth) {
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (in_string) {
+            if (c == '\\') {
+                i++;  // skip the escaped character
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            if (++depth > max_depth) {
+                return true;
+            }
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+    }
+    return false;
+}
+
+bool parse_request(const std::string& message, RpcRequest& request, std::string& error_response) {
+    if (nesting_exceeds(message, MAX_REQUEST_DEPTH)) {
+        error_response = R"({"id":null,"error":{"code":-32600,"message":"Invalid request: nesting too deep"}})";
+        return false;
+    }
+
+    // parse JSON without exceptions (godot-cpp disables exceptions).
+    // the DOM only lives for this call, so it goes in the request arena
+    arena_json parsed = arena_json::parse(message, nullptr, false);
+
+    // check if parsing failed - parse returns discarded value on error
+    if (parsed.is_discarded()) {
+        error_response = R"({"id":null,"error":{"code":-32700,"message":"Parse error"}})";
+        return false;
+    }
+
+    // extract the request id
+    request.id = 0;
+    if (parsed.is_object() && parsed.contains("id")) {
+        if (parsed["id"].is_number_integer()) {
+            request.id = parsed["id"].get<int64_t>();
+        } else if (parsed["id"].is_number_float()) {
+            // out-of-range (or nan) ids would make the cast undefined; treat them as 0
+            double id = parsed["id"].get<double>();
+            if (id > -9.2e18 && id < 9.2e18) {
+                request.id = static_cast<int64_t>(id);
+            }
+        }
+    }
+
+    // extract the method name
+    if (!parsed.is_object() || !parsed.contains("method") || !parsed["method"].is_string()) {
+        error_response = make_error(request.id, -32600, "Invalid request: missing method");
+        return false;
+    }
+    request.method = parsed["method"].get<std::string>();
+
+    // extract params as string (re-serialize for handlers to parse)
+    // this avoids passing json objects across the header boundary
+    request.params_str = "{}";
+    auto params = parsed.find("params");
+    if (params != parsed.end() && params->is_object()) {
+        request.params_str.clear();
+        append_json(request.params_str, *params);
+    }
+    return true;
+}
+
+void RpcDispatcher::add(const std::string& method, Handler handler, CachePolicy policy) {
+    handlers[method] = Route{std::move(handler), nullptr, policy};
+}
+
+void RpcDispatcher::add_task(const std::string& method, TaskHandler handler, CachePolicy policy) {
+    handlers[method] = Route{nullptr, std::move(handler), policy};
+}
+
+bool RpcDispatcher::has(const std::string& method) const {
+    return handlers.find(method) != handlers.end();
+}
+
+void RpcDispatcher::set_lane(const std::string& method, Lane lane) {
+    lanes[method] = lane;
+}
+
+Lane RpcDispatcher::lane_of(const std::string& message) const {
+    std::string method;
+    if (!peek_method(message, method)) {
+        return Lane::interactive;
+    }
+    auto it = lanes.find(method);
+    return it == lanes.end() ? Lane::interactive : it->second;
+}
+
+namespace {
+// helper: publishes the request context for the duration of one handler
+struct ContextScope {
+    RpcContext*& slot;
+    RpcContext* saved;
+    ContextScope(RpcContext*& slot, RpcContext* ctx) : slot(slot), saved(slot) { slot = ctx; }
+    ~ContextScope() { slot = saved; }
+};
+}
+
+std::string RpcDispatcher::handle(const std::string& message, RpcContext* ctx) {
+    std::optional<ArenaScope> arena_scope(std::in_place, arena);
+    RpcRequest request;
+    std::string error_response;
+    if (!parse_request(message, request, error_response)) {
+        if (stats) {
+            stats->record_request("(invalid_request)", 0, message.size(), error_response.size(), true);
+        }
+        return error_response;
+    }
+
+    auto it = handlers.find(request.method);
+    if (it == handlers.end()) {
+        // unknown names share one stats bucket so clients can't grow the map
+        std::string response = make_error(request.id, -32601, "Method not found: " + request.method);
+        if (stats) {
+            stats->record_request("(unknown_method)", 0, message.size(), response.size(), true);
+        }
+        return response;
+    }
+
+    const Route& route = it->second;
+    PEEK_TRACE_SCOPE(request.method);
+
+    // cached read: the result is stored in the connection's encoding and
+    // re-wrapped around each new request id
+    bool cached = cache && route.policy == CachePolicy::cached;
+    std::string key;
+    if (cached) {
+        uint8_t encoding = ctx ? ctx->encoding : CONTENT_JSON;
+        key = ResponseCache::key(request.method, request.params_str, encoding);
+        uint64_t start = stats_now_ns();
+        if (const std::string* hit = cache->find(key, start)) {
+            std::string response = wrap_result(request.id, *hit, encoding);
+            if (ctx) {
+                ctx->response_type = encoding;
+            }
+            if (stats) {
+                stats->record_request(request.method, stats_now_ns() - start, message.size(), response.size(), false);
+                stats->record_cache(request.method, true);
+            }
+            return response;
+        }
+    }
+
+    if (route.task) {
+        // the coroutine keeps its locals alive across frames, long after the
+        // arena is reset: run it without one
+        arena_scope.reset();
+        return start_task(route, request, message.size(), ctx, std::move(key));
+    }
+
+    ContextScope scope(current, ctx);
+    std::string response = invoke(route, request, message.size());
+    if (cached) {
+        remember(request.method, key, request.id, response, ctx);
+    } else if (cache && route.policy == CachePolicy::invalidates) {
+        cache->bump();
+    }
+    return response;
+}
+
+void RpcDispatcher::remember(const std::string& method, const std::string& key, int64_t id,
+                             const std::string& response, const RpcContext* ctx) {
+    uint8_t encoding = ctx ? ctx->encoding : CONTENT_JSON;
+    uint8_t produced = ctx ? ctx->response_type : CONTENT_JSON;
+    bool has_attachments = ctx && !ctx->attachments.empty();
+    bool placeholder = ctx && ctx->no_cache;
+    std::string result;
+    if (produced == encoding && !has_attachments && !placeholder && extract_result(response, id, encoding, result)) {
+        cache->store(key, std::move(result), stats_now_ns());
+    }
+    if (stats) {
+        stats->record_cache(method, false);
+    }
+}
+
+std::string RpcDispatcher::invoke(const Route& route, const RpcRequest& request, size_t message_size) {
+    if (!stats) {
+        return route.handler(request.id, request.params_str);
+    }
+
+    // time the handler and attribute it to the method
+    uint64_t start = stats_now_ns();
+    std::string response = route.handler(request.id, request.params_str);
+    stats->record_request(request.method, stats_now_ns() - start,
+                          message_size, response.size(), is_error_response(response));
+    return response;
+}
+
+std::string RpcDispatcher::start_task(const Route& route, const RpcRequest& request, size_t message_size,
+                                      RpcContext* ctx, std::string cache_key) {
+    auto deferred = std::make_shared<DeferredResponse>();
+    if (ctx) {
+        deferred->ctx = *ctx;
+    }
+    uint64_t start = stats_now_ns();
+    RpcTask task = route.task(request.id, request.params_str, deferred->ctx);
+
+    if (task.done()) {
+        // finished without waiting: answer like any other handler
+        std::string response = task.take_response();
+        if (stats) {
+            stats->record_request(request.method, stats_now_ns() - start,
+                                  message_size, response.size(), is_error_response(response));
+        }
+        // the task's own context has what it produced, even without ctx
+        if (!cache_key.empty()) {
+            remember(request.method, cache_key, request.id, response, &deferred->ctx);
+        } else if (cache && route.policy == CachePolicy::invalidates) {
+            cache->bump();
+        }
+        if (ctx) {
+            ctx->response_type = deferred->ctx.response_type;
+            ctx->attachments = std::move(deferred->ctx.attachments);
+        }
+        return response;
+    }
+
+    if (ctx) {
+        ctx->deferred = deferred;
+    }
+    RunningTask r;
+    r.task = std::move(task);
+    r.deferred = std::move(deferred);
+    r.method = request.method;
+    r.id = request.id;
+    r.cache_key = std::move(cache_key);
+    r.policy = route.policy;
+    r.start_ns = start;
+    r.message_size = message_size;
+    running.push_back(std::move(r));
+    return std::string();
+}
+
+size_t RpcDispatcher::finish_tasks() {
+    for (size_t i = 0; i < running.size();) {
+        RunningTask& r = running[i];
+        if (!r.task.done()) {
+            i++;
+            continue;
+        }
+        DeferredResponse& d = *r.deferred;
+        d.response = r.task.take_response();
+        d.done = true;
+        // the time covers every frame the handler waited through
+        if (stats) {
+            stats->record_request(r.method, stats_now_ns() - r.start_ns,
+                                  r.message_size, d.response.size(), is_error_response(d.response));
+        }
+        if (!r.cache_key.empty()) {
+            remember(r.method, r.cache_key, r.id, d.response, &d.ctx);
+        } else if (cache && r.policy == CachePolicy::invalidates) {
+            cache->bump();
+        }
+        running.erase(running.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    return running.size();
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "frame_task.h"
+#include "request_lanes.h"
+#include "rpc_context.h"
+
+class ServerStats;
+class ResponseCache;
+class RequestArena;
+
+// request parsing, method routing and per-method instrumentation
+// (no godot dependency). MessageHandler registers its handlers here so the
+// whole decode -> dispatch -> response path can be tested and benchmarked
+// without the editor.
+
+// a decoded JSON-RPC request
+struct RpcRequest {
+    int64_t id = 0;
+    std::string method;
+    std::string params_str = "{}";  // params re-serialised for handlers to parse
+};
+
+// deepest array/object nesting accepted in a request. real requests are a
+// few levels deep; the limit keeps recursive serialisation of params bounded
+constexpr int MAX_REQUEST_DEPTH = 64;
+
+// decode a raw message. on failure returns false and fills error_response
+// with the JSON-RPC error to send back
+bool parse_request(const std::string& message, RpcRequest& request, std::string& error_response);
+
+// how a method interacts with the response cache (response_cache.h)
+enum class CachePolicy {
+    none,         // never cached, leaves the cache alone
+    cached,       // idempotent read: served from the cache while the revision holds
+    invalidates,  // changes editor state: bumps the revision after it runs
+};
+
+class RpcDispatcher {
+public:
+    // handler signature: receives the request id and params JSON, returns the full response
+    using Handler = std::function<std::string(int64_t id, const std::string& params_str)>;
+
+    // multi-frame handler (frame_task.h): a coroutine that co_returns the
+    // full response. params_str is a copy the coroutine can keep; ctx stays
+    // valid until the task finishes and is what handlers encode against
+    using TaskHandler = std::function<RpcTask(int64_t id, std::string params_str, RpcContext& ctx)>;
+
+    // register (or replace) the handler for a method
+    void add(const std::string& method, Handler handler, CachePolicy policy = CachePolicy::none);
+
+    // register a multi-frame handler. policies apply when the task finishes
+    void add_task(const std::string& method, TaskHandler handler, CachePolicy policy = CachePolicy::none);
+
+    bool has(const std::string& method) const;
+
+    // priority class of a method (request_lanes.h); unlisted methods are
+    // interactive
+    void set_lane(const std::string& method, Lane lane);
+
+    // lane of a raw message, judged by its method name without decoding it.
+    // SocketServer uses this to order the requests of each frame
+    Lane lane_of(const std::string& message) const;
+
+    // decode, route, time and record one message. always returns a response,
+    // except when a multi-frame handler suspends: then the result is empty,
+    // ctx->deferred receives the response later and finish_tasks() completes it.
+    // ctx (optional) is what context() returns while the handler runs
+    std::string handle(const std::string& message, RpcContext* ctx = nullptr);
+
+    // complete the deferred response of every task that has finished since
+    // the last call (after FrameScheduler::tick each frame). returns how many
+    // are still running
+    size_t finish_tasks();
+
+    // multi-frame handlers that haven't finished
+    size_t tasks_running() const { return running.size(); }
+
+    // transport context of the request being handled, nullptr when the
+    // caller didn't supply one
+    RpcContext* context() const { return current; }
+
+    // optional stats sink (not owned)
+    void set_stats(ServerStats* s) { stats = s; }
+
+    // optional response cache (not owned). without one every policy acts as none
+    void set_cache(ResponseCache* c) { cache = c; }
+
+    // optional per-request arena (not owned). while set, each handle() runs
+    // inside an ArenaScope so arena_json DOMs built by the decoder, handlers
+    // and response helpers skip the heap; it is reset once the response is built
+    void set_arena(RequestArena* a) { arena = a; }
+
+private:
+    struct Route {
+        Handler handler;
+        TaskHandler task;  // set instead of handler for multi-frame methods
+        CachePolicy policy = CachePolicy::none;
+    };
+
+    // a suspended multi-frame handler and where its response goes
+    struct RunningTask {
+        RpcTask task;
+        std::shared_ptr<DeferredResponse> deferred;
+        std::string method;
+        int64_t id = 0;
+        std::string cache_key;  // set for cached methods
+        CachePolicy policy = CachePolicy::none;
+        uint64_t start_ns = 0;
+        size_t message_size = 0;
+    };
+
+    // run a handler, timing it into the stats
+    std::string invoke(const Route& route, const RpcRequest& request, size_t message_size);
+
+    // start a multi-frame handler; its response if it finished right away
+    std::string start_task(const Route& route, const RpcRequest& request, size_t message_size, RpcContext* ctx,
+                           std::string cache_key);
+
+    // store a freshly produced response of a cached method (cache miss)
+    void remember(const std::string& method, const std::string& key, int64_t id,
+                  const std::string& response, const RpcContext* ctx);
+
+    std::unordered_map<std::string, Route> handlers;
+    std::unordered_map<std::string, Lane> lanes;
+    ServerStats* stats = nullptr;
+    ResponseCache* cache = nullptr;
+    RequestArena* arena = nullptr;
+    RpcContext* current = nullptr;
+    std::vector<RunningTask> running;
+};
@@ -0,0 +1,167 @@
+#include "runtime_commands.h"
+
+#include <cctype>
+#include <type_traits>
+
+using json = nlohmann::json;
+
+std::string game_socket_path(const std::string& editor_socket_path) {
+    static const std::string suffix = ".sock";
+    std::string base = editor_socket_path;
+    if (base.size() >= suffix.size() && base.compare(base.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        base.resize(base.size() - suffix.size());
+    }
+    return base + "-game.sock";
+}
+
+bool datagram_to_request(const std::string& datagram, int64_t id, std::string& cmd, std::string& request,
+                         std::string& error) {
+    json data = json::parse(datagram, nullptr, false);
+    if (data.is_discarded() || !data.is_object()) {
+        error = "parse error";
+        return false;
+    }
+    auto it = data.find("cmd");
+    if (it == data.end() || !it->is_string()) {
+        error = "unknown command: ";
+        return false;
+    }
+    cmd = it->get<std::string>();
+    data.erase(it);
+    request = json{{"id", id}, {"method", cmd}, {"params", std::move(data)}}.dump();
+    return true;
+}
+
+std::string response_to_datagram(const std::string& response, const std::string& cmd) {
+    json r = json::parse(response, nullptr, false);
+    if (r.is_discarded() || !r.is_object()) {
+        return json{{"error", "invalid response"}}.dump();
+    }
+    if (r.contains("error")) {
+        const json& e = r["error"];
+        if (e.is_object() && e.contains("code") && e["code"] == -32601) {
+            return json{{"error", "unknown command: " + cmd}}.dump();
+        }
+        std::string message = e.is_object() && e.contains("message") && e["message"].is_string()
+                                  ? e["message"].get<std::string>()
+                                  : "error";
+        return json{{"error", message}}.dump();
+    }
+    return r.value("result", json::object()).dump();
+}
+
+// helper: params[key] if it has the wanted type, else fallback
+template <typename T>
+static T field(const json& params, const char* key, T fallback) {
+    auto it = params.find(key);
+    if (it == params.end()) {
+        return fallback;
+    }
+    if constexpr (std::is_same_v<T, bool>) {
+        return it->is_boolean() ? it->get<bool>() : fallback;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return it->is_string() ? it->get<std::string>() : fallback;
+    } else {
+        return it->is_number() ? it->get<T>() : fallback;
+    }
+}
+
+// helper: an [x, y] array field
+static void point(const json& params, const char* key, double& x, double& y) {
+    auto it = params.find(key);
+    if (it != params.end() && it->is_array() && it->size() >= 2 && (*it)[0].is_number() && (*it)[1].is_number()) {
+        x = (*it)[0].get<double>();
+        y = (*it)[1].get<double>();
+    }
+}
+
+bool parse_input_command(const json& params, InputCommand& out, std::string& error) {
+    out = InputCommand();
+    out.type = field<std::string>(params, "type", "");
+    out.pressed = field(params, "pressed", true);
+
+    if (out.type == "action") {
+        out.kind = InputKind::action;
+        out.action = field<std::string>(params, "action", "");
+        out.strength = field(params, "strength", 1.0);
+    } else if (out.type == "key") {
+        out.kind = InputKind::key;
+        // accepted as a name like "KEY_W" or a raw keycode
+        auto it = params.find("keycode");
+        if (it != params.end() && it->is_number_integer()) {
+            out.keycode = it->get<int64_t>();
+        } else {
+            out.key = normalize_key_name(field<std::string>(params, "keycode", ""));
+        }
+    } else if (out.type == "mouse_button") {
+        out.kind = InputKind::mouse_button;
+        out.button = mouse_button_index(field<std::string>(params, "button", "left"));
+        point(params, "position", out.x, out.y);
+    } else if (out.type == "mouse_motion") {
+        out.kind = InputKind::mouse_motion;
+        point(params, "relative", out.rel_x, out.rel_y);
+        point(params, "position", out.x, out.y);
+    } else {
+        error = "unknown input type: " + out.type;
+        return false;
+    }
+    return true;
+}
+
+// helper: ascii uppercase copy
+static std::string upper(const std::string& s) {
+    std::string out = s;
+    for (char& c : out) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+std::string normalize_key_name(const std::string& name) {
+    std::string key = name;
+    if (upper(key.substr(0, 4)) == "KEY_") {
+        key = key.substr(4);
+    }
+    // spellings godot doesn't know itself
+    std::string u = upper(key);
+    if (u == "ESC") return "Escape";
+    if (u == "RETURN") return "Enter";
+    if (u == "CONTROL") return "Ctrl";
+    return key;
+}
+
+int mouse_button_index(const std::string& name) {
+    std::string n = upper(name);
+    if (n == "RIGHT" || n == "2") return 2;
+    if (n == "MIDDLE" || n == "3") return 3;
+    if (n == "WHEEL_UP" || n == "4") return 4;
+    if (n == "WHEEL_DOWN" || n == "5") return 5;
+    if (n == "WHEEL_LEFT" || n == "6") return 6;
+    if (n == "WHEEL_RIGHT" || n == "7") return 7;
+    return 1;
+}
+
+std::string evaluate_source(const std::string& expression) {
+    std::string expr = expression;
+
+    // a lone expression like get_node("/root/X").health becomes a return
+    if (expr.find('\n') == std::string::npos) {
+        size_t start = expr.find_first_not_of(" \t\r");
+        std::string trimmed = start == std::string::npos ? std::string() : expr.substr(start);
+        if (trimmed.rfind("var ", 0) != 0 && trimmed.rfind("return", 0) != 0) {
+            expr = "return " + expr;
+        }
+    }
+
+    std::string body;
+    size_t pos = 0;
+    while (true) {
+        size_t nl = expr.find('\n', pos);
+        body += "\t" + expr.substr(pos, nl == std::string::npos ? std::string::npos : nl - pos) + "\n";
+        if (nl == std::string::npos) {
+            break;
+        }
+        pos = nl + 1;
+    }
+    return "extends Node\n\nfunc _eval():\n" + body;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+
+// the game-side command protocol (no godot dependency).
+//
+// a game launched from the editor runs GodotPeekRuntime
+// (godot_peek_runtime.h), which answers the same commands two ways:
+//   - udp datagrams on RUNTIME_UDP_PORT: {"cmd":"screenshot", ...} in, the
+//     bare result object (or {"error": message}) out. this is also what the
+//     peek_runtime_helper.gd fallback speaks, so existing clients work
+//     against either
+//   - JSON-RPC on a SocketServer at game_socket_path() (methods screenshot,
+//     evaluate, input, query_nodes, snapshot_counts, diff_counts,
+//     find_orphans, load_profile, sample_physics, physics_series), with the
+//     usual framing negotiation, so a screenshot can come back inline as a
+//     binary frame instead of through a file
+// query_nodes (node_query.h), the count snapshots (count_snapshots.h),
+// find_orphans (orphan_tracker.h), load_profile (load_profile.h) and the
+// physics probe (physics_probe.h) are native only; the gdscript helper
+// answers them with an unknown command error.
+
+constexpr int RUNTIME_UDP_PORT = 6971;
+constexpr const char* RUNTIME_SCREENSHOT_PATH = "/tmp/godot_peek_game_screenshot.png";
+constexpr const char* RUNTIME_OVERRIDES_PATH = "/tmp/godot_peek_overrides.json";
+
+// the editor exports the game socket path to the games it launches in this
+// environment variable
+constexpr const char* GAME_SOCKET_ENV = "GODOT_PEEK_GAME_SOCKET";
+
+// set (to anything but "0") to track orphan nodes from startup instead of
+// from the first find_orphans
+constexpr const char* TRACK_ORPHANS_ENV = "GODOT_PEEK_TRACK_ORPHANS";
+
+// run_scene with profile_loads exports this (set to "1") so the game times
+// every resource load from startup (profiling_loader.h); every other launch
+// clears it
+constexpr const char* PROFILE_LOADS_ENV = "GODOT_PEEK_PROFILE_LOADS";
+
+// the game socket next to an editor socket:
+// /tmp/godot-peek-foo.sock -> /tmp/godot-peek-foo-game.sock
+std::string game_socket_path(const std::string& editor_socket_path);
+
+// a udp datagram as a JSON-RPC request: cmd becomes the method and the
+// remaining fields the params. false, with error set, if the datagram isn't
+// a JSON object with a string cmd
+bool datagram_to_request(const std::string& datagram, int64_t id, std::string& cmd, std::string& request,
+                         std::string& error);
+
+// a JSON-RPC response to cmd as the udp reply: its result, or
+// {"error": message} worded like the gdscript helper's where they differ
+// (an unknown cmd)
+std::string response_to_datagram(const std::string& response, const std::string& cmd);
+
+enum class InputKind {
+    action,
+    key,
+    mouse_button,
+    mouse_motion,
+};
+
+// a decoded "input" command. fields that don't apply to kind keep their
+// defaults
+struct InputCommand {
+    InputKind kind = InputKind::action;
+    std::string type;          // as sent, echoed back in the reply
+    std::string action;
+    bool pressed = true;
+    double strength = 1.0;     // analog actions
+    std::string key;           // key name for OS.find_keycode_from_string ...
+    int64_t keycode = 0;       // ... or the raw keycode when sent as a number
+    int button = 1;            // godot MouseButton index
+    double x = 0.0;            // position
+    double y = 0.0;
+    double rel_x = 0.0;        // mouse_motion relative
+    double rel_y = 0.0;
+};
+
+// decode the params of an "input" command. false with error set for an
+// unknown type; missing or mistyped fields fall back to their defaults
+bool parse_input_command(const nlohmann::json& params, InputCommand& out, std::string& error);
+
+// "KEY_W" -> "W", "esc" -> "Escape": the spelling OS.find_keycode_from_string
+// expects (it ignores case and understands modifiers like "Ctrl+S")
+std::string normalize_key_name(const std::string& name);
+
+// "left" / "1" -> 1, "wheel_down" -> 5; anything unknown is the left button
+int mouse_button_index(const std::string& name);
+
+// the GDScript source evaluate compiles: a single line that isn't a var or
+// return statement gets "return " prepended, and the whole expression
+// becomes the body of _eval() on a Node
+std::string evaluate_source(const std::string& expression);
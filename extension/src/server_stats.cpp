@@ -0,0 +1,354 @@
+#include "server_stats.h"
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using json = nlohmann::json;
+
+// --- LatencyHistogram ---
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    // small values get one exact bucket each
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    // shift so the top SUB_BUCKET_BITS+1 bits remain: mantissa in [SUB_BUCKETS, 2*SUB_BUCKETS)
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - SUB_BUCKET_BITS;
+    uint64_t mantissa = value >> shift;
+    return static_cast<size_t>(SUB_BUCKETS * shift + mantissa);
+}
+
+uint64_t LatencyHistogram::bucket_lower(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKETS - 1;
+    uint64_t mantissa = index - SUB_BUCKETS * shift;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    uint64_t shift = index / SUB_BUCKETS - 1;
+    uint64_t mantissa = index - SUB_BUCKETS * shift;
+    // wraps to UINT64_MAX for the very last bucket, which is what we want
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[bucket_index(value)]++;
+    total++;
+    sum += value;
+    min_value = std::min(min_value, value);
+    max_value = std::max(max_value, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    min_value = std::min(min_value, other.min_value);
+    max_value = std::max(max_value, other.max_value);
+}
+
+void LatencyHistogram::reset() {
+    counts.fill(0);
+    total = 0;
+    sum = 0;
+    min_value = UINT64_MAX;
+    max_value = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0;
+    }
+    if (p >= 100.0) {
+        return max_value;
+    }
+
+    // rank of the sample we're looking for (1-based)
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(p, 0.0) / 100.0 * total));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // report the bucket midpoint, clamped to what was actually recorded
+            uint64_t lower = bucket_lower(i);
+            uint64_t mid = lower + (bucket_upper(i) - lower) / 2;
+            return std::clamp(mid, min_value, max_value);
+        }
+    }
+    return max_value;
+}
+
+// helper: histogram summary in microseconds (recorded values are ns)
+static json histogram_json(const LatencyHistogram& h) {
+    auto us = [](double ns) { return ns / 1000.0; };
+    return {
+        {"count", h.count()},
+        {"min", us(h.min())},
+        {"mean", us(h.mean())},
+        {"p50", us(h.percentile(50))},
+        {"p90", us(h.percentile(90))},
+        {"p99", us(h.percentile(99))},
+        {"p999", us(h.percentile(99.9))},
+        {"max", us(h.max())}
+    };
+}
+
+// --- ServerStats ---
+
+ServerStats::ServerStats() {
+    started_ns = stats_now_ns();
+    reset_ns = started_ns;
+}
+
+void ServerStats::record_connect(uint64_t client_id) {
+    ClientStats& c = client_stats[client_id];
+    c = ClientStats();
+    c.connected_at_ns = stats_now_ns();
+}
+
+ClientStats* ServerStats::live_client(uint64_t client_id) {
+    auto it = client_stats.find(client_id);
+    return it == client_stats.end() ? nullptr : &it->second;
+}
+
+void ServerStats::record_disconnect(uint64_t client_id) {
+    auto it = client_stats.find(client_id);
+    if (it == client_stats.end()) {
+        return;
+    }
+    closed_totals.bytes_in += it->second.bytes_in;
+    closed_totals.bytes_out += it->second.bytes_out;
+    closed_totals.messages_in += it->second.messages_in;
+    closed_totals.messages_out += it->second.messages_out;
+    closed_count++;
+    client_stats.erase(it);
+}
+
+void ServerStats::record_read(uint64_t client_id, size_t bytes) {
+    if (ClientStats* c = live_client(client_id)) {
+        c->bytes_in += bytes;
+    }
+}
+
+void ServerStats::record_queue_wait(uint64_t client_id, uint64_t wait_ns) {
+    if (ClientStats* c = live_client(client_id)) {
+        c->messages_in++;
+    }
+    queue_wait_hist.record(wait_ns);
+}
+
+void ServerStats::record_lane(Lane lane, uint64_t latency_ns) {
+    lane_hist[static_cast<size_t>(lane)].record(latency_ns);
+}
+
+void ServerStats::record_send(uint64_t client_id, size_t bytes, uint64_t send_ns) {
+    if (ClientStats* c = live_client(client_id)) {
+        c->bytes_out += bytes;
+        c->messages_out++;
+    }
+    send_hist.record(send_ns);
+}
+
+void ServerStats::record_request(const std::string& method, uint64_t handler_ns,
+                                 size_t request_bytes, size_t response_bytes, bool error) {
+    MethodStats& m = method_stats[method];
+    m.calls++;
+    m.bytes_in += request_bytes;
+    m.bytes_out += response_bytes;
+    m.handler.record(handler_ns);
+    if (error) {
+        m.errors++;
+        total_errors++;
+    }
+    total_requests++;
+    handler_hist.record(handler_ns);
+}
+
+void ServerStats::record_cache(const std::string& method, bool hit) {
+    MethodStats& m = method_stats[method];
+    if (hit) {
+        m.cache_hits++;
+        total_cache_hits++;
+    } else {
+        m.cache_misses++;
+        total_cache_misses++;
+    }
+}
+
+void ServerStats::record_encode(const std::string& encoding, size_t bytes, uint64_t encode_ns) {
+    EncodingStats& e = encoding_stats[encoding];
+    e.responses++;
+    e.bytes += bytes;
+    e.encode.record(encode_ns);
+}
+
+void ServerStats::record_encode_comparison(const std::string& encoding, size_t bytes, uint64_t encode_ns,
+                                          size_t json_bytes, uint64_t json_ns) {
+    EncodingStats& e = encoding_stats[encoding];
+    e.samples++;
+    e.sample_bytes += bytes;
+    e.sample_json_bytes += json_bytes;
+    e.sample_ns += encode_ns;
+    e.sample_json_ns += json_ns;
+}
+
+void ServerStats::record_compression(size_t bytes_in, size_t bytes_out, uint64_t compress_ns, bool compressed) {
+    CompressionStats& c = compression_stats;
+    c.responses++;
+    if (compressed) {
+        c.compressed++;
+    }
+    c.bytes_in += bytes_in;
+    c.bytes_out += bytes_out;
+    c.compress.record(compress_ns);
+}
+
+std::string ServerStats::to_json() const {
+    uint64_t now = stats_now_ns();
+
+    uint64_t bytes_in = closed_totals.bytes_in;
+    uint64_t bytes_out = closed_totals.bytes_out;
+    json clients = json::array();
+    for (const auto& [id, c] : client_stats) {
+        bytes_in += c.bytes_in;
+        bytes_out += c.bytes_out;
+        clients.push_back({
+            {"id", id},
+            {"bytes_in", c.bytes_in},
+            {"bytes_out", c.bytes_out},
+            {"messages_in", c.messages_in},
+            {"messages_out", c.messages_out}
+        });
+    }
+
+    // hit_rate over cacheable calls only
+    auto cache_json = [](uint64_t hits, uint64_t misses) {
+        return json{
+            {"hits", hits},
+            {"misses", misses},
+            {"hit_rate", hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0}
+        };
+    };
+
+    json methods = json::object();
+    for (const auto& [name, m] : method_stats) {
+        methods[name] = {
+            {"calls", m.calls},
+            {"errors", m.errors},
+            {"bytes_in", m.bytes_in},
+            {"bytes_out", m.bytes_out},
+            {"handler_us", histogram_json(m.handler)}
+        };
+        if (m.cache_hits + m.cache_misses > 0) {
+            methods[name]["cache"] = cache_json(m.cache_hits, m.cache_misses);
+        }
+    }
+
+    json encodings = json::object();
+    for (const auto& [name, e] : encoding_stats) {
+        json entry = {
+            {"responses", e.responses},
+            {"bytes", e.bytes},
+            {"encode_us", histogram_json(e.encode)}
+        };
+        if (e.samples > 0) {
+            // ratios < 1 mean this encoding is smaller / faster than JSON text
+            entry["vs_json"] = {
+                {"samples", e.samples},
+                {"bytes", e.sample_bytes},
+                {"json_bytes", e.sample_json_bytes},
+                {"size_ratio", e.sample_json_bytes ? static_cast<double>(e.sample_bytes) / e.sample_json_bytes : 0.0},
+                {"encode_us", e.sample_ns / 1000.0},
+                {"json_encode_us", e.sample_json_ns / 1000.0},
+                {"time_ratio", e.sample_json_ns ? static_cast<double>(e.sample_ns) / e.sample_json_ns : 0.0}
+            };
+        }
+        encodings[name] = entry;
+    }
+
+    // ratio < 1 means compression saved bytes overall
+    const CompressionStats& cs = compression_stats;
+    json compression = {
+        {"responses", cs.responses},
+        {"compressed", cs.compressed},
+        {"bytes_in", cs.bytes_in},
+        {"bytes_out", cs.bytes_out},
+        {"ratio", cs.bytes_in ? static_cast<double>(cs.bytes_out) / cs.bytes_in : 0.0},
+        {"compress_us", histogram_json(cs.compress)}
+    };
+
+    // lanes that have run requests (the server classifies them only when
+    // given a classifier)
+    json lanes = json::object();
+    for (size_t i = 0; i < LANE_COUNT; i++) {
+        if (lane_hist[i].count()) {
+            lanes[lane_name(static_cast<Lane>(i))] = {{"latency_us", histogram_json(lane_hist[i])}};
+        }
+    }
+
+    json result = {
+        {"uptime_ms", (now - started_ns) / 1000000.0},
+        {"since_reset_ms", (now - reset_ns) / 1000000.0},
+        {"requests", total_requests},
+        {"errors", total_errors},
+        {"bytes_in", bytes_in},
+        {"bytes_out", bytes_out},
+        {"queue_wait_us", histogram_json(queue_wait_hist)},
+        {"handler_us", histogram_json(handler_hist)},
+        {"send_us", histogram_json(send_hist)},
+        {"methods", methods},
+        {"encodings", encodings},
+        {"compression", compression},
+        {"cache", cache_json(total_cache_hits, total_cache_misses)},
+        {"lanes", lanes},
+        {"clients", clients},
+        {"closed_clients", {
+            {"count", closed_count},
+            {"bytes_in", closed_totals.bytes_in},
+            {"bytes_out", closed_totals.bytes_out},
+            {"messages_in", closed_totals.messages_in},
+            {"messages_out", closed_totals.messages_out}
+        }}
+    };
+    return result.dump();
+}
+
+void ServerStats::reset() {
+    reset_ns = stats_now_ns();
+    total_requests = 0;
+    total_errors = 0;
+    total_cache_hits = 0;
+    total_cache_misses = 0;
+    queue_wait_hist.reset();
+    handler_hist.reset();
+    send_hist.reset();
+    for (LatencyHistogram& h : lane_hist) {
+        h.reset();
+    }
+    method_stats.clear();
+    encoding_stats.clear();
+    compression_stats = CompressionStats();
+
+    // keep live connections, zeroed
+    for (auto& [id, c] : client_stats) {
+        uint64_t connected_at = c.connected_at_ns;
+        c = ClientStats();
+        c.connected_at_ns = connected_at;
+    }
+    closed_totals = ClientStats();
+    closed_count = 0;
+}
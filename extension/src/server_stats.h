@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "request_lanes.h"
+
+// server-side RPC instrumentation (no godot dependency)
+// recorded by SocketServer (bytes, queue wait, send time) and MessageHandler
+// (per-method handler time), read back through the get_server_stats RPC.
+// not thread-safe: all recording happens on the main thread inside poll().
+
+// monotonic clock in nanoseconds, shared by every timing site
+inline uint64_t stats_now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// HDR-style log-linear histogram: each power of two is split into
+// SUB_BUCKETS linear slots, so any recorded value is reported within
+// ~1.6% of its true value. fixed memory, O(1) record, no allocation.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? min_value : 0; }
+    uint64_t max() const { return max_value; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // value at the given percentile (0-100), 0 if nothing recorded
+    uint64_t percentile(double p) const;
+
+    // bucket mapping, public so tests can check precision bounds
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower(size_t index);
+    static uint64_t bucket_upper(size_t index);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+};
+
+// counters for one RPC method
+struct MethodStats {
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t bytes_in = 0;     // request payload bytes
+    uint64_t bytes_out = 0;    // response payload bytes
+    uint64_t cache_hits = 0;   // served from the response cache
+    uint64_t cache_misses = 0; // cacheable calls that ran the handler
+    LatencyHistogram handler;  // handler time in ns
+};
+
+// responses encoded in one encoding (json, msgpack, cbor)
+struct EncodingStats {
+    uint64_t responses = 0;
+    uint64_t bytes = 0;
+    LatencyHistogram encode;  // encode time in ns
+
+    // sampled results also encoded as JSON, for the size/time comparison
+    uint64_t samples = 0;
+    uint64_t sample_bytes = 0;
+    uint64_t sample_json_bytes = 0;
+    uint64_t sample_ns = 0;
+    uint64_t sample_json_ns = 0;
+};
+
+// responses that went through the compression worker
+struct CompressionStats {
+    uint64_t responses = 0;    // payloads submitted
+    uint64_t compressed = 0;   // sent compressed (the rest didn't shrink)
+    uint64_t bytes_in = 0;     // payload bytes before compression
+    uint64_t bytes_out = 0;    // payload bytes actually sent
+    LatencyHistogram compress; // worker time per payload in ns
+};
+
+// counters for one client connection
+struct ClientStats {
+    uint64_t connected_at_ns = 0;
+    uint64_t bytes_in = 0;
+    uint64_t bytes_out = 0;
+    uint64_t messages_in = 0;
+    uint64_t messages_out = 0;
+};
+
+class ServerStats {
+public:
+    ServerStats();
+
+    // connection lifecycle (client ids are assigned by SocketServer). a
+    // disconnected client's counters fold into the closed totals
+    void record_connect(uint64_t client_id);
+    void record_disconnect(uint64_t client_id);
+
+    // raw bytes pulled off a client socket
+    void record_read(uint64_t client_id, size_t bytes);
+
+    // time a complete message waited before dispatch
+    void record_queue_wait(uint64_t client_id, uint64_t wait_ns);
+
+    // a request that ran from its priority lane (request_lanes.h): time
+    // from being read to its response being queued
+    void record_lane(Lane lane, uint64_t latency_ns);
+
+    // one response written to a client
+    void record_send(uint64_t client_id, size_t bytes, uint64_t send_ns);
+
+    // one dispatched request
+    void record_request(const std::string& method, uint64_t handler_ns,
+                        size_t request_bytes, size_t response_bytes, bool error);
+
+    // one call to a cacheable method (response_cache.h), hit or miss
+    void record_cache(const std::string& method, bool hit);
+
+    // one response result encoded (see response_encoding.h)
+    void record_encode(const std::string& encoding, size_t bytes, uint64_t encode_ns);
+
+    // the same result encoded both ways, for the "vs_json" comparison
+    void record_encode_comparison(const std::string& encoding, size_t bytes, uint64_t encode_ns,
+                                  size_t json_bytes, uint64_t json_ns);
+
+    // one response payload compressed off the main thread. bytes_out is
+    // what was sent, which equals bytes_in when deflate didn't help
+    void record_compression(size_t bytes_in, size_t bytes_out, uint64_t compress_ns, bool compressed);
+
+    // snapshot as a JSON object string (the get_server_stats result)
+    std::string to_json() const;
+
+    // zero all counters and histograms, including the closed totals
+    void reset();
+
+    // read access for tests and benchmarks
+    const LatencyHistogram& queue_wait() const { return queue_wait_hist; }
+    const LatencyHistogram& handler_time() const { return handler_hist; }
+    const LatencyHistogram& send_time() const { return send_hist; }
+    const LatencyHistogram& lane_latency(Lane lane) const { return lane_hist[static_cast<size_t>(lane)]; }
+    const std::map<std::string, MethodStats>& methods() const { return method_stats; }
+    const std::map<uint64_t, ClientStats>& clients() const { return client_stats; }
+    const ClientStats& closed_clients() const { return closed_totals; }
+    uint64_t closed_client_count() const { return closed_count; }
+    const std::map<std::string, EncodingStats>& encodings() const { return encoding_stats; }
+    const CompressionStats& compression() const { return compression_stats; }
+
+private:
+    // counters of a connected client; null once it has disconnected, so
+    // late reports don't bring a closed client back
+    ClientStats* live_client(uint64_t client_id);
+
+    uint64_t started_ns = 0;
+    uint64_t reset_ns = 0;
+
+    uint64_t total_requests = 0;
+    uint64_t total_errors = 0;
+    uint64_t total_cache_hits = 0;
+    uint64_t total_cache_misses = 0;
+
+    LatencyHistogram queue_wait_hist;
+    LatencyHistogram handler_hist;
+    LatencyHistogram send_hist;
+    std::array<LatencyHistogram, LANE_COUNT> lane_hist;
+
+    // ordered maps keep the JSON output stable between snapshots
+    std::map<std::string, MethodStats> method_stats;
+    std::map<uint64_t, ClientStats> client_stats;   // live connections only
+    ClientStats closed_totals;
+    uint64_t closed_count = 0;
+    std::map<std::string, EncodingStats> encoding_stats;
+    CompressionStats compression_stats;
+};
@@ -1,4 +1,8 @@
 #include "socket_server.h"
+#include "server_stats.h"
+#include "json_rpc.h"
+#include "response_encoding.h"
+#include "trace.h"
 
 #include <sys/socket.h>  // socket(), bind(), listen(), accept(), send()
 #include <sys/un.h>      // sockaddr_un - unix domain socket address structure
@@ -35,7 +39,7 @@ static void set_nosigpipe(int fd) {
 }
 #endif
 
-SocketServer::SocketServer() = default;
+SocketServer::SocketServer(IoBackend backend) : requested_backend(backend) {}
 
 SocketServer::~SocketServer() {
     stop();
@@ -121,6 +125,15 @@ bool SocketServer::start(const std::string& path) {
     int flags = fcntl(server_fd, F_GETFL, 0);
     fcntl(server_fd, F_SETFL, flags | O_NONBLOCK);
 
+    // io_uring: one multishot accept covers every future connection. any
+    // failure here just leaves the poll loop in charge
+    if (requested_backend == IoBackend::io_uring) {
+        uring = std::make_unique<UringLoop>();
+        if (!uring->init() || !uring->arm_accept(server_fd) || !uring->submit()) {
+            uring.reset();
+        }
+    }
+
     owns_socket = true;
     return true;
 }
@@ -128,10 +141,21 @@ bool SocketServer::start(const std::string& path) {
 void SocketServer::stop() {
     for (auto& client : clients) {
         if (client.fd >= 0) {
+            if (uring) {
+                shutdown(client.fd, SHUT_RDWR);  // ends its multishot recv
+            }
             close(client.fd);
         }
+        if (stats) {
+            stats->record_disconnect(client.id);
+        }
     }
     clients.clear();
+    for (auto& lane : lanes) {
+        lane.clear();
+    }
+    uring.reset();  // cancels the accept and waits out in-flight sends
+    compressor.reset();  // joins the worker; jobs for closed clients are dropped
 
     if (server_fd >= 0) {
         close(server_fd);
@@ -147,10 +171,25 @@ void SocketServer::stop() {
 }
 
 void SocketServer::poll(MessageCallback on_message) {
+    poll([&on_message](const std::string& message, RpcContext&) { return on_message(message); });
+}
+
+void SocketServer::poll(const ContextCallback& on_message) {
     if (server_fd < 0) {
         return;
     }
+    PEEK_TRACE_SCOPE("SocketServer::poll");
+
+    if (uring) {
+        poll_uring(on_message);
+    } else {
+        accept_clients();
+        read_clients(on_message);
+        run_lanes(on_message);
+    }
+}
 
+void SocketServer::accept_clients() {
     // accept all pending connections (drain the backlog)
     while (true) {
 #ifdef __linux__
@@ -171,68 +210,520 @@ void SocketServer::poll(MessageCallback on_message) {
         // on macOS, prevent SIGPIPE per-socket (linux uses MSG_NOSIGNAL per-send)
         set_nosigpipe(new_fd);
 #endif
-        clients.push_back({new_fd, ""});
+        ClientConnection conn;
+        conn.fd = new_fd;
+        conn.id = next_client_id++;
+        if (stats) {
+            conn.last_read_ns = stats_now_ns();
+            stats->record_connect(conn.id);
+        }
+        clients.push_back(std::move(conn));
     }
+}
 
+void SocketServer::read_clients(const ContextCallback& on_message) {
     // read from all connected clients
     // iterate by index so we can remove disconnected ones
     for (size_t i = 0; i < clients.size(); ) {
         auto& client = clients[i];
+
+        // finish any response that didn't fit in the socket buffer last
+        // frame, then whatever the compression worker has finished since
+        if (!flush_writes(client) || !drain_outbound(client)) {
+            remove_client(i);
+            continue;
+        }
+
         char buf[4096];
-        ssize_t n = read(client.fd, buf, sizeof(buf) - 1);
+        // the bytes we're about to read arrived some time after the previous
+        // read attempt; that bound is what we report as queue wait
+        uint64_t read_ns = stats ? stats_now_ns() : 0;
+        ssize_t n = read(client.fd, buf, sizeof(buf));
 
         if (n > 0) {
-            buf[n] = '\0';
-            client.read_buffer += buf;
-
-            // process complete messages (newline-delimited JSON)
-            // track whether this client died during processing
-            bool client_dead = false;
-            size_t pos;
-            while ((pos = client.read_buffer.find('\n')) != std::string::npos) {
-                std::string message = client.read_buffer.substr(0, pos);
-                client.read_buffer.erase(0, pos + 1);
-
-                if (!message.empty()) {
-                    std::string response = on_message(message);
-
-                    // send response back to this specific client
-                    // uses send() instead of write() so we can pass MSG_NOSIGNAL
-                    // on linux to prevent SIGPIPE if client disconnected between
-                    // sending its request and receiving our response
-                    if (!response.empty()) {
-                        response += '\n';
-                        ssize_t written = send(client.fd, response.c_str(), response.length(), SEND_FLAGS);
-                        if (written < 0) {
-                            // write failed (EPIPE, ECONNRESET, etc) - client is dead
-                            client_dead = true;
-                            break;
-                        }
-                    }
-                }
+            if (stats) {
+                stats->record_read(client.id, static_cast<size_t>(n));
             }
-            if (client_dead) {
-                close(client.fd);
-                clients.erase(clients.begin() + i);
+            if (!process_input(client, buf, static_cast<size_t>(n), on_message)) {
+                remove_client(i);
             } else {
+                client.last_read_ns = read_ns;
                 ++i;
             }
         } else if (n == 0) {
             // clean disconnect
-            close(client.fd);
-            clients.erase(clients.begin() + i);
+            remove_client(i);
         } else {
             // n == -1: check if it's a transient error or a fatal one
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
                 // no data available right now, try again next frame
+                client.last_read_ns = read_ns;
                 ++i;
             } else {
                 // fatal error (ECONNRESET, EBADF, etc) - remove dead client
-                close(client.fd);
-                clients.erase(clients.begin() + i);
+                remove_client(i);
+            }
+        }
+    }
+}
+
+void SocketServer::poll_uring(const ContextCallback& on_message) {
+    // completions come straight out of the shared ring, so a frame with
+    // nothing to do makes no syscalls at all
+    uint64_t reap_ns = stats ? stats_now_ns() : 0;
+    uring->reap([&](const UringCompletion& c) { handle_completion(c, on_message); });
+    last_reap_ns = reap_ns;
+    run_lanes(on_message);
+
+    // responses queued by this frame's messages (and finished compression
+    // jobs) go out as one send per client
+    flush_clients();
+}
+
+void SocketServer::flush_clients() {
+    for (size_t i = 0; i < clients.size(); ) {
+        if (!drain_outbound(clients[i]) || !flush_writes(clients[i])) {
+            remove_client(i);
+            continue;
+        }
+        ++i;
+    }
+    if (uring) {
+        uring->submit();
+    }
+}
+
+size_t SocketServer::queued() const {
+    size_t n = 0;
+    for (const auto& lane : lanes) {
+        n += lane.size();
+    }
+    return n;
+}
+
+bool SocketServer::dispatch(ClientConnection& client, std::string& message, uint8_t content_type,
+                            const ContextCallback& on_message) {
+    if (!classify) {
+        return deliver(client, message, content_type, on_message);
+    }
+    // binary payloads other than JSON get their error reply in the default lane
+    Lane lane = content_type == CONTENT_JSON ? classify(message) : Lane::interactive;
+    QueuedRequest r;
+    r.client_id = client.id;
+    r.message.swap(message);
+    r.content_type = content_type;
+    r.queued_ns = stats_now_ns();
+    lanes[static_cast<size_t>(lane)].push_back(std::move(r));
+    return true;
+}
+
+void SocketServer::run_lanes(const ContextCallback& on_message) {
+    uint64_t start = stats_now_ns();
+    bool spent = false;  // a budgeted request has run this frame
+    while (true) {
+        size_t lane = 0;
+        while (lane < LANE_COUNT && lanes[lane].empty()) {
+            lane++;
+        }
+        if (lane == LANE_COUNT) {
+            return;
+        }
+        // control always runs; the others get the frame budget (and at
+        // least one request per frame, so bulk work still progresses)
+        if (lane != static_cast<size_t>(Lane::control) && spent && stats_now_ns() - start >= frame_budget_ns) {
+            return;
+        }
+
+        QueuedRequest r = std::move(lanes[lane].front());
+        lanes[lane].pop_front();
+        size_t i = find_client(r.client_id);
+        if (i == clients.size()) {
+            continue;  // disconnected while queued
+        }
+        if (!deliver(clients[i], r.message, r.content_type, on_message, static_cast<Lane>(lane))) {
+            remove_client(i);
+            continue;
+        }
+        if (stats) {
+            stats->record_lane(static_cast<Lane>(lane), stats_now_ns() - r.queued_ns);
+        }
+        if (lane != static_cast<size_t>(Lane::control)) {
+            spent = true;
+        }
+        if (lane == static_cast<size_t>(Lane::bulk)) {
+            checkpoint(on_message);
+        }
+    }
+}
+
+void SocketServer::checkpoint(const ContextCallback& on_message) {
+    if (uring) {
+        // completions posted meanwhile are already in the ring
+        flush_clients();
+        uring->reap([&](const UringCompletion& c) { handle_completion(c, on_message); });
+    } else {
+        read_clients(on_message);
+    }
+}
+
+void SocketServer::handle_completion(const UringCompletion& c, const ContextCallback& on_message) {
+    switch (c.op) {
+    case UringOp::accept: {
+        if (c.result >= 0) {
+            ClientConnection conn;
+            conn.fd = c.result;
+            conn.id = next_client_id++;
+            if (!uring->arm_recv(conn.fd, conn.id)) {
+                close(conn.fd);
+            } else {
+                if (stats) {
+                    conn.last_read_ns = stats_now_ns();
+                    stats->record_connect(conn.id);
+                }
+                clients.push_back(std::move(conn));
             }
         }
+        // the kernel drops a multishot accept on errors (eg EMFILE); re-arm
+        if (!c.more) {
+            uring->arm_accept(server_fd);
+        }
+        break;
     }
+    case UringOp::recv: {
+        size_t i = find_client(c.client_id);
+        if (i == clients.size()) {
+            break;  // client already removed; its recv is winding down
+        }
+        ClientConnection& client = clients[i];
+        if (c.result > 0) {
+            if (stats) {
+                stats->record_read(client.id, static_cast<size_t>(c.result));
+                // the bytes arrived some time after the previous reap
+                client.last_read_ns = last_reap_ns;
+            }
+            if (!process_input(client, c.data, static_cast<size_t>(c.result), on_message)) {
+                remove_client(i);
+                break;
+            }
+        } else if (c.result != -ENOBUFS) {
+            // clean disconnect (0) or a fatal error
+            remove_client(i);
+            break;
+        }
+        // ENOBUFS (every provided buffer busy) and the kernel retiring the
+        // recv both leave data unread; arm it again
+        if (!c.more && !uring->arm_recv(client.fd, client.id)) {
+            remove_client(i);
+        }
+        break;
+    }
+    case UringOp::send: {
+        size_t i = find_client(c.client_id);
+        if (i == clients.size()) {
+            break;
+        }
+        if (c.result < 0) {
+            remove_client(i);  // EPIPE, ECONNRESET, etc
+        } else {
+            clients[i].send_in_flight = false;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+size_t SocketServer::find_client(uint64_t id) const {
+    for (size_t i = 0; i < clients.size(); i++) {
+        if (clients[i].id == id) {
+            return i;
+        }
+    }
+    return clients.size();
+}
+
+void SocketServer::remove_client(size_t index) {
+    if (uring) {
+        // the kernel holds its own reference to the socket for the armed
+        // recv; shutdown makes that recv complete so the fd really closes
+        shutdown(clients[index].fd, SHUT_RDWR);
+    }
+    close(clients[index].fd);
+    if (stats) {
+        stats->record_disconnect(clients[index].id);
+    }
+    clients.erase(clients.begin() + index);
+}
+
+bool SocketServer::process_input(ClientConnection& client, const char* data, size_t len,
+                                 const ContextCallback& on_message) {
+    bool was_binary = client.binary;
+
+    if (!client.binary) {
+        // append by length: client bytes may contain NULs
+        client.framer.append(data, len);
+
+        // process complete messages (newline-delimited JSON)
+        std::string message;
+        while (client.framer.next(message)) {
+            if (message.empty()) {
+                continue;
+            }
+
+            // the first message may ask to switch framing
+            bool first = !client.greeted;
+            client.greeted = true;
+            Handshake hs;
+            if (first && parse_handshake(message, hs)) {
+                Negotiated negotiated;
+                if (!queue_send(client, handshake_response(hs, negotiated) + '\n')) {
+                    return false;
+                }
+                client.encoding = negotiated.encoding;
+                client.deflate = negotiated.deflate;
+                client.compress_threshold = negotiated.compress_threshold;
+                if (negotiated.binary) {
+                    // whatever followed the handshake is already frames
+                    client.binary = true;
+                    std::string rest = client.framer.take_buffered();
+                    client.decoder.append(rest.data(), rest.size());
+                    break;
+                }
+                continue;
+            }
+
+            if (!dispatch(client, message, CONTENT_JSON, on_message)) {
+                return false;
+            }
+        }
+
+        // a line longer than the framer's limit never completes; drop
+        // the client instead of buffering without bound
+        if (client.framer.overflowed()) {
+            return false;
+        }
+    }
+
+    if (client.binary) {
+        if (was_binary) {
+            client.decoder.append(data, len);
+        }
+        Frame frame;
+        while (client.decoder.next(frame)) {
+            if (!dispatch(client, frame.payload, frame.content_type, on_message)) {
+                return false;
+            }
+        }
+        if (client.decoder.failed()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SocketServer::deliver(ClientConnection& client, const std::string& message, uint8_t content_type,
+                           const ContextCallback& on_message, Lane lane) {
+    if (stats) {
+        stats->record_queue_wait(client.id, stats_now_ns() - client.last_read_ns);
+    }
+
+    RpcContext ctx;
+    ctx.client_id = client.id;
+    ctx.binary_frames = client.binary;
+    ctx.encoding = client.encoding;
+
+    std::string response;
+    if (content_type == CONTENT_JSON) {
+        response = on_message(message, ctx);
+    } else {
+        response = make_error(0, -32600, "Invalid request: unsupported content type " + std::to_string(content_type));
+    }
+
+    // a multi-frame handler answers later: hold this client's place in line
+    if (ctx.deferred) {
+        PendingResponse pending;
+        pending.deferred = std::move(ctx.deferred);
+        client.outbound.push_back(std::move(pending));
+        return true;
+    }
+    if (response.empty()) {
+        return true;
+    }
+
+    uint64_t send_start = stats ? stats_now_ns() : 0;
+    PendingResponse ready = package(client, response, ctx);
+
+    // keep responses in order behind one that is still compressing (or
+    // still being produced). control responses are matched by id and
+    // can't wait on bulk work
+    bool jump = lane == Lane::control && !ready.job;
+    if (ready.job || (!client.outbound.empty() && !jump)) {
+        client.outbound.push_back(std::move(ready));
+        return true;
+    }
+
+    // send response back to this specific client
+    if (!queue_send(client, ready.bytes)) {
+        // write failed (EPIPE, ECONNRESET, etc) - client is dead
+        return false;
+    }
+    if (stats) {
+        stats->record_send(client.id, ready.bytes.length(), stats_now_ns() - send_start);
+    }
+    return true;
+}
+
+PendingResponse SocketServer::package(ClientConnection& client, std::string& response, RpcContext& ctx) {
+    // handlers that still return JSON text (errors, small fixed results)
+    // get re-encoded for connections that asked for msgpack/cbor
+    if (client.binary && client.encoding != CONTENT_JSON && ctx.response_type == CONTENT_JSON) {
+        std::string encoded;
+        if (transcode_response(response, client.encoding, encoded)) {
+            response.swap(encoded);
+            ctx.response_type = client.encoding;
+        }
+    }
+
+    PendingResponse pending;
+
+    // large responses are deflated on the worker thread; drain_outbound
+    // sends them (and anything queued behind them) once it's done
+    if (client.binary && client.deflate && response.size() >= client.compress_threshold) {
+        if (!compressor) {
+            compressor = std::make_unique<CompressionWorker>();
+        }
+        pending.job = std::make_shared<CompressionJob>();
+        pending.job->payload.swap(response);
+        pending.content_type = ctx.response_type;
+        pending.flags = ctx.attachments.empty() ? 0 : FRAME_FLAG_MORE;
+        for (size_t a = 0; a < ctx.attachments.size(); a++) {
+            uint8_t flags = a + 1 < ctx.attachments.size() ? FRAME_FLAG_MORE : 0;
+            append_frame(pending.tail, CONTENT_BINARY, flags, ctx.attachments[a]);
+        }
+        compressor->submit(pending.job);
+        return pending;
+    }
+
+    if (client.binary) {
+        uint8_t flags = ctx.attachments.empty() ? 0 : FRAME_FLAG_MORE;
+        append_frame(pending.bytes, ctx.response_type, flags, response);
+        for (size_t a = 0; a < ctx.attachments.size(); a++) {
+            flags = a + 1 < ctx.attachments.size() ? FRAME_FLAG_MORE : 0;
+            append_frame(pending.bytes, CONTENT_BINARY, flags, ctx.attachments[a]);
+        }
+    } else {
+        response += '\n';
+        pending.bytes.swap(response);
+    }
+    return pending;
+}
+
+bool SocketServer::drain_outbound(ClientConnection& client) {
+    while (!client.outbound.empty()) {
+        PendingResponse& front = client.outbound.front();
+        if (front.deferred) {
+            if (!front.deferred->done) {
+                return true;  // handler still waiting on a later frame
+            }
+            std::shared_ptr<DeferredResponse> finished = std::move(front.deferred);
+            if (finished->response.empty()) {
+                client.outbound.pop_front();
+            } else {
+                // becomes an ordinary (possibly compressing) response in place
+                front = package(client, finished->response, finished->ctx);
+            }
+            continue;
+        }
+
+        std::string out;
+        if (front.job) {
+            CompressionJob& job = *front.job;
+            if (!job.done.load(std::memory_order_acquire)) {
+                return true;  // still compressing; everything behind it waits
+            }
+            const std::string& payload = job.ok ? job.compressed : job.payload;
+            uint8_t flags = front.flags | (job.ok ? FRAME_FLAG_DEFLATE : 0);
+            append_frame(out, front.content_type, flags, payload);
+            out += front.tail;
+            if (stats) {
+                stats->record_compression(job.payload.size(), payload.size(), job.compress_ns, job.ok);
+            }
+        } else {
+            out.swap(front.bytes);
+        }
+        client.outbound.pop_front();
+
+        uint64_t send_start = stats ? stats_now_ns() : 0;
+        if (!queue_send(client, out)) {
+            return false;
+        }
+        if (stats) {
+            stats->record_send(client.id, out.length(), stats_now_ns() - send_start);
+        }
+    }
+    return true;
+}
+
+bool SocketServer::queue_send(ClientConnection& client, const std::string& data) {
+    // io_uring: collect this frame's responses; flush_writes sends them
+    if (uring) {
+        client.write_buffer += data;
+        return true;
+    }
+
+    // keep responses in order: if earlier bytes are still queued, get in line
+    if (client.write_offset < client.write_buffer.size()) {
+        client.write_buffer += data;
+        return flush_writes(client);
+    }
+
+    // uses send() instead of write() so we can pass MSG_NOSIGNAL
+    // on linux to prevent SIGPIPE if client disconnected between
+    // sending its request and receiving our response
+    ssize_t written = send(client.fd, data.c_str(), data.length(), SEND_FLAGS);
+    if (written < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        written = 0;  // socket buffer full, queue everything
+    }
+
+    // large responses can exceed the socket buffer; keep the rest for later
+    if (static_cast<size_t>(written) < data.length()) {
+        client.write_buffer.assign(data, static_cast<size_t>(written), std::string::npos);
+        client.write_offset = 0;
+    }
+    return true;
+}
+
+bool SocketServer::flush_writes(ClientConnection& client) {
+    if (uring) {
+        // one send in flight per client keeps bytes in order; whatever
+        // queues meanwhile goes out together as the next batch
+        if (client.send_in_flight || client.write_buffer.empty()) {
+            return true;
+        }
+        std::string batch;
+        batch.swap(client.write_buffer);
+        client.send_in_flight = uring->send(client.fd, client.id, std::move(batch));
+        return client.send_in_flight;
+    }
+
+    while (client.write_offset < client.write_buffer.size()) {
+        ssize_t written = send(client.fd,
+                               client.write_buffer.data() + client.write_offset,
+                               client.write_buffer.size() - client.write_offset,
+                               SEND_FLAGS);
+        if (written < 0) {
+            // EAGAIN: client isn't reading fast enough, try again next frame
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.write_offset += static_cast<size_t>(written);
+    }
+    client.write_buffer.clear();
+    client.write_offset = 0;
+    return true;
 }
 
 bool SocketServer::is_running() const {
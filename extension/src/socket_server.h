@@ -3,11 +3,54 @@
 #include <string>
 #include <functional>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+
+#include "line_framer.h"
+#include "frame_codec.h"
+#include "rpc_context.h"
+#include "compression.h"
+#include "uring_loop.h"
+#include "request_lanes.h"
+
+class ServerStats;
+
+// a response waiting its turn behind an earlier one that is still being
+// compressed or produced. either bytes is ready to send, job is in flight,
+// or a multi-frame handler hasn't answered yet (deferred)
+struct PendingResponse {
+    std::string bytes;                    // encoded frames, when job and deferred are null
+    std::shared_ptr<CompressionJob> job;  // response payload on the worker
+    std::shared_ptr<DeferredResponse> deferred; // filled in by RpcDispatcher::finish_tasks
+    uint8_t content_type = CONTENT_JSON;  // of the job's payload
+    uint8_t flags = 0;                    // of the job's frame, before FRAME_FLAG_DEFLATE
+    std::string tail;                     // attachment frames that follow the job's frame
+};
 
 // per-client connection state
 struct ClientConnection {
     int fd = -1;
-    std::string read_buffer;  // accumulates partial reads until we get a full line
+    LineFramer framer;        // accumulates partial reads until we get a full line
+    FrameDecoder decoder;     // used instead of framer once binary framing is negotiated
+    bool binary = false;      // negotiated length-prefixed frames (frame_codec.h)
+    uint8_t encoding = CONTENT_JSON; // negotiated response encoding
+    bool deflate = false;     // negotiated response compression
+    size_t compress_threshold = DEFAULT_COMPRESS_THRESHOLD;
+    std::deque<PendingResponse> outbound; // responses queued behind a compression job
+    bool greeted = false;     // first message seen (the only place a handshake is accepted)
+    std::string write_buffer; // response bytes the kernel hasn't accepted yet
+    size_t write_offset = 0;  // how much of write_buffer has already been sent
+    uint64_t id = 0;          // stable id for stats (fds get reused)
+    uint64_t last_read_ns = 0; // when we last found this socket empty (stats only)
+    bool send_in_flight = false; // io_uring: a send is with the kernel; write_buffer waits
+};
+
+// how SocketServer waits for sockets. io_uring is linux-only and falls back
+// to poll when the kernel doesn't support it
+enum class IoBackend {
+    poll,      // non-blocking accept/read/send on every client each frame
+    io_uring,  // multishot accept/recv and batched sends (uring_loop.h)
 };
 
 class SocketServer {
@@ -15,7 +58,11 @@ public:
     // callback type: receives the raw message string, returns response string
     using MessageCallback = std::function<std::string(const std::string&)>;
 
-    SocketServer();
+    // callback with transport context: handlers can see the client and, on
+    // binary-framed connections, attach raw payloads to the response
+    using ContextCallback = std::function<std::string(const std::string&, RpcContext&)>;
+
+    explicit SocketServer(IoBackend backend = IoBackend::poll);
     ~SocketServer();
 
     // start listening on the given socket path
@@ -29,13 +76,109 @@ public:
     // call this each frame from _process()
     // uses the callback to handle complete messages
     void poll(MessageCallback on_message);
+    void poll(const ContextCallback& on_message);
 
     // check if server is running
     bool is_running() const;
 
+    // the backend actually in use (io_uring only once start() set it up)
+    IoBackend backend() const { return uring ? IoBackend::io_uring : IoBackend::poll; }
+
+    // optional instrumentation sink (not owned, may be nullptr)
+    void set_stats(ServerStats* s) { stats = s; }
+
+    // picks the lane (request_lanes.h) of each complete request. without
+    // one, requests run as they are read and responses keep request order
+    using LaneClassifier = std::function<Lane(const std::string& message)>;
+    void set_lane_classifier(LaneClassifier fn) { classify = std::move(fn); }
+
+    // time per poll() that interactive and bulk requests may use; the rest
+    // wait for the next frame. control requests always run
+    static constexpr uint64_t DEFAULT_FRAME_BUDGET_NS = 8000000;  // 8ms
+    void set_frame_budget_ns(uint64_t ns) { frame_budget_ns = ns; }
+
+    // requests read but left for a later frame
+    size_t queued() const;
+
+    // connections currently open
+    size_t client_count() const { return clients.size(); }
+
 private:
     int server_fd = -1;                    // listening socket file descriptor
     std::string socket_path;               // path to the socket file
     std::vector<ClientConnection> clients; // all connected clients
     bool owns_socket = false;              // true if we created the socket file
+    uint64_t next_client_id = 1;           // ids handed to new connections
+    ServerStats* stats = nullptr;          // instrumentation sink (not owned)
+    std::unique_ptr<CompressionWorker> compressor; // started by the first large response
+    IoBackend requested_backend;           // what the constructor asked for
+    std::unique_ptr<UringLoop> uring;      // set while the io_uring backend is active
+    uint64_t last_reap_ns = 0;             // io_uring: previous completion reap (stats only)
+
+    // a complete request waiting in its lane
+    struct QueuedRequest {
+        uint64_t client_id = 0;
+        std::string message;
+        uint8_t content_type = CONTENT_JSON;
+        uint64_t queued_ns = 0;
+    };
+    LaneClassifier classify;
+    std::deque<QueuedRequest> lanes[LANE_COUNT];
+    uint64_t frame_budget_ns = DEFAULT_FRAME_BUDGET_NS;
+
+    // poll backend: accept every pending connection
+    void accept_clients();
+
+    // poll backend: flush pending writes to and read from every client
+    void read_clients(const ContextCallback& on_message);
+
+    // send whatever is ready for every client (io_uring: one batch each)
+    void flush_clients();
+
+    // run queued requests, highest lane first, within the frame budget
+    void run_lanes(const ContextCallback& on_message);
+
+    // between bulk requests: send what's ready and pick up requests that
+    // arrived meanwhile, so a control request can go next
+    void checkpoint(const ContextCallback& on_message);
+
+    // hand a complete message to deliver, or to its lane when classifying
+    bool dispatch(ClientConnection& client, std::string& message, uint8_t content_type,
+                  const ContextCallback& on_message);
+
+    // io_uring backend: reap completions, handle input, batch sends
+    void poll_uring(const ContextCallback& on_message);
+    void handle_completion(const UringCompletion& c, const ContextCallback& on_message);
+
+    // index of the client with this id, or clients.size()
+    size_t find_client(uint64_t id) const;
+
+    // close a client's fd and drop it from the list
+    void remove_client(size_t index);
+
+    // frame freshly read bytes and handle every complete message.
+    // returns false if the client is dead or sent something unframeable
+    bool process_input(ClientConnection& client, const char* data, size_t len, const ContextCallback& on_message);
+
+    // run one message through the callback and queue its response. control
+    // responses don't wait behind earlier ones still being produced.
+    // returns false if the client is dead
+    bool deliver(ClientConnection& client, const std::string& message, uint8_t content_type,
+                 const ContextCallback& on_message, Lane lane = Lane::interactive);
+
+    // encode and frame a handler response for this client (consuming
+    // response), or start compressing it
+    PendingResponse package(ClientConnection& client, std::string& response, RpcContext& ctx);
+
+    // send every outbound response whose compression (or multi-frame
+    // handler) has finished, in order. returns false if the client is dead
+    bool drain_outbound(ClientConnection& client);
+
+    // send data to a client, queueing whatever the socket buffer can't take.
+    // returns false if the client is dead
+    bool queue_send(ClientConnection& client, const std::string& data);
+
+    // retry sending queued response bytes (io_uring: hand them to the
+    // kernel as one send). returns false if the client is dead
+    bool flush_writes(ClientConnection& client);
 };
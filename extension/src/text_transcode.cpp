@@ -0,0 +1,214 @@
+#include "text_transcode.h"
+
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// helper: one code point as UTF-8
+static void append_code_point(std::string& out, char32_t c) {
+    char buf[4];
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+        return;
+    }
+    if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+        c = 0xFFFD;
+    }
+    size_t n;
+    if (c < 0x800) {
+        buf[0] = static_cast<char>(0xC0 | (c >> 6));
+        buf[1] = static_cast<char>(0x80 | (c & 0x3F));
+        n = 2;
+    } else if (c < 0x10000) {
+        buf[0] = static_cast<char>(0xE0 | (c >> 12));
+        buf[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | (c & 0x3F));
+        n = 3;
+    } else {
+        buf[0] = static_cast<char>(0xF0 | (c >> 18));
+        buf[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        buf[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        buf[3] = static_cast<char>(0x80 | (c & 0x3F));
+        n = 4;
+    }
+    out.append(buf, n);
+}
+
+// helper: one code point inside a JSON string literal
+static void append_json_code_point(std::string& out, char32_t c) {
+    switch (c) {
+        case '\b': out += "\\b"; return;
+        case '\t': out += "\\t"; return;
+        case '\n': out += "\\n"; return;
+        case '\f': out += "\\f"; return;
+        case '\r': out += "\\r"; return;
+        case '"': out += "\\\""; return;
+        case '\\': out += "\\\\"; return;
+        default: break;
+    }
+    if (c < 0x20) {
+        static const char hex[] = "0123456789abcdef";
+        char buf[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+        out.append(buf, sizeof(buf));
+        return;
+    }
+    append_code_point(out, c);
+}
+
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define TRANSCODE_VECTOR 1
+constexpr size_t BLOCK = 16;
+#endif
+
+#if defined(__SSE2__)
+using AsciiBlock = __m128i;
+
+// helper: if the 16 code points at src are all ASCII, narrow them to bytes
+static bool narrow_ascii_block(const char32_t* src, AsciiBlock& bytes) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    __m128i high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(~0x7F));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    // every lane is < 0x80, so the saturating packs are plain narrowing
+    bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    return true;
+}
+
+static void store_block(char* dst, AsciiBlock bytes) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), bytes);
+}
+
+// helper: index of the first byte a JSON string must escape, BLOCK if none
+static size_t first_json_special(AsciiBlock bytes) {
+    // bytes are < 0x80, so the signed compare finds the control characters
+    __m128i special = _mm_or_si128(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')),
+                                                _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    return mask ? static_cast<size_t>(__builtin_ctz(mask)) : BLOCK;
+}
+#elif defined(TRANSCODE_VECTOR)
+using AsciiBlock = uint8x16_t;
+
+// helper: if the 16 code points at src are all ASCII, narrow them to bytes
+static bool narrow_ascii_block(const char32_t* src, AsciiBlock& bytes) {
+    const uint32_t* p = reinterpret_cast<const uint32_t*>(src);
+    uint32x4_t a = vld1q_u32(p);
+    uint32x4_t b = vld1q_u32(p + 4);
+    uint32x4_t c = vld1q_u32(p + 8);
+    uint32x4_t d = vld1q_u32(p + 12);
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80) {
+        return false;
+    }
+    // every lane is < 0x80, so the narrowing moves keep every bit
+    uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    bytes = vcombine_u8(vmovn_u16(ab), vmovn_u16(cd));
+    return true;
+}
+
+static void store_block(char* dst, AsciiBlock bytes) {
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst), bytes);
+}
+
+// helper: index of the first byte a JSON string must escape, BLOCK if none
+static size_t first_json_special(AsciiBlock bytes) {
+    uint8x16_t special = vorrq_u8(vcltq_u8(bytes, vdupq_n_u8(0x20)),
+                                  vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('"')), vceqq_u8(bytes, vdupq_n_u8('\\'))));
+    // no movemask on NEON: shifting each 16-bit pair right by 4 and
+    // narrowing leaves one nibble per byte in a 64-bit mask
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+    return mask ? static_cast<size_t>(__builtin_ctzll(mask)) / 4 : BLOCK;
+}
+#endif
+
+void append_utf8_scalar(std::string& out, std::u32string_view text) {
+    out.reserve(out.size() + text.size());
+    for (char32_t c : text) {
+        append_code_point(out, c);
+    }
+}
+
+void append_utf8(std::string& out, std::u32string_view text) {
+    out.reserve(out.size() + text.size());
+    const char32_t* src = text.data();
+    size_t n = text.size();
+    size_t i = 0;
+#if defined(TRANSCODE_VECTOR)
+    while (i + BLOCK <= n) {
+        AsciiBlock bytes;
+        if (!narrow_ascii_block(src + i, bytes)) {
+            for (size_t end = i + BLOCK; i < end; i++) {
+                append_code_point(out, src[i]);
+            }
+            continue;
+        }
+        char buf[BLOCK];
+        store_block(buf, bytes);
+        out.append(buf, BLOCK);
+        i += BLOCK;
+    }
+#endif
+    for (; i < n; i++) {
+        append_code_point(out, src[i]);
+    }
+}
+
+std::string utf32_to_utf8(std::u32string_view text) {
+    std::string out;
+    append_utf8(out, text);
+    return out;
+}
+
+void append_json_string_scalar(std::string& out, std::u32string_view text) {
+    out.reserve(out.size() + text.size() + 2);
+    out += '"';
+    for (char32_t c : text) {
+        append_json_code_point(out, c);
+    }
+    out += '"';
+}
+
+void append_json_string(std::string& out, std::u32string_view text) {
+    out.reserve(out.size() + text.size() + 2);
+    out += '"';
+    const char32_t* src = text.data();
+    size_t n = text.size();
+    size_t i = 0;
+#if defined(TRANSCODE_VECTOR)
+    while (i + BLOCK <= n) {
+        AsciiBlock bytes;
+        if (!narrow_ascii_block(src + i, bytes)) {
+            for (size_t end = i + BLOCK; i < end; i++) {
+                append_json_code_point(out, src[i]);
+            }
+            continue;
+        }
+        char buf[BLOCK];
+        store_block(buf, bytes);
+        size_t first = first_json_special(bytes);
+        if (first == BLOCK) {
+            out.append(buf, BLOCK);
+            i += BLOCK;
+            continue;
+        }
+        // copy up to the first character that needs escaping, escape it and
+        // carry on from the one after
+        out.append(buf, first);
+        append_json_code_point(out, src[i + first]);
+        i += first + 1;
+    }
+#endif
+    for (; i < n; i++) {
+        append_json_code_point(out, src[i]);
+    }
+    out += '"';
+}
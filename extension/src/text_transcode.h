@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// UTF-32 -> UTF-8 transcoding for large editor text (no godot dependency).
+//
+// godot Strings are UTF-32. the usual way out - String::utf8() into a
+// CharString, copied into a std::string, escaped again by dump() - walks a
+// multi-megabyte Output panel three times. these read the String's buffer
+// (String::ptr(), String::length()) directly. runs of 16 ASCII code points
+// are narrowed with SSE2 on x86-64 and NEON on arm64; anything else goes
+// through the scalar encoder. code points that aren't valid scalar values
+// (surrogates, > U+10FFFF) become U+FFFD.
+
+// append text as UTF-8
+void append_utf8(std::string& out, std::u32string_view text);
+
+std::string utf32_to_utf8(std::u32string_view text);
+
+// append text as a JSON string literal, quotes included, in one pass. the
+// bytes are the same as nlohmann's dump() of the UTF-8 text: \b \t \n \f \r
+// \" \\ escaped by name, other control characters as \u00xx, everything
+// else (non-ASCII included) written as is
+void append_json_string(std::string& out, std::u32string_view text);
+
+// the same two encoders without the vector path, which is all other
+// targets get. tests hold both paths to the same bytes
+void append_utf8_scalar(std::string& out, std::u32string_view text);
+void append_json_string_scalar(std::string& out, std::u32string_view text);
@@ -0,0 +1,151 @@
+#include "trace.h"
+#include "server_stats.h"  // stats_now_ns
+#include <nlohmann/json.hpp>
+
+#include <unistd.h>  // getpid
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using json = nlohmann::json;
+
+std::atomic<bool> g_trace_enabled{false};
+
+// single-producer ring owned by one thread. the owner writes a slot and then
+// publishes it by bumping head; readers only ever look at published slots.
+struct TraceRing {
+    static constexpr size_t CAPACITY = 1 << 14;  // events kept per thread
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    TraceEvent events[CAPACITY];
+    std::atomic<uint64_t> head{0};  // total events ever written
+    std::atomic<uint64_t> tail{0};  // events before this index were cleared
+    uint32_t tid = 0;
+};
+
+// registry of every thread's ring. only locked when a thread records its
+// first event and when exporting/clearing, never on the recording path.
+// rings are shared_ptr so events survive their thread exiting.
+static std::mutex registry_mutex;
+static std::vector<std::shared_ptr<TraceRing>> registry;
+static uint32_t next_tid = 1;
+
+static thread_local TraceRing* local_ring = nullptr;
+
+static TraceRing* get_local_ring() {
+    if (!local_ring) {
+        auto ring = std::make_shared<TraceRing>();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        ring->tid = next_tid++;
+        registry.push_back(ring);
+        local_ring = ring.get();
+    }
+    return local_ring;
+}
+
+void trace_set_enabled(bool enabled) {
+    g_trace_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void trace_clear() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& ring : registry) {
+        ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
+
+void trace_record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    TraceRing* ring = get_local_ring();
+    uint64_t index = ring->head.load(std::memory_order_relaxed);
+    TraceEvent& ev = ring->events[index & TraceRing::MASK];
+
+    strncpy(ev.name, name, TraceEvent::NAME_SIZE - 1);
+    ev.name[TraceEvent::NAME_SIZE - 1] = '\0';
+    ev.start_ns = start_ns;
+    ev.duration_ns = end_ns - start_ns;
+
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+// helper: [first, last) range of live events in a ring
+static void ring_range(const TraceRing& ring, uint64_t& first, uint64_t& last) {
+    last = ring.head.load(std::memory_order_acquire);
+    first = ring.tail.load(std::memory_order_acquire);
+    if (last - first > TraceRing::CAPACITY) {
+        first = last - TraceRing::CAPACITY;  // oldest events were overwritten
+    }
+}
+
+size_t trace_event_count() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    size_t total = 0;
+    for (const auto& ring : registry) {
+        uint64_t first, last;
+        ring_range(*ring, first, last);
+        total += static_cast<size_t>(last - first);
+    }
+    return total;
+}
+
+std::string trace_to_chrome_json() {
+    json events = json::array();
+    int pid = static_cast<int>(getpid());
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto& ring : registry) {
+        uint64_t first, last;
+        ring_range(*ring, first, last);
+
+        // name the thread so the viewer shows something readable
+        events.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", pid},
+            {"tid", ring->tid},
+            {"args", {{"name", "thread-" + std::to_string(ring->tid)}}}
+        });
+
+        for (uint64_t i = first; i < last; i++) {
+            const TraceEvent& ev = ring->events[i & TraceRing::MASK];
+            // "X" = complete event; chrome trace timestamps are microseconds
+            events.push_back({
+                {"name", ev.name},
+                {"cat", "godot_peek"},
+                {"ph", "X"},
+                {"ts", ev.start_ns / 1000.0},
+                {"dur", ev.duration_ns / 1000.0},
+                {"pid", pid},
+                {"tid", ring->tid}
+            });
+        }
+    }
+
+    json doc = {
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"}
+    };
+    // replace rather than throw on any invalid UTF-8 in copied names
+    return doc.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+bool trace_export_chrome(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out << trace_to_chrome_json();
+    return static_cast<bool>(out);
+}
+
+void TraceScope::begin(const char* scope_name) {
+    active = true;
+    strncpy(name, scope_name, TraceEvent::NAME_SIZE - 1);
+    name[TraceEvent::NAME_SIZE - 1] = '\0';
+    start_ns = stats_now_ns();
+}
+
+void TraceScope::end() {
+    trace_record(name, start_ns, stats_now_ns());
+}
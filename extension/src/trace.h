@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// lightweight scoped tracing (no godot dependency)
+// PEEK_TRACE_SCOPE("name") records a complete event covering the enclosing
+// scope into a per-thread ring buffer. export with trace_export_chrome() and
+// open the file in chrome://tracing or https://ui.perfetto.dev.
+//
+// build with GODOT_PEEK_TRACE=0 (scons trace=no) to compile every trace site
+// out. when compiled in but not enabled, a trace site costs one relaxed load
+// and a not-taken branch.
+
+#ifndef GODOT_PEEK_TRACE
+#define GODOT_PEEK_TRACE 1
+#endif
+
+// one recorded event. names are copied so callers can pass temporaries
+struct TraceEvent {
+    static constexpr size_t NAME_SIZE = 48;
+    char name[NAME_SIZE];
+    uint64_t start_ns;
+    uint64_t duration_ns;
+};
+
+// global on/off switch, checked by every trace site
+extern std::atomic<bool> g_trace_enabled;
+
+inline bool trace_enabled() {
+    return g_trace_enabled.load(std::memory_order_relaxed);
+}
+
+// start/stop recording. enabling does not clear previously recorded events
+void trace_set_enabled(bool enabled);
+
+// drop all recorded events on every thread
+void trace_clear();
+
+// append one event to the calling thread's ring buffer (lock-free after the
+// thread's first event, which registers its buffer)
+void trace_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+// total events currently held across all threads
+size_t trace_event_count();
+
+// serialise everything recorded as a chrome trace-format JSON document.
+// exporting while other threads are recording may include a few torn events
+std::string trace_to_chrome_json();
+
+// write trace_to_chrome_json() to a file. returns false on IO error
+bool trace_export_chrome(const std::string& path);
+
+// RAII helper behind PEEK_TRACE_SCOPE
+class TraceScope {
+public:
+    explicit TraceScope(const char* scope_name) {
+        if (trace_enabled()) {
+            begin(scope_name);
+        }
+    }
+    explicit TraceScope(const std::string& scope_name) : TraceScope(scope_name.c_str()) {}
+
+    ~TraceScope() {
+        if (active) {
+            end();
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    void begin(const char* scope_name);
+    void end();
+
+    // name is copied on begin so temporaries are safe to pass
+    bool active = false;
+    uint64_t start_ns = 0;
+    char name[TraceEvent::NAME_SIZE];
+};
+
+#if GODOT_PEEK_TRACE
+#define PEEK_TRACE_CONCAT_INNER(a, b) a##b
+#define PEEK_TRACE_CONCAT(a, b) PEEK_TRACE_CONCAT_INNER(a, b)
+#define PEEK_TRACE_SCOPE(name) TraceScope PEEK_TRACE_CONCAT(peek_trace_scope_, __LINE__)(name)
+#else
+#define PEEK_TRACE_SCOPE(name) ((void)0)
+#endif
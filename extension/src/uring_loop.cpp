@@ -0,0 +1,422 @@
+#include "uring_loop.h"
+
+#ifdef __linux__
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+// user_data layout: op tag in the top byte, client id (or send slot) below
+static constexpr int TAG_SHIFT = 56;
+static constexpr uint64_t VALUE_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+static constexpr uint16_t BUFFER_GROUP = 0;
+
+static uint64_t pack_user_data(UringOp op, uint64_t value) {
+    return (static_cast<uint64_t>(op) << TAG_SHIFT) | (value & VALUE_MASK);
+}
+
+static int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+UringLoop::~UringLoop() {
+    stop();
+}
+
+bool UringLoop::init(unsigned entries, unsigned count, size_t size) {
+    if (ring_fd >= 0) {
+        return true;
+    }
+    if (count == 0 || (count & (count - 1)) != 0 || count > 32768 || size == 0) {
+        return false;
+    }
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // ENOSYS on old kernels, EPERM where io_uring is disabled by sysctl or seccomp
+    ring_fd = sys_io_uring_setup(entries, &params);
+    if (ring_fd < 0) {
+        ring_fd = -1;
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+        stop();
+        return false;
+    }
+
+    // map the shared rings and the submission entries
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring_size = sq_size > cq_size ? sq_size : cq_size;
+    ring_mem = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                    IORING_OFF_SQ_RING);
+    if (ring_mem == MAP_FAILED) {
+        ring_mem = nullptr;
+        stop();
+        return false;
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_mem = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                         IORING_OFF_SQES);
+    if (sqe_mem == MAP_FAILED) {
+        stop();
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqe_mem);
+
+    char* base = static_cast<char*>(ring_mem);
+    sq_head = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    sq_flags = reinterpret_cast<unsigned*>(base + params.sq_off.flags);
+    sq_array = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    sq_mask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sq_entries = params.sq_entries;
+    cq_head = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+    cq_mask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+
+    // provided buffers: the kernel picks one per recv completion and we
+    // hand it back after the callback. both live in anonymous mappings so a
+    // late kernel write after stop() faults instead of hitting the heap
+    buffer_count = count;
+    buffer_size = size;
+    buf_ring_size = count * sizeof(io_uring_buf);
+    void* ring_buf_mem = mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring_buf_mem == MAP_FAILED) {
+        stop();
+        return false;
+    }
+    buf_ring = static_cast<io_uring_buf_ring*>(ring_buf_mem);
+    void* buffer_mem = mmap(nullptr, count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer_mem == MAP_FAILED) {
+        stop();
+        return false;
+    }
+    buffers = static_cast<char*>(buffer_mem);
+
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(buf_ring);
+    reg.ring_entries = count;
+    reg.bgid = BUFFER_GROUP;
+    if (sys_io_uring_register(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        stop();
+        return false;
+    }
+    for (unsigned i = 0; i < count; i++) {
+        provide_buffer(static_cast<uint16_t>(i));
+    }
+
+    // provided buffer rings predate multishot recv by a release; make sure
+    // this kernel actually keeps a recv armed before relying on it
+    if (!probe_multishot_recv()) {
+        stop();
+        return false;
+    }
+    syscall_count = 0;
+    return true;
+}
+
+bool UringLoop::probe_multishot_recv() {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) {
+        return false;
+    }
+    bool supported = false;
+    bool armed = ::send(pair[1], "x", 1, MSG_NOSIGNAL) == 1 && arm_recv(pair[0], 0) && submit();
+    while (armed) {
+        if (sys_io_uring_enter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            break;  // stop() cancels whatever is left
+        }
+        reap([&](const UringCompletion& c) {
+            if (c.result == 1) {
+                supported = c.more;
+                shutdown(pair[0], SHUT_RDWR);  // ends the multishot recv
+            }
+            if (!c.more) {
+                armed = false;
+            }
+        });
+    }
+    close(pair[0]);
+    close(pair[1]);
+    return supported && inflight == 0;
+}
+
+void UringLoop::provide_buffer(uint16_t bid) {
+    // index the ring as a plain array: in C++ the header's flex-array macro
+    // wraps bufs in a struct with a 1-byte empty member, shifting it by 8
+    io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(buf_ring) + (buf_tail & (buffer_count - 1));
+    buf->addr = reinterpret_cast<uintptr_t>(buffers + static_cast<size_t>(bid) * buffer_size);
+    buf->len = static_cast<uint32_t>(buffer_size);
+    buf->bid = bid;
+    buf_tail++;
+    __atomic_store_n(&buf_ring->tail, buf_tail, __ATOMIC_RELEASE);
+}
+
+bool UringLoop::queue(const io_uring_sqe& sqe) {
+    if (ring_fd < 0) {
+        return false;
+    }
+    unsigned tail = *sq_tail;
+    if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        // full: push what's queued to the kernel to make room
+        if (!submit() || tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            return false;
+        }
+    }
+    unsigned index = tail & sq_mask;
+    sqes[index] = sqe;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    unsubmitted++;
+    inflight++;
+    return true;
+}
+
+bool UringLoop::arm_accept(int listen_fd) {
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = listen_fd;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_CLOEXEC;  // the game child process must not inherit clients
+    sqe.user_data = pack_user_data(UringOp::accept, 0);
+    return queue(sqe);
+}
+
+bool UringLoop::arm_recv(int fd, uint64_t client_id) {
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUFFER_GROUP;
+    sqe.user_data = pack_user_data(UringOp::recv, client_id);
+    return queue(sqe);
+}
+
+bool UringLoop::queue_send(uint64_t slot, const PendingSend& pending) {
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_SEND;
+    sqe.fd = pending.fd;
+    sqe.addr = reinterpret_cast<uintptr_t>(pending.data.data() + pending.offset);
+    sqe.len = static_cast<uint32_t>(pending.data.size() - pending.offset);
+    sqe.msg_flags = MSG_NOSIGNAL;
+    sqe.user_data = pack_user_data(UringOp::send, slot);
+    return queue(sqe);
+}
+
+bool UringLoop::send(int fd, uint64_t client_id, std::string data) {
+    uint64_t slot = next_send_slot++;
+    // unordered_map nodes don't move, so data stays put until its completion
+    PendingSend& pending = sends[slot];
+    pending.fd = fd;
+    pending.client_id = client_id;
+    pending.data = std::move(data);
+    if (!queue_send(slot, pending)) {
+        sends.erase(slot);
+        return false;
+    }
+    return true;
+}
+
+bool UringLoop::submit() {
+    while (unsubmitted > 0) {
+        int n = sys_io_uring_enter(ring_fd, unsubmitted, 0, 0);
+        syscall_count++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EAGAIN/EBUSY: out of resources or completions backed up;
+            // the entries stay queued for the next submit
+            return errno == EAGAIN || errno == EBUSY;
+        }
+        if (n == 0) {
+            break;
+        }
+        unsubmitted -= static_cast<unsigned>(n) < unsubmitted ? static_cast<unsigned>(n) : unsubmitted;
+    }
+    return true;
+}
+
+size_t UringLoop::reap(const std::function<void(const UringCompletion&)>& on_completion) {
+    if (ring_fd < 0) {
+        return 0;
+    }
+    size_t reaped = 0;
+    while (true) {
+        unsigned head = *cq_head;
+        if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+            // completions that didn't fit in the ring wait in the kernel
+            // until an enter flushes them
+            if (!(__atomic_load_n(sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW)) {
+                break;
+            }
+            sys_io_uring_enter(ring_fd, 0, 0, IORING_ENTER_GETEVENTS);
+            syscall_count++;
+            if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            continue;
+        }
+        io_uring_cqe cqe = cqes[head & cq_mask];
+        __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+        if (!(cqe.flags & IORING_CQE_F_MORE) && inflight > 0) {
+            inflight--;
+        }
+        reaped++;
+        handle(cqe, on_completion);
+    }
+    return reaped;
+}
+
+void UringLoop::handle(const io_uring_cqe& cqe, const std::function<void(const UringCompletion&)>& on_completion) {
+    UringCompletion c;
+    c.op = static_cast<UringOp>(cqe.user_data >> TAG_SHIFT);
+    c.result = cqe.res;
+    c.more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    uint64_t value = cqe.user_data & VALUE_MASK;
+
+    switch (c.op) {
+    case UringOp::accept:
+        on_completion(c);
+        break;
+    case UringOp::recv: {
+        c.client_id = value;
+        int bid = -1;
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            bid = static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            c.data = buffers + static_cast<size_t>(bid) * buffer_size;
+        }
+        on_completion(c);
+        // recycle even when the callback ignored it (stale client)
+        if (bid >= 0) {
+            provide_buffer(static_cast<uint16_t>(bid));
+        }
+        break;
+    }
+    case UringOp::send: {
+        auto it = sends.find(value);
+        if (it == sends.end()) {
+            break;
+        }
+        PendingSend& pending = it->second;
+        if (cqe.res > 0 && pending.offset + static_cast<size_t>(cqe.res) < pending.data.size()) {
+            // short send: queue the rest from the same buffer
+            pending.offset += static_cast<size_t>(cqe.res);
+            if (queue_send(value, pending)) {
+                break;
+            }
+            c.result = -EAGAIN;
+        } else if (cqe.res == 0 && !pending.data.empty()) {
+            c.result = -EPIPE;
+        } else if (cqe.res > 0) {
+            c.result = 0;
+        }
+        c.client_id = pending.client_id;
+        sends.erase(it);
+        on_completion(c);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void UringLoop::stop() {
+    if (ring_fd >= 0 && ring_mem && sqes) {
+        if (inflight > 0) {
+            io_uring_sqe sqe;
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            sqe.user_data = pack_user_data(UringOp::cancel, 0);
+            queue(sqe);
+            submit();
+        }
+        // cancelled ops still post a final completion; the kernel may touch
+        // send buffers and provided buffers until then. bounded at ~100ms
+        for (int i = 0; i < 200 && inflight > 0; i++) {
+            reap([](const UringCompletion&) {});
+            if (inflight > 0) {
+                usleep(500);
+            }
+        }
+    }
+    if (ring_fd >= 0) {
+        close(ring_fd);
+        ring_fd = -1;
+    }
+    if (buffers) {
+        munmap(buffers, static_cast<size_t>(buffer_count) * buffer_size);
+        buffers = nullptr;
+    }
+    if (buf_ring) {
+        munmap(buf_ring, buf_ring_size);
+        buf_ring = nullptr;
+    }
+    if (sqes) {
+        munmap(sqes, sqes_size);
+        sqes = nullptr;
+    }
+    if (ring_mem) {
+        munmap(ring_mem, ring_size);
+        ring_mem = nullptr;
+    }
+    sends.clear();
+    inflight = 0;
+    unsubmitted = 0;
+    buf_tail = 0;
+}
+
+#else
+
+// io_uring is linux-only; SocketServer falls back to its poll loop
+
+UringLoop::~UringLoop() = default;
+
+bool UringLoop::init(unsigned, unsigned, size_t) {
+    return false;
+}
+
+bool UringLoop::arm_accept(int) {
+    return false;
+}
+
+bool UringLoop::arm_recv(int, uint64_t) {
+    return false;
+}
+
+bool UringLoop::send(int, uint64_t, std::string) {
+    return false;
+}
+
+size_t UringLoop::reap(const std::function<void(const UringCompletion&)>&) {
+    return 0;
+}
+
+bool UringLoop::submit() {
+    return false;
+}
+
+void UringLoop::stop() {
+}
+
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+// io_uring event loop behind SocketServer's io_uring backend (no godot
+// dependency). linux only: everywhere else init() fails and the server keeps
+// its poll loop. the kernel is driven through the raw syscalls so there is
+// no liburing dependency.
+//
+// accept and recv are multishot, so one submission keeps delivering
+// connections/bytes; received bytes land in a registered ring of provided
+// buffers. completions are read straight out of the shared completion ring,
+// so an idle reap() makes no syscall.
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+enum class UringOp : uint8_t {
+    accept = 1,
+    recv = 2,
+    send = 3,
+    cancel = 4,
+};
+
+struct UringCompletion {
+    UringOp op = UringOp::accept;
+    uint64_t client_id = 0;      // recv/send: id passed when the op was queued
+    int32_t result = 0;          // accept: new fd. recv: bytes (0 = eof). send: 0. or -errno
+    bool more = false;           // the multishot op is still armed
+    const char* data = nullptr;  // recv: the bytes, valid only inside the callback
+};
+
+class UringLoop {
+public:
+    UringLoop() = default;
+    ~UringLoop();
+
+    UringLoop(const UringLoop&) = delete;
+    UringLoop& operator=(const UringLoop&) = delete;
+
+    // set up the rings and buffer_count provided buffers of buffer_size
+    // bytes (buffer_count must be a power of two). false if io_uring or
+    // multishot recv isn't available; the loop is left inactive
+    bool init(unsigned entries = 256, unsigned buffer_count = 64, size_t buffer_size = 16384);
+
+    bool active() const { return ring_fd >= 0; }
+
+    // the ring's fd; it polls readable while completions are waiting
+    int fd() const { return ring_fd; }
+
+    // queue a multishot accept / recv. false if the submission queue is full
+    bool arm_accept(int listen_fd);
+    bool arm_recv(int fd, uint64_t client_id);
+
+    // queue a send of data, which the loop keeps alive until the kernel is
+    // done with it. short sends are resubmitted internally; the caller sees
+    // one completion for the whole buffer
+    bool send(int fd, uint64_t client_id, std::string data);
+
+    // hand every ready completion to on_completion. recv buffers go back to
+    // the kernel as soon as the callback returns. returns the number reaped
+    size_t reap(const std::function<void(const UringCompletion&)>& on_completion);
+
+    // one io_uring_enter for everything queued since the last submit, or
+    // nothing if the queue is empty. false on a fatal ring error
+    bool submit();
+
+    // cancel every op, wait (briefly) for their final completions, and
+    // release the rings. called by the destructor
+    void stop();
+
+    // io_uring_enter calls made since init (for tests and benchmarks)
+    uint64_t syscalls() const { return syscall_count; }
+
+private:
+    struct PendingSend {
+        int fd = -1;
+        uint64_t client_id = 0;
+        std::string data;
+        size_t offset = 0;  // bytes the kernel has already taken
+    };
+
+    bool queue(const io_uring_sqe& sqe);
+    bool queue_send(uint64_t slot, const PendingSend& pending);
+    void handle(const io_uring_cqe& cqe, const std::function<void(const UringCompletion&)>& on_completion);
+    void provide_buffer(uint16_t bid);
+    bool probe_multishot_recv();
+
+    int ring_fd = -1;
+    void* ring_mem = nullptr;  // sq and cq rings share one mapping
+    size_t ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_flags = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned unsubmitted = 0;  // queued sqes io_uring_enter hasn't taken yet
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+
+    io_uring_buf_ring* buf_ring = nullptr;
+    size_t buf_ring_size = 0;
+    char* buffers = nullptr;
+    unsigned buffer_count = 0;
+    size_t buffer_size = 0;
+    uint16_t buf_tail = 0;
+
+    std::unordered_map<uint64_t, PendingSend> sends;  // by send slot
+    uint64_t next_send_slot = 1;
+    size_t inflight = 0;  // submitted ops whose final completion hasn't arrived
+    uint64_t syscall_count = 0;
+};
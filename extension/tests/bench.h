@@ -0,0 +1,28 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <string>
+
+// shared pieces of the standalone benchmark runner (make bench).
+// each bench_*.cpp file exposes one run_*_benchmarks() suite that appends
+// result objects to the output array.
+
+struct BenchOptions {
+    bool quick = false;   // shorter runs for CI smoke checks
+    std::string filter;   // only run cases whose name contains this
+};
+
+// true if a case name passes the --filter option
+bool bench_selected(const BenchOptions& opts, const std::string& name);
+
+// allocation counting. bench_main.cpp replaces global operator new; only
+// threads that opted in with bench_count_allocations(true) are counted, so a
+// suite can measure the server side without its client threads.
+void bench_count_allocations(bool enabled);
+uint64_t bench_allocations();
+
+// suites
+void run_socket_benchmarks(const BenchOptions& opts, nlohmann::json& results);
+void run_editor_core_benchmarks(const BenchOptions& opts, nlohmann::json& results);
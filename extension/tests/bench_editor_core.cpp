@@ -0,0 +1,360 @@
+// editor-side serialiser and dispatch benchmarks over synthetic trees built
+// with the mocks in mock_editor.h, so handler regressions show up without an
+// editor or GPU.
+
+#include "bench.h"
+#include "mock_editor.h"
+#include "editor_serializers.h"
+#include "rpc_dispatcher.h"
+#include "server_stats.h"
+#include "json_rpc.h"
+#include "response_encoding.h"
+#include "response_cache.h"
+#include "request_arena.h"
+#include "text_transcode.h"
+#include "node_query.h"
+#include "count_snapshots.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+using json = nlohmann::json;
+
+// helper: run fn iterations times, report time and allocations per iteration.
+// fn returns the size of what it produced so the work can't be optimised out
+static json time_case(const std::string& name, size_t nodes, int iterations, const std::function<size_t()>& fn) {
+    fn();  // warm-up
+
+    size_t output_bytes = 0;
+    bench_count_allocations(true);
+    uint64_t allocs_before = bench_allocations();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        output_bytes = fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocs = bench_allocations() - allocs_before;
+    bench_count_allocations(false);
+
+    return {
+        {"suite", "editor_core"},
+        {"name", name},
+        {"nodes", nodes},
+        {"iterations", iterations},
+        {"seconds", seconds},
+        {"ms_per_iteration", seconds * 1000.0 / iterations},
+        {"ns_per_node", nodes ? seconds * 1e9 / iterations / nodes : 0.0},
+        {"allocs_per_iteration", static_cast<double>(allocs) / iterations},
+        {"output_bytes", output_bytes}
+    };
+}
+
+// debugger-errors shaped tree: groups of entries, each with a couple of
+// stack lines beneath it, two columns
+static void build_error_tree(MockTree& tree, size_t count) {
+    ItemHandle root = tree.add(nullptr, {"Errors"});
+    size_t made = 1;
+    for (size_t e = 0; made < count; e++) {
+        ItemHandle entry = tree.add(root, {"E 0:00:" + std::to_string(e), "Invalid access to property 'position'"});
+        made++;
+        for (int f = 0; f < 3 && made < count; f++, made++) {
+            tree.add(entry, {"", "res://scripts/enemy.gd:" + std::to_string(40 + f) + " @ _physics_process()"});
+        }
+    }
+}
+
+// remote scene tree: fan-out of 10 per level, type info in tooltips
+static void build_scene_tree(MockTree& tree, size_t count) {
+    std::vector<ItemHandle> level = {tree.add(nullptr, {"root"}, {"root (Window)"})};
+    size_t made = 1;
+    while (made < count) {
+        std::vector<ItemHandle> next;
+        for (ItemHandle parent : level) {
+            for (int i = 0; i < 10 && made < count; i++, made++) {
+                std::string name = "Node" + std::to_string(made);
+                next.push_back(tree.add(parent, {name}, {name + " (Sprite2D)\nType: Sprite2D"}));
+            }
+        }
+        level.swap(next);
+    }
+}
+
+// inspector: sections of EditorProperty nodes, each wrapping a value control
+static void build_inspector(MockNodeTree& nodes, NodeHandle inspector, size_t count) {
+    size_t made = 1;
+    static const char* kinds[] = {"EditorPropertyFloat", "EditorPropertyText", "EditorPropertyCheck", "EditorPropertyVector2"};
+    for (size_t s = 0; made < count; s++) {
+        NodeHandle section = nodes.add(inspector, {"VBoxContainer", "Container", "Control", "Node"});
+        made++;
+        for (int p = 0; p < 16 && made < count; p++) {
+            const char* kind = kinds[p % 4];
+            NodeHandle prop = nodes.add(section, {kind, "EditorProperty", "Container", "Control", "Node"});
+            nodes.get(prop).label = "property_" + std::to_string(s) + "_" + std::to_string(p);
+            made++;
+            if (p % 4 == 0 || p % 4 == 3) {
+                int sliders = p % 4 == 0 ? 1 : 2;
+                for (int i = 0; i < sliders; i++, made++) {
+                    NodeHandle slider = nodes.add(prop, {"EditorSpinSlider", "Range", "Control", "Node"});
+                    nodes.get(slider).value = "12.5";
+                    nodes.get(slider).has_value = true;
+                }
+            } else if (p % 4 == 1) {
+                nodes.get(nodes.add(prop, {"LineEdit", "Control", "Node"})).text = "Player";
+                made++;
+            } else {
+                nodes.get(nodes.add(prop, {"CheckBox", "Button", "BaseButton", "Control", "Node"})).pressed = true;
+                made++;
+            }
+        }
+    }
+}
+
+// a game scene: rooms under /root/Level, each with props, lights and a few
+// rigid bodies (a quarter of them awake, some tagged "loot")
+static void build_game_scene(MockSceneTree& tree, size_t count) {
+    NodeHandle level = tree.add(tree.root(), "Level", {"Node3D", "Node"});
+    NodeHandle room = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 100 == 0) {
+            room = tree.add(level, "Room" + std::to_string(i / 100), {"Node3D", "Node"});
+            continue;
+        }
+        std::string name = std::to_string(i);
+        NodeHandle node;
+        switch (i % 10) {
+            case 0:
+            case 1:
+                node = tree.add(room, "Body" + name, {"RigidBody3D", "PhysicsBody3D", "CollisionObject3D", "Node3D", "Node"});
+                tree.get(node).properties = {{"sleeping", i % 4 != 0}, {"mass", static_cast<double>(i % 7)}};
+                if (i % 3 == 0) {
+                    tree.add_to_group(node, "loot");
+                }
+                break;
+            case 2:
+                node = tree.add(room, "Light" + name, {"OmniLight3D", "Light3D", "VisualInstance3D", "Node3D", "Node"});
+                break;
+            default:
+                node = tree.add(room, "Mesh" + name, {"MeshInstance3D", "GeometryInstance3D", "VisualInstance3D", "Node3D", "Node"});
+                break;
+        }
+    }
+}
+
+void run_editor_core_benchmarks(const BenchOptions& opts, json& results) {
+    size_t nodes = opts.quick ? 10000 : 100000;
+    int iterations = opts.quick ? 5 : 20;
+    std::string suffix = "/n" + std::to_string(nodes);
+
+    if (bench_selected(opts, "editor_core/tree_text" + suffix)) {
+        MockTree tree(2);
+        build_error_tree(tree, nodes);
+        results.push_back(time_case("tree_text" + suffix, nodes, iterations,
+                                    [&] { return tree_text(tree).size(); }));
+    }
+
+    if (bench_selected(opts, "editor_core/scene_tree_text" + suffix)) {
+        MockTree tree(1);
+        build_scene_tree(tree, nodes);
+        results.push_back(time_case("scene_tree_text" + suffix, nodes, iterations,
+                                    [&] { return scene_tree_text(tree).size(); }));
+    }
+
+    if (bench_selected(opts, "editor_core/collect_editor_properties" + suffix)) {
+        MockNodeTree view;
+        NodeHandle inspector = view.add(nullptr, {"EditorInspector", "ScrollContainer", "Control", "Node"});
+        build_inspector(view, inspector, nodes);
+        results.push_back(time_case("collect_editor_properties" + suffix, nodes, iterations, [&] {
+            json props = json::array();
+            collect_editor_properties(view, inspector, props);
+            return props.dump().size();
+        }));
+    }
+
+    // encoding a large property batch: the old dump -> make_result round trip
+    // against encoding straight from the DOM in each negotiated encoding
+    if (bench_selected(opts, "editor_core/encode")) {
+        MockNodeTree view;
+        NodeHandle inspector = view.add(nullptr, {"EditorInspector", "ScrollContainer", "Control", "Node"});
+        build_inspector(view, inspector, nodes);
+        json props = json::array();
+        collect_editor_properties(view, inspector, props);
+        json result = {{"properties", props}, {"count", props.size()}};
+
+        if (bench_selected(opts, "editor_core/encode/make_result" + suffix)) {
+            results.push_back(time_case("encode/make_result" + suffix, nodes, iterations,
+                                        [&] { return make_result(1, result.dump()).size(); }));
+        }
+        for (uint8_t type : {CONTENT_JSON, CONTENT_MSGPACK, CONTENT_CBOR}) {
+            std::string name = std::string("encode/") + encoding_name(type) + suffix;
+            if (bench_selected(opts, "editor_core/" + name)) {
+                results.push_back(time_case(name, nodes, iterations,
+                                            [&] { return encode_result(1, result, type).size(); }));
+            }
+        }
+    }
+
+    // a large get_output response: the old String::utf8() -> CharString ->
+    // std::string -> dump() path (the first step stood in for by a scalar
+    // encoder into a separate buffer) against transcoding and escaping the
+    // UTF-32 text straight into the response
+    if (bench_selected(opts, "editor_core/output_text")) {
+        std::u32string text;
+        for (size_t i = 0; text.size() < nodes * 40; i++) {
+            std::string line = "frame " + std::to_string(i) + ": player at (12.5, -3.25) \"idle\"\n";
+            text.append(line.begin(), line.end());
+            if (i % 50 == 0) {
+                text += U"ERROR: überlauf in res://main.gd:42\n   at: _process\n";
+            }
+        }
+        arena_json result = {{"length", static_cast<int64_t>(text.size())}, {"total_length", 0}};
+        std::string chars = std::to_string(text.size() / 1000) + "k";
+
+        if (bench_selected(opts, "editor_core/output_text/char_string/" + chars)) {
+            results.push_back(time_case("output_text/char_string/" + chars, text.size(), iterations, [&] {
+                std::vector<char> char_string;
+                char_string.reserve(text.size() + 1);
+                for (char32_t c : text) {
+                    if (c < 0x80) {
+                        char_string.push_back(static_cast<char>(c));
+                    } else {
+                        std::string cp = utf32_to_utf8(std::u32string_view(&c, 1));
+                        char_string.insert(char_string.end(), cp.begin(), cp.end());
+                    }
+                }
+                arena_json full = result;
+                full["output"] = std::string(char_string.data(), char_string.size());
+                return encode_result(1, full, CONTENT_JSON).size();
+            }));
+        }
+        if (bench_selected(opts, "editor_core/output_text/utf8_dom/" + chars)) {
+            results.push_back(time_case("output_text/utf8_dom/" + chars, text.size(), iterations, [&] {
+                arena_json full = result;
+                full["output"] = utf32_to_utf8(text);
+                return encode_result(1, full, CONTENT_JSON).size();
+            }));
+        }
+        if (bench_selected(opts, "editor_core/output_text/one_pass/" + chars)) {
+            results.push_back(time_case("output_text/one_pass/" + chars, text.size(), iterations,
+                                        [&] { return encode_result_text(1, result, "output", text, CONTENT_JSON).size(); }));
+        }
+    }
+
+    // query_nodes over a game-sized scene from each candidate source
+    if (bench_selected(opts, "editor_core/node_query")) {
+        size_t scene_nodes = opts.quick ? 10000 : 50000;
+        std::string scene_suffix = "/n" + std::to_string(scene_nodes);
+        MockSceneTree tree;
+        build_game_scene(tree, scene_nodes);
+        NodeClassIndex index;
+        for (size_t i = 1; i <= tree.size(); i++) {
+            index.add(MockSceneTree::to_handle(i), tree.class_name(MockSceneTree::to_handle(i)));
+        }
+
+        struct QueryCase {
+            const char* name;
+            const char* selector;
+            bool use_index;
+        };
+        for (const QueryCase& c : {QueryCase{"node_query/walk", "/root/Level RigidBody3D [sleeping == false]", false},
+                                   QueryCase{"node_query/class_index", "/root/Level RigidBody3D [sleeping == false]", true},
+                                   QueryCase{"node_query/group", "/root/Level .loot [mass > 3]", true}}) {
+            std::string name = c.name + scene_suffix;
+            if (!bench_selected(opts, "editor_core/" + name)) {
+                continue;
+            }
+            NodeSelector sel;
+            std::string error;
+            parse_selector(c.selector, sel, error);
+            results.push_back(time_case(name, scene_nodes, iterations, [&] {
+                return run_node_query(tree, sel, {"mass"}, NODE_QUERY_MAX_LIMIT, c.use_index ? &index : nullptr)
+                    .matches.size();
+            }));
+        }
+    }
+
+    // one count snapshot pass over the same scene, as the runtime takes it
+    // (every node's class and script handed to the store)
+    if (bench_selected(opts, "editor_core/count_snapshot")) {
+        size_t scene_nodes = opts.quick ? 10000 : 50000;
+        MockSceneTree tree;
+        build_game_scene(tree, scene_nodes);
+        CountSnapshotStore store;
+        std::string name = "count_snapshot/n" + std::to_string(scene_nodes);
+        results.push_back(time_case(name, scene_nodes, iterations, [&] {
+            store.begin();
+            for (size_t i = 1; i <= tree.size(); i++) {
+                NodeHandle node = MockSceneTree::to_handle(i);
+                const std::string& cls = tree.get(node).classes.front();
+                store.add(cls, cls == "RigidBody3D" ? "res://crate.gd" : "");
+            }
+            return store.commit(0, 0, CountTotals()).counts.size();
+        }));
+    }
+
+    // a cacheable read over a large errors tree: every call a miss (revision
+    // bumped first) against every call served from the response cache
+    if (bench_selected(opts, "editor_core/cached_read")) {
+        MockTree tree(2);
+        build_error_tree(tree, nodes);
+        ResponseCache cache;
+        ResponseEncoder encoder;
+        RpcDispatcher reads;
+        reads.set_cache(&cache);
+        reads.add("get_debugger_errors", [&](int64_t id, const std::string&) {
+            std::string errors = tree_text(tree);
+            return encoder.encode(id, json{{"errors", errors}, {"length", errors.size()}}, reads.context());
+        }, CachePolicy::cached);
+        std::string request = R"({"id":3,"method":"get_debugger_errors"})";
+
+        if (bench_selected(opts, "editor_core/cached_read/miss" + suffix)) {
+            results.push_back(time_case("cached_read/miss" + suffix, nodes, iterations, [&] {
+                cache.bump();
+                return reads.handle(request).size();
+            }));
+        }
+        if (bench_selected(opts, "editor_core/cached_read/hit" + suffix)) {
+            results.push_back(time_case("cached_read/hit" + suffix, nodes, iterations,
+                                        [&] { return reads.handle(request).size(); }));
+        }
+    }
+
+    // decode -> route -> respond for a cheap handler, with stats attached as
+    // in the editor. each case runs with the per-request arena and again
+    // with every DOM on the heap ("/heap")
+    int calls = opts.quick ? 20000 : 200000;
+    ServerStats stats;
+    RequestArena arena;
+    RpcDispatcher dispatcher;
+    dispatcher.set_stats(&stats);
+    ResponseEncoder ping_encoder;
+    // as the editor's ping: the result DOM straight to the encoder, no text
+    // for make_result to parse again
+    dispatcher.add("ping", [&](int64_t id, const std::string&) {
+        return ping_encoder.encode(id, arena_json{{"status", "ok"}}, dispatcher.context());
+    });
+    dispatcher.add("get_remote_node_properties", [](int64_t id, const std::string& params_str) {
+        arena_json params = arena_json::parse(params_str, nullptr, false);
+        return make_result(id, arena_json{{"path", params.value("path", "")}}.dump());
+    });
+
+    struct DispatchCase {
+        const char* name;
+        std::string request;
+    };
+    std::vector<DispatchCase> cases = {
+        {"dispatch/ping", R"({"id":1,"method":"ping"})"},
+        {"dispatch/params", R"({"id":2,"method":"get_remote_node_properties","params":{"path":"/root/Main/Player"}})"},
+    };
+    for (const DispatchCase& c : cases) {
+        for (bool use_arena : {true, false}) {
+            std::string name = std::string(c.name) + (use_arena ? "" : "/heap");
+            if (!bench_selected(opts, "editor_core/" + name)) {
+                continue;
+            }
+            dispatcher.set_arena(use_arena ? &arena : nullptr);
+            results.push_back(time_case(name, 0, calls,
+                                        [&] { return dispatcher.handle(c.request).size(); }));
+        }
+    }
+}
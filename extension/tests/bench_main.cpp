@@ -0,0 +1,97 @@
+// standalone benchmark runner for the godot-free parts of the extension.
+// usage: bench_runner [--quick] [--filter substr] [--out results.json]
+// results are emitted as one JSON document so runs can be diffed across commits.
+
+#include "bench.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+using json = nlohmann::json;
+
+// --- allocation counting ---
+
+static std::atomic<uint64_t> allocation_count{0};
+static thread_local bool count_this_thread = false;
+
+void bench_count_allocations(bool enabled) {
+    count_this_thread = enabled;
+}
+
+uint64_t bench_allocations() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+// gcc can't see that these replace the global allocator and flags the
+// malloc/free pairing as mismatched
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(std::size_t size) {
+    if (count_this_thread) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#pragma GCC diagnostic pop
+
+bool bench_selected(const BenchOptions& opts, const std::string& name) {
+    return opts.filter.empty() || name.find(opts.filter) != std::string::npos;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opts;
+    std::string out_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            opts.quick = true;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            opts.filter = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--quick] [--filter substr] [--out file.json]\n";
+            return 2;
+        }
+    }
+
+    json results = json::array();
+    run_socket_benchmarks(opts, results);
+    run_editor_core_benchmarks(opts, results);
+
+    json doc = {
+        {"timestamp", static_cast<int64_t>(std::time(nullptr))},
+        {"quick", opts.quick},
+        {"results", results}
+    };
+
+    std::string text = doc.dump(2);
+    if (out_path.empty()) {
+        std::cout << text << "\n";
+    } else {
+        std::ofstream out(out_path);
+        out << text << "\n";
+        std::cerr << "wrote " << results.size() << " results to " << out_path << "\n";
+    }
+    return 0;
+}
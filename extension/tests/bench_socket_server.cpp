@@ -0,0 +1,405 @@
+// SocketServer throughput/latency benchmarks: N concurrent clients talk to a
+// server polled in a tight loop, either one request at a time or pipelined.
+// every case runs on both backends; io_uring cases are prefixed "uring/".
+
+#include "bench.h"
+#include "socket_server.h"
+#include "server_stats.h"
+#include "request_lanes.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+
+static const char* BENCH_SOCK = "/tmp/godot_peek_bench.sock";
+
+struct SocketCase {
+    int clients;
+    int pipeline_depth;  // 1 = request/response
+    size_t message_size; // bytes per request line, newline included
+    int requests_per_client;
+};
+
+// helper: blocking client connection
+static int connect_client(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool write_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(fd, data.data() + sent, data.size() - sent);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// reads newline-delimited replies off a blocking socket
+struct LineReader {
+    int fd;
+    std::string buffer;
+    size_t scan = 0;
+
+    // blocks until one full line is available; returns false on EOF/error
+    bool next_line() {
+        while (true) {
+            size_t pos = buffer.find('\n', scan);
+            if (pos != std::string::npos) {
+                buffer.erase(0, pos + 1);
+                scan = 0;
+                return true;
+            }
+            scan = buffer.size();
+            char chunk[65536];
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+    }
+};
+
+// helper: a request line of exactly `size` bytes including the newline
+static std::string make_request(size_t size) {
+    std::string head = "{\"id\":1,\"method\":\"bench\",\"params\":{\"pad\":\"";
+    std::string tail = "\"}}";
+    size_t pad = size > head.size() + tail.size() + 1 ? size - head.size() - tail.size() - 1 : 0;
+    return head + std::string(pad, 'x') + tail + "\n";
+}
+
+static const char* backend_name(IoBackend backend) {
+    return backend == IoBackend::io_uring ? "io_uring" : "poll";
+}
+
+static json run_case(const SocketCase& c, const std::string& name, IoBackend backend) {
+    unlink(BENCH_SOCK);
+    SocketServer server(backend);
+    ServerStats stats;
+    server.set_stats(&stats);
+    if (!server.start(BENCH_SOCK)) {
+        return {{"name", name}, {"error", "failed to start server"}};
+    }
+    if (server.backend() != backend) {
+        server.stop();
+        return {{"name", name}, {"error", "io_uring unavailable"}};
+    }
+
+    // synthetic handler: echo the request back so response size tracks request size
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> server_allocs{0};
+    std::thread server_thread([&] {
+        bench_count_allocations(true);
+        uint64_t before = bench_allocations();
+        while (running.load(std::memory_order_relaxed)) {
+            server.poll([](const std::string& message) -> std::string {
+                return message;
+            });
+        }
+        server_allocs = bench_allocations() - before;
+        bench_count_allocations(false);
+    });
+
+    std::string request = make_request(c.message_size);
+    std::string batch;
+    for (int i = 0; i < c.pipeline_depth; i++) {
+        batch += request;
+    }
+
+    std::vector<LatencyHistogram> latencies(static_cast<size_t>(c.clients));
+    std::vector<std::thread> client_threads;
+    std::atomic<int> failures{0};
+
+    uint64_t start = stats_now_ns();
+    for (int t = 0; t < c.clients; t++) {
+        client_threads.emplace_back([&, t] {
+            int fd = connect_client(BENCH_SOCK);
+            if (fd < 0) {
+                failures++;
+                return;
+            }
+            LineReader reader{fd, {}, 0};
+            LatencyHistogram& hist = latencies[static_cast<size_t>(t)];
+
+            for (int sent = 0; sent < c.requests_per_client; sent += c.pipeline_depth) {
+                uint64_t send_ns = stats_now_ns();
+                if (!write_all(fd, batch)) {
+                    failures++;
+                    break;
+                }
+                for (int r = 0; r < c.pipeline_depth; r++) {
+                    if (!reader.next_line()) {
+                        failures++;
+                        close(fd);
+                        return;
+                    }
+                    hist.record(stats_now_ns() - send_ns);
+                }
+            }
+            close(fd);
+        });
+    }
+    for (auto& th : client_threads) {
+        th.join();
+    }
+    uint64_t elapsed = stats_now_ns() - start;
+
+    running = false;
+    server_thread.join();
+    server.stop();
+
+    LatencyHistogram all;
+    for (const auto& h : latencies) {
+        all.merge(h);
+    }
+    double seconds = elapsed / 1e9;
+    uint64_t requests = all.count();
+
+    json result = {
+        {"suite", "socket_server"},
+        {"name", name},
+        {"backend", backend_name(backend)},
+        {"clients", c.clients},
+        {"pipeline_depth", c.pipeline_depth},
+        {"message_size", c.message_size},
+        {"requests", requests},
+        {"failures", failures.load()},
+        {"seconds", seconds},
+        {"requests_per_sec", seconds > 0 ? requests / seconds : 0.0},
+        {"mb_per_sec", seconds > 0 ? (2.0 * requests * c.message_size) / seconds / 1e6 : 0.0},
+        {"latency_us", {
+            {"mean", all.mean() / 1000.0},
+            {"p50", all.percentile(50) / 1000.0},
+            {"p99", all.percentile(99) / 1000.0},
+            {"max", all.max() / 1000.0}
+        }},
+        {"server_queue_wait_p99_us", stats.queue_wait().percentile(99) / 1000.0},
+        {"allocs_per_request", requests ? static_cast<double>(server_allocs.load()) / requests : 0.0}
+    };
+    return result;
+}
+
+// cost of one poll() with idle clients connected: the poll backend reads
+// every socket each frame, io_uring only looks at its completion ring
+static json run_idle_case(int clients, const std::string& name, IoBackend backend) {
+    unlink(BENCH_SOCK);
+    SocketServer server(backend);
+    if (!server.start(BENCH_SOCK)) {
+        return {{"name", name}, {"error", "failed to start server"}};
+    }
+    if (server.backend() != backend) {
+        server.stop();
+        return {{"name", name}, {"error", "io_uring unavailable"}};
+    }
+    auto callback = [](const std::string& message) -> std::string { return message; };
+
+    // accept as we go: the listen backlog is smaller than the client count
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+        fds.push_back(connect_client(BENCH_SOCK));
+        for (int p = 0; p < 10; p++) {
+            server.poll(callback);
+        }
+    }
+
+    const int polls = 200000;
+    uint64_t start = stats_now_ns();
+    for (int i = 0; i < polls; i++) {
+        server.poll(callback);
+    }
+    uint64_t elapsed = stats_now_ns() - start;
+
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    server.stop();
+    return {
+        {"suite", "socket_server"},
+        {"name", name},
+        {"backend", backend_name(backend)},
+        {"clients", clients},
+        {"polls", polls},
+        {"ns_per_poll", static_cast<double>(elapsed) / polls}
+    };
+}
+
+// tail latency of a control command while another client keeps the server
+// busy with slow bulk requests (~2ms of handler work each, pipelined 16
+// deep). without lanes the command waits behind whatever bulk work was read
+// in the same frame; with lanes it runs at the next checkpoint
+static json run_lanes_case(bool lanes, const std::string& name, IoBackend backend, int samples) {
+    unlink(BENCH_SOCK);
+    SocketServer server(backend);
+    if (lanes) {
+        server.set_lane_classifier([](const std::string& message) {
+            std::string method;
+            peek_method(message, method);
+            if (method == "stop") return Lane::control;
+            if (method == "dump") return Lane::bulk;
+            return Lane::interactive;
+        });
+    }
+    if (!server.start(BENCH_SOCK)) {
+        return {{"name", name}, {"error", "failed to start server"}};
+    }
+    if (server.backend() != backend) {
+        server.stop();
+        return {{"name", name}, {"error", "io_uring unavailable"}};
+    }
+
+    const uint64_t BULK_WORK_NS = 2000000;
+    std::atomic<bool> running{true};
+    std::thread server_thread([&] {
+        while (running.load(std::memory_order_relaxed)) {
+            server.poll([&](const std::string& message) -> std::string {
+                if (message.find("\"dump\"") != std::string::npos) {
+                    uint64_t until = stats_now_ns() + BULK_WORK_NS;
+                    while (stats_now_ns() < until) {
+                    }
+                }
+                return message;
+            });
+        }
+    });
+
+    std::atomic<bool> bulk_running{true};
+    std::thread bulk_thread([&] {
+        int fd = connect_client(BENCH_SOCK);
+        if (fd < 0) {
+            return;
+        }
+        std::string batch;
+        for (int i = 0; i < 16; i++) {
+            batch += "{\"id\":1,\"method\":\"dump\"}\n";
+        }
+        LineReader reader{fd, {}, 0};
+        while (bulk_running.load(std::memory_order_relaxed)) {
+            if (!write_all(fd, batch)) {
+                break;
+            }
+            for (int r = 0; r < 16; r++) {
+                if (!reader.next_line()) {
+                    close(fd);
+                    return;
+                }
+            }
+        }
+        close(fd);
+    });
+
+    LatencyHistogram control;
+    int failures = 0;
+    int fd = connect_client(BENCH_SOCK);
+    if (fd >= 0) {
+        LineReader reader{fd, {}, 0};
+        std::string stop = "{\"id\":2,\"method\":\"stop\"}\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));  // let the bulk load build up
+        for (int i = 0; i < samples; i++) {
+            uint64_t send_ns = stats_now_ns();
+            if (!write_all(fd, stop) || !reader.next_line()) {
+                failures++;
+                break;
+            }
+            control.record(stats_now_ns() - send_ns);
+            std::this_thread::sleep_for(std::chrono::milliseconds(3));
+        }
+        close(fd);
+    } else {
+        failures++;
+    }
+
+    bulk_running = false;
+    bulk_thread.join();
+    running = false;
+    server_thread.join();
+    server.stop();
+
+    return {
+        {"suite", "socket_server"},
+        {"name", name},
+        {"backend", backend_name(backend)},
+        {"lanes", lanes},
+        {"requests", control.count()},
+        {"failures", failures},
+        {"control_latency_us", {
+            {"mean", control.mean() / 1000.0},
+            {"p50", control.percentile(50) / 1000.0},
+            {"p99", control.percentile(99) / 1000.0},
+            {"max", control.max() / 1000.0}
+        }}
+    };
+}
+
+void run_socket_benchmarks(const BenchOptions& opts, json& results) {
+    std::vector<int> client_counts = opts.quick ? std::vector<int>{1, 4} : std::vector<int>{1, 4, 16};
+    std::vector<size_t> sizes = opts.quick ? std::vector<size_t>{64, 16384}
+                                           : std::vector<size_t>{64, 1024, 16384, 262144};
+    std::vector<int> depths = {1, 16};
+    std::vector<IoBackend> backends = {IoBackend::poll, IoBackend::io_uring};
+
+    for (IoBackend backend : backends) {
+        std::string prefix = backend == IoBackend::io_uring ? "uring/" : "";
+
+        for (int clients : {1, 16}) {
+            std::string name = prefix + "idle/c" + std::to_string(clients);
+            if (bench_selected(opts, "socket_server/" + name)) {
+                results.push_back(run_idle_case(clients, name, backend));
+            }
+        }
+
+        for (bool lanes : {false, true}) {
+            std::string name = prefix + "lanes/" + (lanes ? "on" : "off");
+            if (bench_selected(opts, "socket_server/" + name)) {
+                results.push_back(run_lanes_case(lanes, name, backend, opts.quick ? 50 : 300));
+            }
+        }
+
+        for (int clients : client_counts) {
+            for (int depth : depths) {
+                for (size_t size : sizes) {
+                    std::string name = prefix + (depth == 1 ? "reqresp" : "pipelined") +
+                                       "/c" + std::to_string(clients) +
+                                       "/s" + std::to_string(size);
+                    if (!bench_selected(opts, "socket_server/" + name)) {
+                        continue;
+                    }
+
+                    // bound each case to roughly the same number of bytes moved
+                    size_t budget = opts.quick ? (4u << 20) : (64u << 20);
+                    int per_client = static_cast<int>(std::clamp<size_t>(budget / size / clients, 32, 4000));
+                    per_client = std::max(depth, per_client / depth * depth);
+
+                    SocketCase c{clients, depth, size, per_client};
+                    results.push_back(run_case(c, name, backend));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// libFuzzer/AFL entry point implemented by each fuzz_*.cpp harness.
+// built with -fsanitize=fuzzer it is driven by libFuzzer; otherwise
+// fuzz_main.cpp provides a standalone replay/mutation driver.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// harness invariant check: report and abort so every fuzzer engine sees a crash
+#define FUZZ_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fuzz_fail(#cond, __FILE__, __LINE__); \
+        } \
+    } while (0)
+
+[[noreturn]] inline void fuzz_fail(const char* expr, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: fuzz check failed: %s\n", file, line, expr);
+    std::abort();
+}
@@ -0,0 +1,67 @@
+// fuzzes the two framings SocketServer::poll() reads with: LineFramer and
+// the length-prefixed FrameDecoder.
+//
+// input layout: byte 0 picks the line/frame limit, byte 1 the read size the
+// bytes are delivered in, the rest is the stream. checks that what comes out
+// re-encodes to exactly the consumed prefix of the stream.
+
+#include "fuzz.h"
+#include "line_framer.h"
+#include "frame_codec.h"
+
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size < 2) {
+        return 0;
+    }
+    // small limits exercise the overflow path, 0 keeps the default
+    size_t max_line = data[0] ? static_cast<size_t>(data[0]) * 64 : LineFramer::DEFAULT_MAX_LINE;
+    size_t chunk = static_cast<size_t>(data[1]) + 1;
+    const char* stream = reinterpret_cast<const char*>(data + 2);
+    size_t len = size - 2;
+
+    LineFramer framer(max_line);
+    std::string rebuilt;
+    std::string line;
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = len - off < chunk ? len - off : chunk;
+        framer.append(stream + off, n);
+        while (framer.next(line)) {
+            FUZZ_CHECK(line.find('\n') == std::string::npos);
+            rebuilt += line;
+            rebuilt += '\n';
+        }
+        if (framer.overflowed()) {
+            break;
+        }
+    }
+
+    FUZZ_CHECK(rebuilt.size() <= len);
+    FUZZ_CHECK(rebuilt.compare(0, rebuilt.size(), stream, rebuilt.size()) == 0);
+    if (!framer.overflowed()) {
+        // everything after the last newline is still buffered
+        FUZZ_CHECK(rebuilt.size() + framer.buffered() == len);
+    }
+
+    // same stream as length-prefixed frames
+    FrameDecoder decoder(max_line);
+    std::string reencoded;
+    Frame frame;
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = len - off < chunk ? len - off : chunk;
+        decoder.append(stream + off, n);
+        while (decoder.next(frame)) {
+            FUZZ_CHECK(frame.payload.size() <= max_line);
+            append_frame(reencoded, frame.content_type, frame.flags, frame.payload);
+        }
+        if (decoder.failed()) {
+            break;
+        }
+    }
+    FUZZ_CHECK(reencoded.compare(0, reencoded.size(), stream, reencoded.size()) == 0);
+    if (!decoder.failed()) {
+        FUZZ_CHECK(reencoded.size() + decoder.buffered() == len);
+    }
+    return 0;
+}
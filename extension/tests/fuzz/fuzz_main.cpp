@@ -0,0 +1,236 @@
+// standalone driver for the fuzz harnesses, for builds without libFuzzer.
+//
+//   fuzz_<name> [options] <file|dir>...
+//     --timeout-ms N    fail if one input takes longer than N ms (default 250)
+//     --rss-limit-mb N  fail if peak RSS exceeds N MB (default 512)
+//     --mutate N        after replaying, run N random mutations of the corpus
+//     --max-len N       cap mutated inputs at N bytes (default 1MB)
+//     --seed N          mutation seed (default 1)
+//
+// the failing input is written to fuzz-failure.bin. AFL can drive the same
+// binary with `afl-fuzz -i corpus -o out -- ./fuzz_<name> @@`.
+
+#include "fuzz.h"
+
+#include <sys/resource.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Limits {
+    double timeout_ms = 250;
+    size_t rss_limit_mb = 512;
+};
+
+static const std::string* current_input = nullptr;
+
+// helper: keep the input that tripped a limit or check so it can be replayed
+static void save_failure() {
+    if (current_input) {
+        std::ofstream out("fuzz-failure.bin", std::ios::binary);
+        out.write(current_input->data(), static_cast<std::streamsize>(current_input->size()));
+        std::cerr << "failing input (" << current_input->size() << " bytes) written to fuzz-failure.bin\n";
+    }
+}
+
+static void on_abort(int) {
+    save_failure();
+    signal(SIGABRT, SIG_DFL);
+    abort();
+}
+
+static void on_alarm(int) {
+    static const char msg[] = "fuzz: input hung well past the time limit\n";
+    (void)!write(2, msg, sizeof(msg) - 1);
+    save_failure();
+    _exit(1);
+}
+
+// helper: peak resident set size in MB
+static size_t peak_rss_mb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss) / (1024 * 1024);  // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;           // kilobytes
+#endif
+}
+
+// run one input under the limits. returns false if a limit was exceeded
+static bool run_input(const std::string& input, const Limits& limits, const std::string& label) {
+    current_input = &input;
+    // hard stop for inputs that never return; the soft limit below reports
+    // ordinary slow inputs
+    alarm(static_cast<unsigned>(limits.timeout_ms * 20 / 1000) + 1);
+    auto start = std::chrono::steady_clock::now();
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    alarm(0);
+
+    if (ms > limits.timeout_ms) {
+        std::cerr << label << ": took " << ms << " ms (limit " << limits.timeout_ms << " ms)\n";
+        save_failure();
+        return false;
+    }
+    size_t rss = peak_rss_mb();
+    if (rss > limits.rss_limit_mb) {
+        std::cerr << label << ": peak RSS " << rss << " MB (limit " << limits.rss_limit_mb << " MB)\n";
+        save_failure();
+        return false;
+    }
+    current_input = nullptr;
+    return true;
+}
+
+static bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// helper: expand directories (one level) into their files
+static void collect_inputs(const std::string& path, std::vector<std::string>& files) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        files.push_back(path);
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            files.push_back(path + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+}
+
+// structural tokens the harnesses care about, spliced in by the mutator
+static const char* const TOKENS[] = {"\n", "{", "}", "[", "]", "\"", "\\", ":", ",", "\"method\"",
+                                     "\"params\"", "\"id\"", "null", "1e999", "\\u0000", "\r\n"};
+
+static std::string mutate(const std::vector<std::string>& corpus, std::mt19937_64& rng, size_t max_len) {
+    std::string s = corpus.empty() ? std::string() : corpus[rng() % corpus.size()];
+    int steps = 1 + static_cast<int>(rng() % 4);
+    for (int i = 0; i < steps; i++) {
+        size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+        switch (rng() % 6) {
+            case 0:  // flip a byte
+                if (!s.empty()) {
+                    s[rng() % s.size()] ^= static_cast<char>(1u << (rng() % 8));
+                }
+                break;
+            case 1:  // insert a random byte
+                s.insert(pos, 1, static_cast<char>(rng() & 0xff));
+                break;
+            case 2: {  // erase a range
+                if (!s.empty()) {
+                    size_t at = rng() % s.size();
+                    s.erase(at, 1 + rng() % (s.size() - at));
+                }
+                break;
+            }
+            case 3: {  // repeat a range many times (long lines, deep nesting, message bursts)
+                if (!s.empty()) {
+                    size_t at = rng() % s.size();
+                    size_t len = 1 + rng() % std::min<size_t>(16, s.size() - at);
+                    std::string piece = s.substr(at, len);
+                    size_t times = 1 + rng() % 4096;
+                    std::string rep;
+                    for (size_t t = 0; t < times && rep.size() < max_len; t++) {
+                        rep += piece;
+                    }
+                    s.insert(at, rep);
+                }
+                break;
+            }
+            case 4:  // insert a token
+                s.insert(pos, TOKENS[rng() % (sizeof(TOKENS) / sizeof(TOKENS[0]))]);
+                break;
+            default:  // splice in another corpus entry
+                if (!corpus.empty()) {
+                    const std::string& other = corpus[rng() % corpus.size()];
+                    s.insert(pos, other, 0, rng() % (other.size() + 1));
+                }
+                break;
+        }
+        if (s.size() > max_len) {
+            s.resize(max_len);
+        }
+    }
+    return s;
+}
+
+int main(int argc, char** argv) {
+    Limits limits;
+    long mutations = 0;
+    size_t max_len = 1 << 20;
+    uint64_t seed = 1;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--timeout-ms" && has_value) {
+            limits.timeout_ms = std::stod(argv[++i]);
+        } else if (arg == "--rss-limit-mb" && has_value) {
+            limits.rss_limit_mb = std::stoul(argv[++i]);
+        } else if (arg == "--mutate" && has_value) {
+            mutations = std::stol(argv[++i]);
+        } else if (arg == "--max-len" && has_value) {
+            max_len = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "usage: " << argv[0] << " [--timeout-ms N] [--rss-limit-mb N] [--mutate N]"
+                      << " [--max-len N] [--seed N] <file|dir>...\n";
+            return 2;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    signal(SIGABRT, on_abort);
+    signal(SIGALRM, on_alarm);
+
+    std::vector<std::string> files;
+    for (const auto& p : paths) {
+        collect_inputs(p, files);
+    }
+
+    std::vector<std::string> corpus;
+    for (const auto& f : files) {
+        std::string data;
+        if (!read_file(f, data)) {
+            std::cerr << "can't read " << f << "\n";
+            return 2;
+        }
+        if (!run_input(data, limits, f)) {
+            return 1;
+        }
+        corpus.push_back(std::move(data));
+    }
+
+    std::mt19937_64 rng(seed);
+    for (long i = 0; i < mutations; i++) {
+        std::string input = mutate(corpus, rng, max_len);
+        if (!run_input(input, limits, "mutation " + std::to_string(i))) {
+            return 1;
+        }
+    }
+
+    std::cerr << argv[0] << ": " << corpus.size() << " corpus inputs, " << mutations
+              << " mutations ok (peak RSS " << peak_rss_mb() << " MB)\n";
+    return 0;
+}
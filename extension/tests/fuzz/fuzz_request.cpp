@@ -0,0 +1,52 @@
+// fuzzes the request decode path: parse_request() and RpcDispatcher::handle()
+// with handlers that parse their params like the editor handlers do. every
+// input must produce a well-formed JSON-RPC response.
+
+#include "fuzz.h"
+#include "rpc_dispatcher.h"
+#include "json_rpc.h"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+using json = nlohmann::json;
+
+static RpcDispatcher& dispatcher() {
+    static RpcDispatcher d = [] {
+        RpcDispatcher r;
+        r.add("ping", [](int64_t id, const std::string&) { return make_result(id, R"({"pong":true})"); });
+        r.add("get_remote_node_properties", [](int64_t id, const std::string& params_str) {
+            json params = json::parse(params_str, nullptr, false);
+            if (params.is_discarded() || !params.contains("path") || !params["path"].is_string()) {
+                return make_error(id, -32602, "Missing required parameter: path");
+            }
+            auto parts = split_node_path(params["path"].get<std::string>());
+            return make_result(id, json{{"depth", parts.size()}}.dump());
+        });
+        return r;
+    }();
+    return d;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string message(reinterpret_cast<const char*>(data), size);
+
+    RpcRequest request;
+    std::string error;
+    bool ok = parse_request(message, request, error);
+    FUZZ_CHECK(ok || !error.empty());
+    if (ok) {
+        // params handed to handlers always round-trip as a JSON object
+        json params = json::parse(request.params_str, nullptr, false);
+        FUZZ_CHECK(params.is_object());
+    }
+
+    std::string response = dispatcher().handle(message);
+    json parsed = json::parse(response, nullptr, false);
+    FUZZ_CHECK(parsed.is_object());
+    FUZZ_CHECK(parsed.contains("id"));
+    FUZZ_CHECK(parsed.contains("result") != parsed.contains("error"));
+    FUZZ_CHECK(is_error_response(response) == parsed.contains("error"));
+    return 0;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+// in-memory stand-ins for the editor widgets behind editor_views.h and the
+// scene tree behind node_query.h, shared by the tests and benchmarks. handles are 1-based indices cast to
+// void* so a null handle still means "none".
+
+#include "editor_views.h"
+#include "node_query.h"
+
+#include <algorithm>
+#include <map>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MockTree : public TreeView {
+public:
+    struct Item {
+        std::vector<std::string> texts;
+        std::vector<std::string> tooltips;
+        size_t first_child = 0;  // 0 = none, else index + 1
+        size_t last_child = 0;
+        size_t next = 0;
+    };
+
+    explicit MockTree(int columns = 1) : columns(columns) {}
+
+    // add an item under parent (nullptr = the root). returns its handle
+    ItemHandle add(ItemHandle parent, std::vector<std::string> texts, std::vector<std::string> tooltips = {}) {
+        items.push_back(Item{std::move(texts), std::move(tooltips), 0, 0, 0});
+        size_t id = items.size();
+        if (parent) {
+            Item& p = get(parent);
+            if (p.last_child) {
+                items[p.last_child - 1].next = id;
+            } else {
+                p.first_child = id;
+            }
+            p.last_child = id;
+        }
+        return to_handle(id);
+    }
+
+    ItemHandle root() const override { return items.empty() ? nullptr : to_handle(1); }
+    ItemHandle first_child(ItemHandle item) const override { return to_handle(get(item).first_child); }
+    ItemHandle next_sibling(ItemHandle item) const override { return to_handle(get(item).next); }
+    int column_count() const override { return columns; }
+
+    std::string text(ItemHandle item, int column) const override {
+        const Item& it = get(item);
+        return column < static_cast<int>(it.texts.size()) ? it.texts[column] : std::string();
+    }
+
+    std::string tooltip(ItemHandle item, int column) const override {
+        const Item& it = get(item);
+        return column < static_cast<int>(it.tooltips.size()) ? it.tooltips[column] : std::string();
+    }
+
+private:
+    static ItemHandle to_handle(size_t id) { return reinterpret_cast<ItemHandle>(static_cast<uintptr_t>(id)); }
+    size_t index(ItemHandle h) const { return reinterpret_cast<uintptr_t>(h) - 1; }
+    Item& get(ItemHandle h) { return items[index(h)]; }
+    const Item& get(ItemHandle h) const { return items[index(h)]; }
+
+    int columns;
+    std::vector<Item> items;
+};
+
+class MockNodeTree : public NodeView {
+public:
+    struct Node {
+        std::vector<std::string> classes;  // own class first, then bases
+        std::string label;                 // EditorProperty::get_label()
+        std::string text;                  // LineEdit/Button/Label text
+        std::string value;                 // get_value() text
+        bool has_value = false;
+        bool pressed = false;
+        std::vector<size_t> children;      // indices + 1
+    };
+
+    // add a node under parent (nullptr = a new root). returns its handle
+    NodeHandle add(NodeHandle parent, std::vector<std::string> classes) {
+        Node n;
+        n.classes = std::move(classes);
+        nodes.push_back(std::move(n));
+        size_t id = nodes.size();
+        if (parent) {
+            get(parent).children.push_back(id);
+        }
+        return to_handle(id);
+    }
+
+    Node& get(NodeHandle h) { return nodes[index(h)]; }
+    const Node& get(NodeHandle h) const { return nodes[index(h)]; }
+
+    std::string class_name(NodeHandle node) const override { return get(node).classes.front(); }
+
+    bool is_class(NodeHandle node, const char* class_name) const override {
+        for (const std::string& c : get(node).classes) {
+            if (c == class_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int child_count(NodeHandle node) const override { return static_cast<int>(get(node).children.size()); }
+    NodeHandle child(NodeHandle node, int i) const override { return to_handle(get(node).children[i]); }
+    std::string property_label(NodeHandle node) const override { return get(node).label; }
+    std::string text(NodeHandle node) const override { return get(node).text; }
+
+    bool value_text(NodeHandle node, std::string& out) const override {
+        const Node& n = get(node);
+        if (!n.has_value) {
+            return false;
+        }
+        out = n.value;
+        return true;
+    }
+
+    bool is_pressed(NodeHandle node) const override { return get(node).pressed; }
+
+private:
+    static NodeHandle to_handle(size_t id) { return reinterpret_cast<NodeHandle>(static_cast<uintptr_t>(id)); }
+    size_t index(NodeHandle h) const { return reinterpret_cast<uintptr_t>(h) - 1; }
+
+    std::vector<Node> nodes;
+};
+
+class MockSceneTree : public SceneView {
+public:
+    struct Node {
+        std::string name;
+        std::vector<std::string> classes;  // own class first, then bases
+        std::vector<std::string> groups;   // see add_to_group
+        std::map<std::string, nlohmann::json> properties;
+        size_t parent = 0;                 // index + 1, 0 for the root
+        std::vector<size_t> children;
+    };
+
+    // starts with the /root window
+    MockSceneTree() {
+        nodes.push_back(Node{"root", {"Window", "Viewport", "Node"}, {}, {}, 0, {}});
+        chains["Window"] = nodes.back().classes;
+    }
+
+    NodeHandle root() const { return to_handle(1); }
+
+    NodeHandle add(NodeHandle parent, std::string name, std::vector<std::string> classes) {
+        Node n;
+        n.name = std::move(name);
+        n.classes = std::move(classes);
+        n.parent = index(parent) + 1;
+        chains[n.classes.front()] = n.classes;
+        nodes.push_back(std::move(n));
+        get(parent).children.push_back(nodes.size());
+        return to_handle(nodes.size());
+    }
+
+    Node& get(NodeHandle h) { return nodes[index(h)]; }
+    const Node& get(NodeHandle h) const { return nodes[index(h)]; }
+
+    void add_to_group(NodeHandle node, const std::string& group) {
+        get(node).groups.push_back(group);
+        groups[group].push_back(node);
+    }
+
+    NodeHandle find(const std::string& path) const override {
+        if (path.rfind("/root", 0) != 0) {
+            return nullptr;
+        }
+        NodeHandle node = root();
+        size_t start = 5;
+        while (node && start < path.size()) {
+            size_t slash = path.find('/', start + 1);
+            std::string part = path.substr(start + 1, slash == std::string::npos ? std::string::npos : slash - start - 1);
+            NodeHandle next = nullptr;
+            for (size_t child : get(node).children) {
+                if (nodes[child - 1].name == part) {
+                    next = to_handle(child);
+                    break;
+                }
+            }
+            node = next;
+            start = slash == std::string::npos ? path.size() : slash;
+        }
+        return node;
+    }
+
+    NodeHandle parent(NodeHandle node) const override { return get(node).parent ? to_handle(get(node).parent) : nullptr; }
+    int child_count(NodeHandle node) const override { return static_cast<int>(get(node).children.size()); }
+    NodeHandle child(NodeHandle node, int i) const override { return to_handle(get(node).children[i]); }
+    std::string name(NodeHandle node) const override { return get(node).name; }
+
+    std::string path(NodeHandle node) const override {
+        std::string p;
+        for (NodeHandle n = node; n; n = parent(n)) {
+            p = "/" + get(n).name + p;
+        }
+        return p;
+    }
+
+    std::string class_name(NodeHandle node) const override { return get(node).classes.front(); }
+
+    bool is_class(NodeHandle node, const std::string& class_name) const override {
+        const std::vector<std::string>& c = get(node).classes;
+        return std::find(c.begin(), c.end(), class_name) != c.end();
+    }
+
+    bool inherits(const std::string& cls, const std::string& base) const override {
+        auto it = chains.find(cls);
+        return cls == base || (it != chains.end() && std::find(it->second.begin(), it->second.end(), base) != it->second.end());
+    }
+
+    bool in_group(NodeHandle node, const std::string& group) const override {
+        const std::vector<std::string>& g = get(node).groups;
+        return std::find(g.begin(), g.end(), group) != g.end();
+    }
+
+    void group_members(const std::string& group, std::vector<NodeHandle>& out) const override {
+        auto it = groups.find(group);
+        if (it != groups.end()) {
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    bool property(NodeHandle node, const std::string& name, nlohmann::json& out) const override {
+        const Node& n = get(node);
+        auto it = n.properties.find(name);
+        if (it != n.properties.end()) {
+            out = it->second;
+            return true;
+        }
+        if (name == "name") {
+            out = n.name;
+            return true;
+        }
+        return false;
+    }
+
+    // every node, for building a NodeClassIndex
+    size_t size() const { return nodes.size(); }
+    static NodeHandle to_handle(size_t id) { return reinterpret_cast<NodeHandle>(static_cast<uintptr_t>(id)); }
+
+private:
+    size_t index(NodeHandle h) const { return reinterpret_cast<uintptr_t>(h) - 1; }
+
+    std::vector<Node> nodes;
+    std::map<std::string, std::vector<std::string>> chains;          // class -> its base chain
+    std::map<std::string, std::vector<NodeHandle>> groups;
+};
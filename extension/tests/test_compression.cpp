@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+#include "compression.h"
+
+#include <chrono>
+#include <thread>
+
+// helper: wait for the worker to finish a job
+static bool wait_done(const CompressionJob& job) {
+    for (int i = 0; i < 2000 && !job.done.load(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return job.done.load();
+}
+
+static std::string repetitive(size_t n) {
+    std::string s;
+    while (s.size() < n) {
+        s += "{\"name\":\"position\",\"value\":\"(1, 2)\",\"type\":\"EditorPropertyVector2\"},";
+    }
+    s.resize(n);
+    return s;
+}
+
+TEST_CASE("deflate round-trips") {
+    std::string in = repetitive(100000);
+    std::string packed;
+    REQUIRE(deflate_compress(in, packed));
+    CHECK(packed.size() < in.size() / 10);
+
+    std::string out;
+    REQUIRE(deflate_decompress(packed, out, in.size()));
+    CHECK(out == in);
+
+    // empty input is still a valid stream
+    REQUIRE(deflate_compress("", packed));
+    REQUIRE(deflate_decompress(packed, out, 0));
+    CHECK(out.empty());
+}
+
+TEST_CASE("deflate_decompress rejects bad and oversized input") {
+    std::string packed;
+    REQUIRE(deflate_compress(repetitive(50000), packed));
+
+    std::string out;
+    CHECK_FALSE(deflate_decompress(packed, out, 49999));
+    CHECK_FALSE(deflate_decompress(packed.substr(0, packed.size() / 2), out, 50000));
+    CHECK_FALSE(deflate_decompress("not deflate at all", out, 1000));
+}
+
+TEST_CASE("CompressionWorker compresses off the calling thread") {
+    CompressionWorker worker;
+
+    auto big = std::make_shared<CompressionJob>();
+    big->payload = repetitive(200000);
+    auto noise = std::make_shared<CompressionJob>();
+    uint32_t x = 2463534242u;  // xorshift32
+    for (int i = 0; i < 4096; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        noise->payload += static_cast<char>(x >> 24);
+    }
+    worker.submit(big);
+    worker.submit(noise);
+
+    REQUIRE(wait_done(*big));
+    CHECK(big->ok);
+    CHECK(big->compressed.size() < big->payload.size());
+    std::string out;
+    REQUIRE(deflate_decompress(big->compressed, out, big->payload.size()));
+    CHECK(out == big->payload);
+
+    // incompressible payloads are reported as not worth it
+    REQUIRE(wait_done(*noise));
+    CHECK_FALSE(noise->ok);
+}
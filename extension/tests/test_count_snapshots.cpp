@@ -0,0 +1,79 @@
+#include <doctest/doctest.h>
+#include "count_snapshots.h"
+
+using json = nlohmann::json;
+
+// helper: one pass over a list of (class, script, how many)
+static const CountSnapshot& take(CountSnapshotStore& store, std::initializer_list<std::tuple<const char*, const char*, int>> nodes,
+                                 int64_t time_ms = 1000) {
+    store.begin();
+    for (const auto& [cls, script, n] : nodes) {
+        for (int i = 0; i < n; i++) {
+            store.add(cls, script);
+        }
+    }
+    CountTotals totals;
+    totals.objects = 100;
+    return store.commit(time_ms, 7, totals);
+}
+
+TEST_CASE("a snapshot counts nodes per class and script") {
+    CountSnapshotStore store;
+    const CountSnapshot& s = take(store, {{"Node2D", "", 3}, {"Sprite2D", "res://enemy.gd", 2}, {"Sprite2D", "", 1}});
+    CHECK(s.id == 1);
+    CHECK(s.nodes == 6);
+    CHECK(s.frame == 7);
+    CHECK(s.counts.size() == 3);
+    CHECK(store.key_count() == 3);
+
+    json summary = count_snapshot_json(store, s, 2);
+    REQUIRE(summary["top"].size() == 2);
+    CHECK(summary["top"][0] == json{{"class", "Node2D"}, {"count", 3}});
+    CHECK(summary["top"][1] == json{{"class", "Sprite2D"}, {"script", "res://enemy.gd"}, {"count", 2}});
+    CHECK(summary["objects"] == 100);
+    CHECK(summary["resources"] == -1);
+}
+
+TEST_CASE("diffs report growth first and shrinkage last") {
+    CountSnapshotStore store;
+    take(store, {{"Node2D", "", 3}, {"Bullet", "res://bullet.gd", 10}, {"Timer", "", 2}}, 1000);
+    take(store, {{"Node2D", "", 3}, {"Bullet", "res://bullet.gd", 40}, {"Label", "", 1}}, 3500);
+
+    std::vector<CountDelta> d = store.diff(*store.find(-1), *store.find(0));
+    REQUIRE(d.size() == 3);
+    CHECK(store.key(d[0].key).class_name == "Bullet");
+    CHECK(d[0].delta() == 30);
+    CHECK(store.key(d[1].key).class_name == "Label");
+    CHECK(store.key(d[2].key).class_name == "Timer");
+    CHECK(d[2].after == 0);
+
+    json diff = count_diff_json(store, *store.find(1), *store.find(2), 1);
+    CHECK(diff["seconds"] == 2.5);
+    CHECK(diff["changed"] == 3);
+    REQUIRE(diff["grown"].size() == 1);
+    CHECK(diff["grown"][0]["script"] == "res://bullet.gd");
+    REQUIRE(diff["shrunk"].size() == 1);
+    CHECK(diff["shrunk"][0]["delta"] == -2);
+    CHECK(diff["nodes"]["delta"] == 29);
+    CHECK_FALSE(diff["resources"].contains("delta"));
+}
+
+TEST_CASE("snapshots are found by id or relative position and age out") {
+    CountSnapshotStore store(3);
+    CHECK(store.find(0) == nullptr);
+    for (int i = 0; i < 5; i++) {
+        take(store, {{"Node", "", i + 1}});
+    }
+    CHECK(store.all().size() == 3);
+    CHECK(store.find(0)->id == 5);
+    CHECK(store.find(-2)->id == 3);
+    CHECK(store.find(-3) == nullptr);
+    CHECK(store.find(2) == nullptr);  // dropped
+    CHECK(store.find(4)->nodes == 4);
+    CHECK(store.find(6) == nullptr);
+
+    // a class that disappears is absent from the next snapshot, not zero
+    take(store, {{"Other", "", 1}});
+    CHECK(store.find(0)->counts.size() == 1);
+    CHECK(store.find(0)->counts[0].first == 1);
+}
@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+#include "editor_serializers.h"
+#include "mock_editor.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// --- tree_text ---
+
+TEST_CASE("tree_text of an empty tree") {
+    MockTree tree(2);
+    CHECK(tree_text(tree) == "");
+}
+
+TEST_CASE("tree_text joins columns and indents children") {
+    MockTree tree(2);
+    ItemHandle root = tree.add(nullptr, {"Errors"});
+    ItemHandle a = tree.add(root, {"E 0:00:01", "Something broke"});
+    tree.add(a, {"", "at res://main.gd:10"});
+    tree.add(root, {"W 0:00:02"});
+
+    CHECK(tree_text(tree) ==
+          "Errors\n"
+          "  E 0:00:01 | Something broke\n"
+          "    at res://main.gd:10\n"
+          "  W 0:00:02\n");
+}
+
+TEST_CASE("tree_text skips items with no text but keeps their children") {
+    MockTree tree(1);
+    ItemHandle root = tree.add(nullptr, {""});
+    tree.add(root, {"child"});
+    CHECK(tree_text(tree) == "  child\n");
+}
+
+// --- scene_tree_text ---
+
+TEST_CASE("scene_tree_text parses types from tooltips") {
+    MockTree tree(1);
+    ItemHandle root = tree.add(nullptr, {"root"}, {"root (Window)"});
+    ItemHandle main = tree.add(root, {"Main"}, {"Main (Node2D)\nType: Node2D"});
+    tree.add(main, {"Label"}, {"no type here"});
+
+    CHECK(scene_tree_text(tree) ==
+          "root (Window)\n"
+          "  Main (Node2D)\n"
+          "    Label\n");
+}
+
+// --- monitors_json ---
+
+TEST_CASE("monitors_json groups metrics") {
+    MockTree tree(2);
+    ItemHandle root = tree.add(nullptr, {""});
+    ItemHandle time = tree.add(root, {"Time"});
+    tree.add(time, {"FPS", "60"});
+    tree.add(time, {"Process", "1.2 ms"});
+    ItemHandle mem = tree.add(root, {"Memory"});
+    tree.add(mem, {"Static", "30 MiB"});
+
+    json m = monitors_json(tree);
+    REQUIRE(m.size() == 2);
+    CHECK(m[0]["group"] == "Time");
+    CHECK(m[0]["metrics"].size() == 2);
+    CHECK(m[0]["metrics"][1]["name"] == "Process");
+    CHECK(m[0]["metrics"][1]["value"] == "1.2 ms");
+    CHECK(m[1]["metrics"][0]["value"] == "30 MiB");
+
+    MockTree empty(2);
+    CHECK(monitors_json(empty).empty());
+}
+
+// --- find_item_by_path ---
+
+TEST_CASE("find_item_by_path walks column-0 names") {
+    MockTree tree(1);
+    ItemHandle root = tree.add(nullptr, {"root"});
+    ItemHandle main = tree.add(root, {"Main"});
+    ItemHandle player = tree.add(main, {"Player"});
+    tree.add(main, {"Enemy"});
+
+    CHECK(find_item_by_path(tree, root, {}) == root);
+    CHECK(find_item_by_path(tree, root, {"root", "Main", "Player"}) == player);
+    CHECK(find_item_by_path(tree, root, {"Main", "Player"}) == player);
+    CHECK(find_item_by_path(tree, root, {"Main", "Missing"}) == nullptr);
+}
+
+// --- collect_editor_properties ---
+
+// helper: an EditorProperty node with a single value control beneath it
+static NodeHandle add_property(MockNodeTree& nodes, NodeHandle parent, const std::string& cls, const std::string& label) {
+    NodeHandle prop = nodes.add(parent, {cls, "EditorProperty", "Container", "Control", "Node"});
+    nodes.get(prop).label = label;
+    return prop;
+}
+
+TEST_CASE("collect_editor_properties reads each property type") {
+    MockNodeTree nodes;
+    NodeHandle inspector = nodes.add(nullptr, {"EditorInspector", "ScrollContainer", "Control", "Node"});
+    NodeHandle section = nodes.add(inspector, {"VBoxContainer", "Container", "Control", "Node"});
+
+    NodeHandle i = add_property(nodes, section, "EditorPropertyInteger", "health");
+    NodeHandle slider = nodes.add(i, {"EditorSpinSlider", "Range", "Control", "Node"});
+    nodes.get(slider).value = "100";
+    nodes.get(slider).has_value = true;
+
+    NodeHandle t = add_property(nodes, section, "EditorPropertyText", "name");
+    nodes.get(nodes.add(t, {"LineEdit", "Control", "Node"})).text = "Bob";
+
+    NodeHandle c = add_property(nodes, section, "EditorPropertyCheck", "alive");
+    nodes.get(nodes.add(c, {"CheckBox", "Button", "BaseButton", "Control", "Node"})).pressed = true;
+
+    NodeHandle v = add_property(nodes, section, "EditorPropertyVector2", "position");
+    NodeHandle box = nodes.add(v, {"HBoxContainer", "Container", "Control", "Node"});
+    for (const char* val : {"1.5", "-2"}) {
+        NodeHandle s = nodes.add(box, {"EditorSpinSlider", "Range", "Control", "Node"});
+        nodes.get(s).value = val;
+        nodes.get(s).has_value = true;
+    }
+
+    add_property(nodes, section, "EditorPropertyNil", "nothing");
+
+    // no get_label: falls back to the first non-empty Label
+    NodeHandle o = add_property(nodes, section, "EditorPropertyObjectID", "");
+    nodes.add(o, {"Label", "Control", "Node"});
+    nodes.get(nodes.add(o, {"Label", "Control", "Node"})).text = "target";
+    nodes.get(nodes.add(o, {"Button", "BaseButton", "Control", "Node"})).text = "Node2D#123";
+
+    // unlabelled properties are skipped
+    add_property(nodes, section, "EditorPropertyText", "");
+
+    json props = json::array();
+    collect_editor_properties(nodes, inspector, props);
+
+    REQUIRE(props.size() == 6);
+    CHECK(props[0] == json({{"name", "health"}, {"value", "100"}, {"type", "EditorPropertyInteger"}}));
+    CHECK(props[1]["value"] == "Bob");
+    CHECK(props[2]["value"] == "true");
+    CHECK(props[3]["value"] == "(1.5, -2)");
+    CHECK(props[4]["value"] == "null");
+    CHECK(props[5]["name"] == "target");
+    CHECK(props[5]["value"] == "Node2D#123");
+}
+
+TEST_CASE("extract_property_value falls back to LineEdit then Button") {
+    MockNodeTree nodes;
+    NodeHandle prop = nodes.add(nullptr, {"EditorPropertyEnum", "EditorProperty", "Node"});
+    NodeHandle button = nodes.add(prop, {"OptionButton", "Button", "Node"});
+    nodes.get(button).text = "Linear";
+    CHECK(extract_property_value(nodes, prop, "EditorPropertyEnum") == "Linear");
+
+    nodes.get(nodes.add(prop, {"LineEdit", "Control", "Node"})).text = "typed";
+    CHECK(extract_property_value(nodes, prop, "EditorPropertyEnum") == "typed");
+
+    NodeHandle bare = nodes.add(nullptr, {"EditorPropertyColor", "EditorProperty", "Node"});
+    CHECK(extract_property_value(nodes, bare, "EditorPropertyColor") == "");
+}
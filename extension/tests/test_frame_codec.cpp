@@ -0,0 +1,161 @@
+#include <doctest/doctest.h>
+#include "frame_codec.h"
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+using json = nlohmann::json;
+
+TEST_CASE("append_frame writes a big-endian header") {
+    std::string out;
+    append_frame(out, CONTENT_BINARY, FRAME_FLAG_MORE, std::string("abc"));
+    REQUIRE(out.size() == FRAME_HEADER_SIZE + 3);
+    CHECK(out.compare(0, FRAME_HEADER_SIZE, std::string("\0\0\0\x03\x02\x01\0\0", 8)) == 0);
+    CHECK(out.substr(FRAME_HEADER_SIZE) == "abc");
+
+    out.clear();
+    append_frame(out, CONTENT_JSON, 0, std::string(0x010203, 'x'));
+    CHECK(static_cast<unsigned char>(out[1]) == 0x01);
+    CHECK(static_cast<unsigned char>(out[2]) == 0x02);
+    CHECK(static_cast<unsigned char>(out[3]) == 0x03);
+}
+
+TEST_CASE("decoder round-trips frames split at every byte") {
+    std::string stream;
+    append_frame(stream, CONTENT_JSON, 0, std::string("{\"id\":1}"));
+    append_frame(stream, CONTENT_BINARY, FRAME_FLAG_MORE, std::string("\0\n\xff", 3));
+    append_frame(stream, CONTENT_BINARY, 0, std::string());
+
+    FrameDecoder d;
+    std::vector<Frame> frames;
+    Frame f;
+    for (char c : stream) {
+        d.append(&c, 1);
+        while (d.next(f)) {
+            frames.push_back(f);
+        }
+    }
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[0].content_type == CONTENT_JSON);
+    CHECK(frames[0].payload == "{\"id\":1}");
+    CHECK(frames[1].flags == FRAME_FLAG_MORE);
+    CHECK(frames[1].payload == std::string("\0\n\xff", 3));
+    CHECK(frames[2].payload.empty());
+    CHECK(d.buffered() == 0);
+}
+
+TEST_CASE("decoder rejects oversized frames and reserved bits") {
+    FrameDecoder small(4);
+    std::string stream;
+    append_frame(stream, CONTENT_JSON, 0, std::string("12345"));
+    small.append(stream.data(), stream.size());
+    Frame f;
+    CHECK_FALSE(small.next(f));
+    CHECK(small.failed());
+
+    FrameDecoder reserved;
+    std::string bad("\0\0\0\0\x01\0\0\x01", 8);
+    reserved.append(bad.data(), bad.size());
+    CHECK_FALSE(reserved.next(f));
+    CHECK(reserved.failed());
+}
+
+TEST_CASE("parse_handshake only matches negotiate") {
+    Handshake hs;
+    CHECK_FALSE(parse_handshake(R"({"id":1,"method":"ping"})", hs));
+    CHECK_FALSE(parse_handshake(R"({"id":1,"method":"ping","params":{"note":"negotiate"}})", hs));
+    CHECK_FALSE(parse_handshake("\"negotiate\" not json", hs));
+
+    REQUIRE(parse_handshake(R"({"id":7,"method":"negotiate","params":{"framing":"binary"}})", hs));
+    CHECK(hs.id == 7);
+    CHECK(hs.framing == "binary");
+
+    REQUIRE(parse_handshake(R"({"id":8,"method":"negotiate"})", hs));
+    CHECK(hs.framing == "newline");
+}
+
+TEST_CASE("handshake_response accepts known framings") {
+    Negotiated n;
+    Handshake hs{3, "newline", "json"};
+    json r = json::parse(handshake_response(hs, n));
+    CHECK_FALSE(n.binary);
+    CHECK(r["result"]["framing"] == "newline");
+
+    hs.framing = "binary";
+    r = json::parse(handshake_response(hs, n));
+    CHECK(n.binary);
+    CHECK(n.encoding == CONTENT_JSON);
+    CHECK(r["id"] == 3);
+    CHECK(r["result"]["content_types"]["binary"] == CONTENT_BINARY);
+
+    hs.framing = "carrier-pigeon";
+    r = json::parse(handshake_response(hs, n));
+    CHECK_FALSE(n.binary);
+    CHECK(r["error"]["code"] == -32602);
+}
+
+TEST_CASE("handshake_response negotiates response encodings") {
+    Negotiated n;
+    Handshake hs{1, "binary", "msgpack"};
+    json r = json::parse(handshake_response(hs, n));
+    CHECK(n.binary);
+    CHECK(n.encoding == CONTENT_MSGPACK);
+    CHECK(r["result"]["encoding"] == "msgpack");
+
+    hs.encoding = "cbor";
+    handshake_response(hs, n);
+    CHECK(n.encoding == CONTENT_CBOR);
+
+    // binary encodings need frames
+    hs = Handshake{2, "newline", "cbor"};
+    r = json::parse(handshake_response(hs, n));
+    CHECK(r["error"]["code"] == -32602);
+    CHECK(n.encoding == CONTENT_JSON);
+
+    hs = Handshake{3, "binary", "xml"};
+    r = json::parse(handshake_response(hs, n));
+    CHECK(r["error"]["code"] == -32602);
+    CHECK_FALSE(n.binary);
+}
+
+TEST_CASE("parse_handshake reads the encoding") {
+    Handshake hs;
+    REQUIRE(parse_handshake(R"({"id":1,"method":"negotiate","params":{"framing":"binary","encoding":"cbor"}})", hs));
+    CHECK(hs.encoding == "cbor");
+    REQUIRE(parse_handshake(R"({"id":1,"method":"negotiate","params":{"framing":"binary"}})", hs));
+    CHECK(hs.encoding == "json");
+}
+
+TEST_CASE("handshake_response negotiates compression") {
+    Negotiated n;
+    Handshake hs{1, "binary", "json", "deflate", 1024};
+    json r = json::parse(handshake_response(hs, n));
+    CHECK(n.deflate);
+    CHECK(n.compress_threshold == 1024);
+    CHECK(r["result"]["compression"] == "deflate");
+    CHECK(r["result"]["compress_threshold"] == 1024);
+
+    // the deflate flag lives in the frame header
+    hs = Handshake{2, "newline", "json", "deflate"};
+    r = json::parse(handshake_response(hs, n));
+    CHECK(r["error"]["code"] == -32602);
+    CHECK_FALSE(n.deflate);
+
+    hs = Handshake{3, "binary", "json", "zstd"};
+    r = json::parse(handshake_response(hs, n));
+    CHECK(r["error"]["code"] == -32602);
+
+    hs = Handshake{4, "binary", "json", "deflate", -1};
+    r = json::parse(handshake_response(hs, n));
+    CHECK(r["error"]["code"] == -32602);
+}
+
+TEST_CASE("parse_handshake reads compression settings") {
+    Handshake hs;
+    REQUIRE(parse_handshake(R"({"id":1,"method":"negotiate","params":{"framing":"binary","compression":"deflate","compress_threshold":10}})", hs));
+    CHECK(hs.compression == "deflate");
+    CHECK(hs.compress_threshold == 10);
+    REQUIRE(parse_handshake(R"({"id":1,"method":"negotiate","params":{"framing":"binary"}})", hs));
+    CHECK(hs.compression == "none");
+    CHECK(hs.compress_threshold == static_cast<int64_t>(DEFAULT_COMPRESS_THRESHOLD));
+}
@@ -0,0 +1,311 @@
+#include <doctest/doctest.h>
+#include "frame_task.h"
+#include "rpc_dispatcher.h"
+#include "response_cache.h"
+#include "server_stats.h"
+#include "socket_server.h"
+#include "json_rpc.h"
+#include <nlohmann/json.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+static const char* TASK_SOCK = "/tmp/godot_peek_task_test.sock";
+
+// --- FrameScheduler ---
+
+static RpcTask wait_frames(FrameScheduler& frames, int n, std::vector<std::string>& log) {
+    for (int i = 0; i < n; i++) {
+        co_await frames.next_frame();
+        log.push_back("frame" + std::to_string(i));
+    }
+    co_return "done";
+}
+
+TEST_CASE("task runs eagerly and resumes once per tick") {
+    FrameScheduler frames;
+    std::vector<std::string> log;
+
+    RpcTask instant = wait_frames(frames, 0, log);
+    CHECK(instant.done());
+    CHECK(instant.take_response() == "done");
+
+    RpcTask task = wait_frames(frames, 2, log);
+    CHECK_FALSE(task.done());
+    CHECK(frames.parked() == 1);
+    frames.tick();
+    CHECK(log == std::vector<std::string>{"frame0"});
+    frames.tick();
+    CHECK(task.done());
+    CHECK(frames.parked() == 0);
+    CHECK(task.take_response() == "done");
+}
+
+static RpcTask sleeper(FrameScheduler& frames, uint32_t ms) {
+    co_await frames.timeout(ms);
+    co_return "slept";
+}
+
+TEST_CASE("timeout resumes once the clock passes the deadline") {
+    FrameScheduler frames;
+    uint64_t t0 = frames.now_ms();
+    RpcTask task = sleeper(frames, 100);
+    frames.tick(t0 + 50);
+    CHECK_FALSE(task.done());
+    frames.tick(t0 + 100);
+    CHECK(task.done());
+
+    // a zero timeout doesn't suspend at all
+    CHECK(sleeper(frames, 0).done());
+}
+
+static RpcTask wait_until(FrameScheduler& frames, const int& value, uint32_t timeout_ms) {
+    bool ok = co_await frames.until([&value] { return value >= 3; }, timeout_ms);
+    co_return ok ? "ok" : "timeout";
+}
+
+TEST_CASE("until polls its predicate each tick and can time out") {
+    FrameScheduler frames;
+    uint64_t t0 = frames.now_ms();
+    int value = 3;
+    CHECK(wait_until(frames, value, 0).done());  // already true: no suspension
+
+    value = 0;
+    RpcTask task = wait_until(frames, value, 0);
+    for (int i = 1; i <= 3; i++) {
+        CHECK_FALSE(task.done());
+        value = i;
+        frames.tick(t0 + static_cast<uint64_t>(i));
+    }
+    REQUIRE(task.done());
+    CHECK(task.take_response() == "ok");
+
+    value = 0;
+    RpcTask late = wait_until(frames, value, 200);
+    frames.tick(t0 + 100);
+    CHECK_FALSE(late.done());
+    frames.tick(t0 + 250);
+    REQUIRE(late.done());
+    CHECK(late.take_response() == "timeout");
+}
+
+static RpcTask wait_signal(FrameScheduler& frames, const FrameSignal& event) {
+    bool fired = co_await frames.signal(event, 1000);
+    co_return fired ? "fired" : "timeout";
+}
+
+TEST_CASE("signal only counts fires after the await") {
+    FrameScheduler frames;
+    FrameSignal event;
+    event.fire();  // before anyone waits: ignored
+
+    RpcTask task = wait_signal(frames, event);
+    frames.tick(frames.now_ms() + 1);
+    CHECK_FALSE(task.done());
+    event.fire();
+    frames.tick(frames.now_ms() + 1);
+    REQUIRE(task.done());
+    CHECK(task.take_response() == "fired");
+}
+
+TEST_CASE("destroying a parked task unparks it") {
+    FrameScheduler frames;
+    std::vector<std::string> log;
+    {
+        RpcTask task = wait_frames(frames, 5, log);
+        CHECK(frames.parked() == 1);
+    }
+    CHECK(frames.parked() == 0);
+    frames.tick();
+    CHECK(log.empty());
+
+    // and a scheduler going first leaves tasks safe to destroy
+    RpcTask orphan;
+    {
+        FrameScheduler short_lived;
+        orphan = wait_frames(short_lived, 1, log);
+    }
+    CHECK_FALSE(orphan.done());
+}
+
+// --- RpcDispatcher ---
+
+// a task method answering after `frames` ticks with {"waited":frames}
+static void add_waiting_method(RpcDispatcher& d, FrameScheduler& frames, const std::string& name,
+                               CachePolicy policy = CachePolicy::none) {
+    d.add_task(name, [&frames](int64_t id, std::string params_str, RpcContext&) -> RpcTask {
+        json params = json::parse(params_str, nullptr, false);
+        int n = params.value("frames", 0);
+        for (int i = 0; i < n; i++) {
+            co_await frames.next_frame();
+        }
+        co_return make_result(id, json{{"waited", n}}.dump());
+    }, policy);
+}
+
+TEST_CASE("dispatcher answers a task that doesn't wait immediately") {
+    FrameScheduler frames;
+    RpcDispatcher d;
+    add_waiting_method(d, frames, "wait");
+
+    RpcContext ctx;
+    std::string response = d.handle(R"({"id":1,"method":"wait","params":{"frames":0}})", &ctx);
+    CHECK(json::parse(response)["result"]["waited"] == 0);
+    CHECK_FALSE(ctx.deferred);
+    CHECK(d.tasks_running() == 0);
+}
+
+TEST_CASE("dispatcher defers a waiting task until finish_tasks") {
+    FrameScheduler frames;
+    ServerStats stats;
+    ResponseCache cache;
+    RpcDispatcher d;
+    d.set_stats(&stats);
+    d.set_cache(&cache);
+    add_waiting_method(d, frames, "wait", CachePolicy::invalidates);
+
+    RpcContext ctx;
+    uint64_t revision = cache.revision();
+    CHECK(d.handle(R"({"id":7,"method":"wait","params":{"frames":2}})", &ctx).empty());
+    REQUIRE(ctx.deferred);
+    CHECK(d.tasks_running() == 1);
+
+    frames.tick();
+    CHECK(d.finish_tasks() == 1);
+    CHECK_FALSE(ctx.deferred->done);
+
+    frames.tick();
+    CHECK(d.finish_tasks() == 0);
+    REQUIRE(ctx.deferred->done);
+    json j = json::parse(ctx.deferred->response);
+    CHECK(j["id"] == 7);
+    CHECK(j["result"]["waited"] == 2);
+    CHECK(cache.revision() == revision + 1);
+    CHECK(json::parse(stats.to_json())["methods"]["wait"]["calls"] == 1);
+}
+
+TEST_CASE("cached task results are served without running the task") {
+    FrameScheduler frames;
+    ResponseCache cache;
+    RpcDispatcher d;
+    d.set_cache(&cache);
+    int runs = 0;
+    d.add_task("tree", [&](int64_t id, std::string, RpcContext&) -> RpcTask {
+        runs++;
+        co_await frames.next_frame();
+        co_return make_result(id, R"({"tree":"root"})");
+    }, CachePolicy::cached);
+
+    RpcContext first;
+    CHECK(d.handle(R"({"id":1,"method":"tree"})", &first).empty());
+    frames.tick();
+    d.finish_tasks();
+    REQUIRE(first.deferred->done);
+
+    RpcContext second;
+    std::string response = d.handle(R"({"id":2,"method":"tree"})", &second);
+    CHECK(json::parse(response) == json::parse(R"({"id":2,"result":{"tree":"root"}})"));
+    CHECK_FALSE(second.deferred);
+    CHECK(runs == 1);
+}
+
+TEST_CASE("task results marked no_cache are not kept") {
+    FrameScheduler frames;
+    ResponseCache cache;
+    RpcDispatcher d;
+    d.set_cache(&cache);
+    int runs = 0;
+    d.add_task("tree", [&](int64_t id, std::string, RpcContext& ctx) -> RpcTask {
+        // still loading the first time, with and without a wait
+        if (++runs == 1) {
+            co_await frames.next_frame();
+        }
+        if (runs < 3) {
+            ctx.no_cache = true;
+            co_return make_result(id, R"({"pending":true})");
+        }
+        co_return make_result(id, R"({"pending":false})");
+    }, CachePolicy::cached);
+
+    RpcContext first;
+    CHECK(d.handle(R"({"id":1,"method":"tree"})", &first).empty());
+    frames.tick();
+    d.finish_tasks();
+    REQUIRE(first.deferred->done);
+
+    CHECK(json::parse(d.handle(R"({"id":2,"method":"tree"})"))["result"]["pending"] == true);
+    CHECK(json::parse(d.handle(R"({"id":3,"method":"tree"})"))["result"]["pending"] == false);
+    CHECK(json::parse(d.handle(R"({"id":4,"method":"tree"})"))["result"]["pending"] == false);
+    CHECK(runs == 3);
+}
+
+// --- SocketServer ---
+
+static int connect_client(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+static std::string read_all(int fd) {
+    std::string received;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        received.append(buf, static_cast<size_t>(n));
+    }
+    return received;
+}
+
+TEST_CASE("socket server keeps later responses behind a deferred one") {
+    unlink(TASK_SOCK);
+    FrameScheduler frames;
+    RpcDispatcher d;
+    add_waiting_method(d, frames, "wait");
+    d.add("ping", [](int64_t id, const std::string&) { return make_result(id, R"({"pong":true})"); });
+
+    SocketServer server;
+    REQUIRE(server.start(TASK_SOCK));
+    int fd = connect_client(TASK_SOCK);
+    REQUIRE(fd >= 0);
+
+    std::string batch = R"({"id":1,"method":"wait","params":{"frames":3}})" "\n"
+                        R"({"id":2,"method":"ping"})" "\n";
+    REQUIRE(write(fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size()));
+
+    auto callback = [&](const std::string& msg, RpcContext& ctx) { return d.handle(msg, &ctx); };
+    std::string received;
+    int ticks = 0;
+    for (int i = 0; i < 2000 && received.find("pong") == std::string::npos; i++) {
+        frames.tick();
+        d.finish_tasks();
+        server.poll(callback);
+        ticks++;
+        received += read_all(fd);
+        // nothing may overtake the waiting request
+        if (d.tasks_running() > 0) {
+            CHECK(received.empty());
+        }
+    }
+    CHECK(ticks >= 3);
+    CHECK(received == R"({"id":1,"result":{"waited":3}})" "\n" R"({"id":2,"result":{"pong":true}})" "\n");
+
+    close(fd);
+    server.stop();
+}
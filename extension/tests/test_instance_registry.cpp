@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include "instance_registry.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// helper: fresh registry directory under /tmp (removed by the caller)
+static std::string temp_registry_dir() {
+    char tmpl[] = "/tmp/godot_peek_registry_test.XXXXXX";
+    REQUIRE(mkdtemp(tmpl) != nullptr);
+    return std::string(tmpl) + "/registry";
+}
+
+static void remove_registry_dir(const std::string& dir) {
+    std::string cmd = "rm -rf '" + dir.substr(0, dir.rfind('/')) + "'";
+    CHECK(std::system(cmd.c_str()) == 0);
+}
+
+static InstanceInfo make_info(int64_t pid, const std::string& project, const std::string& socket) {
+    InstanceInfo info;
+    info.pid = pid;
+    info.project_path = project;
+    info.project_hash = project_path_hash(project);
+    info.socket_path = socket;
+    info.godot_version = "4.3.stable";
+    info.started_at = 1700000000;
+    return info;
+}
+
+TEST_CASE("project_path_hash ignores trailing slashes") {
+    std::string h = project_path_hash("/home/me/Code/game");
+    CHECK(h.size() == 16);
+    CHECK(h == project_path_hash("/home/me/Code/game/"));
+    CHECK(h != project_path_hash("/home/you/Code/game"));
+}
+
+TEST_CASE("instance entries round-trip through JSON") {
+    InstanceInfo in = make_info(42, "/home/me/game", "/tmp/godot-peek-game.sock");
+    InstanceInfo out;
+    REQUIRE(instance_from_json(instance_to_json(in), out));
+    CHECK(out.pid == 42);
+    CHECK(out.project_path == in.project_path);
+    CHECK(out.project_hash == in.project_hash);
+    CHECK(out.socket_path == in.socket_path);
+    CHECK(out.godot_version == "4.3.stable");
+    CHECK(out.started_at == 1700000000);
+
+    CHECK_FALSE(instance_from_json("{broken", out));
+    CHECK_FALSE(instance_from_json(R"({"pid":"1","socket_path":"/tmp/x.sock"})", out));
+    CHECK_FALSE(instance_from_json(R"({"pid":1})", out));
+}
+
+TEST_CASE("pid_alive") {
+    CHECK(pid_alive(getpid()));
+    CHECK_FALSE(pid_alive(0));
+    CHECK_FALSE(pid_alive(-5));
+}
+
+TEST_CASE("registry lists live entries and prunes stale ones") {
+    std::string dir = temp_registry_dir();
+    InstanceRegistry registry(dir);
+    CHECK(registry.list().empty());  // directory doesn't exist yet
+
+    REQUIRE(registry.add(make_info(getpid(), "/home/me/game", "/tmp/godot-peek-game.sock")));
+
+    // an entry for a pid that can't exist, plus one that isn't valid JSON
+    InstanceInfo dead = make_info(0x7ffffff0, "/home/me/old", "/tmp/godot-peek-old.sock");
+    REQUIRE(registry.add(dead));
+    std::ofstream(dir + "/123.json") << "{not json";
+
+    auto live = registry.list();
+    REQUIRE(live.size() == 1);
+    CHECK(live[0].pid == getpid());
+    CHECK(live[0].socket_path == "/tmp/godot-peek-game.sock");
+
+    // pruned entries are gone from disk
+    CHECK(access((dir + "/2147483632.json").c_str(), F_OK) != 0);
+    CHECK(access((dir + "/123.json").c_str(), F_OK) != 0);
+
+    registry.remove(getpid());
+    CHECK(registry.list().empty());
+
+    remove_registry_dir(dir);
+}
+
+TEST_CASE("registry directory is private to its user") {
+    std::string dir = temp_registry_dir();
+    InstanceRegistry registry(dir);
+    REQUIRE(registry.add(make_info(getpid(), "/home/me/game", "/tmp/godot-peek-game.sock")));
+
+    struct stat st;
+    REQUIRE(stat(dir.c_str(), &st) == 0);
+    CHECK((st.st_mode & 0777) == 0700);
+
+    // entries written by another user are skipped, not pruned
+    if (getuid() == 0) {
+        std::string other = dir + "/1.json";
+        std::ofstream(other) << instance_to_json(make_info(1, "/home/eve/game", "/tmp/evil.sock"));
+        REQUIRE(chown(other.c_str(), 12345, 12345) == 0);
+        auto live = registry.list();
+        REQUIRE(live.size() == 1);
+        CHECK(live[0].pid == getpid());
+        CHECK(access(other.c_str(), F_OK) == 0);
+
+        // a directory someone else created first is not used
+        REQUIRE(chown(dir.c_str(), 12345, 12345) == 0);
+        CHECK_FALSE(registry.add(make_info(getpid(), "/home/me/game", "/tmp/godot-peek-game.sock")));
+    }
+
+    remove_registry_dir(dir);
+}
+
+TEST_CASE("choose_socket_path separates same-named projects") {
+    std::string preferred = "/tmp/godot-peek-game.sock";
+    std::vector<InstanceInfo> live = {make_info(getpid(), "/home/me/game", preferred)};
+
+    // same project (eg a second editor or the game process): same path
+    CHECK(choose_socket_path(live, "/home/me/game", preferred) == preferred);
+    CHECK(choose_socket_path({}, "/home/you/game", preferred) == preferred);
+
+    std::string other = choose_socket_path(live, "/home/you/game", preferred);
+    CHECK(other == "/tmp/godot-peek-game-" + project_path_hash("/home/you/game").substr(0, 8) + ".sock");
+}
@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>
+#include "line_framer.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// helper: drain every complete line
+static std::vector<std::string> drain(LineFramer& f) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (f.next(line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST_CASE("framer splits lines and keeps the partial tail") {
+    LineFramer f;
+    std::string in = "one\ntwo\nthr";
+    f.append(in.data(), in.size());
+    CHECK(drain(f) == std::vector<std::string>{"one", "two"});
+    CHECK(f.buffered() == 3);
+
+    f.append("ee\n", 3);
+    CHECK(drain(f) == std::vector<std::string>{"three"});
+    CHECK(f.buffered() == 0);
+}
+
+TEST_CASE("framer returns empty lines and NUL bytes") {
+    LineFramer f;
+    std::string in("\na\0b\n", 5);
+    f.append(in.data(), in.size());
+    auto lines = drain(f);
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0].empty());
+    CHECK(lines[1] == std::string("a\0b", 3));
+}
+
+TEST_CASE("framer reassembles byte-at-a-time input") {
+    LineFramer f;
+    std::string in = "{\"id\":1}\n{\"id\":2}\n";
+    std::vector<std::string> lines;
+    for (char c : in) {
+        f.append(&c, 1);
+        for (auto& l : drain(f)) {
+            lines.push_back(l);
+        }
+    }
+    CHECK(lines == std::vector<std::string>{"{\"id\":1}", "{\"id\":2}"});
+}
+
+TEST_CASE("framer flags lines over the limit") {
+    LineFramer f(16);
+    std::string in(10, 'x');
+    f.append(in.data(), in.size());
+    CHECK(drain(f).empty());
+    CHECK_FALSE(f.overflowed());
+
+    f.append(in.data(), in.size());
+    CHECK(drain(f).empty());
+    CHECK(f.overflowed());
+    CHECK(f.buffered() == 0);
+
+    // nothing more comes out once overflowed
+    f.append("\nok\n", 4);
+    CHECK(drain(f).empty());
+}
+
+TEST_CASE("framer stays linear on pathological input") {
+    // a 16MB line in 4KB reads and 1M one-byte messages in one read used to
+    // rescan/erase the whole buffer per step
+    auto start = std::chrono::steady_clock::now();
+
+    LineFramer big;
+    std::string chunk(4096, 'a');
+    std::string line;
+    bool early = false;
+    for (int i = 0; i < 4096; i++) {
+        big.append(chunk.data(), chunk.size());
+        early = early || big.next(line);
+    }
+    CHECK_FALSE(early);
+    big.append("\n", 1);
+    REQUIRE(big.next(line));
+    CHECK(line.size() == 4096u * 4096u);
+
+    LineFramer tiny;
+    std::string burst;
+    for (int i = 0; i < 1000000; i++) {
+        burst += "x\n";
+    }
+    tiny.append(burst.data(), burst.size());
+    size_t count = 0;
+    while (tiny.next(line)) {
+        count++;
+    }
+    CHECK(count == 1000000);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(seconds < 2.0);
+}
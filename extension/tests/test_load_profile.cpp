@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>
+#include "load_profile.h"
+
+#include <thread>
+
+using json = nlohmann::json;
+
+TEST_CASE("dependency entries give their path") {
+    CHECK(dependency_path("res://a.png") == "res://a.png");
+    CHECK(dependency_path("res://a.png::Texture2D") == "res://a.png");
+    CHECK(dependency_path("uid://b1::::res://a.png") == "res://a.png");
+    CHECK(dependency_path("uid://b1::Texture2D::res://a.png") == "res://a.png");
+    CHECK(dependency_path("uid://b1::Texture2D::") == "uid://b1");
+}
+
+TEST_CASE("nested loads nest and leave their parent's self time") {
+    LoadProfile profile;
+    int32_t scene = profile.begin("res://level.tscn", false, 1000);
+    profile.cache_hit("res://player.gd", 1010);
+    int32_t mesh = profile.begin("res://rock.mesh", false, 1100);
+    int32_t tex = profile.begin("res://rock.png", false, 1200);
+    profile.end(tex, "CompressedTexture2D", 4096, true, 1700);
+    profile.end(mesh, "ArrayMesh", 2048, true, 2100);
+    profile.end(scene, "PackedScene", 512, true, 2500);
+
+    std::vector<LoadRecord> records = profile.records();
+    REQUIRE(records.size() == 4);
+    CHECK(records[1].cache_hit);
+    CHECK(records[1].parent == scene);
+    CHECK(records[tex].parent == mesh);
+    CHECK(records[tex].depth == 2);
+    CHECK(records[tex].self_us == 500);
+    CHECK(records[mesh].total_us == 1000);
+    CHECK(records[mesh].self_us == 500);
+    CHECK(records[scene].total_us == 1500);
+    CHECK(records[scene].self_us == 500);
+
+    json out = load_profile_json(records, profile.dropped(), 2, true);
+    CHECK(out["loads"] == 3);
+    CHECK(out["cache_hits"] == 1);
+    CHECK(out["pending"] == 0);
+    CHECK(out["wall_ms"] == doctest::Approx(1.5));
+    CHECK(out["self_ms"] == doctest::Approx(1.5));
+    REQUIRE(out["top"].size() == 2);
+    CHECK(out["top"][0]["path"] == "res://level.tscn");
+    CHECK(out["top"][0]["cache_hits"] == 1);
+    CHECK(out["top"][0]["chain"] == json::array());
+    CHECK(out["top"][1]["path"] == "res://rock.mesh");
+    CHECK(out["top"][1]["chain"] == json::array({"res://level.tscn"}));
+    CHECK(out["by_type"].size() == 2);
+}
+
+TEST_CASE("the report ranks by self time and groups by type") {
+    LoadProfile profile;
+    profile.end(profile.begin("res://a.png", false, 0), "CompressedTexture2D", 100, true, 300);
+    profile.end(profile.begin("res://b.png", true, 0), "CompressedTexture2D", 100, true, 900);
+    profile.end(profile.begin("res://c.ogg", false, 0), "AudioStreamOggVorbis", 100, true, 1000);
+    profile.end(profile.begin("res://missing.tres", false, 0), "", -1, false, 50);
+    profile.begin("res://still_loading.tscn", false, 0);
+
+    json out = load_profile_json(profile.records(), 0, 10, false);
+    CHECK(out["loads"] == 5);
+    CHECK(out["failed"] == 1);
+    CHECK(out["pending"] == 1);
+    REQUIRE(out["top"].size() == 4);
+    CHECK(out["top"][0]["path"] == "res://c.ogg");
+    CHECK(out["top"][1]["path"] == "res://b.png");
+    CHECK(out["top"][1]["threaded"] == true);
+    CHECK(out["top"][3]["failed"] == true);
+    REQUIRE(out["by_type"].size() == 3);
+    CHECK(out["by_type"][0] == json{{"type", "CompressedTexture2D"}, {"count", 2}, {"self_ms", 1.2}});
+    CHECK(out["by_type"][2]["type"] == "(failed)");
+}
+
+TEST_CASE("loads on other threads don't nest under this one's") {
+    LoadProfile profile;
+    int32_t outer = profile.begin("res://main.tscn", false, 0);
+    int32_t worker = -1;
+    std::thread t([&] {
+        worker = profile.begin("res://music.ogg", true, 10);
+        profile.end(worker, "AudioStreamOggVorbis", 10, true, 400);
+    });
+    t.join();
+    profile.end(outer, "PackedScene", 10, true, 500);
+
+    std::vector<LoadRecord> records = profile.records();
+    CHECK(records[worker].parent == -1);
+    CHECK(records[outer].self_us == 500);
+}
+
+TEST_CASE("the cap drops records but keeps nesting straight") {
+    LoadProfile profile(1);
+    int32_t a = profile.begin("res://a.tscn", false, 0);
+    int32_t b = profile.begin("res://b.tscn", false, 10);
+    CHECK(b == -1);
+    profile.end(b, "PackedScene", 1, true, 20);
+    profile.end(a, "PackedScene", 1, true, 30);
+    CHECK(profile.dropped() == 1);
+    CHECK(profile.records()[0].total_us == 30);
+    CHECK(profile.records()[0].self_us == 30);
+}
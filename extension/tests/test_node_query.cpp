@@ -0,0 +1,190 @@
+#include <doctest/doctest.h>
+#include "node_query.h"
+#include "mock_editor.h"
+
+using json = nlohmann::json;
+
+// /root/Level with three bodies, an area and a nested crate
+struct LevelScene {
+    MockSceneTree tree;
+    NodeHandle level, crate, barrel, rock, area, nested;
+
+    LevelScene() {
+        level = tree.add(tree.root(), "Level", {"Node3D", "Node"});
+        crate = tree.add(level, "Crate1", {"RigidBody3D", "PhysicsBody3D", "Node3D", "Node"});
+        barrel = tree.add(level, "Barrel", {"RigidBody3D", "PhysicsBody3D", "Node3D", "Node"});
+        rock = tree.add(level, "Rock", {"StaticBody3D", "PhysicsBody3D", "Node3D", "Node"});
+        area = tree.add(level, "Trigger", {"Area3D", "Node3D", "Node"});
+        nested = tree.add(area, "Crate2", {"RigidBody3D", "PhysicsBody3D", "Node3D", "Node"});
+        tree.add(tree.root(), "Crate9", {"RigidBody3D", "PhysicsBody3D", "Node3D", "Node"});
+
+        tree.get(crate).properties = {{"sleeping", false}, {"mass", 3.5}};
+        tree.get(barrel).properties = {{"sleeping", true}, {"mass", 1}};
+        tree.get(nested).properties = {{"sleeping", false}, {"mass", 2}};
+        tree.add_to_group(crate, "loot");
+        tree.add_to_group(nested, "loot");
+        tree.add_to_group(rock, "loot");
+    }
+
+    NodeClassIndex index() const {
+        NodeClassIndex idx;
+        for (size_t i = 1; i <= tree.size(); i++) {
+            NodeHandle h = MockSceneTree::to_handle(i);
+            idx.add(h, tree.class_name(h));
+        }
+        return idx;
+    }
+};
+
+static std::vector<std::string> paths(const NodeQueryResult& r) {
+    std::vector<std::string> out;
+    for (const NodeMatch& m : r.matches) {
+        out.push_back(m.path);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+TEST_CASE("parse_selector reads every term") {
+    NodeSelector sel;
+    std::string error;
+    REQUIRE(parse_selector("/root/Level/ RigidBody3D #Crate* .loot [sleeping == false] [mass>2.5] [tag = \"a ]b\"] :depth(2)",
+                           sel, error));
+    CHECK(sel.root == "/root/Level");
+    CHECK(sel.type == "RigidBody3D");
+    CHECK(sel.name_glob == "Crate*");
+    CHECK(sel.group == "loot");
+    REQUIRE(sel.tests.size() == 3);
+    CHECK(sel.tests[0].property == "sleeping");
+    CHECK(sel.tests[0].value == json(false));
+    CHECK(sel.tests[1].op == CompareOp::gt);
+    CHECK(sel.tests[1].value == json(2.5));
+    CHECK(sel.tests[2].value == json("a ]b"));
+    CHECK(sel.max_depth == 2);
+
+    REQUIRE(parse_selector("", sel, error));
+    CHECK(sel.root == "/root");
+    REQUIRE(parse_selector("Node2D[layer != top]", sel, error));
+    CHECK(sel.tests[0].value == json("top"));
+    CHECK(sel.tests[0].op == CompareOp::ne);
+
+    CHECK_FALSE(parse_selector("Node2D Sprite2D", sel, error));
+    CHECK_FALSE(parse_selector("[mass]", sel, error));
+    CHECK(error.find("operator") != std::string::npos);
+    CHECK_FALSE(parse_selector("[mass > 1", sel, error));
+    CHECK_FALSE(parse_selector(":depth(0)", sel, error));
+    CHECK_FALSE(parse_selector(":deep(2)", sel, error));
+    CHECK_FALSE(parse_selector("Node $", sel, error));
+}
+
+TEST_CASE("glob_match and compare_values") {
+    CHECK(glob_match("Crate*", "Crate12"));
+    CHECK(glob_match("*ate?", "Crate1"));
+    CHECK(glob_match("*", ""));
+    CHECK_FALSE(glob_match("Crate?", "Crate12"));
+    CHECK(glob_match("a*b*c", "axxbyybzc"));
+
+    CHECK(compare_values(json(3), CompareOp::gt, json(2.5)));
+    CHECK(compare_values(json(2), CompareOp::eq, json(2.0)));
+    CHECK(compare_values(json("b"), CompareOp::ge, json("a")));
+    CHECK(compare_values(json(true), CompareOp::ne, json(false)));
+    CHECK_FALSE(compare_values(json(true), CompareOp::gt, json(false)));
+    CHECK_FALSE(compare_values(json("3"), CompareOp::eq, json(3)));
+    CHECK(compare_values(json(nullptr), CompareOp::eq, json(nullptr)));
+}
+
+TEST_CASE("queries match the same nodes from a walk, a group and the class index") {
+    LevelScene scene;
+    NodeClassIndex index = scene.index();
+    NodeSelector sel;
+    std::string error;
+    REQUIRE(parse_selector("/root/Level RigidBody3D [sleeping == false]", sel, error));
+
+    NodeQueryResult walked = run_node_query(scene.tree, sel, {"mass"}, 100, nullptr);
+    CHECK(std::string(walked.source) == "walk");
+    CHECK(paths(walked) == std::vector<std::string>{"/root/Level/Crate1", "/root/Level/Trigger/Crate2"});
+    CHECK(walked.matches[0].properties == json{{"mass", 3.5}});
+    CHECK(walked.matches[0].class_name == "RigidBody3D");
+
+    NodeQueryResult indexed = run_node_query(scene.tree, sel, {}, 100, &index);
+    CHECK(std::string(indexed.source) == "class_index");
+    CHECK(paths(indexed) == paths(walked));
+    CHECK(indexed.visited == 4);  // every RigidBody3D, /root/Crate9 included
+
+    // subclasses come out of the index through inherits()
+    REQUIRE(parse_selector("/root/Level PhysicsBody3D", sel, error));
+    CHECK(run_node_query(scene.tree, sel, {}, 100, &index).matches.size() == 4);
+
+    REQUIRE(parse_selector("/root/Level RigidBody3D .loot", sel, error));
+    NodeQueryResult grouped = run_node_query(scene.tree, sel, {}, 100, &index);
+    CHECK(std::string(grouped.source) == "group");
+    CHECK(paths(grouped) == paths(walked));
+}
+
+TEST_CASE("depth, names, limit and missing properties") {
+    LevelScene scene;
+    NodeClassIndex index = scene.index();
+    NodeSelector sel;
+    std::string error;
+
+    REQUIRE(parse_selector("/root/Level RigidBody3D :depth(1)", sel, error));
+    CHECK(paths(run_node_query(scene.tree, sel, {}, 100, nullptr)) ==
+          std::vector<std::string>{"/root/Level/Barrel", "/root/Level/Crate1"});
+    CHECK(paths(run_node_query(scene.tree, sel, {}, 100, &index)) ==
+          std::vector<std::string>{"/root/Level/Barrel", "/root/Level/Crate1"});
+
+    REQUIRE(parse_selector("#Crate?", sel, error));
+    CHECK(run_node_query(scene.tree, sel, {}, 100, nullptr).matches.size() == 3);
+
+    // a node without the property never matches, even for !=
+    REQUIRE(parse_selector("/root/Level [mass != 1]", sel, error));
+    CHECK(paths(run_node_query(scene.tree, sel, {}, 100, nullptr)) ==
+          std::vector<std::string>{"/root/Level/Crate1", "/root/Level/Trigger/Crate2"});
+
+    REQUIRE(parse_selector("Node", sel, error));
+    NodeQueryResult limited = run_node_query(scene.tree, sel, {}, 3, nullptr);
+    CHECK(limited.matches.size() == 3);
+    CHECK(limited.truncated);
+    CHECK(limited.matches[0].path == "/root/Level");  // tree order
+    limited = run_node_query(scene.tree, sel, {}, 7, nullptr);
+    CHECK(limited.matches.size() == 7);
+    CHECK_FALSE(limited.truncated);
+
+    REQUIRE(parse_selector("/root/Nowhere", sel, error));
+    CHECK_FALSE(run_node_query(scene.tree, sel, {}, 3, nullptr).root_found);
+}
+
+TEST_CASE("the class index follows removals") {
+    LevelScene scene;
+    NodeClassIndex index = scene.index();
+    index.remove(scene.crate);
+    index.remove(scene.crate);  // twice is harmless
+    index.add(scene.barrel, "RigidBody3D");  // re-adding replaces
+    NodeSelector sel;
+    std::string error;
+    REQUIRE(parse_selector("/root/Level RigidBody3D", sel, error));
+    CHECK(paths(run_node_query(scene.tree, sel, {}, 100, &index)) ==
+          std::vector<std::string>{"/root/Level/Barrel", "/root/Level/Trigger/Crate2"});
+}
+
+TEST_CASE("query_nodes takes udp-style string params") {
+    LevelScene scene;
+    json result;
+    std::string error;
+    json params = {{"selector", "/root/Level RigidBody3D"}, {"properties", "mass, sleeping"}, {"limit", "1"}};
+    REQUIRE(query_nodes(scene.tree, params, nullptr, result, error));
+    CHECK(result["count"] == 1);
+    CHECK(result["truncated"] == true);
+    CHECK(result["matches"][0]["path"] == "/root/Level/Crate1");
+    CHECK(result["matches"][0]["properties"] == json{{"mass", 3.5}, {"sleeping", false}});
+
+    params = {{"selector", "Node3D"}, {"properties", json::array({"mass"})}, {"limit", 50}};
+    REQUIRE(query_nodes(scene.tree, params, nullptr, result, error));
+    CHECK(result["count"] == 7);
+    CHECK(result["matches"][0]["properties"] == json::object());
+
+    CHECK_FALSE(query_nodes(scene.tree, {{"selector", "/root/Missing"}}, nullptr, result, error));
+    CHECK(error == "no node at /root/Missing");
+    CHECK_FALSE(query_nodes(scene.tree, {{"limit", "many"}}, nullptr, result, error));
+    CHECK_FALSE(query_nodes(scene.tree, {{"selector", "[x"}}, nullptr, result, error));
+}
@@ -0,0 +1,111 @@
+#include <doctest/doctest.h>
+#include "orphan_tracker.h"
+
+#include <map>
+
+using json = nlohmann::json;
+
+// helper: a detach of node id under parent, from key
+static DetachedNode detach(uint64_t id, uint64_t parent, uint32_t key, int64_t time_ms = 1000) {
+    DetachedNode node;
+    node.id = id;
+    node.parent_id = parent;
+    node.key = key;
+    node.time_ms = time_ms;
+    node.frame = 10;
+    return node;
+}
+
+// helper: sweep against a table of states; ids missing from it are freed
+static size_t sweep(OrphanTracker& tracker, const std::map<uint64_t, DetachedState>& states) {
+    return tracker.sweep([&](uint64_t id) {
+        auto it = states.find(id);
+        return it == states.end() ? DetachedState::freed : it->second;
+    });
+}
+
+TEST_CASE("keys are interned once") {
+    OrphanTracker tracker;
+    uint32_t a = tracker.intern("Node2D", "res://enemy.gd", "res://enemy.tscn");
+    uint32_t b = tracker.intern("Node2D", "", "");
+    CHECK(a != b);
+    CHECK(tracker.intern("Node2D", "res://enemy.gd", "res://enemy.tscn") == a);
+    CHECK(tracker.key(a).script == "res://enemy.gd");
+    CHECK(tracker.key(a).scene_file == "res://enemy.tscn");
+    CHECK(tracker.key(b).class_name == "Node2D");
+}
+
+TEST_CASE("re-added and freed nodes drop out, orphans stay") {
+    OrphanTracker tracker;
+    uint32_t key = tracker.intern("Sprite2D", "", "");
+    tracker.detached(detach(1, 100, key));
+    tracker.detached(detach(2, 100, key));
+    tracker.detached(detach(3, 100, key));
+    tracker.detached(detach(4, 3, key));
+    tracker.attached(2);
+    CHECK(tracker.size() == 3);
+
+    // 1 was freed, 3 is an orphan root holding 4
+    CHECK(sweep(tracker, {{3, DetachedState::orphan_root}, {4, DetachedState::orphan_child}}) == 2);
+    CHECK(tracker.all().at(3).root);
+    CHECK_FALSE(tracker.all().at(4).root);
+
+    // back in the tree without a node_added (tracking started late)
+    CHECK(sweep(tracker, {{3, DetachedState::in_tree}, {4, DetachedState::in_tree}}) == 0);
+}
+
+TEST_CASE("the cap drops new detaches and counts them") {
+    OrphanTracker tracker(2);
+    uint32_t key = tracker.intern("Node", "", "");
+    tracker.detached(detach(1, 0, key));
+    tracker.detached(detach(2, 0, key));
+    tracker.detached(detach(3, 0, key));
+    tracker.detached(detach(1, 0, key, 2000));
+    CHECK(tracker.size() == 2);
+    CHECK(tracker.dropped() == 1);
+    CHECK(tracker.all().at(1).time_ms == 2000);
+
+    tracker.clear();
+    CHECK(tracker.size() == 0);
+    CHECK(tracker.dropped() == 0);
+}
+
+TEST_CASE("groups are largest first with the oldest roots sampled") {
+    OrphanTracker tracker;
+    uint32_t bullet = tracker.intern("Area2D", "res://bullet.gd", "res://bullet.tscn");
+    uint32_t label = tracker.intern("Label", "", "");
+    tracker.detached(detach(1, 50, bullet, 3000));
+    tracker.detached(detach(2, 50, bullet, 1000));
+    tracker.detached(detach(3, 50, bullet, 2000));
+    tracker.detached(detach(4, 1, label, 1500));
+    tracker.detached(detach(5, 60, label, 4000));
+    sweep(tracker, {{1, DetachedState::orphan_root},
+                    {2, DetachedState::orphan_root},
+                    {3, DetachedState::orphan_root},
+                    {4, DetachedState::orphan_child},
+                    {5, DetachedState::orphan_root}});
+
+    json out = orphan_groups_json(tracker, 10, 2, 5000, [](const DetachedNode& n) { return json{{"id", n.id}}; });
+    CHECK(out["tracked"] == 5);
+    CHECK(out["roots"] == 4);
+    CHECK(out["dropped"] == 0);
+    REQUIRE(out["groups"].size() == 2);
+
+    const json& first = out["groups"][0];
+    CHECK(first["class"] == "Area2D");
+    CHECK(first["script"] == "res://bullet.gd");
+    CHECK(first["scene_file"] == "res://bullet.tscn");
+    CHECK(first["count"] == 3);
+    CHECK(first["roots"] == 3);
+    CHECK(first["oldest_s"] == doctest::Approx(4.0));
+    CHECK(first["samples"] == json::array({json{{"id", 2}}, json{{"id", 3}}}));
+
+    const json& second = out["groups"][1];
+    CHECK(second["class"] == "Label");
+    CHECK_FALSE(second.contains("script"));
+    CHECK(second["count"] == 2);
+    CHECK(second["roots"] == 1);
+    CHECK(second["samples"] == json::array({json{{"id", 5}}}));
+
+    CHECK(orphan_groups_json(tracker, 1, 0, 5000, nullptr)["groups"].size() == 1);
+}
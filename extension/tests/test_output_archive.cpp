@@ -0,0 +1,199 @@
+#include <doctest/doctest.h>
+#include "output_archive.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <unistd.h>
+
+// helper: fresh archive directory under /tmp (removed by the caller)
+static std::string temp_archive_dir() {
+    char tmpl[] = "/tmp/godot_peek_archive_test.XXXXXX";
+    REQUIRE(mkdtemp(tmpl) != nullptr);
+    return std::string(tmpl) + "/project";
+}
+
+static void remove_archive_dir(const std::string& dir) {
+    std::string cmd = "rm -rf '" + dir.substr(0, dir.rfind('/')) + "'";
+    CHECK(std::system(cmd.c_str()) == 0);
+}
+
+static std::string line_text(uint64_t i) {
+    return "line " + std::to_string(i);
+}
+
+TEST_CASE("default archive dir is per project and follows GODOT_PEEK_ARCHIVE") {
+    unsetenv("GODOT_PEEK_ARCHIVE");
+    CHECK(default_archive_dir("abc") == "/tmp/godot-peek-archive/abc");
+    setenv("GODOT_PEEK_ARCHIVE", "/var/tmp/peek", 1);
+    CHECK(default_archive_dir("abc") == "/var/tmp/peek/abc");
+    unsetenv("GODOT_PEEK_ARCHIVE");
+}
+
+TEST_CASE("archived lines come back by seq range across segments") {
+    std::string dir = temp_archive_dir();
+    {
+        // tiny segments, so 2000 lines span many of them
+        OutputArchive archive(dir, ARCHIVE_MAX_BYTES, 4096);
+        CHECK(archive.append("dropped", 1000) == 0);  // no session yet
+        REQUIRE(archive.begin_session(1000));
+        for (uint64_t i = 1; i <= 2000; i++) {
+            REQUIRE(archive.append(line_text(i), 1000 + static_cast<int64_t>(i)) == i);
+        }
+
+        ArchiveQuery q;
+        q.from_seq = 1500;
+        q.limit = 10;
+        ArchiveResult r = archive.query(q);
+        CHECK(r.session == archive.current_session());
+        REQUIRE(r.records.size() == 10);
+        CHECK(r.truncated);
+        CHECK(r.records.front().seq == 1500);
+        CHECK(r.records.front().text == "line 1500");
+        CHECK(r.records.back().seq == 1509);
+
+        q.from_seq = 1995;
+        q.limit = 100;
+        r = archive.query(q);
+        CHECK(r.records.size() == 6);
+        CHECK_FALSE(r.truncated);
+        CHECK(r.records.back().text == "line 2000");
+
+        q.from_seq = 1;
+        q.to_seq = 3;
+        r = archive.query(q);
+        REQUIRE(r.records.size() == 3);
+        CHECK(r.records[0].text == "line 1");
+    }
+    remove_archive_dir(dir);
+}
+
+TEST_CASE("archived lines come back by time range") {
+    std::string dir = temp_archive_dir();
+    {
+        OutputArchive archive(dir, ARCHIVE_MAX_BYTES, 4096);
+        REQUIRE(archive.begin_session(5000));
+        // ten lines per millisecond
+        for (uint64_t i = 0; i < 3000; i++) {
+            archive.append(line_text(i), 5000 + static_cast<int64_t>(i / 10));
+        }
+        // the clock going back doesn't reorder the archive
+        uint64_t late = archive.append("late", 4000);
+
+        ArchiveQuery q;
+        q.from_ms = 5100;
+        q.to_ms = 5101;
+        ArchiveResult r = archive.query(q);
+        REQUIRE(r.records.size() == 20);
+        CHECK(r.records.front().text == "line 1000");
+        CHECK(r.records.back().text == "line 1019");
+
+        q = ArchiveQuery();
+        q.from_seq = late;
+        r = archive.query(q);
+        REQUIRE(r.records.size() == 1);
+        CHECK(r.records[0].time_ms == 5299);
+    }
+    remove_archive_dir(dir);
+}
+
+TEST_CASE("past sessions survive a restart and are addressable") {
+    std::string dir = temp_archive_dir();
+    int64_t first_id = 0;
+    {
+        OutputArchive archive(dir);
+        REQUIRE(archive.begin_session(1000));
+        first_id = archive.current_session();
+        archive.append("yesterday", 1001);
+        archive.append("crashed", 1002);
+        REQUIRE(archive.begin_session(1000));  // same millisecond: still a new id
+        CHECK(archive.current_session() > first_id);
+        archive.append("today", 2000);
+    }
+
+    OutputArchive archive(dir);
+    std::vector<ArchiveSession> sessions = archive.list_sessions();
+    REQUIRE(sessions.size() == 2);
+    CHECK(sessions[0].id == first_id);
+    CHECK(sessions[0].first_seq == 1);
+    CHECK(sessions[0].last_seq == 2);
+    CHECK(sessions[0].first_ms == 1001);
+    CHECK(sessions[0].last_ms == 1002);
+    CHECK(sessions[1].last_seq == 1);
+
+    // with no session of its own, 0 is the newest and -1 the one before
+    ArchiveQuery q;
+    ArchiveResult r = archive.query(q);
+    REQUIRE(r.records.size() == 1);
+    CHECK(r.records[0].text == "today");
+    q.session = -1;
+    r = archive.query(q);
+    CHECK(r.session == first_id);
+    REQUIRE(r.records.size() == 2);
+    CHECK(r.records[1].text == "crashed");
+    q.session = -2;
+    CHECK(archive.query(q).session == 0);
+    q.session = first_id;
+    CHECK(archive.query(q).records.size() == 2);
+    q.session = 12345;
+    CHECK(archive.query(q).records.empty());
+
+    remove_archive_dir(dir);
+}
+
+TEST_CASE("retention deletes the oldest segments and keeps the live one") {
+    std::string dir = temp_archive_dir();
+    {
+        OutputArchive archive(dir, 32 * 1024, 4096);
+        REQUIRE(archive.begin_session(1000));
+        for (uint64_t i = 1; i <= 5000; i++) {
+            archive.append(line_text(i), 1000);
+        }
+        CHECK(archive.disk_bytes() <= 32 * 1024);
+
+        // the start is gone, the end still answers
+        std::vector<ArchiveSession> sessions = archive.list_sessions();
+        REQUIRE(sessions.size() == 1);
+        CHECK(sessions[0].first_seq > 1);
+        CHECK(sessions[0].last_seq == 5000);
+        ArchiveQuery q;
+        q.from_seq = 4990;
+        CHECK(archive.query(q).records.size() == 11);
+
+        // a line larger than a segment gets a segment of its own
+        std::string big(10000, 'x');
+        uint64_t seq = archive.append(big, 2000);
+        REQUIRE(seq == 5001);
+        q.from_seq = seq;
+        ArchiveResult r = archive.query(q);
+        REQUIRE(r.records.size() == 1);
+        CHECK(r.records[0].text == big);
+    }
+    remove_archive_dir(dir);
+}
+
+TEST_CASE("archive keeps each line's flags and filters on the level byte") {
+    std::string dir = temp_archive_dir();
+    {
+        OutputArchive archive(dir);
+        REQUIRE(archive.begin_session(1000));
+        archive.append("ok", 1000, 0);
+        archive.append("ERROR: bad", 1000, 2);
+        archive.append("WARNING: meh", 1000, 1);
+        archive.append("ERROR: worse", 1000, 2);
+
+        ArchiveQuery q;
+        q.level_mask = 1u << 2;
+        ArchiveResult r = archive.query(q);
+        REQUIRE(r.records.size() == 2);
+        CHECK(r.records[0].seq == 2);
+        CHECK(r.records[0].flags == 2);
+        CHECK(r.records[1].text == "ERROR: worse");
+
+        q.level_mask = (1u << 1) | (1u << 0);
+        r = archive.query(q);
+        REQUIRE(r.records.size() == 2);
+        CHECK(r.records[1].text == "WARNING: meh");
+    }
+    remove_archive_dir(dir);
+}
@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>
+#include "output_columns.h"
+
+TEST_CASE("output levels round-trip through their names") {
+    for (int i = 0; i < OUTPUT_LEVEL_COUNT; i++) {
+        OutputLevel level;
+        REQUIRE(parse_output_level(output_level_name(static_cast<OutputLevel>(i)), level));
+        CHECK(static_cast<int>(level) == i);
+    }
+    OutputLevel level;
+    CHECK_FALSE(parse_output_level("fatal", level));
+}
+
+TEST_CASE("panel lines are classified by godot's prefixes") {
+    OutputLevel p = OutputLevel::print;
+    CHECK(classify_output_line("hello world", p) == OutputLevel::print);
+    CHECK(classify_output_line("ERROR: Condition \"x\" is true.", p) == OutputLevel::error);
+    CHECK(classify_output_line("SCRIPT ERROR: Invalid call.", p) == OutputLevel::error);
+    CHECK(classify_output_line("USER ERROR: boom", p) == OutputLevel::error);
+    CHECK(classify_output_line("WARNING: deprecated", p) == OutputLevel::warning);
+    CHECK(classify_output_line("USER WARNING: careful", p) == OutputLevel::warning);
+    CHECK(classify_output_line("E 0:00:01:234   _ready: oops", p) == OutputLevel::error);
+    CHECK(classify_output_line("W 0:00:01:234   _ready: hmm", p) == OutputLevel::warning);
+
+    // continuation lines stay with the message above them
+    CHECK(classify_output_line("   at: _ready (res://main.gd:3)", OutputLevel::error) == OutputLevel::error);
+    CHECK(classify_output_line("   <GDScript Source>main.gd:3", OutputLevel::warning) == OutputLevel::warning);
+
+    // a colon alone doesn't make an error
+    CHECK(classify_output_line("Player: took 3 damage, ERROR count 0", p) == OutputLevel::print);
+    CHECK(classify_output_line("at: the start", OutputLevel::error) == OutputLevel::print);
+    CHECK(classify_output_line("", OutputLevel::error) == OutputLevel::print);
+}
+
+static LineMeta meta(OutputLevel level, uint64_t mono_ms, uint64_t frame, int32_t session = -1) {
+    LineMeta m;
+    m.level = level;
+    m.mono_ms = mono_ms;
+    m.capture_frame = frame;
+    m.debug_session = session;
+    return m;
+}
+
+TEST_CASE("columns hand back each line's metadata by seq") {
+    OutputColumns columns;
+    columns.append(1, meta(OutputLevel::print, 0, 5000));
+    columns.append(2, meta(OutputLevel::error, 15, 5001, 0));
+    columns.append(3, meta(OutputLevel::warning, 15, 5001, 0));
+
+    LineMeta m;
+    REQUIRE(columns.get(2, m));
+    CHECK(m.level == OutputLevel::error);
+    CHECK(m.mono_ms == 15);
+    CHECK(m.capture_frame == 5001);
+    CHECK(m.debug_session == 0);
+    REQUIRE(columns.get(1, m));
+    CHECK(m.debug_session == -1);
+    CHECK_FALSE(columns.get(4, m));
+    CHECK_FALSE(columns.get(0, m));
+
+    // a gap starts over
+    columns.append(10, meta(OutputLevel::print, 20, 6000));
+    CHECK(columns.first_seq() == 10);
+    CHECK(columns.size() == 1);
+    CHECK_FALSE(columns.get(2, m));
+}
+
+TEST_CASE("columns evict their oldest rows at the bound") {
+    OutputColumns columns(8);
+    for (uint64_t seq = 1; seq <= 9; seq++) {
+        columns.append(seq, meta(OutputLevel::print, seq, seq, seq < 3 ? -1 : 1));
+    }
+    CHECK(columns.size() == 7);
+    CHECK(columns.first_seq() == 3);
+    LineMeta m;
+    REQUIRE(columns.get(3, m));
+    CHECK(m.debug_session == 1);
+    CHECK(m.capture_frame == 3);
+    REQUIRE(columns.get(9, m));
+    CHECK(m.mono_ms == 9);
+}
+
+TEST_CASE("histogram counts levels per bucket with frame ranges") {
+    OutputColumns columns;
+    uint64_t seq = 1;
+    // second 0: 3 prints; second 1: nothing; second 2: 2 errors, 1 warning
+    for (uint64_t t : {0, 200, 900}) {
+        columns.append(seq++, meta(OutputLevel::print, t, 100 + t / 100));
+    }
+    columns.append(seq++, meta(OutputLevel::error, 2100, 130));
+    columns.append(seq++, meta(OutputLevel::warning, 2500, 131));
+    columns.append(seq++, meta(OutputLevel::error, 2999, 140));
+
+    auto buckets = columns.histogram(0, UINT64_MAX, 1000);
+    REQUIRE(buckets.size() == 2);
+    CHECK(buckets[0].start_ms == 0);
+    CHECK(buckets[0].counts[0] == 3);
+    CHECK(buckets[0].first_capture_frame == 100);
+    CHECK(buckets[0].last_capture_frame == 109);
+    CHECK(buckets[1].start_ms == 2000);
+    CHECK(buckets[1].counts[static_cast<int>(OutputLevel::error)] == 2);
+    CHECK(buckets[1].counts[static_cast<int>(OutputLevel::warning)] == 1);
+    CHECK(buckets[1].last_capture_frame == 140);
+
+    // a time window cuts rows, not just buckets
+    buckets = columns.histogram(2400, 2600, 1000);
+    REQUIRE(buckets.size() == 1);
+    CHECK(buckets[0].counts[static_cast<int>(OutputLevel::warning)] == 1);
+    CHECK(buckets[0].counts[static_cast<int>(OutputLevel::error)] == 0);
+
+    CHECK(columns.histogram(0, 100, 0).empty());
+}
@@ -0,0 +1,45 @@
+#include <doctest/doctest.h>
+#include "output_governor.h"
+
+#include <cstdlib>
+
+TEST_CASE("governor cap comes from GODOT_PEEK_OUTPUT_MAX_LINES") {
+    unsetenv("GODOT_PEEK_OUTPUT_MAX_LINES");
+    CHECK(default_output_max_lines() == OUTPUT_GOVERNOR_DEFAULT_LINES);
+    setenv("GODOT_PEEK_OUTPUT_MAX_LINES", "5000", 1);
+    CHECK(default_output_max_lines() == 5000);
+    setenv("GODOT_PEEK_OUTPUT_MAX_LINES", "0", 1);
+    CHECK(default_output_max_lines() == 0);
+    unsetenv("GODOT_PEEK_OUTPUT_MAX_LINES");
+
+    // a governor nobody configured is off
+    OutputGovernor governor;
+    CHECK(governor.lines_to_trim(1000000) == 0);
+}
+
+TEST_CASE("governor trims down to three quarters of the cap") {
+    OutputGovernor governor;
+    governor.set_max_lines(1000);
+    CHECK(governor.lines_to_trim(999) == 0);
+    CHECK(governor.lines_to_trim(1000) == 0);
+    CHECK(governor.lines_to_trim(1001) == 251);
+    // a flood that overshot by a lot still lands on the same size
+    CHECK(governor.lines_to_trim(50000) == 50000 - 750);
+
+    // tiny caps are raised; 0 switches it off again
+    governor.set_max_lines(5);
+    CHECK(governor.max_lines() == OUTPUT_GOVERNOR_MIN_LINES);
+    governor.set_max_lines(0);
+    CHECK(governor.lines_to_trim(50000) == 0);
+}
+
+TEST_CASE("governor counts trims and says so in the summary") {
+    OutputGovernor governor;
+    governor.set_max_lines(1000);
+    std::string first = governor.record_trim(251);
+    CHECK(first.find("251 older lines") != std::string::npos);
+    std::string second = governor.record_trim(300);
+    CHECK(second.find("(551 so far)") != std::string::npos);
+    CHECK(governor.trimmed_lines() == 551);
+    CHECK(governor.trims() == 2);
+}
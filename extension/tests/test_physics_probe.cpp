@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+#include "physics_probe.h"
+
+using json = nlohmann::json;
+
+// helper: a sample with the given tree pass and engine tick time
+static const PhysicsSample& sample(PhysicsSampleStore& store, int64_t time_ms, TickStats tree = {},
+                                   double physics_ms = -1) {
+    PhysicsServerCounts s2d;
+    PhysicsServerCounts s3d{12, 30, 4};
+    return store.commit(time_ms, 60, tree, physics_ms, s2d, s3d);
+}
+
+TEST_CASE("the tick timer times start-stop pairs and drops stray stops") {
+    PhysicsTickTimer timer;
+    timer.stop(50);
+    timer.start(100);
+    timer.stop(400);
+    timer.start(1000);
+    timer.stop(1100);
+    TickStats stats = timer.take();
+    CHECK(stats.ticks == 2);
+    CHECK(stats.total_us == 400);
+    CHECK(stats.max_us == 300);
+    CHECK(timer.take().ticks == 0);
+}
+
+TEST_CASE("a sample counts bodies per space and processors per script") {
+    PhysicsSampleStore store;
+    store.begin();
+    store.add_body(7, 3, BodyKind::rigid, true, false);
+    store.add_body(7, 3, BodyKind::rigid, false, false);
+    store.add_body(7, 3, BodyKind::rigid, false, true);
+    store.add_body(7, 3, BodyKind::static_body, false, false);
+    store.add_body(3, 2, BodyKind::character, false, false);
+    store.add_body(3, 2, BodyKind::area, false, false);
+    store.add_processor("CharacterBody2D", "res://player.gd");
+    store.add_processor("Node3D", "res://spinner.gd");
+    store.add_processor("Node3D", "res://spinner.gd");
+    const PhysicsSample& s = sample(store, 1000, TickStats{2, 3000, 2000}, 5.0);
+
+    REQUIRE(s.spaces.size() == 2);
+    CHECK(s.spaces[0].space == 3);
+    CHECK(s.spaces[0].dims == 2);
+    CHECK(s.spaces[1].rigid == 3);
+    CHECK(s.spaces[1].rigid_active == 1);
+    CHECK(s.spaces[1].rigid_frozen == 1);
+    CHECK(physics_server_ms(s) == doctest::Approx(3.0));
+
+    json out = physics_sample_json(store, s, 1);
+    CHECK(out["tree"]["avg_ms"] == doctest::Approx(1.5));
+    CHECK(out["server_3d"] == json{{"active_objects", 12}, {"collision_pairs", 30}, {"islands", 4}});
+    CHECK(out["server_2d"]["islands"] == -1);
+    CHECK(out["physics_processing"] == 3);
+    REQUIRE(out["processors"].size() == 1);
+    CHECK(out["processors"][0] == json{{"class", "Node3D"}, {"script", "res://spinner.gd"}, {"nodes", 2}});
+    CHECK(out["spaces"][1]["static"] == 1);
+
+    // the next pass starts empty
+    const PhysicsSample& next = sample(store, 2000);
+    CHECK(next.spaces.empty());
+    CHECK(next.processors.empty());
+    CHECK(physics_server_ms(next) == -1);
+}
+
+TEST_CASE("the series returns what's new, newest last, capped") {
+    PhysicsSampleStore store(3);
+    for (int i = 1; i <= 5; i++) {
+        store.begin();
+        store.add_body(1, 3, BodyKind::rigid, true, false);
+        sample(store, i * 1000, TickStats{1, 1000, 1000}, 2.5);
+    }
+    CHECK(store.all().size() == 3);
+
+    json all = physics_series_json(store, 0, 100);
+    CHECK(all["stored"] == 3);
+    CHECK(all["newest"] == 5);
+    REQUIRE(all["samples"].size() == 3);
+    CHECK(all["samples"][0]["id"] == 3);
+    CHECK(all["samples"][2]["rigid_active"] == 1);
+    CHECK(all["samples"][2]["bodies"] == 1);
+    CHECK(all["samples"][2]["collision_pairs"] == 30);
+    CHECK(all["samples"][2]["server_ms"] == doctest::Approx(1.5));
+
+    json since = physics_series_json(store, 4, 100);
+    REQUIRE(since["samples"].size() == 1);
+    CHECK(since["samples"][0]["id"] == 5);
+    CHECK(physics_series_json(store, 5, 100)["samples"].empty());
+
+    json capped = physics_series_json(store, 0, 2);
+    REQUIRE(capped["samples"].size() == 2);
+    CHECK(capped["samples"][0]["id"] == 4);
+}
@@ -0,0 +1,213 @@
+#include <doctest/doctest.h>
+#include "request_arena.h"
+#include "rpc_dispatcher.h"
+#include "response_encoding.h"
+#include "json_rpc.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using json = nlohmann::json;
+
+// --- allocation counting ---
+
+// replaces global operator new for the whole test runner; only counts while
+// a test has switched it on, on the thread that did
+static uint64_t allocation_count = 0;
+static thread_local bool count_this_thread = false;
+
+// gcc can't see that these replace the global allocator and flags the
+// malloc/free pairing as mismatched
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(std::size_t size) {
+    if (count_this_thread) {
+        allocation_count++;
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#pragma GCC diagnostic pop
+
+// helper: heap allocations made by one call of fn
+template <typename Fn>
+static uint64_t count_allocations(Fn&& fn) {
+    uint64_t before = allocation_count;
+    count_this_thread = true;
+    fn();
+    count_this_thread = false;
+    return allocation_count - before;
+}
+
+// --- RequestArena ---
+
+TEST_CASE("arena allocations are aligned and bump within a block") {
+    RequestArena arena(1024);
+    char* a = static_cast<char*>(arena.allocate(3, 1));
+    void* b = arena.allocate(8, 8);
+    CHECK(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+    CHECK(static_cast<char*>(b) - a < 16);
+    CHECK(arena.used() == 11);
+    CHECK(arena.block_count() == 1);
+}
+
+TEST_CASE("arena spills into new blocks and merges them on reset") {
+    RequestArena arena(256);
+    for (int i = 0; i < 10; i++) {
+        arena.allocate(100);
+    }
+    CHECK(arena.block_count() > 1);
+    size_t grown = arena.capacity();
+
+    arena.reset();
+    CHECK(arena.block_count() == 1);
+    CHECK(arena.capacity() == grown);
+    CHECK(arena.used() == 0);
+
+    // the same request now fits without growing
+    for (int i = 0; i < 10; i++) {
+        arena.allocate(100);
+    }
+    CHECK(arena.block_count() == 1);
+}
+
+TEST_CASE("arena caps the capacity kept after a huge request") {
+    RequestArena arena(1024);
+    arena.allocate(RequestArena::MAX_RETAINED * 2);
+    arena.reset();
+    CHECK(arena.capacity() == RequestArena::MAX_RETAINED);
+}
+
+// --- ArenaScope / ArenaAllocator ---
+
+TEST_CASE("scopes route allocations and reset at the outermost close") {
+    RequestArena arena;
+    CHECK(RequestArena::current() == nullptr);
+    {
+        ArenaScope outer(&arena);
+        CHECK(RequestArena::current() == &arena);
+        arena_json doc = arena_json::parse(R"({"a":[1,2,3],"b":{"c":"d"}})");
+        CHECK(arena.used() > 0);
+        {
+            ArenaScope inner(&arena);
+            arena_json more = {{"x", 1}};
+        }
+        // the inner scope closing must not pull memory out from under doc
+        CHECK(arena.used() > 0);
+        CHECK(doc["b"]["c"] == "d");
+    }
+    CHECK(RequestArena::current() == nullptr);
+    CHECK(arena.used() == 0);
+
+    ArenaScope none(nullptr);
+    CHECK(RequestArena::current() == nullptr);
+}
+
+TEST_CASE("arena_json falls back to the heap outside a scope") {
+    RequestArena arena;
+    arena_json heap_doc = {{"kept", {1, 2, 3}}};
+    {
+        ArenaScope scope(&arena);
+        // heap nodes can be replaced and freed while a scope is open
+        heap_doc["kept"] = "replaced";
+        arena_json copy = heap_doc;
+        CHECK(copy["kept"] == "replaced");
+    }
+    CHECK(heap_doc.dump() == R"({"kept":"replaced"})");
+    CHECK(arena.used() == 0);
+}
+
+TEST_CASE("arena_json converts to and from nlohmann::json") {
+    json plain = {{"a", 1}, {"b", {true, nullptr, "s"}}};
+    arena_json converted = plain;
+    CHECK(converted.dump() == plain.dump());
+    json back = converted;
+    CHECK(back == plain);
+
+    std::string out = "prefix:";
+    append_json(out, converted);
+    CHECK(out == "prefix:" + plain.dump());
+}
+
+// --- dispatcher ---
+
+TEST_CASE("dispatching through an arena gives the same responses") {
+    RequestArena arena(512);  // small so requests spill and merge blocks
+    ResponseEncoder encoder;
+    RpcDispatcher with_arena;
+    RpcDispatcher without;
+    with_arena.set_arena(&arena);
+
+    for (RpcDispatcher* d : {&with_arena, &without}) {
+        d->add("echo", [&encoder, d](int64_t id, const std::string& params_str) {
+            arena_json params = arena_json::parse(params_str, nullptr, false);
+            arena_json result = {{"path", params.value("path", "")}, {"items", params["items"]}};
+            return encoder.encode(id, result, d->context());
+        });
+        d->add("text", [](int64_t id, const std::string&) {
+            return make_result(id, R"({"b":2,"a":1})");
+        });
+    }
+
+    std::string items = "[";
+    for (int i = 0; i < 200; i++) {
+        items += (i ? "," : "") + std::to_string(i);
+    }
+    items += "]";
+    std::vector<std::string> requests = {
+        R"({"id":1,"method":"echo","params":{"path":"/root/Main/Player","items":)" + items + "}}",
+        R"({"id":2,"method":"text"})",
+        R"({"id":3,"method":"missing"})",
+        R"({"id":4,"method":)",
+    };
+    for (int round = 0; round < 3; round++) {
+        for (const std::string& request : requests) {
+            CHECK(with_arena.handle(request) == without.handle(request));
+        }
+        CHECK(arena.used() == 0);
+    }
+    CHECK(arena.block_count() == 1);
+    CHECK(with_arena.handle(requests[1]) == R"({"id":2,"result":{"a":1,"b":2}})");
+}
+
+// the arena only holds DOM nodes. what a ping still takes from the heap in
+// steady state is pinned here so a change either way shows up: the lexer's
+// token buffer growing (5), the parser's state stack and the SAX DOM stack
+// (2), basic_json::destroy's teardown stacks (3) and the response text (1)
+TEST_CASE("ping's remaining heap allocations are pinned") {
+    RequestArena arena;
+    ResponseEncoder encoder;
+    RpcDispatcher dispatcher;
+    dispatcher.add("ping", [&](int64_t id, const std::string&) {
+        return encoder.encode(id, arena_json{{"status", "ok"}}, dispatcher.context());
+    });
+    const std::string request = R"({"id":1,"method":"ping"})";
+
+    std::string response;
+    auto ping = [&] { response = dispatcher.handle(request); };
+
+    dispatcher.set_arena(nullptr);
+    ping();  // warm-up
+    uint64_t heap = count_allocations(ping);
+
+    dispatcher.set_arena(&arena);
+    ping();
+    uint64_t with_arena = count_allocations(ping);
+
+    CHECK(response == R"({"id":1,"result":{"status":"ok"}})");
+    CHECK(with_arena == 11);
+    CHECK(with_arena < heap);
+}
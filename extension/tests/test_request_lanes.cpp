@@ -0,0 +1,231 @@
+#include <doctest/doctest.h>
+#include "request_lanes.h"
+#include "rpc_dispatcher.h"
+#include "socket_server.h"
+#include "server_stats.h"
+#include <nlohmann/json.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+static const char* LANES_SOCK = "/tmp/godot_peek_lanes_test.sock";
+
+// --- peek_method ---
+
+TEST_CASE("peek_method finds the method without parsing") {
+    std::string method;
+    CHECK(peek_method(R"({"id":1,"method":"debug_break"})", method));
+    CHECK(method == "debug_break");
+    CHECK(peek_method(R"({ "method" : "stop_scene", "id": 2 })", method));
+    CHECK(method == "stop_scene");
+
+    // "method" as a value first, then the real key
+    CHECK(peek_method(R"({"params":{"x":"method"},"method":"ping"})", method));
+    CHECK(method == "ping");
+
+    CHECK_FALSE(peek_method(R"({"id":1})", method));
+    CHECK_FALSE(peek_method(R"({"method":12})", method));
+    CHECK_FALSE(peek_method(R"({"method":"a\"b"})", method));
+    CHECK_FALSE(peek_method(R"({"method":"unterminated)", method));
+}
+
+TEST_CASE("dispatcher classifies messages by method") {
+    RpcDispatcher d;
+    d.set_lane("debug_break", Lane::control);
+    d.set_lane("get_screenshot", Lane::bulk);
+    CHECK(d.lane_of(R"({"id":1,"method":"debug_break"})") == Lane::control);
+    CHECK(d.lane_of(R"({"id":1,"method":"get_screenshot"})") == Lane::bulk);
+    CHECK(d.lane_of(R"({"id":1,"method":"get_output"})") == Lane::interactive);
+    CHECK(d.lane_of("not json") == Lane::interactive);
+}
+
+// --- SocketServer ---
+
+static int connect_client(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+static std::string read_all(int fd) {
+    std::string received;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        received.append(buf, static_cast<size_t>(n));
+    }
+    return received;
+}
+
+// ids of the newline-delimited responses, in arrival order
+static std::vector<int> response_ids(const std::string& data) {
+    std::vector<int> ids;
+    size_t start = 0;
+    size_t nl;
+    while ((nl = data.find('\n', start)) != std::string::npos) {
+        ids.push_back(json::parse(data.substr(start, nl - start))["id"].get<int>());
+        start = nl + 1;
+    }
+    return ids;
+}
+
+static std::string request(int id, const char* method) {
+    return "{\"id\":" + std::to_string(id) + ",\"method\":\"" + method + "\"}\n";
+}
+
+// lanes from the method name alone
+static Lane test_lane(const std::string& message) {
+    std::string method;
+    peek_method(message, method);
+    if (method == "stop") return Lane::control;
+    if (method == "dump") return Lane::bulk;
+    return Lane::interactive;
+}
+
+TEST_CASE("control requests run first and bulk work spreads over frames") {
+    unlink(LANES_SOCK);
+    ServerStats stats;
+    SocketServer server;
+    server.set_stats(&stats);
+    server.set_lane_classifier(test_lane);
+    server.set_frame_budget_ns(1);  // one budgeted request per frame
+    REQUIRE(server.start(LANES_SOCK));
+    int fd = connect_client(LANES_SOCK);
+    REQUIRE(fd >= 0);
+
+    std::string batch = request(1, "dump") + request(2, "dump") + request(3, "read") + request(4, "stop");
+    REQUIRE(write(fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size()));
+
+    std::vector<std::string> ran;
+    auto callback = [&](const std::string& msg, RpcContext&) -> std::string {
+        ran.push_back(json::parse(msg)["method"]);
+        return msg;
+    };
+
+    std::string received;
+    for (int i = 0; i < 1000 && response_ids(received).size() < 4; i++) {
+        server.poll(callback);
+        received += read_all(fd);
+        if (i == 0 && !ran.empty()) {
+            // stop plus one budgeted request; the dumps wait for later frames
+            CHECK(ran.size() == 2);
+            CHECK(server.queued() == 2);
+        }
+    }
+    CHECK(ran == std::vector<std::string>{"stop", "read", "dump", "dump"});
+    CHECK(response_ids(received) == std::vector<int>{4, 3, 1, 2});
+    CHECK(stats.lane_latency(Lane::control).count() == 1);
+    CHECK(stats.lane_latency(Lane::bulk).count() == 2);
+    CHECK(json::parse(stats.to_json())["lanes"].contains("interactive"));
+
+    close(fd);
+    server.stop();
+}
+
+TEST_CASE("a control request arriving during bulk work runs at the next checkpoint") {
+    unlink(LANES_SOCK);
+    SocketServer server;
+    server.set_lane_classifier(test_lane);
+    REQUIRE(server.start(LANES_SOCK));
+    int bulk_fd = connect_client(LANES_SOCK);
+    int control_fd = connect_client(LANES_SOCK);
+    REQUIRE(bulk_fd >= 0);
+    REQUIRE(control_fd >= 0);
+
+    std::vector<std::string> ran;
+    bool sent_control = false;
+    auto callback = [&](const std::string& msg, RpcContext&) -> std::string {
+        ran.push_back(json::parse(msg)["method"]);
+        // the control request lands while the first dump is running
+        if (!sent_control) {
+            sent_control = true;
+            std::string stop = request(9, "stop");
+            CHECK(write(control_fd, stop.data(), stop.size()) == static_cast<ssize_t>(stop.size()));
+        }
+        return msg;
+    };
+
+    // let the server accept both before any requests show up
+    server.poll(callback);
+
+    std::string batch = request(1, "dump") + request(2, "dump") + request(3, "dump");
+    REQUIRE(write(bulk_fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size()));
+    for (int i = 0; i < 1000 && ran.size() < 4; i++) {
+        server.poll(callback);
+    }
+    CHECK(ran == std::vector<std::string>{"dump", "stop", "dump", "dump"});
+    std::string control_reply;
+    for (int i = 0; i < 100 && control_reply.empty(); i++) {
+        control_reply = read_all(control_fd);
+        server.poll(callback);
+    }
+    CHECK(response_ids(control_reply) == std::vector<int>{9});
+
+    close(bulk_fd);
+    close(control_fd);
+    server.stop();
+}
+
+TEST_CASE("control responses skip ahead of a deferred response") {
+    unlink(LANES_SOCK);
+    SocketServer server;
+    server.set_lane_classifier(test_lane);
+    REQUIRE(server.start(LANES_SOCK));
+    int fd = connect_client(LANES_SOCK);
+    REQUIRE(fd >= 0);
+
+    std::shared_ptr<DeferredResponse> waiting;
+    auto callback = [&](const std::string& msg, RpcContext& ctx) -> std::string {
+        if (json::parse(msg)["method"] == "dump") {
+            waiting = std::make_shared<DeferredResponse>();
+            ctx.deferred = waiting;
+            return "";
+        }
+        return msg;
+    };
+
+    std::string first = request(1, "dump");
+    REQUIRE(write(fd, first.data(), first.size()) == static_cast<ssize_t>(first.size()));
+    for (int i = 0; i < 200 && !waiting; i++) {
+        server.poll(callback);
+    }
+    REQUIRE(waiting);
+
+    std::string batch = request(2, "read") + request(3, "stop");
+    REQUIRE(write(fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size()));
+
+    std::string received;
+    for (int i = 0; i < 200 && received.empty(); i++) {
+        server.poll(callback);
+        received += read_all(fd);
+    }
+    // stop answers at once; read keeps its place behind the waiting dump
+    CHECK(response_ids(received) == std::vector<int>{3});
+
+    waiting->response = R"({"id":1,"result":true})";
+    waiting->done = true;
+    for (int i = 0; i < 200 && response_ids(received).size() < 3; i++) {
+        server.poll(callback);
+        received += read_all(fd);
+    }
+    CHECK(response_ids(received) == std::vector<int>{3, 1, 2});
+
+    close(fd);
+    server.stop();
+}
@@ -0,0 +1,127 @@
+#include <doctest/doctest.h>
+#include "response_cache.h"
+#include "response_encoding.h"
+#include "rpc_dispatcher.h"
+#include "server_stats.h"
+#include "json_rpc.h"
+
+using json = nlohmann::json;
+
+// --- ResponseCache ---
+
+TEST_CASE("cache entries live until the revision changes") {
+    ResponseCache cache;
+    std::string key = ResponseCache::key("get_debugger_errors", "{}", CONTENT_JSON);
+    CHECK(cache.find(key, 0) == nullptr);
+
+    cache.store(key, "{\"errors\":\"\"}", 100);
+    REQUIRE(cache.find(key, 200) != nullptr);
+    CHECK(*cache.find(key, 200) == "{\"errors\":\"\"}");
+
+    cache.bump();
+    CHECK(cache.find(key, 200) == nullptr);
+}
+
+TEST_CASE("cache entries expire after max_age") {
+    ResponseCache cache(1000);
+    std::string key = ResponseCache::key("m", "{}", CONTENT_JSON);
+    cache.store(key, "1", 5000);
+    CHECK(cache.find(key, 6000) != nullptr);
+    CHECK(cache.find(key, 6001) == nullptr);
+}
+
+TEST_CASE("cache keys separate params and encodings") {
+    CHECK(ResponseCache::key("m", "{}", CONTENT_JSON) != ResponseCache::key("m", "{}", CONTENT_MSGPACK));
+    CHECK(ResponseCache::key("m", "{\"a\":1}", CONTENT_JSON) != ResponseCache::key("m", "{}", CONTENT_JSON));
+    CHECK(ResponseCache::key("ab", "{}", CONTENT_JSON) != ResponseCache::key("a", "b{}", CONTENT_JSON));
+}
+
+TEST_CASE("cache stays bounded") {
+    ResponseCache cache;
+    bool bounded = true;
+    for (size_t i = 0; i < ResponseCache::MAX_ENTRIES * 3; i++) {
+        cache.store(ResponseCache::key("m", std::to_string(i), CONTENT_JSON), "x", 0);
+        bounded = bounded && cache.size() <= ResponseCache::MAX_ENTRIES;
+    }
+    CHECK(bounded);
+}
+
+// --- dispatcher integration ---
+
+TEST_CASE("dispatcher serves cached reads until an invalidating call") {
+    RpcDispatcher dispatcher;
+    ResponseCache cache;
+    ServerStats stats;
+    dispatcher.set_cache(&cache);
+    dispatcher.set_stats(&stats);
+
+    int reads = 0;
+    ResponseEncoder encoder;
+    dispatcher.add("read", [&](int64_t id, const std::string&) {
+        reads++;
+        return encoder.encode(id, json{{"reads", reads}}, dispatcher.context());
+    }, CachePolicy::cached);
+    dispatcher.add("write", [](int64_t id, const std::string&) { return make_result(id, "{}"); },
+                   CachePolicy::invalidates);
+    dispatcher.add("ping", [](int64_t id, const std::string&) { return make_result(id, "{}"); });
+
+    CHECK(dispatcher.handle(R"({"id":1,"method":"read"})") == R"({"id":1,"result":{"reads":1}})");
+    // same call, new id: served from the cache
+    CHECK(dispatcher.handle(R"({"id":2,"method":"read"})") == R"({"id":2,"result":{"reads":1}})");
+    CHECK(reads == 1);
+
+    // different params are a different entry
+    dispatcher.handle(R"({"id":3,"method":"read","params":{"x":1}})");
+    CHECK(reads == 2);
+
+    // uncached methods leave the cache alone
+    dispatcher.handle(R"({"id":4,"method":"ping"})");
+    CHECK(dispatcher.handle(R"({"id":5,"method":"read"})") == R"({"id":5,"result":{"reads":1}})");
+
+    dispatcher.handle(R"({"id":6,"method":"write"})");
+    CHECK(dispatcher.handle(R"({"id":7,"method":"read"})") == R"({"id":7,"result":{"reads":3}})");
+
+    json s = json::parse(stats.to_json());
+    CHECK(s["cache"]["hits"] == 2);
+    CHECK(s["cache"]["misses"] == 3);
+    CHECK(s["methods"]["read"]["cache"]["hits"] == 2);
+    CHECK(s["methods"]["read"]["calls"] == 5);
+    CHECK_FALSE(s["methods"]["ping"].contains("cache"));
+}
+
+TEST_CASE("dispatcher caches per encoding and skips errors") {
+    RpcDispatcher dispatcher;
+    ResponseCache cache;
+    dispatcher.set_cache(&cache);
+
+    int reads = 0;
+    bool fail = true;
+    ResponseEncoder encoder;
+    dispatcher.add("read", [&](int64_t id, const std::string&) {
+        reads++;
+        if (fail) {
+            return make_error(id, -32000, "not ready");
+        }
+        return encoder.encode(id, json{{"ok", true}}, dispatcher.context());
+    }, CachePolicy::cached);
+
+    // errors are never stored
+    dispatcher.handle(R"({"id":1,"method":"read"})");
+    dispatcher.handle(R"({"id":2,"method":"read"})");
+    CHECK(reads == 2);
+
+    fail = false;
+    RpcContext packed;
+    packed.encoding = CONTENT_MSGPACK;
+    dispatcher.handle(R"({"id":3,"method":"read"})", &packed);
+    RpcContext again;
+    again.encoding = CONTENT_MSGPACK;
+    std::string hit = dispatcher.handle(R"({"id":4,"method":"read"})", &again);
+    CHECK(reads == 3);
+    CHECK(again.response_type == CONTENT_MSGPACK);
+    CHECK(hit == encode_result(4, json{{"ok", true}}, CONTENT_MSGPACK));
+
+    // a JSON connection doesn't get the msgpack entry
+    CHECK(dispatcher.handle(R"({"id":5,"method":"read"})") == R"({"id":5,"result":{"ok":true}})");
+    CHECK(reads == 4);
+}
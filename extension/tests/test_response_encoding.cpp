@@ -0,0 +1,105 @@
+#include <doctest/doctest.h>
+#include "response_encoding.h"
+#include "json_rpc.h"
+#include "server_stats.h"
+
+using json = nlohmann::json;
+
+static json sample_result() {
+    return {
+        {"tree", "root (Window)\n  Main (Node2D)\n"},
+        {"length", 30},
+        {"properties", {{{"name", "position"}, {"value", "(1, 2)"}}, {{"name", "visible"}, {"value", "true"}}}},
+        {"ratio", 0.25},
+        {"pending", false}
+    };
+}
+
+TEST_CASE("encode_result JSON matches make_result") {
+    json result = sample_result();
+    CHECK(encode_result(42, result, CONTENT_JSON) == make_result(42, result.dump()));
+    CHECK(encode_result(-1, json::object(), CONTENT_JSON) == make_result(-1, "{}"));
+}
+
+TEST_CASE("encode_result binary encodings decode to the same response") {
+    json result = sample_result();
+    json expected = json::parse(make_result(7, result.dump()));
+
+    std::string packed = encode_result(7, result, CONTENT_MSGPACK);
+    CHECK(json::from_msgpack(packed) == expected);
+    CHECK(packed.size() < make_result(7, result.dump()).size());
+
+    // byte-identical to encoding the whole envelope
+    std::string whole;
+    json::to_msgpack(expected, whole);
+    CHECK(packed == whole);
+
+    std::string cbor = encode_result(7, result, CONTENT_CBOR);
+    CHECK(json::from_cbor(cbor) == expected);
+    whole.clear();
+    json::to_cbor(expected, whole);
+    CHECK(cbor == whole);
+}
+
+TEST_CASE("transcode_response re-encodes text responses") {
+    std::string text = make_error(3, -32000, "boom");
+    std::string out;
+    REQUIRE(transcode_response(text, CONTENT_MSGPACK, out));
+    CHECK(json::from_msgpack(out)["error"]["message"] == "boom");
+    REQUIRE(transcode_response(text, CONTENT_CBOR, out));
+    CHECK(json::from_cbor(out)["id"] == 3);
+    CHECK_FALSE(transcode_response("{broken", CONTENT_MSGPACK, out));
+}
+
+TEST_CASE("ResponseEncoder follows the context and records stats") {
+    ServerStats stats;
+    ResponseEncoder encoder;
+    encoder.set_stats(&stats);
+    json result = sample_result();
+
+    // no context: JSON text
+    CHECK(encoder.encode(1, result, nullptr) == make_result(1, result.dump()));
+
+    RpcContext ctx;
+    ctx.encoding = CONTENT_MSGPACK;
+    for (uint32_t i = 0; i < ResponseEncoder::COMPARE_EVERY * 2; i++) {
+        std::string out = encoder.encode(2, result, &ctx);
+        CHECK(ctx.response_type == CONTENT_MSGPACK);
+        CHECK(json::from_msgpack(out)["id"] == 2);
+    }
+
+    const auto& enc = stats.encodings();
+    REQUIRE(enc.count("json") == 1);
+    REQUIRE(enc.count("msgpack") == 1);
+    CHECK(enc.at("json").responses == 1);
+    CHECK(enc.at("msgpack").responses == ResponseEncoder::COMPARE_EVERY * 2);
+    CHECK(enc.at("msgpack").samples == 2);
+    CHECK(enc.at("msgpack").sample_bytes < enc.at("msgpack").sample_json_bytes);
+
+    json snap = json::parse(stats.to_json());
+    CHECK(snap["encodings"]["msgpack"]["vs_json"]["size_ratio"].get<double>() < 1.0);
+    CHECK_FALSE(snap["encodings"]["json"].contains("vs_json"));
+
+    stats.reset();
+    CHECK(stats.encodings().empty());
+}
+
+TEST_CASE("extract_result and wrap_result round-trip every encoding") {
+    json result = sample_result();
+    for (uint8_t type : {CONTENT_JSON, CONTENT_MSGPACK, CONTENT_CBOR}) {
+        std::string response = encode_result(9, result, type);
+        std::string body;
+        REQUIRE(extract_result(response, 9, type, body));
+        CHECK(wrap_result(9, body, type) == response);
+        CHECK(wrap_result(-300, body, type) == encode_result(-300, result, type));
+
+        // wrong id or encoding doesn't match
+        CHECK_FALSE(extract_result(response, 10, type, body));
+    }
+
+    // text results from make_result work too; errors don't
+    std::string body;
+    REQUIRE(extract_result(make_result(3, R"({"b":1,"a":[1,2]})"), 3, CONTENT_JSON, body));
+    CHECK(body == R"({"a":[1,2],"b":1})");
+    CHECK_FALSE(extract_result(make_error(3, -32000, "boom"), 3, CONTENT_JSON, body));
+}
@@ -0,0 +1,128 @@
+#include <doctest/doctest.h>
+#include "rpc_dispatcher.h"
+#include "server_stats.h"
+#include "json_rpc.h"
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// --- parse_request ---
+
+TEST_CASE("parse_request extracts id, method and params") {
+    RpcRequest req;
+    std::string err;
+    REQUIRE(parse_request(R"({"id":7,"method":"run_scene","params":{"path":"res://a.tscn"}})", req, err));
+    CHECK(req.id == 7);
+    CHECK(req.method == "run_scene");
+    CHECK(json::parse(req.params_str)["path"] == "res://a.tscn");
+}
+
+TEST_CASE("parse_request defaults params to empty object") {
+    RpcRequest req;
+    std::string err;
+    REQUIRE(parse_request(R"({"id":1,"method":"ping","params":[1,2]})", req, err));
+    CHECK(req.params_str == "{}");
+}
+
+TEST_CASE("parse_request accepts float ids") {
+    RpcRequest req;
+    std::string err;
+    REQUIRE(parse_request(R"({"id":3.0,"method":"ping"})", req, err));
+    CHECK(req.id == 3);
+}
+
+TEST_CASE("parse_request rejects malformed JSON") {
+    RpcRequest req;
+    std::string err;
+    CHECK_FALSE(parse_request("{not json", req, err));
+    auto j = json::parse(err);
+    CHECK(j["id"].is_null());
+    CHECK(j["error"]["code"] == -32700);
+}
+
+TEST_CASE("parse_request rejects missing method") {
+    RpcRequest req;
+    std::string err;
+    CHECK_FALSE(parse_request(R"({"id":4,"method":12})", req, err));
+    auto j = json::parse(err);
+    CHECK(j["id"] == 4);
+    CHECK(j["error"]["code"] == -32600);
+}
+
+// --- RpcDispatcher ---
+
+TEST_CASE("dispatcher routes to the registered handler") {
+    RpcDispatcher d;
+    d.add("echo", [](int64_t id, const std::string& params) { return make_result(id, params); });
+    d.add("ping", [](int64_t id, const std::string&) { return make_result(id, R"({"pong":true})"); });
+    CHECK(d.has("echo"));
+    CHECK_FALSE(d.has("missing"));
+
+    auto j = json::parse(d.handle(R"({"id":2,"method":"echo","params":{"x":1}})"));
+    CHECK(j["id"] == 2);
+    CHECK(j["result"]["x"] == 1);
+
+    j = json::parse(d.handle(R"({"id":3,"method":"ping"})"));
+    CHECK(j["result"]["pong"] == true);
+}
+
+TEST_CASE("dispatcher replaces a handler on re-registration") {
+    RpcDispatcher d;
+    d.add("m", [](int64_t id, const std::string&) { return make_result(id, R"({"v":1})"); });
+    d.add("m", [](int64_t id, const std::string&) { return make_result(id, R"({"v":2})"); });
+    CHECK(json::parse(d.handle(R"({"id":1,"method":"m"})"))["result"]["v"] == 2);
+}
+
+TEST_CASE("dispatcher reports unknown methods") {
+    RpcDispatcher d;
+    auto j = json::parse(d.handle(R"({"id":5,"method":"nope"})"));
+    CHECK(j["id"] == 5);
+    CHECK(j["error"]["code"] == -32601);
+    CHECK(j["error"]["message"] == "Method not found: nope");
+}
+
+TEST_CASE("dispatcher records stats per method") {
+    ServerStats stats;
+    RpcDispatcher d;
+    d.set_stats(&stats);
+    d.add("ok", [](int64_t id, const std::string&) { return make_result(id, "{}"); });
+    d.add("fail", [](int64_t id, const std::string&) { return make_error(id, -32000, "boom"); });
+
+    d.handle(R"({"id":1,"method":"ok"})");
+    d.handle(R"({"id":2,"method":"ok"})");
+    d.handle(R"({"id":3,"method":"fail"})");
+    d.handle(R"({"id":4,"method":"unknown_a"})");
+    d.handle(R"({"id":5,"method":"unknown_b"})");
+    d.handle("garbage");
+
+    json snap = json::parse(stats.to_json());
+    CHECK(snap["requests"] == 6);
+    CHECK(snap["errors"] == 4);
+    CHECK(snap["methods"]["ok"]["calls"] == 2);
+    CHECK(snap["methods"]["ok"]["errors"] == 0);
+    CHECK(snap["methods"]["fail"]["errors"] == 1);
+    CHECK(snap["methods"]["(unknown_method)"]["calls"] == 2);
+    CHECK(snap["methods"]["(invalid_request)"]["calls"] == 1);
+    CHECK_FALSE(snap["methods"].contains("unknown_a"));
+}
+
+TEST_CASE("parse_request rejects deeply nested input") {
+    RpcRequest req;
+    std::string err;
+    std::string deep = R"({"id":1,"method":"ping","params":{"a":)" + std::string(100000, '[') +
+                       std::string(100000, ']') + "}}";
+    CHECK_FALSE(parse_request(deep, req, err));
+    CHECK(json::parse(err)["error"]["code"] == -32600);
+
+    // brackets inside strings don't count
+    std::string quoted = R"({"id":1,"method":"ping","params":{"s":")" + std::string(1000, '[') + R"(\"{"}})";
+    CHECK(parse_request(quoted, req, err));
+    CHECK(json::parse(req.params_str)["s"].get<std::string>().size() == 1002);
+}
+
+TEST_CASE("parse_request ignores out-of-range float ids") {
+    RpcRequest req;
+    std::string err;
+    REQUIRE(parse_request(R"({"id":1e300,"method":"ping"})", req, err));
+    CHECK(req.id == 0);
+}
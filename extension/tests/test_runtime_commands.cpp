@@ -0,0 +1,90 @@
+#include <doctest/doctest.h>
+#include "runtime_commands.h"
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+TEST_CASE("game socket sits next to the editor socket") {
+    CHECK(game_socket_path("/tmp/godot-peek-foo.sock") == "/tmp/godot-peek-foo-game.sock");
+    CHECK(game_socket_path("/tmp/peek") == "/tmp/peek-game.sock");
+}
+
+TEST_CASE("datagram becomes a JSON-RPC request") {
+    std::string cmd;
+    std::string request;
+    std::string error;
+    REQUIRE(datagram_to_request(R"({"cmd":"evaluate","expression":"1+1"})", 7, cmd, request, error));
+    CHECK(cmd == "evaluate");
+    json r = json::parse(request);
+    CHECK(r["id"] == 7);
+    CHECK(r["method"] == "evaluate");
+    CHECK(r["params"] == json{{"expression", "1+1"}});
+
+    CHECK_FALSE(datagram_to_request("not json", 1, cmd, request, error));
+    CHECK(error == "parse error");
+    CHECK_FALSE(datagram_to_request(R"({"expression":"1"})", 1, cmd, request, error));
+    CHECK(error == "unknown command: ");
+}
+
+TEST_CASE("JSON-RPC response becomes the udp reply") {
+    CHECK(json::parse(response_to_datagram(R"({"id":1,"result":{"path":"/tmp/x.png"}})", "screenshot")) ==
+          json{{"path", "/tmp/x.png"}});
+    CHECK(json::parse(response_to_datagram(R"({"id":1,"error":{"code":-32000,"message":"boom"}})", "evaluate")) ==
+          json{{"error", "boom"}});
+    CHECK(json::parse(response_to_datagram("garbage", "evaluate")) == json{{"error", "invalid response"}});
+    // worded like the gdscript helper, not the dispatcher
+    CHECK(json::parse(response_to_datagram(R"({"id":1,"error":{"code":-32601,"message":"Method not found: dance"}})",
+                                           "dance")) == json{{"error", "unknown command: dance"}});
+}
+
+TEST_CASE("input commands decode per type") {
+    InputCommand cmd;
+    std::string error;
+
+    REQUIRE(parse_input_command(json{{"type", "action"}, {"action", "jump"}, {"pressed", false}, {"strength", 0.5}}, cmd, error));
+    CHECK(cmd.kind == InputKind::action);
+    CHECK(cmd.action == "jump");
+    CHECK_FALSE(cmd.pressed);
+    CHECK(cmd.strength == doctest::Approx(0.5));
+
+    REQUIRE(parse_input_command(json{{"type", "key"}, {"keycode", "KEY_ESC"}}, cmd, error));
+    CHECK(cmd.kind == InputKind::key);
+    CHECK(cmd.key == "Escape");
+    CHECK(cmd.pressed);
+    REQUIRE(parse_input_command(json{{"type", "key"}, {"keycode", 87}}, cmd, error));
+    CHECK(cmd.keycode == 87);
+    CHECK(cmd.key.empty());
+
+    REQUIRE(parse_input_command(json{{"type", "mouse_button"}, {"button", "right"}, {"position", {10, 20}}}, cmd, error));
+    CHECK(cmd.kind == InputKind::mouse_button);
+    CHECK(cmd.button == 2);
+    CHECK(cmd.x == doctest::Approx(10));
+    CHECK(cmd.y == doctest::Approx(20));
+
+    REQUIRE(parse_input_command(json{{"type", "mouse_motion"}, {"relative", {3, -4}}}, cmd, error));
+    CHECK(cmd.kind == InputKind::mouse_motion);
+    CHECK(cmd.rel_x == doctest::Approx(3));
+    CHECK(cmd.rel_y == doctest::Approx(-4));
+
+    CHECK_FALSE(parse_input_command(json{{"type", "gamepad"}}, cmd, error));
+    CHECK(error == "unknown input type: gamepad");
+}
+
+TEST_CASE("key names and mouse buttons") {
+    CHECK(normalize_key_name("KEY_W") == "W");
+    CHECK(normalize_key_name("key_return") == "Enter");
+    CHECK(normalize_key_name("control") == "Ctrl");
+    CHECK(normalize_key_name("Ctrl+S") == "Ctrl+S");
+
+    CHECK(mouse_button_index("left") == 1);
+    CHECK(mouse_button_index("WHEEL_DOWN") == 5);
+    CHECK(mouse_button_index("7") == 7);
+    CHECK(mouse_button_index("thumb") == 1);
+}
+
+TEST_CASE("evaluate wraps the expression in _eval") {
+    CHECK(evaluate_source("get_tree().root.name") == "extends Node\n\nfunc _eval():\n\treturn get_tree().root.name\n");
+    CHECK(evaluate_source("return 1") == "extends Node\n\nfunc _eval():\n\treturn 1\n");
+    CHECK(evaluate_source("var a = 2\nreturn a * 3") == "extends Node\n\nfunc _eval():\n\tvar a = 2\n\treturn a * 3\n");
+}
@@ -0,0 +1,184 @@
+#include <doctest/doctest.h>
+#include "server_stats.h"
+#include "socket_server.h"
+#include "json_rpc.h"
+#include <nlohmann/json.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <vector>
+
+using json = nlohmann::json;
+
+static const char* STATS_SOCK = "/tmp/godot_peek_stats_test.sock";
+
+// --- LatencyHistogram ---
+
+TEST_CASE("histogram empty") {
+    LatencyHistogram h;
+    CHECK(h.count() == 0);
+    CHECK(h.min() == 0);
+    CHECK(h.max() == 0);
+    CHECK(h.percentile(50) == 0);
+}
+
+TEST_CASE("histogram small values are exact") {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 10; v++) {
+        h.record(v);
+    }
+    CHECK(h.count() == 10);
+    CHECK(h.min() == 1);
+    CHECK(h.max() == 10);
+    CHECK(h.percentile(50) == 5);
+    CHECK(h.percentile(100) == 10);
+    CHECK(h.mean() == doctest::Approx(5.5));
+}
+
+TEST_CASE("histogram bucket precision") {
+    // every bucket must contain its lower bound and stay within ~3% width
+    for (uint64_t v : std::vector<uint64_t>{33, 1000, 123456, 987654321, 1ull << 40, UINT64_MAX}) {
+        size_t idx = LatencyHistogram::bucket_index(v);
+        REQUIRE(idx < LatencyHistogram::BUCKET_COUNT);
+        CHECK(LatencyHistogram::bucket_lower(idx) <= v);
+        CHECK(LatencyHistogram::bucket_upper(idx) >= v);
+        double width = static_cast<double>(LatencyHistogram::bucket_upper(idx) - LatencyHistogram::bucket_lower(idx));
+        CHECK(width / static_cast<double>(v) < 0.04);
+    }
+}
+
+TEST_CASE("histogram percentiles on a uniform range") {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100000; v++) {
+        h.record(v * 1000);
+    }
+    CHECK(h.percentile(50) == doctest::Approx(50000000.0).epsilon(0.02));
+    CHECK(h.percentile(99) == doctest::Approx(99000000.0).epsilon(0.02));
+    CHECK(h.percentile(100) == 100000000);
+}
+
+TEST_CASE("histogram merge and reset") {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    b.record(20);
+    b.record(30);
+    a.merge(b);
+    CHECK(a.count() == 3);
+    CHECK(a.min() == 10);
+    CHECK(a.max() == 30);
+
+    a.reset();
+    CHECK(a.count() == 0);
+    CHECK(a.percentile(99) == 0);
+}
+
+// --- ServerStats ---
+
+TEST_CASE("stats record requests per method") {
+    ServerStats stats;
+    stats.record_request("ping", 1000, 30, 40, false);
+    stats.record_request("ping", 3000, 30, 40, false);
+    stats.record_request("get_output", 5000, 50, 900, true);
+
+    json snap = json::parse(stats.to_json());
+    CHECK(snap["requests"] == 3);
+    CHECK(snap["errors"] == 1);
+    CHECK(snap["methods"]["ping"]["calls"] == 2);
+    CHECK(snap["methods"]["ping"]["bytes_out"] == 80);
+    CHECK(snap["methods"]["get_output"]["errors"] == 1);
+    CHECK(snap["handler_us"]["count"] == 3);
+    CHECK(snap["handler_us"]["max"] == doctest::Approx(5.0));
+}
+
+TEST_CASE("stats reset keeps live clients") {
+    ServerStats stats;
+    stats.record_connect(1);
+    stats.record_connect(2);
+    stats.record_read(1, 100);
+    stats.record_disconnect(2);
+    stats.record_request("ping", 1000, 10, 10, false);
+
+    stats.reset();
+
+    json snap = json::parse(stats.to_json());
+    CHECK(snap["requests"] == 0);
+    CHECK(snap["methods"].empty());
+    REQUIRE(snap["clients"].size() == 1);
+    CHECK(snap["clients"][0]["id"] == 1);
+    CHECK(snap["clients"][0]["bytes_in"] == 0);
+    CHECK(snap["closed_clients"]["count"] == 0);
+}
+
+TEST_CASE("disconnected clients fold into the closed totals") {
+    ServerStats stats;
+    stats.record_connect(1);
+    stats.record_connect(2);
+    stats.record_read(1, 100);
+    stats.record_read(2, 40);
+    stats.record_queue_wait(2, 1000);
+    stats.record_send(2, 60, 1000);
+    stats.record_disconnect(2);
+
+    // reports for a client that is already gone don't recreate it
+    stats.record_send(2, 60, 1000);
+
+    REQUIRE(stats.clients().size() == 1);
+    CHECK(stats.clients().count(2) == 0);
+    json snap = json::parse(stats.to_json());
+    CHECK(snap["closed_clients"]["count"] == 1);
+    CHECK(snap["closed_clients"]["bytes_in"] == 40);
+    CHECK(snap["closed_clients"]["bytes_out"] == 60);
+    CHECK(snap["closed_clients"]["messages_in"] == 1);
+    CHECK(snap["closed_clients"]["messages_out"] == 1);
+    CHECK(snap["bytes_in"] == 140);
+    CHECK(snap["bytes_out"] == 60);
+}
+
+TEST_CASE("is_error_response") {
+    CHECK(is_error_response(make_error(1, -32000, "boom")));
+    CHECK(is_error_response(R"({"id":null,"error":{"code":-32700,"message":"Parse error"}})"));
+    CHECK_FALSE(is_error_response(make_result(1, R"({"error":"not an rpc error"})")));
+}
+
+// --- socket server integration ---
+
+TEST_CASE("socket server records bytes and timings") {
+    unlink(STATS_SOCK);
+    ServerStats stats;
+    SocketServer server;
+    server.set_stats(&stats);
+    REQUIRE(server.start(STATS_SOCK));
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, STATS_SOCK, sizeof(addr.sun_path) - 1);
+    REQUIRE(connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0);
+
+    std::string req = "{\"id\":1}\n{\"id\":2}\n";
+    write(fd, req.c_str(), req.size());
+
+    server.poll([](const std::string&) -> std::string { return "{\"ok\":true}"; });
+
+    CHECK(stats.queue_wait().count() == 2);
+    CHECK(stats.send_time().count() == 2);
+    REQUIRE(stats.clients().size() == 1);
+    const ClientStats& c = stats.clients().begin()->second;
+    CHECK(c.bytes_in == req.size());
+    CHECK(c.bytes_out == 2 * std::string("{\"ok\":true}\n").size());
+    CHECK(c.messages_in == 2);
+    CHECK(c.messages_out == 2);
+
+    close(fd);
+    server.poll([](const std::string&) -> std::string { return ""; });
+    CHECK(stats.clients().empty());
+    CHECK(stats.closed_client_count() == 1);
+    CHECK(stats.closed_clients().bytes_in == req.size());
+
+    server.stop();
+}
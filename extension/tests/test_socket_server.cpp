@@ -1,9 +1,14 @@
 #include <doctest/doctest.h>
 #include "socket_server.h"
+#include "frame_codec.h"
+#include "compression.h"
+#include "server_stats.h"
+#include <nlohmann/json.hpp>
 
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -263,3 +268,241 @@ TEST_CASE("multiple messages in single read") {
     close(client_fd);
     server.stop();
 }
+
+// --- large responses ---
+
+TEST_CASE("large response survives a full socket buffer") {
+    unlink(TEST_SOCK);
+    SocketServer server;
+    REQUIRE(server.start(TEST_SOCK));
+
+    int client_fd = connect_client(TEST_SOCK);
+    REQUIRE(client_fd >= 0);
+    fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL, 0) | O_NONBLOCK);
+
+    // far bigger than a unix socket buffer, so send() must go partial
+    std::string big(4 * 1024 * 1024, 'x');
+    send_str(client_fd, "{\"id\":1}\n");
+
+    auto callback = [&](const std::string&) -> std::string { return big; };
+
+    std::string received;
+    for (int attempt = 0; attempt < 10000 && received.size() < big.size() + 1; attempt++) {
+        server.poll(callback);
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(client_fd, buf, sizeof(buf))) > 0) {
+            received.append(buf, static_cast<size_t>(n));
+        }
+    }
+
+    REQUIRE(received.size() == big.size() + 1);
+    CHECK(received.back() == '\n');
+    CHECK(received.compare(0, big.size(), big) == 0);
+
+    close(client_fd);
+    server.stop();
+}
+
+// --- binary framing ---
+
+// helper: poll until the client has received at least want bytes
+static std::string poll_until(SocketServer& server, int fd, size_t want,
+                              const SocketServer::ContextCallback& callback) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    std::string received;
+    for (int attempt = 0; attempt < 1000 && received.size() < want; attempt++) {
+        server.poll(callback);
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            received.append(buf, static_cast<size_t>(n));
+        }
+    }
+    return received;
+}
+
+TEST_CASE("binary framing negotiated by handshake") {
+    unlink(TEST_SOCK);
+    SocketServer server;
+    REQUIRE(server.start(TEST_SOCK));
+
+    int client_fd = connect_client(TEST_SOCK);
+    REQUIRE(client_fd >= 0);
+
+    // handshake and the first frame arrive in the same read
+    std::string out = "{\"id\":1,\"method\":\"negotiate\",\"params\":{\"framing\":\"binary\"}}\n";
+    append_frame(out, CONTENT_JSON, 0, std::string("{\"id\":2,\"method\":\"shot\"}"));
+    send_str(client_fd, out);
+
+    std::vector<std::string> received;
+    std::string png("\x89PNG\r\n\x1a\n\0\0", 10);
+    auto callback = [&](const std::string& msg, RpcContext& ctx) -> std::string {
+        received.push_back(msg);
+        CHECK(ctx.binary_frames);
+        ctx.attachments.push_back(png);
+        return "{\"id\":2,\"result\":{\"attachment\":0}}";
+    };
+
+    std::string reply = "{\"id\":2,\"result\":{\"attachment\":0}}";
+    size_t want = FRAME_HEADER_SIZE * 2 + reply.size() + png.size();
+    std::string data = poll_until(server, client_fd, want, callback);
+
+    // the handshake reply is the last newline-framed message
+    size_t nl = data.find('\n');
+    REQUIRE(nl != std::string::npos);
+    CHECK(nlohmann::json::parse(data.substr(0, nl))["result"]["framing"] == "binary");
+
+    FrameDecoder decoder;
+    decoder.append(data.data() + nl + 1, data.size() - nl - 1);
+    Frame f;
+    REQUIRE(decoder.next(f));
+    CHECK(f.content_type == CONTENT_JSON);
+    CHECK(f.flags == FRAME_FLAG_MORE);
+    CHECK(f.payload == reply);
+    REQUIRE(decoder.next(f));
+    CHECK(f.content_type == CONTENT_BINARY);
+    CHECK(f.flags == 0);
+    CHECK(f.payload == png);
+
+    REQUIRE(received.size() == 1);
+    CHECK(received[0] == "{\"id\":2,\"method\":\"shot\"}");
+
+    close(client_fd);
+    server.stop();
+}
+
+TEST_CASE("newline framing ignores attachments and late handshakes") {
+    unlink(TEST_SOCK);
+    SocketServer server;
+    REQUIRE(server.start(TEST_SOCK));
+
+    int client_fd = connect_client(TEST_SOCK);
+    REQUIRE(client_fd >= 0);
+
+    // negotiate is only interpreted as the first message
+    send_str(client_fd, "{\"id\":1,\"method\":\"ping\"}\n{\"id\":2,\"method\":\"negotiate\",\"params\":{\"framing\":\"binary\"}}\n");
+
+    std::vector<std::string> received;
+    auto callback = [&](const std::string& msg, RpcContext& ctx) -> std::string {
+        received.push_back(msg);
+        CHECK_FALSE(ctx.binary_frames);
+        ctx.attachments.push_back("ignored");
+        return "{\"id\":1,\"result\":{}}";
+    };
+
+    std::string data = poll_until(server, client_fd, 2 * 21, callback);
+    CHECK(data == "{\"id\":1,\"result\":{}}\n{\"id\":1,\"result\":{}}\n");
+    CHECK(received.size() == 2);
+
+    close(client_fd);
+    server.stop();
+}
+
+TEST_CASE("msgpack connections get binary responses") {
+    unlink(TEST_SOCK);
+    SocketServer server;
+    REQUIRE(server.start(TEST_SOCK));
+
+    int client_fd = connect_client(TEST_SOCK);
+    REQUIRE(client_fd >= 0);
+
+    std::string out = "{\"id\":1,\"method\":\"negotiate\",\"params\":{\"framing\":\"binary\",\"encoding\":\"msgpack\"}}\n";
+    append_frame(out, CONTENT_JSON, 0, std::string("{\"id\":2,\"method\":\"text\"}"));
+    send_str(client_fd, out);
+
+    // the handler returns JSON text; the transport transcodes it
+    auto callback = [&](const std::string&, RpcContext& ctx) -> std::string {
+        CHECK(ctx.encoding == CONTENT_MSGPACK);
+        return "{\"id\":2,\"result\":{\"ok\":true}}";
+    };
+
+    std::string data;
+    size_t nl = std::string::npos;
+    Frame f;
+    FrameDecoder decoder;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        data += poll_until(server, client_fd, 1, callback);
+        nl = data.find('\n');
+        if (nl != std::string::npos && data.size() > nl + FRAME_HEADER_SIZE) {
+            break;
+        }
+    }
+    REQUIRE(nl != std::string::npos);
+    CHECK(nlohmann::json::parse(data.substr(0, nl))["result"]["encoding"] == "msgpack");
+
+    decoder.append(data.data() + nl + 1, data.size() - nl - 1);
+    REQUIRE(decoder.next(f));
+    CHECK(f.content_type == CONTENT_MSGPACK);
+    nlohmann::json decoded = nlohmann::json::from_msgpack(f.payload);
+    CHECK(decoded["id"] == 2);
+    CHECK(decoded["result"]["ok"] == true);
+
+    close(client_fd);
+    server.stop();
+}
+
+TEST_CASE("large responses are deflated off the main thread and stay in order") {
+    unlink(TEST_SOCK);
+    SocketServer server;
+    ServerStats stats;
+    server.set_stats(&stats);
+    REQUIRE(server.start(TEST_SOCK));
+
+    int client_fd = connect_client(TEST_SOCK);
+    REQUIRE(client_fd >= 0);
+
+    // a big reply followed by a small one that must not overtake it
+    std::string out = "{\"id\":1,\"method\":\"negotiate\",\"params\":{\"framing\":\"binary\",\"compression\":\"deflate\",\"compress_threshold\":1024}}\n";
+    append_frame(out, CONTENT_JSON, 0, std::string("{\"id\":2,\"method\":\"big\"}"));
+    append_frame(out, CONTENT_JSON, 0, std::string("{\"id\":3,\"method\":\"small\"}"));
+    send_str(client_fd, out);
+
+    std::string big = "{\"id\":2,\"result\":{\"text\":\"" + std::string(100000, 'x') + "\"}}";
+    std::string small = "{\"id\":3,\"result\":{}}";
+    auto callback = [&](const std::string& msg, RpcContext&) -> std::string {
+        return msg.find("big") != std::string::npos ? big : small;
+    };
+
+    std::string data;
+    size_t nl = std::string::npos;
+    FrameDecoder decoder;
+    std::vector<Frame> frames;
+    for (int attempt = 0; attempt < 200 && frames.size() < 2; attempt++) {
+        std::string chunk = poll_until(server, client_fd, 1, callback);
+        if (nl == std::string::npos) {
+            data += chunk;
+            nl = data.find('\n');
+            if (nl == std::string::npos) {
+                continue;
+            }
+            CHECK(nlohmann::json::parse(data.substr(0, nl))["result"]["compression"] == "deflate");
+            chunk = data.substr(nl + 1);
+        }
+        decoder.append(chunk.data(), chunk.size());
+        Frame f;
+        while (decoder.next(f)) {
+            frames.push_back(f);
+        }
+    }
+
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[0].flags == FRAME_FLAG_DEFLATE);
+    CHECK(frames[0].payload.size() < big.size() / 10);
+    std::string inflated;
+    REQUIRE(deflate_decompress(frames[0].payload, inflated, big.size()));
+    CHECK(inflated == big);
+
+    // below the threshold: sent as-is, after the big one
+    CHECK(frames[1].flags == 0);
+    CHECK(frames[1].payload == small);
+
+    nlohmann::json s = nlohmann::json::parse(stats.to_json());
+    CHECK(s["compression"]["responses"] == 1);
+    CHECK(s["compression"]["compressed"] == 1);
+    CHECK(s["compression"]["bytes_in"] == big.size());
+    CHECK(s["compression"]["ratio"].get<double>() < 0.1);
+
+    close(client_fd);
+    server.stop();
+}
@@ -0,0 +1,130 @@
+#include <doctest/doctest.h>
+#include "text_transcode.h"
+#include "response_encoding.h"
+#include "request_arena.h"
+
+#include <random>
+
+using json = nlohmann::json;
+
+// the vector encoders (SSE2 or NEON, when the target has them) and the
+// scalar ones every other target runs
+struct TranscodePath {
+    const char* name;
+    void (*utf8)(std::string&, std::u32string_view);
+    void (*json_string)(std::string&, std::u32string_view);
+};
+static const TranscodePath PATHS[] = {
+    {"vector", append_utf8, append_json_string},
+    {"scalar", append_utf8_scalar, append_json_string_scalar},
+};
+
+// helper: text as UTF-8 through one path
+static std::string to_utf8(const TranscodePath& path, std::u32string_view text) {
+    std::string out;
+    path.utf8(out, text);
+    return out;
+}
+
+// helper: what nlohmann writes for the UTF-8 of text
+static std::string reference_json(std::u32string_view text) {
+    std::string utf8;
+    append_utf8_scalar(utf8, text);
+    return json(utf8).dump();
+}
+
+// helper: text long enough to take the vector path, with a bit of everything
+static std::u32string mixed_text(size_t length, uint32_t seed) {
+    static const char32_t pool[] = {
+        U'a', U'Z', U' ', U'0', U'{', U'~', U'\x7f', U'\n', U'\t', U'\r', U'\b', U'\f', U'\x01', U'\x1f',
+        U'"', U'\\', U'/', U'é', U'߿', U'ࠀ', U'中', U'￿', U'\U0001f600', U'\U0010ffff',
+    };
+    std::mt19937 rng(seed);
+    std::u32string text;
+    for (size_t i = 0; i < length; i++) {
+        // mostly ASCII runs, like real output
+        text += rng() % 8 ? static_cast<char32_t>(U'a' + rng() % 26) : pool[rng() % std::size(pool)];
+    }
+    return text;
+}
+
+TEST_CASE("utf32_to_utf8 encodes every length class") {
+    CHECK(utf32_to_utf8(U"plain ascii that is longer than one block") == "plain ascii that is longer than one block");
+    for (const TranscodePath& path : PATHS) {
+        CAPTURE(path.name);
+        CHECK(to_utf8(path, U"") == "");
+        CHECK(to_utf8(path, U"plain ascii that is longer than one block") == "plain ascii that is longer than one block");
+        CHECK(to_utf8(path, U"é") == "\xc3\xa9");
+        CHECK(to_utf8(path, U"中") == "\xe4\xb8\xad");
+        CHECK(to_utf8(path, U"\U0001f600") == "\xf0\x9f\x98\x80");
+
+        // a non-ASCII character in the middle of a block
+        std::u32string text(40, U'x');
+        text[20] = U'é';
+        std::string expected(20, 'x');
+        expected += "\xc3\xa9";
+        expected += std::string(19, 'x');
+        CHECK(to_utf8(path, text) == expected);
+    }
+}
+
+TEST_CASE("code points that aren't scalar values become U+FFFD") {
+    std::u32string text = U"a";
+    text += static_cast<char32_t>(0xD800);
+    text += static_cast<char32_t>(0x110000);
+    for (const TranscodePath& path : PATHS) {
+        CAPTURE(path.name);
+        CHECK(to_utf8(path, text) == "a\xef\xbf\xbd\xef\xbf\xbd");
+    }
+}
+
+TEST_CASE("append_json_string matches nlohmann's dump") {
+    CHECK(reference_json(U"") == "\"\"");
+    for (const TranscodePath& path : PATHS) {
+        CAPTURE(path.name);
+        std::string out;
+        path.json_string(out, U"");
+        CHECK(out == "\"\"");
+
+        for (std::u32string_view text : {std::u32string_view(U"a\"b\\c\nd\x01\x7f"),
+                                         std::u32string_view(U"ERROR: res://main.gd:12 - \"bad\"\n   at: _ready\n")}) {
+            out.clear();
+            path.json_string(out, text);
+            CHECK(out == reference_json(text));
+        }
+
+        for (uint32_t seed = 1; seed <= 50; seed++) {
+            std::u32string text = mixed_text(seed * 37, seed);
+            out = "prefix";
+            path.json_string(out, text);
+            REQUIRE(out == "prefix" + reference_json(text));
+        }
+    }
+}
+
+TEST_CASE("vector and scalar paths agree on long mixed text") {
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        std::u32string text = mixed_text(1000 + seed, seed);
+        REQUIRE(to_utf8(PATHS[0], text) == to_utf8(PATHS[1], text));
+    }
+}
+
+TEST_CASE("encode_result_text matches encode_result with the text in the DOM") {
+    std::u32string text = mixed_text(5000, 7);
+    arena_json result = {{"length", static_cast<int64_t>(text.size())}, {"total_length", 9000}};
+    arena_json full = result;
+    full["output"] = utf32_to_utf8(text);
+
+    for (uint8_t type : {CONTENT_JSON, CONTENT_MSGPACK, CONTENT_CBOR}) {
+        CHECK(encode_result_text(3, result, "output", text, type) == encode_result(3, full, type));
+    }
+
+    // the text key sorts first, last, and into an empty object
+    for (const char* key : {"a", "zz"}) {
+        arena_json with_key = result;
+        with_key[key] = utf32_to_utf8(U"x\ny");
+        CHECK(encode_result_text(1, result, key, U"x\ny", CONTENT_JSON) == encode_result(1, with_key, CONTENT_JSON));
+    }
+    CHECK(encode_result_text(1, arena_json::object(), "errors", U"e", CONTENT_JSON) ==
+          R"({"id":1,"result":{"errors":"e"}})");
+}
@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+#include "trace.h"
+#include <nlohmann/json.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using json = nlohmann::json;
+
+// helper: count complete ("X") events with a given name
+static int count_events(const json& doc, const std::string& name) {
+    int n = 0;
+    for (const auto& ev : doc["traceEvents"]) {
+        if (ev["ph"] == "X" && ev["name"] == name) {
+            n++;
+        }
+    }
+    return n;
+}
+
+TEST_CASE("trace scope records nothing while disabled") {
+    trace_set_enabled(false);
+    trace_clear();
+    {
+        PEEK_TRACE_SCOPE("disabled_scope");
+    }
+    CHECK(trace_event_count() == 0);
+}
+
+TEST_CASE("trace scope records complete events") {
+    trace_clear();
+    trace_set_enabled(true);
+    {
+        PEEK_TRACE_SCOPE("outer");
+        PEEK_TRACE_SCOPE(std::string("inner_") + "temp");
+    }
+    trace_set_enabled(false);
+
+    json doc = json::parse(trace_to_chrome_json());
+    CHECK(count_events(doc, "outer") == 1);
+    CHECK(count_events(doc, "inner_temp") == 1);
+    for (const auto& ev : doc["traceEvents"]) {
+        if (ev["ph"] == "X") {
+            CHECK(ev["dur"].get<double>() >= 0.0);
+            CHECK(ev["cat"] == "godot_peek");
+        }
+    }
+}
+
+TEST_CASE("trace names are truncated not overflowed") {
+    trace_clear();
+    trace_set_enabled(true);
+    std::string long_name(200, 'x');
+    {
+        PEEK_TRACE_SCOPE(long_name);
+    }
+    trace_set_enabled(false);
+
+    json doc = json::parse(trace_to_chrome_json());
+    CHECK(count_events(doc, std::string(TraceEvent::NAME_SIZE - 1, 'x')) == 1);
+}
+
+TEST_CASE("trace ring keeps only the newest events") {
+    trace_clear();
+    trace_set_enabled(true);
+    for (int i = 0; i < 20000; i++) {
+        trace_record("spam", 0, 1);
+    }
+    trace_set_enabled(false);
+
+    // one ring per thread; capacity is 16k events
+    CHECK(trace_event_count() == 16384);
+    trace_clear();
+    CHECK(trace_event_count() == 0);
+}
+
+TEST_CASE("trace records from multiple threads") {
+    trace_clear();
+    trace_set_enabled(true);
+    std::thread worker([] {
+        for (int i = 0; i < 100; i++) {
+            PEEK_TRACE_SCOPE("worker_scope");
+        }
+    });
+    worker.join();
+    {
+        PEEK_TRACE_SCOPE("main_scope");
+    }
+    trace_set_enabled(false);
+
+    json doc = json::parse(trace_to_chrome_json());
+    CHECK(count_events(doc, "worker_scope") == 100);
+    CHECK(count_events(doc, "main_scope") == 1);
+}
+
+TEST_CASE("trace export writes a chrome trace file") {
+    const char* path = "/tmp/godot_peek_trace_test.json";
+    trace_clear();
+    trace_set_enabled(true);
+    {
+        PEEK_TRACE_SCOPE("exported");
+    }
+    trace_set_enabled(false);
+
+    REQUIRE(trace_export_chrome(path));
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    json doc = json::parse(ss.str());
+    CHECK(doc.contains("traceEvents"));
+    CHECK(count_events(doc, "exported") == 1);
+    std::remove(path);
+
+    CHECK_FALSE(trace_export_chrome("/nonexistent-dir/trace.json"));
+}
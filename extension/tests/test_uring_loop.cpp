@@ -0,0 +1,244 @@
+#include <doctest/doctest.h>
+#include "uring_loop.h"
+#include "socket_server.h"
+#include "frame_codec.h"
+#include "server_stats.h"
+#include <nlohmann/json.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char* URING_SOCK = "/tmp/godot_peek_uring_test.sock";
+
+// io_uring can be missing (old kernel, non-linux) or disabled by policy;
+// those machines only run the poll backend
+static bool uring_available() {
+    UringLoop probe;
+    if (probe.init()) {
+        return true;
+    }
+    MESSAGE("io_uring unavailable, skipping");
+    return false;
+}
+
+static int connect_client(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+// helper: poll until the client has received at least want bytes
+static std::string poll_until(SocketServer& server, int fd, size_t want,
+                              const SocketServer::ContextCallback& callback) {
+    std::string received;
+    for (int attempt = 0; attempt < 20000 && received.size() < want; attempt++) {
+        server.poll(callback);
+        char buf[65536];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            received.append(buf, static_cast<size_t>(n));
+        }
+    }
+    return received;
+}
+
+static SocketServer::ContextCallback echo() {
+    return [](const std::string& msg, RpcContext&) -> std::string { return msg; };
+}
+
+// --- the loop itself ---
+
+TEST_CASE("uring loop multishot recv and send") {
+    if (!uring_available()) return;
+    UringLoop loop;
+    REQUIRE(loop.init(32, 4, 64));
+
+    int pair[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+    REQUIRE(loop.arm_recv(pair[0], 7));
+    REQUIRE(loop.submit());
+
+    // more writes than provided buffers: each gets recycled after its callback
+    std::string received;
+    int completions = 0;
+    for (int i = 0; i < 10; i++) {
+        std::string chunk = "chunk" + std::to_string(i) + ";";
+        REQUIRE(write(pair[1], chunk.data(), chunk.size()) == static_cast<ssize_t>(chunk.size()));
+        for (int spin = 0; spin < 100000 && received.find(chunk) == std::string::npos; spin++) {
+            loop.reap([&](const UringCompletion& c) {
+                CHECK(c.op == UringOp::recv);
+                CHECK(c.client_id == 7);
+                if (c.result > 0) {
+                    received.append(c.data, static_cast<size_t>(c.result));
+                }
+                completions++;
+            });
+        }
+    }
+    CHECK(received.find("chunk9;") != std::string::npos);
+    CHECK(completions >= 10);
+
+    // nothing pending: reaping is free
+    uint64_t before = loop.syscalls();
+    CHECK(loop.reap([](const UringCompletion&) {}) == 0);
+    CHECK(loop.syscalls() == before);
+
+    REQUIRE(loop.send(pair[0], 9, "pong"));
+    REQUIRE(loop.submit());
+    bool sent = false;
+    for (int spin = 0; spin < 100000 && !sent; spin++) {
+        loop.reap([&](const UringCompletion& c) {
+            if (c.op == UringOp::send) {
+                CHECK(c.client_id == 9);
+                CHECK(c.result == 0);
+                sent = true;
+            }
+        });
+    }
+    CHECK(sent);
+    char buf[16];
+    CHECK(read(pair[1], buf, sizeof(buf)) == 4);
+
+    close(pair[1]);
+    loop.stop();
+    close(pair[0]);
+    CHECK_FALSE(loop.active());
+}
+
+// --- SocketServer on io_uring ---
+
+TEST_CASE("io_uring backend roundtrip with several clients") {
+    if (!uring_available()) return;
+    unlink(URING_SOCK);
+    SocketServer server(IoBackend::io_uring);
+    REQUIRE(server.start(URING_SOCK));
+    CHECK(server.backend() == IoBackend::io_uring);
+
+    std::vector<int> fds;
+    for (int i = 0; i < 3; i++) {
+        fds.push_back(connect_client(URING_SOCK));
+        REQUIRE(fds.back() >= 0);
+    }
+    for (size_t i = 0; i < fds.size(); i++) {
+        std::string msg = "{\"id\":" + std::to_string(i) + "}\n";
+        REQUIRE(write(fds[i], msg.data(), msg.size()) == static_cast<ssize_t>(msg.size()));
+    }
+    for (size_t i = 0; i < fds.size(); i++) {
+        std::string want = "{\"id\":" + std::to_string(i) + "}\n";
+        CHECK(poll_until(server, fds[i], want.size(), echo()) == want);
+        close(fds[i]);
+    }
+    server.stop();
+    CHECK_FALSE(server.is_running());
+}
+
+TEST_CASE("io_uring backend keeps pipelined responses in order") {
+    if (!uring_available()) return;
+    unlink(URING_SOCK);
+    SocketServer server(IoBackend::io_uring);
+    REQUIRE(server.start(URING_SOCK));
+    int fd = connect_client(URING_SOCK);
+    REQUIRE(fd >= 0);
+
+    // a response far bigger than the socket buffer, then small ones queued
+    // behind it while its send is still in flight
+    std::string big(2 * 1024 * 1024, 'x');
+    std::string batch = "{\"big\":1}\n";
+    for (int i = 0; i < 20; i++) {
+        batch += "{\"n\":" + std::to_string(i) + "}\n";
+    }
+    REQUIRE(write(fd, batch.data(), batch.size()) == static_cast<ssize_t>(batch.size()));
+
+    auto callback = [&](const std::string& msg, RpcContext&) -> std::string {
+        return msg == "{\"big\":1}" ? big : msg;
+    };
+    std::string expected = big + "\n" + batch.substr(batch.find('\n') + 1);
+    std::string data = poll_until(server, fd, expected.size(), callback);
+    REQUIRE(data.size() == expected.size());
+    CHECK(data == expected);
+
+    close(fd);
+    server.stop();
+}
+
+// helper: is the client the stats know as id still connected
+static bool stats_connected(const ServerStats& stats) {
+    nlohmann::json j = nlohmann::json::parse(stats.to_json());
+    return !j["clients"].empty();
+}
+
+TEST_CASE("io_uring backend drops disconnected clients") {
+    if (!uring_available()) return;
+    unlink(URING_SOCK);
+    ServerStats stats;
+    SocketServer server(IoBackend::io_uring);
+    server.set_stats(&stats);
+    REQUIRE(server.start(URING_SOCK));
+
+    int fd = connect_client(URING_SOCK);
+    REQUIRE(fd >= 0);
+    for (int i = 0; i < 10000 && !stats_connected(stats); i++) {
+        server.poll(echo());
+    }
+    REQUIRE(stats_connected(stats));
+
+    close(fd);
+    for (int i = 0; i < 10000 && stats_connected(stats); i++) {
+        server.poll(echo());
+    }
+    CHECK_FALSE(stats_connected(stats));
+    CHECK(stats.closed_client_count() == 1);
+    server.stop();
+}
+
+TEST_CASE("io_uring backend negotiates binary framing") {
+    if (!uring_available()) return;
+    unlink(URING_SOCK);
+    SocketServer server(IoBackend::io_uring);
+    REQUIRE(server.start(URING_SOCK));
+    int fd = connect_client(URING_SOCK);
+    REQUIRE(fd >= 0);
+
+    std::string out = "{\"id\":1,\"method\":\"negotiate\",\"params\":{\"framing\":\"binary\"}}\n";
+    append_frame(out, CONTENT_JSON, 0, std::string("{\"id\":2}"));
+    REQUIRE(write(fd, out.data(), out.size()) == static_cast<ssize_t>(out.size()));
+
+    std::string reply = "{\"id\":2,\"result\":true}";
+    auto callback = [&](const std::string&, RpcContext& ctx) -> std::string {
+        CHECK(ctx.binary_frames);
+        return reply;
+    };
+
+    // handshake line, then one frame
+    std::string data;
+    size_t nl = std::string::npos;
+    for (int i = 0; i < 100 && (nl == std::string::npos || data.size() < nl + 1 + FRAME_HEADER_SIZE + reply.size()); i++) {
+        data += poll_until(server, fd, 1, callback);
+        nl = data.find('\n');
+    }
+    REQUIRE(nl != std::string::npos);
+    CHECK(nlohmann::json::parse(data.substr(0, nl))["result"]["framing"] == "binary");
+
+    FrameDecoder decoder;
+    decoder.append(data.data() + nl + 1, data.size() - nl - 1);
+    Frame f;
+    REQUIRE(decoder.next(f));
+    CHECK(f.payload == reply);
+
+    close(fd);
+    server.stop();
+}
@@ -2,12 +2,17 @@ package godot
 
 import (
 	"bufio"
+	"bytes"
 	"context"
 	"encoding/json"
+	"errors"
 	"fmt"
+	"io"
 	"log"
 	"net"
 	"os"
+	"strconv"
+	"strings"
 	"sync"
 	"time"
 )
@@ -23,9 +28,13 @@ const (
 type Client struct {
 	socketPath string
 
+	// requested framing (GODOT_PEEK_FRAMING, newline by default)
+	framing string
+
 	mu           sync.RWMutex
 	conn         net.Conn
-	reader       *bufio.Scanner
+	reader       *bufio.Reader
+	binary       bool // binary framing negotiated on the current connection
 	connected    bool
 	outputBuffer []OutputNotification
 
@@ -49,10 +58,16 @@ func NewClient(socketPath string) *Client {
 		}
 	}
 
+	framing := os.Getenv("GODOT_PEEK_FRAMING")
+	if framing == "" {
+		framing = FramingNewline
+	}
+
 	ctx, cancel := context.WithCancel(context.Background())
 
 	c := &Client{
 		socketPath: socketPath,
+		framing:    framing,
 		pending:    make(map[int64]chan *Response),
 		outputCh:   make(chan OutputNotification, 100),
 		ctx:        ctx,
@@ -64,21 +79,70 @@ func NewClient(socketPath string) *Client {
 
 // Connect establishes connection to Godot
 func (c *Client) Connect(ctx context.Context) error {
-	conn, err := net.Dial("unix", c.socketPath)
+	c.mu.RLock()
+	socketPath := c.socketPath
+	c.mu.RUnlock()
+
+	conn, err := net.Dial("unix", socketPath)
 	if err != nil {
 		return fmt.Errorf("dial unix socket: %w", err)
 	}
 
+	reader := bufio.NewReader(conn)
+	binary := false
+	if c.framing == FramingBinary {
+		binary, err = negotiate(conn, reader, c.framing)
+		if err != nil {
+			conn.Close()
+			return fmt.Errorf("negotiate framing: %w", err)
+		}
+		if !binary {
+			log.Printf("[godot] Binary framing not supported, using newline framing")
+		}
+	}
+
 	c.mu.Lock()
 	c.conn = conn
-	c.reader = bufio.NewScanner(conn)
+	c.reader = reader
+	c.binary = binary
 	c.connected = true
 	c.mu.Unlock()
 
 	// start reading messages
-	go c.readLoop()
+	go c.readLoop(reader)
 
-	log.Printf("[godot] Connected to %s", c.socketPath)
+	log.Printf("[godot] Connected to %s", socketPath)
+	return nil
+}
+
+// SocketPath returns the socket of the editor this client talks to
+func (c *Client) SocketPath() string {
+	c.mu.RLock()
+	defer c.mu.RUnlock()
+	return c.socketPath
+}
+
+// SwitchEditor connects to the editor listening on socketPath and drops the
+// current connection, so one MCP process can move between editors. on
+// failure the current connection is kept
+func (c *Client) SwitchEditor(ctx context.Context, socketPath string) error {
+	c.mu.Lock()
+	old := c.conn
+	previous := c.socketPath
+	c.socketPath = socketPath
+	c.mu.Unlock()
+
+	if err := c.Connect(ctx); err != nil {
+		c.mu.Lock()
+		c.socketPath = previous
+		c.mu.Unlock()
+		return err
+	}
+
+	// the old readLoop sees its reader replaced and exits quietly
+	if old != nil {
+		old.Close()
+	}
 	return nil
 }
 
@@ -102,11 +166,14 @@ func (c *Client) Close() error {
 	return nil
 }
 
-// readLoop handles incoming messages from Unix socket
-func (c *Client) readLoop() {
+// readLoop handles incoming messages from Unix socket. it exits once its
+// connection is replaced (SwitchEditor) or closed
+func (c *Client) readLoop(own *bufio.Reader) {
 	defer func() {
 		c.mu.Lock()
-		c.connected = false
+		if c.reader == own {
+			c.connected = false
+		}
 		c.mu.Unlock()
 	}()
 
@@ -119,33 +186,110 @@ func (c *Client) readLoop() {
 
 		c.mu.RLock()
 		reader := c.reader
+		binary := c.binary
 		c.mu.RUnlock()
 
-		if reader == nil {
+		if reader == nil || reader != own {
 			return
 		}
 
-		// read one line (newline-delimited JSON)
-		if !reader.Scan() {
-			if err := reader.Err(); err != nil {
-				if c.ctx.Err() == nil {
-					log.Printf("[godot] Read error: %v", err)
-				}
+		var (
+			data        []byte
+			attachments [][]byte
+			err         error
+		)
+		if binary {
+			data, attachments, err = readReply(reader)
+		} else {
+			// read one line (newline-delimited JSON). unlike bufio.Scanner
+			// this has no token limit, so multi-megabyte responses fit
+			data, err = reader.ReadBytes('\n')
+			data = bytes.TrimSuffix(data, []byte{'\n'})
+		}
+		if err != nil {
+			c.mu.RLock()
+			replaced := c.reader != own
+			c.mu.RUnlock()
+			if c.ctx.Err() == nil && err != io.EOF && !replaced {
+				log.Printf("[godot] Read error: %v", err)
 			}
 			return
 		}
 
-		data := reader.Bytes()
 		if len(data) == 0 {
 			continue
 		}
 
-		c.handleMessage(data)
+		c.handleReply(data, attachments)
 	}
 }
 
+// negotiate sends the framing handshake as the first message on conn and
+// reports whether the server switched to binary frames. binary connections
+// also ask for deflate on large responses; readFrame undoes it
+func negotiate(conn net.Conn, reader *bufio.Reader, framing string) (bool, error) {
+	id := nextID()
+	params := NegotiateParams{Framing: framing}
+	if framing == FramingBinary {
+		params.Compression = CompressionDeflate
+	}
+	data, err := json.Marshal(Request{ID: id, Method: "negotiate", Params: params})
+	if err != nil {
+		return false, err
+	}
+	if _, err := conn.Write(append(data, '\n')); err != nil {
+		return false, err
+	}
+
+	// the reply is always newline-framed
+	line, err := reader.ReadBytes('\n')
+	if err != nil {
+		return false, err
+	}
+	var resp Response
+	if err := json.Unmarshal(line, &resp); err != nil {
+		return false, fmt.Errorf("parse handshake reply: %w", err)
+	}
+	if resp.Error != nil || resp.Result == nil {
+		// older servers answer "Method not found": stay on newlines
+		return false, nil
+	}
+	var result NegotiateResult
+	if err := json.Unmarshal(*resp.Result, &result); err != nil {
+		return false, fmt.Errorf("parse handshake result: %w", err)
+	}
+	return result.Framing == FramingBinary, nil
+}
+
+// readReply reads one JSON frame plus any binary frames flagged as
+// belonging to it
+func readReply(r *bufio.Reader) ([]byte, [][]byte, error) {
+	f, err := readFrame(r)
+	if err != nil {
+		return nil, nil, err
+	}
+	if f.contentType != contentJSON {
+		return nil, nil, fmt.Errorf("unexpected frame content type %d", f.contentType)
+	}
+
+	data := f.payload
+	var attachments [][]byte
+	for f.flags&frameFlagMore != 0 {
+		if f, err = readFrame(r); err != nil {
+			return nil, nil, err
+		}
+		attachments = append(attachments, f.payload)
+	}
+	return data, attachments, nil
+}
+
 // handleMessage processes a raw message
 func (c *Client) handleMessage(data []byte) {
+	c.handleReply(data, nil)
+}
+
+// handleReply processes a raw message and the binary frames that came with it
+func (c *Client) handleReply(data []byte, attachments [][]byte) {
 	log.Printf("[godot] Received message: %s", string(data)[:min(len(data), 200)])
 
 	// try to parse as response (has id)
@@ -168,8 +312,9 @@ func (c *Client) handleMessage(data []byte) {
 		log.Printf("[godot] Response for request id=%d", id)
 
 		resp := &Response{
-			ID:    id,
-			Error: msg.Error,
+			ID:          id,
+			Error:       msg.Error,
+			Attachments: attachments,
 		}
 		if msg.Result != nil {
 			resp.Result = &msg.Result
@@ -260,6 +405,7 @@ func (c *Client) sendRequest(ctx context.Context, method string, params interfac
 	c.mu.RLock()
 	conn := c.conn
 	connected := c.connected
+	binary := c.binary
 	c.mu.RUnlock()
 
 	if !connected || conn == nil {
@@ -278,8 +424,12 @@ func (c *Client) sendRequest(ctx context.Context, method string, params interfac
 		return nil, fmt.Errorf("marshal: %w", err)
 	}
 
-	// add newline delimiter for line-based protocol
-	data = append(data, '\n')
+	if binary {
+		data = encodeFrame(contentJSON, 0, data)
+	} else {
+		// add newline delimiter for line-based protocol
+		data = append(data, '\n')
+	}
 
 	// register pending request
 	respCh := make(chan *Response, 1)
@@ -387,18 +537,21 @@ func (c *Client) RunMainScene(ctx context.Context, overrides Overrides, timeout
 	return &result, nil
 }
 
-// RunScene starts a specific scene
-func (c *Client) RunScene(ctx context.Context, scenePath string, overrides Overrides, timeout float64) (*GenericResult, error) {
+// RunScene starts a specific scene. with profileLoads the game times every
+// resource load from startup, and the result carries the report once the
+// startup check is done
+func (c *Client) RunScene(ctx context.Context, scenePath string, overrides Overrides, timeout float64, profileLoads bool) (*GenericResult, error) {
 	// write overrides file before sending command
 	if err := writeOverrides(overrides); err != nil {
 		return nil, fmt.Errorf("write overrides: %w", err)
 	}
 
-	// only send scene_path and timeout_seconds in params
+	// only send scene_path, timeout_seconds and profile_loads in params
 	params := struct {
 		ScenePath      string  `json:"scene_path"`
 		TimeoutSeconds float64 `json:"timeout_seconds,omitempty"`
-	}{ScenePath: scenePath, TimeoutSeconds: timeout}
+		ProfileLoads   bool    `json:"profile_loads,omitempty"`
+	}{ScenePath: scenePath, TimeoutSeconds: timeout, ProfileLoads: profileLoads}
 
 	resp, err := c.sendRequest(ctx, "run_scene", params)
 	if err != nil {
@@ -416,6 +569,14 @@ func (c *Client) RunScene(ctx context.Context, scenePath string, overrides Overr
 	}
 
 	c.checkStartupErrors(ctx, &result, timeout)
+	if profileLoads && !result.ErrorDetected {
+		profile, err := c.LoadProfile(ctx, 10, false)
+		if err != nil {
+			result.LoadProfileError = err.Error()
+		} else {
+			result.LoadProfile = profile
+		}
+	}
 	return &result, nil
 }
 
@@ -481,6 +642,85 @@ func (c *Client) GetOutputFromGodot(ctx context.Context, clear bool, newOnly boo
 	return &result, nil
 }
 
+// GetArchivedOutput reads a range of a current or past session from the
+// output archive
+func (c *Client) GetArchivedOutput(ctx context.Context, params ArchiveQueryParams) (*ArchiveResult, error) {
+	resp, err := c.sendRequest(ctx, "get_output", params)
+	if err != nil {
+		return nil, err
+	}
+	if resp.Error != nil {
+		return nil, fmt.Errorf("godot error: %s", resp.Error.Message)
+	}
+
+	var result ArchiveResult
+	if resp.Result != nil {
+		if err := json.Unmarshal(*resp.Result, &result); err != nil {
+			return nil, fmt.Errorf("unmarshal result: %w", err)
+		}
+	}
+	return &result, nil
+}
+
+// ListOutputSessions lists the sessions in the output archive
+func (c *Client) ListOutputSessions(ctx context.Context) (*OutputSessionsResult, error) {
+	resp, err := c.sendRequest(ctx, "list_output_sessions", nil)
+	if err != nil {
+		return nil, err
+	}
+	if resp.Error != nil {
+		return nil, fmt.Errorf("godot error: %s", resp.Error.Message)
+	}
+
+	var result OutputSessionsResult
+	if resp.Result != nil {
+		if err := json.Unmarshal(*resp.Result, &result); err != nil {
+			return nil, fmt.Errorf("unmarshal result: %w", err)
+		}
+	}
+	return &result, nil
+}
+
+// GetOutputStats counts the current session's output lines per level and
+// time bucket
+func (c *Client) GetOutputStats(ctx context.Context, params GetOutputStatsParams) (*OutputStatsResult, error) {
+	resp, err := c.sendRequest(ctx, "get_output_stats", params)
+	if err != nil {
+		return nil, err
+	}
+	if resp.Error != nil {
+		return nil, fmt.Errorf("godot error: %s", resp.Error.Message)
+	}
+
+	var result OutputStatsResult
+	if resp.Result != nil {
+		if err := json.Unmarshal(*resp.Result, &result); err != nil {
+			return nil, fmt.Errorf("unmarshal result: %w", err)
+		}
+	}
+	return &result, nil
+}
+
+// SetOutputGovernor caps the editor's Output panel at maxLines (0 turns the
+// cap off); trimmed lines stay in the output archive
+func (c *Client) SetOutputGovernor(ctx context.Context, maxLines int) (*OutputGovernorResult, error) {
+	resp, err := c.sendRequest(ctx, "set_output_governor", SetOutputGovernorParams{MaxLines: maxLines})
+	if err != nil {
+		return nil, err
+	}
+	if resp.Error != nil {
+		return nil, fmt.Errorf("godot error: %s", resp.Error.Message)
+	}
+
+	var result OutputGovernorResult
+	if resp.Result != nil {
+		if err := json.Unmarshal(*resp.Result, &result); err != nil {
+			return nil, fmt.Errorf("unmarshal result: %w", err)
+		}
+	}
+	return &result, nil
+}
+
 // GetDebugErrors fetches errors/warnings from debugger
 func (c *Client) GetDebugErrors(ctx context.Context) (*DebugErrorsResult, error) {
 	resp, err := c.sendRequest(ctx, "get_debugger_errors", nil)
@@ -829,17 +1069,90 @@ func sendGameUDP(ctx context.Context, request interface{}) ([]byte, error) {
 	return buf[:n], nil
 }
 
+// GameSocketPath is the framed socket the native game runtime
+// (GodotPeekRuntime) serves for a game launched from the editor listening on
+// editorSocket: /tmp/godot-peek-foo.sock -> /tmp/godot-peek-foo-game.sock
+func GameSocketPath(editorSocket string) string {
+	return strings.TrimSuffix(editorSocket, ".sock") + "-game.sock"
+}
+
+// errNoGameSocket means nothing listens on the game socket (no game running,
+// or only the GDScript helper, which speaks UDP)
+var errNoGameSocket = errors.New("game socket not available")
+
+// sendGameSocket sends a command as one JSON-RPC request over the game
+// socket and returns the reply in the UDP shape: the bare result object, or
+// {"error": message}, with an unknown method worded like the GDScript
+// helper's "unknown command: <cmd>"
+func sendGameSocket(ctx context.Context, path string, request map[string]string) ([]byte, error) {
+	conn, err := net.Dial("unix", path)
+	if err != nil {
+		return nil, fmt.Errorf("%w: %v", errNoGameSocket, err)
+	}
+	defer conn.Close()
+
+	deadline, ok := ctx.Deadline()
+	if !ok {
+		deadline = time.Now().Add(5 * time.Second)
+	}
+	conn.SetDeadline(deadline)
+
+	params := make(map[string]string, len(request))
+	for k, v := range request {
+		if k != "cmd" {
+			params[k] = v
+		}
+	}
+	data, err := json.Marshal(map[string]interface{}{"id": 1, "method": request["cmd"], "params": params})
+	if err != nil {
+		return nil, fmt.Errorf("marshal request: %w", err)
+	}
+	if _, err := conn.Write(append(data, '\n')); err != nil {
+		return nil, fmt.Errorf("write game socket: %w", err)
+	}
+
+	line, err := bufio.NewReader(conn).ReadBytes('\n')
+	if err != nil {
+		return nil, fmt.Errorf("read game socket: %w", err)
+	}
+	var resp struct {
+		Result json.RawMessage `json:"result"`
+		Error  *ResponseError  `json:"error"`
+	}
+	if err := json.Unmarshal(line, &resp); err != nil {
+		return nil, fmt.Errorf("unmarshal game response: %w", err)
+	}
+	if resp.Error != nil {
+		message := resp.Error.Message
+		if resp.Error.Code == -32601 {
+			message = "unknown command: " + request["cmd"]
+		}
+		return json.Marshal(map[string]string{"error": message})
+	}
+	return resp.Result, nil
+}
+
+// sendGame sends a command to the running game: over the framed game
+// socket when the native runtime serves one, else as a UDP datagram
+func (c *Client) sendGame(ctx context.Context, request map[string]string) ([]byte, error) {
+	data, err := sendGameSocket(ctx, GameSocketPath(c.SocketPath()), request)
+	if errors.Is(err, errNoGameSocket) {
+		return sendGameUDP(ctx, request)
+	}
+	return data, err
+}
+
 // EvaluateExpression evaluates a GDScript expression in the running game
-// communicates directly with game autoload via UDP (no C++ passthrough)
+// talks to the game directly (no editor passthrough)
 func (c *Client) EvaluateExpression(ctx context.Context, expression string) (*EvaluateResult, error) {
 	request := map[string]string{
 		"cmd":        "evaluate",
 		"expression": expression,
 	}
 
-	respData, err := sendGameUDP(ctx, request)
+	respData, err := c.sendGame(ctx, request)
 	if err != nil {
-		return nil, fmt.Errorf("udp request failed: %w", err)
+		return nil, fmt.Errorf("game request failed: %w", err)
 	}
 
 	var result EvaluateResult
@@ -854,16 +1167,212 @@ func (c *Client) EvaluateExpression(ctx context.Context, expression string) (*Ev
 	return &result, nil
 }
 
-// GetGameScreenshot captures the game viewport directly via UDP
-// bypasses C++ extension (only editor screenshots need C++)
+// QueryNodes runs a selector over the running game's scene tree and returns
+// the matching paths with the requested properties (native runtime only)
+func (c *Client) QueryNodes(ctx context.Context, selector string, properties []string, limit int) (*QueryNodesResult, error) {
+	request := map[string]string{
+		"cmd":      "query_nodes",
+		"selector": selector,
+	}
+	if len(properties) > 0 {
+		request["properties"] = strings.Join(properties, ",")
+	}
+	if limit > 0 {
+		request["limit"] = strconv.Itoa(limit)
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result QueryNodesResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("query error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// SnapshotNodeCounts takes a per-class node count snapshot in the running
+// game. intervalMs > 0 also keeps taking them that often, 0 stops that, and
+// a negative value leaves the schedule alone
+func (c *Client) SnapshotNodeCounts(ctx context.Context, intervalMs int, top int) (*CountSnapshotResult, error) {
+	request := map[string]string{"cmd": "snapshot_counts"}
+	if intervalMs >= 0 {
+		request["interval_ms"] = strconv.Itoa(intervalMs)
+	}
+	if top > 0 {
+		request["top"] = strconv.Itoa(top)
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result CountSnapshotResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("snapshot error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// DiffNodeCounts compares two count snapshots: ids, or 0 for the newest and
+// negative numbers for the ones before it
+func (c *Client) DiffNodeCounts(ctx context.Context, from, to int64, limit int) (*CountDiffResult, error) {
+	request := map[string]string{
+		"cmd":  "diff_counts",
+		"from": strconv.FormatInt(from, 10),
+		"to":   strconv.FormatInt(to, 10),
+	}
+	if limit > 0 {
+		request["limit"] = strconv.Itoa(limit)
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result CountDiffResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("diff error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// FindOrphans lists the game's orphan nodes grouped by class, script and
+// scene file. the first call starts tracking, so only nodes detached from
+// then on are attributed; stop ends tracking and frees its memory
+func (c *Client) FindOrphans(ctx context.Context, limit, samples int, stop bool) (*OrphansResult, error) {
+	request := map[string]string{"cmd": "find_orphans"}
+	if limit > 0 {
+		request["limit"] = strconv.Itoa(limit)
+	}
+	if samples >= 0 {
+		request["samples"] = strconv.Itoa(samples)
+	}
+	if stop {
+		request["stop"] = "1"
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result OrphansResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("orphans error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// LoadProfile reports the resource loads of a game started with
+// run_scene profile_loads: the slowest by self time (or total time, which
+// includes the dependencies each one pulled in) and the time per type
+func (c *Client) LoadProfile(ctx context.Context, limit int, byTotal bool) (*LoadProfileResult, error) {
+	request := map[string]string{"cmd": "load_profile"}
+	if limit > 0 {
+		request["limit"] = strconv.Itoa(limit)
+	}
+	if byTotal {
+		request["sort"] = "total"
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result LoadProfileResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("load profile error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// SamplePhysics takes a physics sample in the game now; intervalMs >= 0 also
+// sets how often it keeps taking them (0 stops), and stop ends sampling and
+// the tree pass timing altogether
+func (c *Client) SamplePhysics(ctx context.Context, intervalMs int, top int, stop bool) (*PhysicsSampleResult, error) {
+	request := map[string]string{"cmd": "sample_physics"}
+	if intervalMs >= 0 {
+		request["interval_ms"] = strconv.Itoa(intervalMs)
+	}
+	if top > 0 {
+		request["top"] = strconv.Itoa(top)
+	}
+	if stop {
+		request["stop"] = "1"
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result PhysicsSampleResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("physics sample error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// PhysicsSeries returns the physics samples after since (0 for all), oldest
+// first
+func (c *Client) PhysicsSeries(ctx context.Context, since int64, limit int) (*PhysicsSeriesResult, error) {
+	request := map[string]string{
+		"cmd":   "physics_series",
+		"since": strconv.FormatInt(since, 10),
+	}
+	if limit > 0 {
+		request["limit"] = strconv.Itoa(limit)
+	}
+
+	respData, err := c.sendGame(ctx, request)
+	if err != nil {
+		return nil, fmt.Errorf("game request failed: %w", err)
+	}
+
+	var result PhysicsSeriesResult
+	if err := json.Unmarshal(respData, &result); err != nil {
+		return nil, fmt.Errorf("unmarshal response: %w", err)
+	}
+	if result.Error != "" {
+		return nil, fmt.Errorf("physics series error: %s", result.Error)
+	}
+	return &result, nil
+}
+
+// GetGameScreenshot captures the game viewport directly from the game
+// (only editor screenshots go through the editor)
 func (c *Client) GetGameScreenshot(ctx context.Context) (*ScreenshotResult, error) {
 	request := map[string]string{
 		"cmd": "screenshot",
 	}
 
-	respData, err := sendGameUDP(ctx, request)
+	respData, err := c.sendGame(ctx, request)
 	if err != nil {
-		return nil, fmt.Errorf("udp request failed: %w", err)
+		return nil, fmt.Errorf("game request failed: %w", err)
 	}
 
 	var result ScreenshotResult
@@ -883,4 +1392,3 @@ func (c *Client) GetGameScreenshot(ctx context.Context) (*ScreenshotResult, erro
 	result.Target = "game"
 	return &result, nil
 }
-
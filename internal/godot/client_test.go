@@ -4,9 +4,11 @@ import (
 	"bufio"
 	"context"
 	"encoding/json"
+	"errors"
 	"fmt"
 	"net"
 	"os"
+	"path/filepath"
 	"testing"
 	"time"
 )
@@ -19,9 +21,9 @@ func newTestClient(t *testing.T) (*Client, net.Conn) {
 	client := NewClient("test")
 	serverConn, clientConn := net.Pipe()
 	client.conn = clientConn
-	client.reader = bufio.NewScanner(clientConn)
+	client.reader = bufio.NewReader(clientConn)
 	client.connected = true
-	go client.readLoop()
+	go client.readLoop(client.reader)
 	return client, serverConn
 }
 
@@ -388,3 +390,456 @@ func TestIsConnected(t *testing.T) {
 		t.Error("expected connected after setting flag")
 	}
 }
+
+// --- binary framing ---
+
+func TestNewClient_FramingEnv(t *testing.T) {
+	t.Setenv("GODOT_PEEK_FRAMING", "")
+	if c := NewClient("test"); c.framing != FramingNewline {
+		t.Errorf("expected default framing %s, got %s", FramingNewline, c.framing)
+	}
+	t.Setenv("GODOT_PEEK_FRAMING", FramingBinary)
+	if c := NewClient("test"); c.framing != FramingBinary {
+		t.Errorf("expected framing %s, got %s", FramingBinary, c.framing)
+	}
+}
+
+func TestNegotiate_Binary(t *testing.T) {
+	serverConn, clientConn := net.Pipe()
+	defer serverConn.Close()
+	defer clientConn.Close()
+
+	go func() {
+		reader := bufio.NewReader(serverConn)
+		line, err := reader.ReadBytes('\n')
+		if err != nil {
+			return
+		}
+		var req struct {
+			ID     int64           `json:"id"`
+			Method string          `json:"method"`
+			Params NegotiateParams `json:"params"`
+		}
+		json.Unmarshal(line, &req)
+		if req.Method != "negotiate" || req.Params.Framing != FramingBinary || req.Params.Compression != CompressionDeflate {
+			serverConn.Write([]byte(`{"id":0,"error":{"code":-32600,"message":"bad handshake"}}` + "\n"))
+			return
+		}
+		serverConn.Write([]byte(fmt.Sprintf(`{"id":%d,"result":{"framing":"binary","max_frame":67108864}}`+"\n", req.ID)))
+	}()
+
+	binary, err := negotiate(clientConn, bufio.NewReader(clientConn), FramingBinary)
+	if err != nil {
+		t.Fatalf("negotiate: %v", err)
+	}
+	if !binary {
+		t.Error("expected binary framing")
+	}
+}
+
+func TestNegotiate_OldServerFallsBack(t *testing.T) {
+	serverConn, clientConn := net.Pipe()
+	defer serverConn.Close()
+	defer clientConn.Close()
+
+	go func() {
+		bufio.NewReader(serverConn).ReadBytes('\n')
+		serverConn.Write([]byte(`{"error":{"code":-32601,"message":"Method not found: negotiate"},"id":1}` + "\n"))
+	}()
+
+	binary, err := negotiate(clientConn, bufio.NewReader(clientConn), FramingBinary)
+	if err != nil {
+		t.Fatalf("negotiate: %v", err)
+	}
+	if binary {
+		t.Error("expected newline fallback")
+	}
+}
+
+func TestSendRequest_BinaryFramesWithAttachment(t *testing.T) {
+	client, serverConn := newTestClient(t)
+	defer serverConn.Close()
+	defer client.Close()
+	client.mu.Lock()
+	client.binary = true
+	client.mu.Unlock()
+
+	png := []byte{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n', 0, '\n'}
+	go func() {
+		f, err := readFrame(bufio.NewReader(serverConn))
+		if err != nil || f.contentType != contentJSON {
+			return
+		}
+		var req Request
+		json.Unmarshal(f.payload, &req)
+
+		resp := fmt.Sprintf(`{"id":%d,"result":{"target":"editor","attachment":0}}`, req.ID)
+		out := encodeFrame(contentJSON, frameFlagMore, []byte(resp))
+		out = append(out, encodeFrame(contentBinary, 0, png)...)
+		serverConn.Write(out)
+	}()
+
+	resp, err := client.sendRequest(context.Background(), "get_screenshot", GetScreenshotParams{Target: "editor"})
+	if err != nil {
+		t.Fatalf("sendRequest: %v", err)
+	}
+	if resp.Result == nil {
+		t.Fatal("expected result")
+	}
+	if len(resp.Attachments) != 1 || string(resp.Attachments[0]) != string(png) {
+		t.Errorf("unexpected attachments: %v", resp.Attachments)
+	}
+}
+
+func TestReadLoop_LargeNewlineResponse(t *testing.T) {
+	client, serverConn := newTestClient(t)
+	defer serverConn.Close()
+	defer client.Close()
+
+	// bigger than bufio.Scanner's default 64KB token limit
+	big := make([]byte, 1<<20)
+	for i := range big {
+		big[i] = 'x'
+	}
+	go func() {
+		line, err := bufio.NewReader(serverConn).ReadBytes('\n')
+		if err != nil {
+			return
+		}
+		var req Request
+		json.Unmarshal(line, &req)
+		serverConn.Write([]byte(fmt.Sprintf(`{"id":%d,"result":{"output":"%s"}}`+"\n", req.ID, big)))
+	}()
+
+	resp, err := client.sendRequest(context.Background(), "get_output", nil)
+	if err != nil {
+		t.Fatalf("sendRequest: %v", err)
+	}
+	var result OutputResult
+	if err := json.Unmarshal(*resp.Result, &result); err != nil {
+		t.Fatalf("unmarshal: %v", err)
+	}
+	if len(result.Output) != len(big) {
+		t.Errorf("expected %d bytes of output, got %d", len(big), len(result.Output))
+	}
+}
+
+func TestSwitchEditor(t *testing.T) {
+	dir := t.TempDir()
+	listen := func(name string) (net.Listener, string) {
+		path := filepath.Join(dir, name)
+		l, err := net.Listen("unix", path)
+		if err != nil {
+			t.Fatalf("listen: %v", err)
+		}
+		return l, path
+	}
+	first, firstPath := listen("a.sock")
+	defer first.Close()
+	second, secondPath := listen("b.sock")
+	defer second.Close()
+
+	client := NewClient(firstPath)
+	defer client.Close()
+	if err := client.Connect(context.Background()); err != nil {
+		t.Fatalf("connect: %v", err)
+	}
+
+	// a missing editor leaves the current connection alone
+	if err := client.SwitchEditor(context.Background(), filepath.Join(dir, "missing.sock")); err == nil {
+		t.Fatal("expected error switching to a missing socket")
+	}
+	if client.SocketPath() != firstPath || !client.IsConnected() {
+		t.Fatalf("expected to stay on %s", firstPath)
+	}
+
+	if err := client.SwitchEditor(context.Background(), secondPath); err != nil {
+		t.Fatalf("switch: %v", err)
+	}
+	if client.SocketPath() != secondPath {
+		t.Errorf("expected socket %s, got %s", secondPath, client.SocketPath())
+	}
+
+	// requests now go to the second editor
+	go func() {
+		conn, err := second.Accept()
+		if err != nil {
+			return
+		}
+		line, err := bufio.NewReader(conn).ReadBytes('\n')
+		if err != nil {
+			return
+		}
+		var req Request
+		json.Unmarshal(line, &req)
+		conn.Write([]byte(fmt.Sprintf(`{"id":%d,"result":{"pong":true}}`+"\n", req.ID)))
+	}()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	resp, err := client.sendRequest(ctx, "ping", nil)
+	if err != nil {
+		t.Fatalf("sendRequest: %v", err)
+	}
+	if resp.Result == nil || string(*resp.Result) != `{"pong":true}` {
+		t.Errorf("unexpected response: %+v", resp)
+	}
+	if !client.IsConnected() {
+		t.Error("old readLoop must not mark the new connection disconnected")
+	}
+}
+
+// --- game socket ---
+
+func TestGameSocketPath(t *testing.T) {
+	if got := GameSocketPath("/tmp/godot-peek-foo.sock"); got != "/tmp/godot-peek-foo-game.sock" {
+		t.Errorf("unexpected game socket %s", got)
+	}
+	if got := GameSocketPath("/tmp/peek"); got != "/tmp/peek-game.sock" {
+		t.Errorf("unexpected game socket %s", got)
+	}
+}
+
+func TestSendGameSocket(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "game.sock")
+	l, err := net.Listen("unix", path)
+	if err != nil {
+		t.Fatalf("listen: %v", err)
+	}
+	defer l.Close()
+
+	// answers a screenshot with a result and anything else the way the
+	// native runtime's dispatcher does
+	go func() {
+		for {
+			conn, err := l.Accept()
+			if err != nil {
+				return
+			}
+			line, err := bufio.NewReader(conn).ReadBytes('\n')
+			if err == nil {
+				var req struct {
+					ID     int64             `json:"id"`
+					Method string            `json:"method"`
+					Params map[string]string `json:"params"`
+				}
+				json.Unmarshal(line, &req)
+				if req.Method == "screenshot" && req.Params["cmd"] == "" {
+					conn.Write([]byte(fmt.Sprintf(`{"id":%d,"result":{"path":"/tmp/x.png"}}`+"\n", req.ID)))
+				} else {
+					conn.Write([]byte(fmt.Sprintf(`{"id":%d,"error":{"code":-32601,"message":"Method not found: %s"}}`+"\n", req.ID, req.Method)))
+				}
+			}
+			conn.Close()
+		}
+	}()
+
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	data, err := sendGameSocket(ctx, path, map[string]string{"cmd": "screenshot"})
+	if err != nil {
+		t.Fatalf("sendGameSocket: %v", err)
+	}
+	if string(data) != `{"path":"/tmp/x.png"}` {
+		t.Errorf("unexpected result %s", data)
+	}
+
+	// errors come back in the udp reply shape, worded like the gdscript helper
+	data, err = sendGameSocket(ctx, path, map[string]string{"cmd": "dance"})
+	if err != nil {
+		t.Fatalf("sendGameSocket: %v", err)
+	}
+	if string(data) != `{"error":"unknown command: dance"}` {
+		t.Errorf("unexpected result %s", data)
+	}
+
+	// no listener means falling back to udp
+	_, err = sendGameSocket(ctx, filepath.Join(t.TempDir(), "missing.sock"), map[string]string{"cmd": "screenshot"})
+	if !errors.Is(err, errNoGameSocket) {
+		t.Errorf("expected errNoGameSocket, got %v", err)
+	}
+}
+
+// serveGameOnce answers one request on the game socket next to
+// dir/peek.sock with result, and hands over the request's params (plus its
+// method under "method")
+func serveGameOnce(t *testing.T, dir string, result string) <-chan map[string]string {
+	l, err := net.Listen("unix", filepath.Join(dir, "peek-game.sock"))
+	if err != nil {
+		t.Fatalf("listen: %v", err)
+	}
+	t.Cleanup(func() { l.Close() })
+
+	got := make(chan map[string]string, 1)
+	go func() {
+		conn, err := l.Accept()
+		if err != nil {
+			return
+		}
+		defer conn.Close()
+		line, _ := bufio.NewReader(conn).ReadBytes('\n')
+		var req struct {
+			ID     int64             `json:"id"`
+			Method string            `json:"method"`
+			Params map[string]string `json:"params"`
+		}
+		json.Unmarshal(line, &req)
+		req.Params["method"] = req.Method
+		got <- req.Params
+		conn.Write([]byte(fmt.Sprintf(`{"id":%d,"result":%s}`+"\n", req.ID, result)))
+	}()
+	return got
+}
+
+func TestQueryNodes_SendsFlatParams(t *testing.T) {
+	dir := t.TempDir()
+	got := serveGameOnce(t, dir, `{"matches":[{"path":"/root/Level/Crate","class":"RigidBody3D","properties":{"mass":2}}],"count":1,"truncated":true,"visited":40,"source":"class_index"}`)
+
+	client := NewClient(filepath.Join(dir, "peek.sock"))
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	result, err := client.QueryNodes(ctx, "RigidBody3D [sleeping == false]", []string{"mass", "sleeping"}, 1)
+	if err != nil {
+		t.Fatalf("QueryNodes: %v", err)
+	}
+
+	params := <-got
+	if params["method"] != "query_nodes" || params["selector"] != "RigidBody3D [sleeping == false]" ||
+		params["properties"] != "mass,sleeping" || params["limit"] != "1" {
+		t.Errorf("unexpected params %v", params)
+	}
+	if result.Count != 1 || !result.Truncated || result.Source != "class_index" || result.Matches[0].Properties["mass"] != 2.0 {
+		t.Errorf("unexpected result %+v", result)
+	}
+}
+
+func TestDiffNodeCounts_SendsRefs(t *testing.T) {
+	dir := t.TempDir()
+	got := serveGameOnce(t, dir, `{"from":{"id":3},"to":{"id":9},"seconds":6,"changed":1,"grown":[{"class":"Area2D","script":"res://bullet.gd","before":10,"after":70,"delta":60}],"shrunk":[],"nodes":{"before":100,"after":160,"delta":60},"resources":{"before":-1,"after":40}}`)
+
+	client := NewClient(filepath.Join(dir, "peek.sock"))
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	result, err := client.DiffNodeCounts(ctx, 3, 0, 5)
+	if err != nil {
+		t.Fatalf("DiffNodeCounts: %v", err)
+	}
+
+	params := <-got
+	if params["method"] != "diff_counts" || params["from"] != "3" || params["to"] != "0" || params["limit"] != "5" {
+		t.Errorf("unexpected params %v", params)
+	}
+	if len(result.Grown) != 1 || result.Grown[0].Delta != 60 || result.Grown[0].Script != "res://bullet.gd" {
+		t.Errorf("unexpected grown %+v", result.Grown)
+	}
+	if result.Nodes.Delta == nil || *result.Nodes.Delta != 60 || result.Resources.Delta != nil {
+		t.Errorf("unexpected totals %+v %+v", result.Nodes, result.Resources)
+	}
+}
+
+func TestFindOrphans_SendsParams(t *testing.T) {
+	dir := t.TempDir()
+	got := serveGameOnce(t, dir, `{"tracking":true,"started":false,"tracked":3,"roots":1,"engine_orphans":5,"untracked":2,"groups":[{"class":"Area2D","script":"res://bullet.gd","scene_file":"res://bullet.tscn","count":3,"roots":1,"oldest_s":12.5,"samples":[{"id":42,"name":"Bullet","children":2,"frame":300,"detached_from":"/root/Level"}]}]}`)
+
+	client := NewClient(filepath.Join(dir, "peek.sock"))
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	result, err := client.FindOrphans(ctx, 5, 1, false)
+	if err != nil {
+		t.Fatalf("FindOrphans: %v", err)
+	}
+
+	params := <-got
+	if params["method"] != "find_orphans" || params["limit"] != "5" || params["samples"] != "1" || params["stop"] != "" {
+		t.Errorf("unexpected params %v", params)
+	}
+	if result.Untracked != 2 || len(result.Groups) != 1 || result.Groups[0].SceneFile != "res://bullet.tscn" {
+		t.Errorf("unexpected result %+v", result)
+	}
+	if s := result.Groups[0].Samples; len(s) != 1 || s[0].DetachedFrom != "/root/Level" || s[0].Children != 2 {
+		t.Errorf("unexpected samples %+v", s)
+	}
+}
+
+func TestLoadProfile_SendsSort(t *testing.T) {
+	dir := t.TempDir()
+	got := serveGameOnce(t, dir, `{"loads":3,"cache_hits":1,"wall_ms":1.5,"self_ms":1.5,"by_type":[{"type":"ArrayMesh","count":1,"self_ms":0.5}],"top":[{"path":"res://rock.mesh","type":"ArrayMesh","self_ms":0.5,"total_ms":1,"size":2048,"threaded":false,"cache_hits":0,"chain":["res://level.tscn"]}]}`)
+
+	client := NewClient(filepath.Join(dir, "peek.sock"))
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	result, err := client.LoadProfile(ctx, 5, true)
+	if err != nil {
+		t.Fatalf("LoadProfile: %v", err)
+	}
+
+	params := <-got
+	if params["method"] != "load_profile" || params["limit"] != "5" || params["sort"] != "total" {
+		t.Errorf("unexpected params %v", params)
+	}
+	if result.Loads != 3 || len(result.Top) != 1 || result.Top[0].Chain[0] != "res://level.tscn" || result.Top[0].Size != 2048 {
+		t.Errorf("unexpected result %+v", result)
+	}
+}
+
+func TestPhysicsSeries_SendsSince(t *testing.T) {
+	dir := t.TempDir()
+	got := serveGameOnce(t, dir, `{"samples":[{"id":8,"time_ms":5000,"ticks":60,"avg_ms":1.2,"max_ms":3.5,"physics_ms":6,"server_ms":2.5,"bodies":400,"rigid_active":120,"active_objects":130,"collision_pairs":900,"islands":12}],"stored":8,"newest":8}`)
+
+	client := NewClient(filepath.Join(dir, "peek.sock"))
+	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
+	defer cancel()
+	result, err := client.PhysicsSeries(ctx, 7, 50)
+	if err != nil {
+		t.Fatalf("PhysicsSeries: %v", err)
+	}
+
+	params := <-got
+	if params["method"] != "physics_series" || params["since"] != "7" || params["limit"] != "50" {
+		t.Errorf("unexpected params %v", params)
+	}
+	if result.Newest != 8 || len(result.Samples) != 1 || result.Samples[0].CollisionPairs != 900 || result.Samples[0].ServerMs != 2.5 {
+		t.Errorf("unexpected result %+v", result)
+	}
+}
+
+// --- output archive ---
+
+func TestGetArchivedOutput_SendsSession(t *testing.T) {
+	client, serverConn := newTestClient(t)
+	defer serverConn.Close()
+	defer client.Close()
+
+	params := make(chan map[string]interface{}, 1)
+	go func() {
+		scanner := bufio.NewScanner(serverConn)
+		if !scanner.Scan() {
+			return
+		}
+		var req struct {
+			ID     int64                  `json:"id"`
+			Params map[string]interface{} `json:"params"`
+		}
+		json.Unmarshal(scanner.Bytes(), &req)
+		params <- req.Params
+		resp := fmt.Sprintf(`{"id":%d,"result":{"session":1700000000000,"lines":[{"seq":5,"time":1700000000123,"text":"hi"}],"truncated":true,"next_seq":6}}`, req.ID)
+		serverConn.Write([]byte(resp + "\n"))
+	}()
+
+	result, err := client.GetArchivedOutput(context.Background(), ArchiveQueryParams{FromSeq: 5, Limit: 1})
+	if err != nil {
+		t.Fatalf("GetArchivedOutput: %v", err)
+	}
+	if len(result.Lines) != 1 || result.Lines[0].Text != "hi" || !result.Truncated || result.NextSeq != 6 {
+		t.Errorf("unexpected result %+v", result)
+	}
+
+	// session 0 must still be sent: it is what selects the archive
+	p := <-params
+	if v, ok := p["session"]; !ok || v.(float64) != 0 {
+		t.Errorf("expected session 0 in params, got %v", p)
+	}
+	if _, ok := p["to_seq"]; ok {
+		t.Errorf("unset bounds should be omitted, got %v", p)
+	}
+}
@@ -1,7 +1,13 @@
 package godot
 
 import (
+	"bufio"
+	"bytes"
+	"compress/zlib"
+	"encoding/binary"
 	"encoding/json"
+	"fmt"
+	"io"
 	"sync/atomic"
 )
 
@@ -24,6 +30,104 @@ type Response struct {
 	ID     int64            `json:"id"`
 	Result *json.RawMessage `json:"result,omitempty"`
 	Error  *ResponseError   `json:"error,omitempty"`
+
+	// raw binary frames that followed the response (binary framing only)
+	Attachments [][]byte `json:"-"`
+}
+
+// Framing modes. newline-delimited JSON is the default; binary frames are
+// negotiated with a handshake as the first message on the connection:
+//
+//	u32 payload length (big endian) | u8 content type | u8 flags | u16 reserved | payload
+const (
+	FramingNewline = "newline"
+	FramingBinary  = "binary"
+
+	frameHeaderSize = 8
+	maxFrameSize    = 64 << 20
+
+	contentJSON   = 1 // a JSON-RPC request or response
+	contentBinary = 2 // raw bytes attached to the preceding response
+
+	frameFlagMore    = 0x01 // another frame of the same reply follows
+	frameFlagDeflate = 0x02 // payload is zlib-format deflate
+
+	// CompressionDeflate asks the server to deflate large response frames
+	// (binary framing only)
+	CompressionDeflate = "deflate"
+)
+
+// NegotiateParams for the negotiate handshake
+type NegotiateParams struct {
+	Framing     string `json:"framing"`
+	Compression string `json:"compression,omitempty"`
+}
+
+// NegotiateResult from the negotiate handshake
+type NegotiateResult struct {
+	Framing     string `json:"framing"`
+	Compression string `json:"compression,omitempty"`
+	MaxFrame    int    `json:"max_frame"`
+}
+
+// frame is one length-prefixed message
+type frame struct {
+	contentType byte
+	flags       byte
+	payload     []byte
+}
+
+// encodeFrame builds a frame with the given content type and flags
+func encodeFrame(contentType, flags byte, payload []byte) []byte {
+	buf := make([]byte, frameHeaderSize+len(payload))
+	binary.BigEndian.PutUint32(buf[0:4], uint32(len(payload)))
+	buf[4] = contentType
+	buf[5] = flags
+	copy(buf[frameHeaderSize:], payload)
+	return buf
+}
+
+// readFrame reads one frame, inflating it if the server compressed it
+func readFrame(r *bufio.Reader) (frame, error) {
+	var header [frameHeaderSize]byte
+	if _, err := io.ReadFull(r, header[:]); err != nil {
+		return frame{}, err
+	}
+	size := binary.BigEndian.Uint32(header[0:4])
+	if size > maxFrameSize {
+		return frame{}, fmt.Errorf("frame too large: %d bytes", size)
+	}
+	f := frame{contentType: header[4], flags: header[5], payload: make([]byte, size)}
+	if _, err := io.ReadFull(r, f.payload); err != nil {
+		return frame{}, err
+	}
+	if f.flags&frameFlagDeflate != 0 {
+		payload, err := inflate(f.payload)
+		if err != nil {
+			return frame{}, fmt.Errorf("inflate frame: %w", err)
+		}
+		f.payload = payload
+		f.flags &^= frameFlagDeflate
+	}
+	return f, nil
+}
+
+// inflate decompresses a deflated frame payload, refusing anything that
+// expands past the frame size limit
+func inflate(data []byte) ([]byte, error) {
+	zr, err := zlib.NewReader(bytes.NewReader(data))
+	if err != nil {
+		return nil, err
+	}
+	defer zr.Close()
+	out, err := io.ReadAll(io.LimitReader(zr, maxFrameSize+1))
+	if err != nil {
+		return nil, err
+	}
+	if len(out) > maxFrameSize {
+		return nil, fmt.Errorf("inflated frame too large")
+	}
+	return out, nil
 }
 
 // ResponseError represents an error in the response
@@ -59,6 +163,7 @@ type RunSceneParams struct {
 	ScenePath      string    `json:"scene_path"`
 	Overrides      Overrides `json:"overrides,omitempty"`
 	TimeoutSeconds float64   `json:"timeout_seconds,omitempty"`
+	ProfileLoads   bool      `json:"profile_loads,omitempty"`
 }
 
 // RunCurrentSceneParams for run_current_scene method
@@ -73,6 +178,19 @@ type GetOutputParams struct {
 	NewOnly bool `json:"new_only"`
 }
 
+// ArchiveQueryParams for get_output reading the output archive. session 0
+// is the current session, negative values count back from it
+type ArchiveQueryParams struct {
+	Session int64 `json:"session"`
+	FromSeq int64 `json:"from_seq,omitempty"`
+	ToSeq   int64 `json:"to_seq,omitempty"`
+	Since   int64 `json:"since,omitempty"`
+	Until   int64 `json:"until,omitempty"`
+	Limit   int   `json:"limit,omitempty"`
+	// print, warning or error; empty for all
+	Level string `json:"level,omitempty"`
+}
+
 // GetLocalsParams for get_debugger_locals method
 type GetLocalsParams struct {
 	FrameIndex int `json:"frame_index"`
@@ -85,6 +203,85 @@ type OutputResult struct {
 	TotalLength int    `json:"total_length"`
 }
 
+// ArchivedLine is one line of archived output
+type ArchivedLine struct {
+	Seq   int64  `json:"seq"`
+	Time  int64  `json:"time"` // unix ms
+	Level string `json:"level"`
+	Text  string `json:"text"`
+	// only for lines of the live session
+	MonoMs *int64 `json:"mono_ms,omitempty"`
+	// editor frame the line was captured in, not the game frame that printed it
+	CaptureFrame *int64 `json:"capture_frame,omitempty"`
+	DebugSession *int   `json:"debug_session,omitempty"`
+}
+
+// ArchiveResult from get_output with archive parameters
+type ArchiveResult struct {
+	Session   int64          `json:"session"`
+	Lines     []ArchivedLine `json:"lines"`
+	Truncated bool           `json:"truncated"`
+	NextSeq   int64          `json:"next_seq"`
+}
+
+// OutputSession describes one archived output session
+type OutputSession struct {
+	Session   int64 `json:"session"`
+	FirstSeq  int64 `json:"first_seq"`
+	LastSeq   int64 `json:"last_seq"`
+	FirstTime int64 `json:"first_time"`
+	LastTime  int64 `json:"last_time"`
+	Bytes     int64 `json:"bytes"`
+	Segments  int   `json:"segments"`
+}
+
+// OutputSessionsResult from list_output_sessions
+type OutputSessionsResult struct {
+	Directory string          `json:"directory"`
+	Current   int64           `json:"current"`
+	DiskBytes int64           `json:"disk_bytes"`
+	Sessions  []OutputSession `json:"sessions"`
+}
+
+// GetOutputStatsParams for get_output_stats method
+type GetOutputStatsParams struct {
+	BucketMs int64 `json:"bucket_ms,omitempty"`
+	FromMs   int64 `json:"from_ms,omitempty"`
+	ToMs     int64 `json:"to_ms,omitempty"`
+}
+
+// OutputBucket counts the lines of one time bucket per level
+type OutputBucket struct {
+	T       int64 `json:"t"` // ms since the session began
+	Print   int64 `json:"print"`
+	Warning int64 `json:"warning"`
+	Error   int64 `json:"error"`
+	// first and last editor frame the bucket's lines were captured in
+	CaptureFrames [2]int64 `json:"capture_frames"`
+}
+
+// OutputStatsResult from get_output_stats
+type OutputStatsResult struct {
+	Session  int64            `json:"session"`
+	FirstSeq int64            `json:"first_seq"`
+	Lines    int64            `json:"lines"`
+	BucketMs int64            `json:"bucket_ms"`
+	Totals   map[string]int64 `json:"totals"`
+	Buckets  []OutputBucket   `json:"buckets"`
+}
+
+// SetOutputGovernorParams for set_output_governor method
+type SetOutputGovernorParams struct {
+	MaxLines int `json:"max_lines"`
+}
+
+// OutputGovernorResult from set_output_governor
+type OutputGovernorResult struct {
+	MaxLines     int   `json:"max_lines"`
+	TrimmedLines int64 `json:"trimmed_lines"`
+	Trims        int64 `json:"trims"`
+}
+
 // DebugErrorsResult from get_debugger_errors
 type DebugErrorsResult struct {
 	Errors string `json:"errors"`
@@ -118,6 +315,10 @@ type GenericResult struct {
 	ErrorDetected bool   `json:"error_detected,omitempty"`
 	StackTrace    string `json:"stack_trace,omitempty"`
 	Warnings      string `json:"warnings,omitempty"` // warnings from debugger errors tree (doesn't affect success)
+
+	// run_scene with profile_loads: the startup loads, or why they're missing
+	LoadProfile      *LoadProfileResult `json:"-"`
+	LoadProfileError string             `json:"-"`
 }
 
 // SceneTreeResult from get_remote_scene_tree
@@ -200,3 +401,229 @@ type EvaluateResult struct {
 	Error string `json:"error,omitempty"`
 }
 
+// NodeMatch is one node a query_nodes selector matched
+type NodeMatch struct {
+	Path       string                 `json:"path"`
+	Class      string                 `json:"class"`
+	Properties map[string]interface{} `json:"properties,omitempty"`
+}
+
+// ClassCount is the live node count of one class (and script)
+type ClassCount struct {
+	Class  string `json:"class"`
+	Script string `json:"script,omitempty"`
+	Count  int64  `json:"count"`
+}
+
+// CountSnapshotResult from the game's snapshot_counts command
+type CountSnapshotResult struct {
+	ID          int64        `json:"id"`
+	TimeMs      int64        `json:"time_ms"`
+	Frame       uint64       `json:"frame"`
+	Nodes       int64        `json:"nodes"`
+	Keys        int          `json:"keys"`
+	Objects     int64        `json:"objects"`
+	Resources   int64        `json:"resources"`
+	OrphanNodes int64        `json:"orphan_nodes"`
+	Top         []ClassCount `json:"top"`
+	IntervalMs  int64        `json:"interval_ms"`
+	Stored      int          `json:"stored"`
+	Error       string       `json:"error,omitempty"`
+}
+
+// ClassDelta is how one class's node count changed between two snapshots
+type ClassDelta struct {
+	Class  string `json:"class"`
+	Script string `json:"script,omitempty"`
+	Before int64  `json:"before"`
+	After  int64  `json:"after"`
+	Delta  int64  `json:"delta"`
+}
+
+// CountTotal is an engine-wide count in both snapshots (Delta is absent
+// when either side is unknown)
+type CountTotal struct {
+	Before int64  `json:"before"`
+	After  int64  `json:"after"`
+	Delta  *int64 `json:"delta,omitempty"`
+}
+
+// CountSnapshotRef identifies one side of a diff
+type CountSnapshotRef struct {
+	ID     int64  `json:"id"`
+	TimeMs int64  `json:"time_ms"`
+	Frame  uint64 `json:"frame"`
+}
+
+// CountDiffResult from the game's diff_counts command
+type CountDiffResult struct {
+	From        CountSnapshotRef `json:"from"`
+	To          CountSnapshotRef `json:"to"`
+	Seconds     float64          `json:"seconds"`
+	Changed     int              `json:"changed"`
+	Grown       []ClassDelta     `json:"grown"`
+	Shrunk      []ClassDelta     `json:"shrunk"`
+	Nodes       CountTotal       `json:"nodes"`
+	Objects     CountTotal       `json:"objects"`
+	Resources   CountTotal       `json:"resources"`
+	OrphanNodes CountTotal       `json:"orphan_nodes"`
+	Error       string           `json:"error,omitempty"`
+}
+
+// OrphanSample is one orphan root: alive, outside the tree, no parent
+type OrphanSample struct {
+	ID           uint64 `json:"id"`
+	Name         string `json:"name,omitempty"`
+	Children     int    `json:"children"`
+	Frame        uint64 `json:"frame"`
+	DetachedFrom string `json:"detached_from,omitempty"`
+}
+
+// OrphanGroup is the tracked orphans sharing a class, script and scene file
+type OrphanGroup struct {
+	Class     string         `json:"class"`
+	Script    string         `json:"script,omitempty"`
+	SceneFile string         `json:"scene_file,omitempty"`
+	Count     int            `json:"count"`
+	Roots     int            `json:"roots"`
+	OldestS   float64        `json:"oldest_s"`
+	Samples   []OrphanSample `json:"samples"`
+}
+
+// OrphansResult from the game's find_orphans command
+type OrphansResult struct {
+	Tracking      bool          `json:"tracking"`
+	Started       bool          `json:"started"`
+	SinceMs       int64         `json:"since_ms"`
+	Tracked       int           `json:"tracked"`
+	Roots         int           `json:"roots"`
+	Dropped       int64         `json:"dropped"`
+	EngineOrphans int64         `json:"engine_orphans"`
+	Untracked     int64         `json:"untracked"`
+	Groups        []OrphanGroup `json:"groups"`
+	Error         string        `json:"error,omitempty"`
+}
+
+// ResourceLoad is one timed resource load; Chain lists the loads that pulled
+// it in, outermost first
+type ResourceLoad struct {
+	Path      string   `json:"path"`
+	Type      string   `json:"type"`
+	SelfMs    float64  `json:"self_ms"`
+	TotalMs   float64  `json:"total_ms"`
+	StartMs   float64  `json:"start_ms"`
+	Size      int64    `json:"size"`
+	Threaded  bool     `json:"threaded"`
+	CacheHits int      `json:"cache_hits"`
+	Failed    bool     `json:"failed,omitempty"`
+	Chain     []string `json:"chain"`
+}
+
+// ResourceTypeLoads is the load time spent on one resource type
+type ResourceTypeLoads struct {
+	Type   string  `json:"type"`
+	Count  int     `json:"count"`
+	SelfMs float64 `json:"self_ms"`
+}
+
+// LoadProfileResult from the game's load_profile command
+type LoadProfileResult struct {
+	Loads     int                 `json:"loads"`
+	CacheHits int                 `json:"cache_hits"`
+	Failed    int                 `json:"failed"`
+	Pending   int                 `json:"pending"`
+	Dropped   int64               `json:"dropped"`
+	WallMs    float64             `json:"wall_ms"`
+	SelfMs    float64             `json:"self_ms"`
+	ByType    []ResourceTypeLoads `json:"by_type"`
+	Top       []ResourceLoad      `json:"top"`
+	Error     string              `json:"error,omitempty"`
+}
+
+// PhysicsTreePass is how long the scene tree's physics pass (scripts'
+// _physics_process and internal node processing) took per tick
+type PhysicsTreePass struct {
+	Ticks uint64  `json:"ticks"`
+	AvgMs float64 `json:"avg_ms"`
+	MaxMs float64 `json:"max_ms"`
+}
+
+// PhysicsServerCounts is a physics server's process info (-1 unknown)
+type PhysicsServerCounts struct {
+	ActiveObjects  int64 `json:"active_objects"`
+	CollisionPairs int64 `json:"collision_pairs"`
+	Islands        int64 `json:"islands"`
+}
+
+// PhysicsSpace counts the bodies in one 2D or 3D physics space
+type PhysicsSpace struct {
+	Space       uint64 `json:"space"`
+	Dims        int    `json:"dims"`
+	Rigid       int    `json:"rigid"`
+	RigidActive int    `json:"rigid_active"`
+	RigidFrozen int    `json:"rigid_frozen"`
+	Character   int    `json:"character"`
+	Static      int    `json:"static"`
+	Areas       int    `json:"areas"`
+}
+
+// PhysicsProcessor is how many nodes of a class and script run
+// _physics_process
+type PhysicsProcessor struct {
+	Class  string `json:"class"`
+	Script string `json:"script,omitempty"`
+	Nodes  int    `json:"nodes"`
+}
+
+// PhysicsSampleResult from the game's sample_physics command
+type PhysicsSampleResult struct {
+	ID                int64               `json:"id"`
+	TimeMs            int64               `json:"time_ms"`
+	Frame             uint64              `json:"frame"`
+	Tree              PhysicsTreePass     `json:"tree"`
+	PhysicsMs         float64             `json:"physics_ms"`
+	ServerMs          float64             `json:"server_ms"`
+	Server2D          PhysicsServerCounts `json:"server_2d"`
+	Server3D          PhysicsServerCounts `json:"server_3d"`
+	Spaces            []PhysicsSpace      `json:"spaces"`
+	PhysicsProcessing int                 `json:"physics_processing"`
+	Processors        []PhysicsProcessor  `json:"processors"`
+	IntervalMs        int64               `json:"interval_ms"`
+	Stored            int                 `json:"stored"`
+	Error             string              `json:"error,omitempty"`
+}
+
+// PhysicsSeriesRow is one sample in a physics series
+type PhysicsSeriesRow struct {
+	ID             int64   `json:"id"`
+	TimeMs         int64   `json:"time_ms"`
+	Ticks          uint64  `json:"ticks"`
+	AvgMs          float64 `json:"avg_ms"`
+	MaxMs          float64 `json:"max_ms"`
+	PhysicsMs      float64 `json:"physics_ms"`
+	ServerMs       float64 `json:"server_ms"`
+	Bodies         int     `json:"bodies"`
+	RigidActive    int     `json:"rigid_active"`
+	ActiveObjects  int64   `json:"active_objects"`
+	CollisionPairs int64   `json:"collision_pairs"`
+	Islands        int64   `json:"islands"`
+}
+
+// PhysicsSeriesResult from the game's physics_series command
+type PhysicsSeriesResult struct {
+	Samples []PhysicsSeriesRow `json:"samples"`
+	Stored  int                `json:"stored"`
+	Newest  int64              `json:"newest"`
+	Error   string             `json:"error,omitempty"`
+}
+
+// QueryNodesResult from the game's query_nodes command
+type QueryNodesResult struct {
+	Matches   []NodeMatch `json:"matches"`
+	Count     int         `json:"count"`
+	Truncated bool        `json:"truncated"`
+	Visited   int         `json:"visited"`
+	Source    string      `json:"source"`
+	Error     string      `json:"error,omitempty"`
+}
+
@@ -1,6 +1,9 @@
 package godot
 
 import (
+	"bufio"
+	"bytes"
+	"compress/zlib"
 	"encoding/json"
 	"sync"
 	"testing"
@@ -139,3 +142,57 @@ func TestResponseUnmarshal_WithError(t *testing.T) {
 		t.Errorf("expected message='something broke', got %s", resp.Error.Message)
 	}
 }
+
+func TestFrame_Roundtrip(t *testing.T) {
+	var buf bytes.Buffer
+	buf.Write(encodeFrame(contentJSON, frameFlagMore, []byte(`{"id":1}`)))
+	buf.Write(encodeFrame(contentBinary, 0, []byte{0, '\n', 0xff}))
+
+	r := bufio.NewReader(&buf)
+	f, err := readFrame(r)
+	if err != nil {
+		t.Fatalf("readFrame: %v", err)
+	}
+	if f.contentType != contentJSON || f.flags != frameFlagMore || string(f.payload) != `{"id":1}` {
+		t.Errorf("unexpected first frame: %+v", f)
+	}
+	f, err = readFrame(r)
+	if err != nil {
+		t.Fatalf("readFrame: %v", err)
+	}
+	if f.contentType != contentBinary || f.flags != 0 || !bytes.Equal(f.payload, []byte{0, '\n', 0xff}) {
+		t.Errorf("unexpected second frame: %+v", f)
+	}
+}
+
+func TestFrame_RejectsOversized(t *testing.T) {
+	header := []byte{0x7f, 0xff, 0xff, 0xff, contentJSON, 0, 0, 0}
+	if _, err := readFrame(bufio.NewReader(bytes.NewReader(header))); err == nil {
+		t.Error("expected error for oversized frame")
+	}
+}
+
+func TestFrame_InflatesDeflated(t *testing.T) {
+	payload := bytes.Repeat([]byte(`{"name":"position","value":"(1, 2)"},`), 2000)
+	var packed bytes.Buffer
+	zw := zlib.NewWriter(&packed)
+	zw.Write(payload)
+	zw.Close()
+
+	var buf bytes.Buffer
+	buf.Write(encodeFrame(contentJSON, frameFlagDeflate|frameFlagMore, packed.Bytes()))
+	f, err := readFrame(bufio.NewReader(&buf))
+	if err != nil {
+		t.Fatalf("readFrame: %v", err)
+	}
+	if f.flags != frameFlagMore || !bytes.Equal(f.payload, payload) {
+		t.Errorf("unexpected inflated frame: flags=%d len=%d", f.flags, len(f.payload))
+	}
+}
+
+func TestFrame_RejectsCorruptDeflate(t *testing.T) {
+	frame := encodeFrame(contentJSON, frameFlagDeflate, []byte("not deflate"))
+	if _, err := readFrame(bufio.NewReader(bytes.NewReader(frame))); err == nil {
+		t.Error("expected error for corrupt deflate payload")
+	}
+}
@@ -0,0 +1,127 @@
+package godot
+
+import (
+	"encoding/json"
+	"errors"
+	"os"
+	"path/filepath"
+	"sort"
+	"strconv"
+	"strings"
+	"syscall"
+)
+
+// DefaultRegistryDir is where editors advertise themselves (one <pid>.json
+// per running editor, written by the plugin's instance registry). it is per
+// user: $XDG_RUNTIME_DIR/godot-peek-registry, else /tmp/godot-peek-registry-<uid>
+func DefaultRegistryDir() string {
+	if runtime := os.Getenv("XDG_RUNTIME_DIR"); runtime != "" {
+		return filepath.Join(runtime, "godot-peek-registry")
+	}
+	return "/tmp/godot-peek-registry-" + strconv.Itoa(os.Getuid())
+}
+
+// Instance is one running editor from the discovery registry
+type Instance struct {
+	PID          int    `json:"pid"`
+	ProjectPath  string `json:"project_path"`
+	ProjectHash  string `json:"project_hash"`
+	SocketPath   string `json:"socket_path"`
+	GodotVersion string `json:"godot_version"`
+	StartedAt    int64  `json:"started_at"`
+}
+
+// ListInstancesResult from list_instances
+type ListInstancesResult struct {
+	PID       int        `json:"pid"`
+	Registry  string     `json:"registry"`
+	Instances []Instance `json:"instances"`
+}
+
+// RegistryDir returns GODOT_PEEK_REGISTRY or the default registry directory
+func RegistryDir() string {
+	if dir := os.Getenv("GODOT_PEEK_REGISTRY"); dir != "" {
+		return dir
+	}
+	return DefaultRegistryDir()
+}
+
+// ownedByUs reports whether info belongs to the current user. anyone who
+// can write entries can point us at their socket, so other users' are skipped
+func ownedByUs(info os.FileInfo) bool {
+	st, ok := info.Sys().(*syscall.Stat_t)
+	return ok && int(st.Uid) == os.Getuid()
+}
+
+// pidAlive reports whether a process exists (EPERM means it does, we just
+// can't signal it)
+func pidAlive(pid int) bool {
+	if pid <= 0 {
+		return false
+	}
+	err := syscall.Kill(pid, 0)
+	return err == nil || errors.Is(err, syscall.EPERM)
+}
+
+// ListInstances reads every live editor of the current user from the
+// registry in dir, oldest first. entries owned by other users are skipped.
+// entries for dead pids and unreadable entries are removed, matching what
+// the plugin does when it lists
+func ListInstances(dir string) ([]Instance, error) {
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		if errors.Is(err, os.ErrNotExist) {
+			return nil, nil
+		}
+		return nil, err
+	}
+
+	var live []Instance
+	for _, entry := range entries {
+		if entry.IsDir() || !strings.HasSuffix(entry.Name(), ".json") {
+			continue
+		}
+		path := filepath.Join(dir, entry.Name())
+		if info, err := os.Lstat(path); err != nil || !info.Mode().IsRegular() || !ownedByUs(info) {
+			continue
+		}
+		data, err := os.ReadFile(path)
+		if err != nil {
+			continue
+		}
+		var inst Instance
+		if err := json.Unmarshal(data, &inst); err != nil || inst.SocketPath == "" || !pidAlive(inst.PID) {
+			os.Remove(path)
+			continue
+		}
+		live = append(live, inst)
+	}
+
+	sort.Slice(live, func(i, j int) bool {
+		if live[i].StartedAt != live[j].StartedAt {
+			return live[i].StartedAt < live[j].StartedAt
+		}
+		return live[i].PID < live[j].PID
+	})
+	return live, nil
+}
+
+// FindInstance picks the editor whose project contains dir (the deepest
+// match wins, so nested projects resolve to the inner one)
+func FindInstance(instances []Instance, dir string) (Instance, bool) {
+	dir = filepath.Clean(dir)
+	best := -1
+	for i, inst := range instances {
+		project := filepath.Clean(inst.ProjectPath)
+		if inst.ProjectPath == "" || (dir != project && !strings.HasPrefix(dir, project+string(filepath.Separator))) {
+			continue
+		}
+		if best < 0 || len(project) > len(filepath.Clean(instances[best].ProjectPath)) {
+			best = i
+		}
+	}
+	if best < 0 {
+		return Instance{}, false
+	}
+	return instances[best], true
+}
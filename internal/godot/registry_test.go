@@ -0,0 +1,122 @@
+package godot
+
+import (
+	"encoding/json"
+	"os"
+	"path/filepath"
+	"strconv"
+	"testing"
+)
+
+func writeEntry(t *testing.T, dir string, inst Instance) {
+	t.Helper()
+	data, err := json.Marshal(inst)
+	if err != nil {
+		t.Fatal(err)
+	}
+	name := filepath.Join(dir, jsonName(inst.PID))
+	if err := os.WriteFile(name, data, 0644); err != nil {
+		t.Fatal(err)
+	}
+}
+
+func jsonName(pid int) string {
+	return strconv.Itoa(pid) + ".json"
+}
+
+func TestListInstances_PrunesStale(t *testing.T) {
+	dir := t.TempDir()
+	self := Instance{PID: os.Getpid(), ProjectPath: "/home/me/game", SocketPath: "/tmp/godot-peek-game.sock", StartedAt: 2}
+	dead := Instance{PID: 0x7ffffff0, ProjectPath: "/home/me/old", SocketPath: "/tmp/godot-peek-old.sock", StartedAt: 1}
+	writeEntry(t, dir, self)
+	writeEntry(t, dir, dead)
+	os.WriteFile(filepath.Join(dir, "123.json"), []byte("{not json"), 0644)
+	os.WriteFile(filepath.Join(dir, "456.json.tmp"), []byte("{}"), 0644)
+
+	live, err := ListInstances(dir)
+	if err != nil {
+		t.Fatalf("ListInstances: %v", err)
+	}
+	if len(live) != 1 || live[0].PID != os.Getpid() || live[0].SocketPath != self.SocketPath {
+		t.Fatalf("unexpected instances: %+v", live)
+	}
+	for _, name := range []string{jsonName(dead.PID), "123.json"} {
+		if _, err := os.Stat(filepath.Join(dir, name)); !os.IsNotExist(err) {
+			t.Errorf("expected %s to be pruned", name)
+		}
+	}
+	if _, err := os.Stat(filepath.Join(dir, "456.json.tmp")); err != nil {
+		t.Error("in-progress entries must be left alone")
+	}
+}
+
+func TestListInstances_SkipsOtherUsers(t *testing.T) {
+	if os.Getuid() != 0 {
+		t.Skip("needs root to create entries owned by another user")
+	}
+	dir := t.TempDir()
+	self := Instance{PID: os.Getpid(), ProjectPath: "/home/me/game", SocketPath: "/tmp/godot-peek-game.sock"}
+	other := Instance{PID: 1, ProjectPath: "/home/eve/game", SocketPath: "/tmp/evil.sock"}
+	writeEntry(t, dir, self)
+	writeEntry(t, dir, other)
+	if err := os.Chown(filepath.Join(dir, jsonName(other.PID)), 12345, 12345); err != nil {
+		t.Fatal(err)
+	}
+
+	live, err := ListInstances(dir)
+	if err != nil {
+		t.Fatalf("ListInstances: %v", err)
+	}
+	if len(live) != 1 || live[0].PID != os.Getpid() {
+		t.Fatalf("unexpected instances: %+v", live)
+	}
+	if _, err := os.Stat(filepath.Join(dir, jsonName(other.PID))); err != nil {
+		t.Error("other users' entries must be left alone")
+	}
+}
+
+func TestDefaultRegistryDir(t *testing.T) {
+	t.Setenv("XDG_RUNTIME_DIR", "/run/user/1000")
+	if got := DefaultRegistryDir(); got != "/run/user/1000/godot-peek-registry" {
+		t.Errorf("with XDG_RUNTIME_DIR: got %q", got)
+	}
+	t.Setenv("XDG_RUNTIME_DIR", "")
+	if got, want := DefaultRegistryDir(), "/tmp/godot-peek-registry-"+strconv.Itoa(os.Getuid()); got != want {
+		t.Errorf("without XDG_RUNTIME_DIR: got %q, want %q", got, want)
+	}
+}
+
+func TestListInstances_MissingDir(t *testing.T) {
+	live, err := ListInstances(filepath.Join(t.TempDir(), "nope"))
+	if err != nil || len(live) != 0 {
+		t.Errorf("expected no instances and no error, got %v, %v", live, err)
+	}
+}
+
+func TestFindInstance(t *testing.T) {
+	instances := []Instance{
+		{PID: 1, ProjectPath: "/home/me/game", SocketPath: "/tmp/a.sock"},
+		{PID: 2, ProjectPath: "/home/me/game/tools/editor", SocketPath: "/tmp/b.sock"},
+		{PID: 3, ProjectPath: "/home/you/game", SocketPath: "/tmp/c.sock"},
+	}
+
+	cases := map[string]int{
+		"/home/me/game":                  1,
+		"/home/me/game/scripts":          1,
+		"/home/me/game/tools/editor/src": 2,
+		"/home/you/game/":                3,
+		"/home/me/gamer":                 0,
+	}
+	for dir, want := range cases {
+		inst, ok := FindInstance(instances, dir)
+		if want == 0 {
+			if ok {
+				t.Errorf("%s: expected no match, got pid %d", dir, inst.PID)
+			}
+			continue
+		}
+		if !ok || inst.PID != want {
+			t.Errorf("%s: expected pid %d, got %d (ok=%v)", dir, want, inst.PID, ok)
+		}
+	}
+}
@@ -2,7 +2,10 @@ package tools
 
 import (
 	"context"
+	"encoding/json"
 	"fmt"
+	"strings"
+	"time"
 
 	"github.com/mark3labs/mcp-go/mcp"
 	"github.com/mark3labs/mcp-go/server"
@@ -39,6 +42,9 @@ func Register(s *server.MCPServer, client *godot.Client) {
 			mcp.WithObject("overrides",
 				mcp.Description("Override autoload variables on startup. Map of autoload names to property overrides, e.g. {\"DebugManager\": {\"debug_mode\": true}}"),
 			),
+			mcp.WithBoolean("profile_loads",
+				mcp.Description("Time every resource load from startup and report the slowest ones (get_load_profile has the rest)"),
+			),
 		),
 		makeRunScene(client),
 	)
@@ -75,10 +81,68 @@ func Register(s *server.MCPServer, client *godot.Client) {
 			mcp.WithBoolean("clear",
 				mcp.Description("If true, mark current position for future new_only calls"),
 			),
+			mcp.WithNumber("session",
+				mcp.Description("Read the output archive instead of the panel: 0 = current session, -1 = the one before, or a session id from list_output_sessions"),
+			),
+			mcp.WithNumber("from_seq",
+				mcp.Description("Archive: first line number to return"),
+			),
+			mcp.WithNumber("to_seq",
+				mcp.Description("Archive: last line number to return"),
+			),
+			mcp.WithNumber("since",
+				mcp.Description("Archive: only lines at or after this unix time in milliseconds"),
+			),
+			mcp.WithNumber("until",
+				mcp.Description("Archive: only lines at or before this unix time in milliseconds"),
+			),
+			mcp.WithNumber("limit",
+				mcp.Description("Archive: maximum lines to return (default 200)"),
+			),
+			mcp.WithString("level",
+				mcp.Description("Archive: only lines of this level (print, warning or error)"),
+			),
 		),
 		makeGetOutput(client),
 	)
 
+	// get_output_stats - output line counts per level over time
+	s.AddTool(
+		mcp.NewTool("get_output_stats",
+			mcp.WithDescription("Count the current session's output lines per level (print, warning, error) in time buckets, with the editor frame range of each bucket. Use it to find log or error bursts without downloading the output."),
+			mcp.WithNumber("bucket_ms",
+				mcp.Description("Bucket width in milliseconds (default 1000)"),
+			),
+			mcp.WithNumber("from_ms",
+				mcp.Description("Start, in ms since the session began"),
+			),
+			mcp.WithNumber("to_ms",
+				mcp.Description("End, in ms since the session began"),
+			),
+		),
+		makeGetOutputStats(client),
+	)
+
+	// set_output_governor - cap the Output panel under log floods
+	s.AddTool(
+		mcp.NewTool("set_output_governor",
+			mcp.WithDescription("Cap how many lines the editor's Output panel keeps, so a game that prints every frame doesn't slow the editor down. Older lines are removed from the panel but stay in the output archive (get_output with session/from_seq)."),
+			mcp.WithNumber("max_lines",
+				mcp.Required(),
+				mcp.Description("Maximum panel lines (at least 100); 0 turns the cap off"),
+			),
+		),
+		makeSetOutputGovernor(client),
+	)
+
+	// list_output_sessions - sessions kept in the output archive
+	s.AddTool(
+		mcp.NewTool("list_output_sessions",
+			mcp.WithDescription("List the editor and game sessions kept in the output archive (ids, line ranges, times), newest last. Use with get_output's session parameter to read past runs."),
+		),
+		makeListOutputSessions(client),
+	)
+
 	// get_debugger_errors - get debugger errors/warnings
 	s.AddTool(
 		mcp.NewTool("get_debugger_errors",
@@ -219,6 +283,135 @@ func Register(s *server.MCPServer, client *godot.Client) {
 		),
 		makeEvaluateExpression(client),
 	)
+
+	// query_nodes - selector query over the running game's scene tree
+	s.AddTool(
+		mcp.NewTool("query_nodes",
+			mcp.WithDescription("Find nodes in the running game with one selector instead of dumping the tree and reading properties node by node. Returns matching paths, classes and the requested properties. Needs the native runtime (GDExtension loaded in the game)."),
+			mcp.WithString("selector",
+				mcp.Required(),
+				mcp.Description("Space-separated terms, all must match: '/root/Level' (subtree to search, default /root), 'RigidBody3D' (class, subclasses included), '#Crate*' (name glob), '.enemies' (group), '[sleeping == false]' (property test: == != < <= > >=, property may be 'position:y'), ':depth(2)' (levels below the root). Example: '/root/Level RigidBody3D [sleeping == false]'"),
+			),
+			mcp.WithString("properties",
+				mcp.Description("Comma-separated properties to return for each match, e.g. 'mass,linear_velocity'"),
+			),
+			mcp.WithNumber("limit",
+				mcp.Description("Maximum matches to return (default 100, max 10000)"),
+			),
+		),
+		makeQueryNodes(client),
+	)
+
+	// snapshot_node_counts / diff_node_counts - leak hunting by class
+	s.AddTool(
+		mcp.NewTool("snapshot_node_counts",
+			mcp.WithDescription("Count the running game's live nodes per class and script (plus engine-wide object, resource and orphan counts) and keep the snapshot for diff_node_counts. Set interval_ms to keep taking one that often while the game runs."),
+			mcp.WithNumber("interval_ms",
+				mcp.Description("Take a snapshot this often (at least 250); 0 stops periodic snapshots"),
+			),
+			mcp.WithNumber("top",
+				mcp.Description("How many of the largest classes to list (default 20)"),
+			),
+		),
+		makeSnapshotNodeCounts(client),
+	)
+
+	s.AddTool(
+		mcp.NewTool("diff_node_counts",
+			mcp.WithDescription("Compare two node count snapshots and list the classes that grew (and shrank) the most. Slowly growing classes point at leaks."),
+			mcp.WithNumber("from",
+				mcp.Description("Snapshot id, or 0 for the newest and -N for N before it (default -1)"),
+			),
+			mcp.WithNumber("to",
+				mcp.Description("Snapshot id, or 0 for the newest (default 0)"),
+			),
+			mcp.WithNumber("limit",
+				mcp.Description("Classes per list (default 20)"),
+			),
+		),
+		makeDiffNodeCounts(client),
+	)
+
+	// find_orphan_nodes - who is leaking nodes outside the tree
+	s.AddTool(
+		mcp.NewTool("find_orphan_nodes",
+			mcp.WithDescription("List the running game's orphan nodes (alive but outside the scene tree) grouped by class, script and scene file, with the oldest orphan roots and the parent each was detached from. The first call starts tracking; only nodes detached after that are attributed, the rest are reported as untracked."),
+			mcp.WithNumber("limit",
+				mcp.Description("Groups to list (default 20)"),
+			),
+			mcp.WithNumber("samples",
+				mcp.Description("Orphan roots to show per group, oldest first (default 3)"),
+			),
+			mcp.WithBoolean("stop",
+				mcp.Description("Stop tracking and drop what was recorded"),
+			),
+		),
+		makeFindOrphanNodes(client),
+	)
+
+	// get_load_profile - resource load times of a run_scene profile_loads run
+	s.AddTool(
+		mcp.NewTool("get_load_profile",
+			mcp.WithDescription("Report the running game's resource loads (needs run_scene with profile_loads): the slowest loads with type, size, whether they ran threaded and the chain of loads that pulled each in, plus load time per resource type."),
+			mcp.WithNumber("limit",
+				mcp.Description("Loads and types to list (default 20)"),
+			),
+			mcp.WithString("sort",
+				mcp.Description("\"self\" (default): time in the load itself; \"total\": including the dependencies it loaded"),
+			),
+		),
+		makeGetLoadProfile(client),
+	)
+
+	// sample_physics / get_physics_series - what drives physics cost
+	s.AddTool(
+		mcp.NewTool("sample_physics",
+			mcp.WithDescription("Sample the running game's physics: bodies per physics space (how many rigid bodies are awake), the 2D/3D servers' active objects, collision pairs and islands, how long the scene tree's physics pass (_physics_process) takes per tick, the engine's physics tick time and the server's share of it, and which scripts run _physics_process. Set interval_ms to keep sampling into a series for get_physics_series."),
+			mcp.WithNumber("interval_ms",
+				mcp.Description("Take a sample this often (at least 100); 0 stops periodic sampling"),
+			),
+			mcp.WithNumber("top",
+				mcp.Description("How many _physics_process classes/scripts to list (default 20)"),
+			),
+			mcp.WithBoolean("stop",
+				mcp.Description("Stop sampling and timing the physics pass"),
+			),
+		),
+		makeSamplePhysics(client),
+	)
+
+	s.AddTool(
+		mcp.NewTool("get_physics_series",
+			mcp.WithDescription("Physics samples over time (from sample_physics with interval_ms), oldest first: tree pass and server time, awake bodies, collision pairs and islands per sample."),
+			mcp.WithNumber("since",
+				mcp.Description("Only samples after this id (default 0: all)"),
+			),
+			mcp.WithNumber("limit",
+				mcp.Description("At most this many of the newest samples (default 120)"),
+			),
+		),
+		makeGetPhysicsSeries(client),
+	)
+
+	// list_editors - discover running editors
+	s.AddTool(
+		mcp.NewTool("list_editors",
+			mcp.WithDescription("List running Godot editors with the peek plugin (project path, socket, Godot version, pid). The one this server is talking to is marked as current."),
+		),
+		makeListEditors(client),
+	)
+
+	// select_editor - switch to another running editor
+	s.AddTool(
+		mcp.NewTool("select_editor",
+			mcp.WithDescription("Switch this server to another running Godot editor. All later tool calls go to that editor."),
+			mcp.WithString("project",
+				mcp.Required(),
+				mcp.Description("Project path of the editor (as shown by list_editors), a directory inside it, or its socket path"),
+			),
+		),
+		makeSelectEditor(client),
+	)
 }
 
 // getTimeoutArg extracts the optional timeout_seconds arg from request
@@ -298,7 +491,8 @@ func makeRunScene(client *godot.Client) server.ToolHandlerFunc {
 
 		timeout := getTimeoutArg(req)
 		overrides := getOverridesArg(req)
-		result, err := client.RunScene(ctx, scenePath, overrides, timeout)
+		profileLoads, _ := req.GetArguments()["profile_loads"].(bool)
+		result, err := client.RunScene(ctx, scenePath, overrides, timeout, profileLoads)
 		if err != nil {
 			return mcp.NewToolResultError(fmt.Sprintf("failed to run scene: %v", err)), nil
 		}
@@ -314,6 +508,11 @@ func makeRunScene(client *godot.Client) server.ToolHandlerFunc {
 		if result.Warnings != "" {
 			msg += fmt.Sprintf("\n\nWarnings:\n%s", result.Warnings)
 		}
+		if result.LoadProfile != nil {
+			msg += "\n\n" + formatLoadProfile(result.LoadProfile)
+		} else if result.LoadProfileError != "" {
+			msg += fmt.Sprintf("\n\nNo load profile: %s", result.LoadProfileError)
+		}
 
 		return mcp.NewToolResultText(msg), nil
 	}
@@ -378,6 +577,9 @@ func makeGetOutput(client *godot.Client) server.ToolHandlerFunc {
 			if v, ok := args["new_only"].(bool); ok {
 				newOnly = v
 			}
+			if params, ok := archiveQueryArgs(args); ok {
+				return getArchivedOutput(ctx, client, params)
+			}
 		}
 
 		output, err := client.GetOutputFromGodot(ctx, clear, newOnly)
@@ -393,6 +595,148 @@ func makeGetOutput(client *godot.Client) server.ToolHandlerFunc {
 	}
 }
 
+// archiveQueryArgs collects get_output's archive arguments. false when none
+// was given, i.e. the call reads the Output panel
+func archiveQueryArgs(args map[string]interface{}) (godot.ArchiveQueryParams, bool) {
+	var params godot.ArchiveQueryParams
+	found := false
+	number := func(key string) int64 {
+		v, ok := args[key].(float64)
+		if ok {
+			found = true
+		}
+		return int64(v)
+	}
+	params.Session = number("session")
+	params.FromSeq = number("from_seq")
+	params.ToSeq = number("to_seq")
+	params.Since = number("since")
+	params.Until = number("until")
+	params.Limit = int(number("limit"))
+	if v, ok := args["level"].(string); ok && v != "" {
+		params.Level = v
+		found = true
+	}
+	return params, found
+}
+
+func getArchivedOutput(ctx context.Context, client *godot.Client, params godot.ArchiveQueryParams) (*mcp.CallToolResult, error) {
+	result, err := client.GetArchivedOutput(ctx, params)
+	if err != nil {
+		return mcp.NewToolResultError(fmt.Sprintf("failed to get output: %v", err)), nil
+	}
+	if len(result.Lines) == 0 {
+		return mcp.NewToolResultText(fmt.Sprintf("No output in session %d for that range", result.Session)), nil
+	}
+
+	output := fmt.Sprintf("session %d\n", result.Session)
+	for _, line := range result.Lines {
+		frame := ""
+		if line.CaptureFrame != nil {
+			frame = fmt.Sprintf(" editor frame %d", *line.CaptureFrame)
+		}
+		output += fmt.Sprintf("[%d %s%s] %s\n", line.Seq, time.UnixMilli(line.Time).Format("15:04:05.000"), frame, line.Text)
+	}
+	if result.Truncated {
+		output += fmt.Sprintf("... more lines, continue with from_seq=%d\n", result.NextSeq)
+	}
+	return mcp.NewToolResultText(output), nil
+}
+
+func makeGetOutputStats(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		if !client.IsConnected() {
+			return mcp.NewToolResultError("not connected to Godot editor"), nil
+		}
+
+		var params godot.GetOutputStatsParams
+		if args := req.GetArguments(); args != nil {
+			if v, ok := args["bucket_ms"].(float64); ok {
+				params.BucketMs = int64(v)
+			}
+			if v, ok := args["from_ms"].(float64); ok {
+				params.FromMs = int64(v)
+			}
+			if v, ok := args["to_ms"].(float64); ok {
+				params.ToMs = int64(v)
+			}
+		}
+
+		result, err := client.GetOutputStats(ctx, params)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to get output stats: %v", err)), nil
+		}
+		if len(result.Buckets) == 0 {
+			return mcp.NewToolResultText("No output in that range"), nil
+		}
+
+		output := fmt.Sprintf("session %d: %d print, %d warning, %d error\n", result.Session,
+			result.Totals["print"], result.Totals["warning"], result.Totals["error"])
+		for _, b := range result.Buckets {
+			output += fmt.Sprintf("%7.1fs  print %d  warning %d  error %d  editor frames %d-%d\n",
+				float64(b.T)/1000, b.Print, b.Warning, b.Error, b.CaptureFrames[0], b.CaptureFrames[1])
+		}
+		return mcp.NewToolResultText(output), nil
+	}
+}
+
+func makeSetOutputGovernor(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		if !client.IsConnected() {
+			return mcp.NewToolResultError("not connected to Godot editor"), nil
+		}
+
+		args := req.GetArguments()
+		maxLines, ok := args["max_lines"].(float64)
+		if !ok || maxLines < 0 {
+			return mcp.NewToolResultError("max_lines is required"), nil
+		}
+
+		result, err := client.SetOutputGovernor(ctx, int(maxLines))
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to set output governor: %v", err)), nil
+		}
+		if result.MaxLines == 0 {
+			return mcp.NewToolResultText(fmt.Sprintf("Output panel cap off (%d lines trimmed so far)", result.TrimmedLines)), nil
+		}
+		return mcp.NewToolResultText(fmt.Sprintf("Output panel capped at %d lines (%d lines trimmed so far)",
+			result.MaxLines, result.TrimmedLines)), nil
+	}
+}
+
+func makeListOutputSessions(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		if !client.IsConnected() {
+			return mcp.NewToolResultError("not connected to Godot editor"), nil
+		}
+
+		result, err := client.ListOutputSessions(ctx)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to list output sessions: %v", err)), nil
+		}
+		if len(result.Sessions) == 0 {
+			return mcp.NewToolResultText("No archived output"), nil
+		}
+
+		var output string
+		for _, s := range result.Sessions {
+			marker := ""
+			if s.Session == result.Current {
+				marker = " (current)"
+			}
+			start := time.UnixMilli(s.Session).Format("2006-01-02 15:04:05")
+			if s.FirstSeq == 0 {
+				output += fmt.Sprintf("%d%s started %s, no lines\n", s.Session, marker, start)
+				continue
+			}
+			output += fmt.Sprintf("%d%s started %s, lines %d-%d, %s to %s, %d KiB\n", s.Session, marker, start,
+				s.FirstSeq, s.LastSeq, time.UnixMilli(s.FirstTime).Format("15:04:05"),
+				time.UnixMilli(s.LastTime).Format("15:04:05"), s.Bytes/1024)
+		}
+		return mcp.NewToolResultText(output), nil
+	}
+}
+
 func makeGetDebugErrors(client *godot.Client) server.ToolHandlerFunc {
 	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
 		if !client.IsConnected() {
@@ -721,3 +1065,390 @@ func makeEvaluateExpression(client *godot.Client) server.ToolHandlerFunc {
 	}
 }
 
+func makeQueryNodes(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		// note: talks directly to the game, like evaluate_expression
+		selector, err := req.RequireString("selector")
+		if err != nil {
+			return mcp.NewToolResultError("missing required parameter: selector"), nil
+		}
+		args := req.GetArguments()
+		var properties []string
+		if v, ok := args["properties"].(string); ok {
+			for _, p := range strings.Split(v, ",") {
+				if p = strings.TrimSpace(p); p != "" {
+					properties = append(properties, p)
+				}
+			}
+		}
+		limit := 0
+		if v, ok := args["limit"].(float64); ok && v > 0 {
+			limit = int(v)
+		}
+
+		result, err := client.QueryNodes(ctx, selector, properties, limit)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to query nodes: %v", err)), nil
+		}
+		if result.Count == 0 {
+			return mcp.NewToolResultText(fmt.Sprintf("No nodes match (%d candidates checked)", result.Visited)), nil
+		}
+
+		var output strings.Builder
+		for _, m := range result.Matches {
+			fmt.Fprintf(&output, "%s (%s)", m.Path, m.Class)
+			if len(m.Properties) > 0 {
+				props, _ := json.Marshal(m.Properties)
+				fmt.Fprintf(&output, " %s", props)
+			}
+			output.WriteString("\n")
+		}
+		if result.Truncated {
+			fmt.Fprintf(&output, "... more matches; raise limit to see them\n")
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+// helper: a class with its script, if it has one
+func classLabel(class, script string) string {
+	if script == "" {
+		return class
+	}
+	return fmt.Sprintf("%s (%s)", class, script)
+}
+
+func makeSnapshotNodeCounts(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		interval := -1
+		if v, ok := args["interval_ms"].(float64); ok && v >= 0 {
+			interval = int(v)
+		}
+		top := 0
+		if v, ok := args["top"].(float64); ok && v > 0 {
+			top = int(v)
+		}
+
+		result, err := client.SnapshotNodeCounts(ctx, interval, top)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to snapshot node counts: %v", err)), nil
+		}
+
+		var output strings.Builder
+		fmt.Fprintf(&output, "Snapshot %d: %d nodes in %d classes (objects %d, resources %d, orphan nodes %d)\n",
+			result.ID, result.Nodes, result.Keys, result.Objects, result.Resources, result.OrphanNodes)
+		for _, c := range result.Top {
+			fmt.Fprintf(&output, "%8d  %s\n", c.Count, classLabel(c.Class, c.Script))
+		}
+		if result.IntervalMs > 0 {
+			fmt.Fprintf(&output, "Taking one every %d ms (%d stored)\n", result.IntervalMs, result.Stored)
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+func makeDiffNodeCounts(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		from := int64(-1)
+		if v, ok := args["from"].(float64); ok {
+			from = int64(v)
+		}
+		to := int64(0)
+		if v, ok := args["to"].(float64); ok {
+			to = int64(v)
+		}
+		limit := 0
+		if v, ok := args["limit"].(float64); ok && v > 0 {
+			limit = int(v)
+		}
+
+		result, err := client.DiffNodeCounts(ctx, from, to, limit)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to diff node counts: %v", err)), nil
+		}
+
+		var output strings.Builder
+		fmt.Fprintf(&output, "Snapshot %d -> %d over %.1fs: nodes %d -> %d, %d classes changed\n",
+			result.From.ID, result.To.ID, result.Seconds, result.Nodes.Before, result.Nodes.After, result.Changed)
+		for _, t := range []struct {
+			name  string
+			total godot.CountTotal
+		}{{"objects", result.Objects}, {"resources", result.Resources}, {"orphan nodes", result.OrphanNodes}} {
+			if t.total.Delta != nil {
+				fmt.Fprintf(&output, "%s: %d -> %d (%+d)\n", t.name, t.total.Before, t.total.After, *t.total.Delta)
+			}
+		}
+		if len(result.Grown) > 0 {
+			output.WriteString("Grew:\n")
+			for _, d := range result.Grown {
+				fmt.Fprintf(&output, "%+8d  %s (%d -> %d)\n", d.Delta, classLabel(d.Class, d.Script), d.Before, d.After)
+			}
+		}
+		if len(result.Shrunk) > 0 {
+			output.WriteString("Shrank:\n")
+			for _, d := range result.Shrunk {
+				fmt.Fprintf(&output, "%+8d  %s (%d -> %d)\n", d.Delta, classLabel(d.Class, d.Script), d.Before, d.After)
+			}
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+func makeFindOrphanNodes(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		limit := 0
+		if v, ok := args["limit"].(float64); ok && v > 0 {
+			limit = int(v)
+		}
+		samples := -1
+		if v, ok := args["samples"].(float64); ok && v >= 0 {
+			samples = int(v)
+		}
+		stop, _ := args["stop"].(bool)
+
+		result, err := client.FindOrphans(ctx, limit, samples, stop)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to find orphan nodes: %v", err)), nil
+		}
+		if !result.Tracking {
+			return mcp.NewToolResultText("Orphan tracking stopped"), nil
+		}
+
+		var output strings.Builder
+		if result.Started {
+			output.WriteString("Orphan tracking started now: call again after the leak has had a chance to happen\n")
+		}
+		fmt.Fprintf(&output, "%d orphan nodes tracked (%d roots), %d untracked of the engine's %d\n",
+			result.Tracked, result.Roots, result.Untracked, result.EngineOrphans)
+		if result.Dropped > 0 {
+			fmt.Fprintf(&output, "%d detaches dropped at the tracking cap\n", result.Dropped)
+		}
+		for _, g := range result.Groups {
+			fmt.Fprintf(&output, "%8d  %s", g.Count, classLabel(g.Class, g.Script))
+			if g.SceneFile != "" {
+				fmt.Fprintf(&output, " from %s", g.SceneFile)
+			}
+			fmt.Fprintf(&output, ": %d roots, oldest %.1fs\n", g.Roots, g.OldestS)
+			for _, o := range g.Samples {
+				fmt.Fprintf(&output, "          #%d %s (%d children, frame %d)", o.ID, o.Name, o.Children, o.Frame)
+				if o.DetachedFrom != "" {
+					fmt.Fprintf(&output, " detached from %s", o.DetachedFrom)
+				}
+				output.WriteString("\n")
+			}
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+// helper: a load profile as text, slowest loads first
+func formatLoadProfile(p *godot.LoadProfileResult) string {
+	var output strings.Builder
+	fmt.Fprintf(&output, "%d loads in %.1f ms (%.1f ms loading), %d cache hits, %d failed",
+		p.Loads, p.WallMs, p.SelfMs, p.CacheHits, p.Failed)
+	if p.Pending > 0 {
+		fmt.Fprintf(&output, ", %d still loading", p.Pending)
+	}
+	if p.Dropped > 0 {
+		fmt.Fprintf(&output, ", %d not recorded", p.Dropped)
+	}
+	output.WriteString("\n")
+	for _, l := range p.Top {
+		fmt.Fprintf(&output, "%8.2f ms  %s (%s", l.SelfMs, l.Path, l.Type)
+		if l.Size >= 0 {
+			fmt.Fprintf(&output, ", %d bytes", l.Size)
+		}
+		if l.TotalMs > l.SelfMs {
+			fmt.Fprintf(&output, ", %.2f ms with dependencies", l.TotalMs)
+		}
+		if l.Threaded {
+			output.WriteString(", threaded")
+		}
+		if l.Failed {
+			output.WriteString(", failed")
+		}
+		output.WriteString(")\n")
+		if len(l.Chain) > 0 {
+			fmt.Fprintf(&output, "             via %s\n", strings.Join(l.Chain, " > "))
+		}
+	}
+	if len(p.ByType) > 0 {
+		output.WriteString("By type:\n")
+		for _, t := range p.ByType {
+			fmt.Fprintf(&output, "%8.2f ms  %s (%d)\n", t.SelfMs, t.Type, t.Count)
+		}
+	}
+	return output.String()
+}
+
+func makeGetLoadProfile(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		limit := 0
+		if v, ok := args["limit"].(float64); ok && v > 0 {
+			limit = int(v)
+		}
+		sort, _ := args["sort"].(string)
+
+		result, err := client.LoadProfile(ctx, limit, sort == "total")
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to get load profile: %v", err)), nil
+		}
+		return mcp.NewToolResultText(formatLoadProfile(result)), nil
+	}
+}
+
+func makeSamplePhysics(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		interval := -1
+		if v, ok := args["interval_ms"].(float64); ok && v >= 0 {
+			interval = int(v)
+		}
+		top := 0
+		if v, ok := args["top"].(float64); ok && v > 0 {
+			top = int(v)
+		}
+		stop, _ := args["stop"].(bool)
+
+		result, err := client.SamplePhysics(ctx, interval, top, stop)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to sample physics: %v", err)), nil
+		}
+		if stop {
+			return mcp.NewToolResultText(fmt.Sprintf("Physics sampling stopped (%d samples stored)", result.Stored)), nil
+		}
+
+		var output strings.Builder
+		fmt.Fprintf(&output, "Sample %d (physics frame %d)\n", result.ID, result.Frame)
+		if result.Tree.Ticks > 0 {
+			fmt.Fprintf(&output, "Tree physics pass: %.2f ms avg, %.2f ms max over %d ticks\n",
+				result.Tree.AvgMs, result.Tree.MaxMs, result.Tree.Ticks)
+		} else {
+			output.WriteString("Tree physics pass: timing started, sample again for tick times\n")
+		}
+		if result.PhysicsMs >= 0 {
+			fmt.Fprintf(&output, "Engine physics tick: %.2f ms max", result.PhysicsMs)
+			if result.ServerMs >= 0 {
+				fmt.Fprintf(&output, " (about %.2f ms in the physics server)", result.ServerMs)
+			}
+			output.WriteString("\n")
+		}
+		for _, s := range []struct {
+			name   string
+			counts godot.PhysicsServerCounts
+		}{{"2D", result.Server2D}, {"3D", result.Server3D}} {
+			if s.counts.ActiveObjects > 0 || s.counts.CollisionPairs > 0 {
+				fmt.Fprintf(&output, "%s server: %d active objects, %d collision pairs, %d islands\n",
+					s.name, s.counts.ActiveObjects, s.counts.CollisionPairs, s.counts.Islands)
+			}
+		}
+		for _, sp := range result.Spaces {
+			fmt.Fprintf(&output, "Space %d (%dD): %d rigid (%d awake, %d frozen), %d character, %d static, %d areas\n",
+				sp.Space, sp.Dims, sp.Rigid, sp.RigidActive, sp.RigidFrozen, sp.Character, sp.Static, sp.Areas)
+		}
+		if len(result.Processors) > 0 {
+			fmt.Fprintf(&output, "_physics_process on %d nodes:\n", result.PhysicsProcessing)
+			for _, p := range result.Processors {
+				fmt.Fprintf(&output, "%8d  %s\n", p.Nodes, classLabel(p.Class, p.Script))
+			}
+		}
+		if result.IntervalMs > 0 {
+			fmt.Fprintf(&output, "Sampling every %d ms (%d stored)\n", result.IntervalMs, result.Stored)
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+func makeGetPhysicsSeries(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		args := req.GetArguments()
+		since := int64(0)
+		if v, ok := args["since"].(float64); ok && v > 0 {
+			since = int64(v)
+		}
+		limit := 0
+		if v, ok := args["limit"].(float64); ok && v > 0 {
+			limit = int(v)
+		}
+
+		result, err := client.PhysicsSeries(ctx, since, limit)
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to get physics series: %v", err)), nil
+		}
+
+		var output strings.Builder
+		fmt.Fprintf(&output, "%d samples (newest %d, %d stored)\n", len(result.Samples), result.Newest, result.Stored)
+		output.WriteString("    id  ticks  tree avg/max ms  tick ms  server ms  bodies  awake  pairs  islands\n")
+		for _, r := range result.Samples {
+			fmt.Fprintf(&output, "%6d  %5d  %6.2f/%6.2f  %7.2f  %9.2f  %6d  %5d  %5d  %7d\n",
+				r.ID, r.Ticks, r.AvgMs, r.MaxMs, r.PhysicsMs, r.ServerMs, r.Bodies, r.RigidActive,
+				r.CollisionPairs, r.Islands)
+		}
+		return mcp.NewToolResultText(output.String()), nil
+	}
+}
+
+func makeListEditors(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		// note: reads the registry directly, works without a connection
+		instances, err := godot.ListInstances(godot.RegistryDir())
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to read editor registry: %v", err)), nil
+		}
+		if len(instances) == 0 {
+			return mcp.NewToolResultText("No running editors found"), nil
+		}
+
+		current := client.SocketPath()
+		var output string
+		for _, inst := range instances {
+			marker := ""
+			if inst.SocketPath == current {
+				marker = " (current)"
+			}
+			output += fmt.Sprintf("%s%s\n  socket: %s\n  godot: %s, pid: %d\n",
+				inst.ProjectPath, marker, inst.SocketPath, inst.GodotVersion, inst.PID)
+		}
+
+		return mcp.NewToolResultText(output), nil
+	}
+}
+
+func makeSelectEditor(client *godot.Client) server.ToolHandlerFunc {
+	return func(ctx context.Context, req mcp.CallToolRequest) (*mcp.CallToolResult, error) {
+		project, err := req.RequireString("project")
+		if err != nil {
+			return mcp.NewToolResultError("missing required parameter: project"), nil
+		}
+
+		instances, err := godot.ListInstances(godot.RegistryDir())
+		if err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to read editor registry: %v", err)), nil
+		}
+
+		socketPath := ""
+		for _, inst := range instances {
+			if inst.SocketPath == project {
+				socketPath = inst.SocketPath
+			}
+		}
+		if socketPath == "" {
+			if inst, ok := godot.FindInstance(instances, project); ok {
+				socketPath = inst.SocketPath
+			}
+		}
+		if socketPath == "" {
+			return mcp.NewToolResultError(fmt.Sprintf("no running editor for %s (see list_editors)", project)), nil
+		}
+
+		if err := client.SwitchEditor(ctx, socketPath); err != nil {
+			return mcp.NewToolResultError(fmt.Sprintf("failed to connect to %s: %v", socketPath, err)), nil
+		}
+
+		return mcp.NewToolResultText(fmt.Sprintf("Now connected to %s", socketPath)), nil
+	}
+}